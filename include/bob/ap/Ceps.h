@@ -27,6 +27,7 @@
 #define BOB_AP_CEPS_H
 
 #include <blitz/array.h>
+#include <algorithm>
 #include "Spectrogram.h"
 
 namespace bob {
@@ -183,6 +184,21 @@ class Ceps: public Spectrogram
      * This methods is used to compute both the delta's and double delta's.
      */
     void addDerivative(const blitz::Array<double,2>& input, blitz::Array<double,2>& output) const;
+    /**
+     * @brief Computes the first order derivative of the row i of a sequence
+     * of n_frames rows, input(j) returning the row j. Only the rows
+     * max(0,i-delta_win) to min(n_frames-1,i+delta_win) and the first and
+     * last rows (at the boundaries) are accessed.
+     */
+    template <typename R>
+    void derivativeRow(const R& input, const int i, const int n_frames,
+      blitz::Array<double,1>& output) const;
+    /**
+     * @brief Computes the static cepstral features (and the energy if
+     * enabled) of the frame i of the input
+     */
+    void cepstralFrame(const blitz::Array<double,1>& input, const size_t i,
+      blitz::Array<double,1>& ceps_row);
     /**
      * @brief Applies the DCT to the cepstral features:
      * \f$out[i]=sqrt(2/N)*sum_{j=1}^{N} (in[j]cos(M_PI*i*(j-0.5)/N)\f$
@@ -219,7 +235,42 @@ class Ceps: public Spectrogram
     blitz::Array<double,2> m_dct_kernel;
 
 //    friend class TestCeps;
+    friend class CepsStream;
 };
+
+template <typename R>
+void Ceps::derivativeRow(const R& input, const int i, const int n_frames,
+  blitz::Array<double,1>& output) const
+{
+  // The operations are the ones of addDerivative(), in the same order,
+  // to get the same results whatever the number of rows available
+  output = 0.;
+
+  // Inner part: \f$output[i] += \sum_{l=1}^{DW} l * (input[i+l] - input[i-l])\f$
+  for (int l=1; l<=(int)m_delta_win; ++l)
+    if (l <= i && i <= n_frames-l-1)
+      output += l*(input(i+l) - input(i-l));
+
+  const double factor = m_delta_win*(m_delta_win+1)/2;
+  // Left boundary part:
+  // \f$output[i] += (\sum_{l=1+i}^{DW} l*input[i+l]) - (\sum_{l=i+1}^{DW}l)*input[0])\f$
+  if (i < (int)m_delta_win) {
+    output -= (factor - i*(i+1)/2) * input(0);
+    for (int l=1+i; l<=(int)m_delta_win; ++l)
+      output += l*input(std::min(i+l,n_frames-1));
+  }
+  // Right boundary part:
+  // \f$output[i] += (\sum_{l=Nframes-1-i}^{DW}l)*input[Nframes-1]) - (\sum_{l=Nframes-1-i}^{DW} l*input[i-l])\f$
+  if (i >= n_frames-(int)m_delta_win) {
+    int ii = (n_frames-1)-i;
+    output += (factor - ii*(ii+1)/2) * input(n_frames-1);
+    for (int l=1+ii; l<=(int)m_delta_win; ++l)
+      output -= l*input(std::max(i-l,0));
+  }
+  // Sum of the integer squared from 1 to delta_win
+  const double sum = m_delta_win*(m_delta_win+1)*(2*m_delta_win+1)/3;
+  output /= sum;
+}
 /*
 class TestCeps
 {
@@ -0,0 +1,188 @@
+/**
+ * @file bob/ap/CepsStream.h
+ * @date Sat Oct 17 17:02:45 2026 +0200
+ *
+ * @brief Online extraction of Linear and Mel Frequency Cepstral
+ * Coefficients (MFCC and LFCC) from an audio stream
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef BOB_AP_CEPSSTREAM_H
+#define BOB_AP_CEPSSTREAM_H
+
+#include <blitz/array.h>
+#include <deque>
+#include <vector>
+#include "Ceps.h"
+
+namespace bob {
+/**
+ * \ingroup libap_api
+ * @{
+ *
+ */
+namespace ap {
+
+/**
+ * @brief This class extracts cepstral features from an audio stream.
+ * @details Samples are pushed by chunks of any size, and the feature
+ * vectors of the frames are made available as soon as they can be computed.
+ * The first and second order derivatives of a frame require the static
+ * features of the delta_win next frames (and of the 2*delta_win next frames
+ * for the second order derivatives), which gives the latency of the
+ * extractor, in frames. Only the frames required to compute the derivatives
+ * are kept, the memory used being independent of the length of the stream.
+ * Once the end of the stream is notified by finish(), the feature vectors
+ * are the ones computed by the Ceps::operator() on the whole signal.
+ */
+class CepsStream
+{
+  public:
+    /**
+     * @brief Constructor. The configuration of the given Ceps (which is
+     * copied) is used for the extraction.
+     */
+    CepsStream(const Ceps& ceps);
+
+    /**
+     * @brief Copy constructor
+     */
+    CepsStream(const CepsStream& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~CepsStream();
+
+    /**
+     * @brief Assignment
+     */
+    CepsStream& operator=(const CepsStream& other);
+
+    /**
+     * @brief Returns the cepstral feature extractor
+     */
+    const Ceps& getCeps() const
+    { return m_ceps; }
+
+    /**
+     * @brief Returns the dimension of the feature vectors
+     */
+    size_t getNFeatures() const
+    { return m_n_features; }
+
+    /**
+     * @brief Returns the number of frames that should follow a frame before
+     * its feature vector is available
+     */
+    size_t getLookahead() const;
+
+    /**
+     * @brief Returns the number of feature vectors which can be read
+     */
+    size_t getNReadyFrames() const
+    { return m_ready.size(); }
+
+    /**
+     * @brief Returns the number of frames extracted since the beginning of
+     * the stream
+     */
+    size_t getNFrames() const
+    { return m_n_statics; }
+
+    /**
+     * @brief Tells if the end of the stream has been notified
+     */
+    bool getFinished() const
+    { return m_finished; }
+
+    /**
+     * @brief Starts a new stream, discarding the samples and the feature
+     * vectors which have not been read
+     */
+    void reset();
+
+    /**
+     * @brief Appends the given samples to the stream
+     */
+    void push(const blitz::Array<double,1>& samples);
+
+    /**
+     * @brief Notifies the end of the stream. The feature vectors of the
+     * last frames become available. The remaining samples, which do not
+     * fill a whole frame, are discarded.
+     */
+    void finish();
+
+    /**
+     * @brief Reads the feature vectors which are available, in the order
+     * of the frames, up to the number of rows of the output array
+     * @return The number of feature vectors written
+     */
+    size_t read(blitz::Array<double,2>& output);
+
+  private:
+    /**
+     * @brief Extracts the static features of the frames which are complete
+     */
+    void processSamples();
+    /**
+     * @brief Computes the derivatives which can be computed and moves the
+     * complete feature vectors into the ready queue
+     */
+    void processFrames();
+    /**
+     * @brief Removes the rows which are not required anymore
+     */
+    void trimHistory();
+
+    Ceps m_ceps;
+    size_t m_n_coefs;
+    size_t m_n_features;
+    bool m_with_delta;
+    bool m_with_delta_delta;
+
+    // Samples which do not belong to a processed frame yet, and number of
+    // samples to skip (if the shift is larger than the window)
+    std::vector<double> m_samples;
+    size_t m_skip;
+    bool m_finished;
+
+    // Static features (and energy), first order derivatives and second
+    // order derivatives: the first row, which is required by the boundary
+    // conditions, and the most recent rows, starting at the given index
+    blitz::Array<double,1> m_first_static;
+    std::deque<blitz::Array<double,1> > m_statics;
+    size_t m_statics_begin;
+    size_t m_n_statics;
+    blitz::Array<double,1> m_first_delta;
+    std::deque<blitz::Array<double,1> > m_deltas;
+    size_t m_deltas_begin;
+    size_t m_n_deltas;
+    std::deque<blitz::Array<double,1> > m_delta_deltas;
+    size_t m_delta_deltas_begin;
+    size_t m_n_delta_deltas;
+
+    // Complete feature vectors which have not been read yet
+    std::deque<blitz::Array<double,1> > m_ready;
+    size_t m_n_done;
+};
+
+}
+}
+
+#endif /* BOB_AP_CEPSSTREAM_H */
@@ -30,7 +30,7 @@
 #include <blitz/array.h>
 #include <boost/format.hpp>
 
-#include <bob/sp/FFT1D.h>
+#include <bob/sp/RFFT1D.h>
 
 #include "Energy.h"
 
@@ -224,10 +224,35 @@ class Spectrogram: public Energy
      * @brief Computes the power-spectrum of the FFT of the input frame
      */
     void powerSpectrumFFT(blitz::Array<double,1>& x);
+    /**
+     * @brief Computes the power-spectra of the FFT of several frames (one
+     * per row) at once. The power-spectrum of a frame replaces its first
+     * win_size/2+1 samples.
+     */
+    void powerSpectrumFFT(blitz::Array<double,2>& frames);
+    /**
+     * @brief Extracts and normalizes the n_frames frames of the input
+     * starting at the frame first_frame into the first rows of
+     * m_cache_frames (n_frames should not exceed s_n_block_frames)
+     */
+    void extractNormalizeFrames(const blitz::Array<double,1>& input,
+      const int first_frame, const int n_frames);
+    /**
+     * @brief Pre-emphasises and applies the Hamming window to several frames
+     * (one per row), in a single pass over each frame
+     */
+    void preEmphasisHammingWindow(blitz::Array<double,2>& frames) const;
     /**
      * @brief Applies the triangular filter bank
      */
     void filterBank(blitz::Array<double,1>& x);
+    /**
+     * @brief Applies the triangular filter bank to the power-spectra of
+     * several frames (one per row). The filter bank is a banded matrix,
+     * each filter being only applied to the bins of its support.
+     */
+    void filterBank(const blitz::Array<double,2>& frames,
+      blitz::Array<double,2>& filters) const;
     /**
      * @brief Applies the triangular filter bank to the input array and
      * returns the logarithm of the magnitude in each band.
@@ -243,6 +268,12 @@ class Spectrogram: public Energy
     virtual void initWinLength();
     virtual void initWinSize();
 
+    /**
+     * @brief The number of frames processed at once by the extractors: the
+     * memory used does not depend on the length of the input
+     */
+    static const int s_n_block_frames;
+
     void initCacheHammingKernel();
     void initCacheFilterBank();
 
@@ -280,10 +311,12 @@ class Spectrogram: public Energy
     blitz::Array<double,1> m_hamming_kernel;
     blitz::Array<int,1> m_p_index;
     std::vector<blitz::Array<double,1> > m_filter_bank;
-    bob::sp::FFT1D m_fft;
+    bob::sp::RFFT1D m_fft;
 
-    mutable blitz::Array<std::complex<double>,1> m_cache_frame_c1;
-    mutable blitz::Array<std::complex<double>,1> m_cache_frame_c2;
+    mutable blitz::Array<std::complex<double>,1> m_cache_frame_c;
+    mutable blitz::Array<double,2> m_cache_frames;
+    mutable blitz::Array<double,2> m_cache_block_filters;
+    mutable blitz::Array<std::complex<double>,2> m_cache_frames_c;
     mutable blitz::Array<double,1> m_cache_filters;
 };
 
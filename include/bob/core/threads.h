@@ -0,0 +1,128 @@
+/**
+ * @file bob/core/threads.h
+ * @date Sat Oct 17 22:10:08 2026 +0200
+ *
+ * @brief Splits loops over independent items across threads
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_CORE_THREADS_H
+#define BOB_CORE_THREADS_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+namespace bob { namespace core {
+/**
+ * @ingroup CORE
+ * @{
+ */
+
+  /**
+   * @brief Returns the number of hardware threads (1 if unknown)
+   */
+  inline size_t hardware_threads()
+  {
+    return std::max(1u, boost::thread::hardware_concurrency());
+  }
+
+  namespace detail {
+    /**
+     * @brief Runs op on the given range, keeping the message of the
+     * exception it may throw (which cannot cross the thread boundary)
+     */
+    template <typename TOp>
+    void thread_run(const TOp& op, const size_t thread, const size_t begin,
+      const size_t end, std::string& error)
+    {
+      try {
+        op(thread, begin, end);
+      }
+      catch (std::exception& e) {
+        error = e.what();
+        if (error.empty()) error = "unknown error in a worker thread";
+      }
+      catch (...) {
+        error = "unknown error in a worker thread";
+      }
+    }
+  }
+
+  /**
+   * @brief Splits the loop over [0,size) into n_threads contiguous ranges
+   * of (almost) equal lengths, and calls op(thread, begin, end) on each of
+   * them in a separate thread. The ranges only depend on size and
+   * n_threads, such that per-thread results which are combined in the
+   * order of the threads give deterministic results.
+   *
+   * @param op The functor, called concurrently: it should only write data
+   * that belongs to its range (or to its thread index)
+   * @param size The number of items
+   * @param n_threads The number of threads (0 for hardware_threads()). No
+   * thread is started if 1, op being called in the calling thread.
+   * @warning Exceptions thrown by op are rethrown as std::runtime_error
+   * once all the threads are done.
+   */
+  template <typename TOp>
+  void thread_loop(const TOp& op, const size_t size, size_t n_threads=1)
+  {
+    if (n_threads == 0) n_threads = hardware_threads();
+    n_threads = std::max((size_t)1, std::min(n_threads, size));
+    if (n_threads == 1) {
+      op(0, 0, size);
+      return;
+    }
+
+    std::vector<std::string> errors(n_threads);
+    boost::thread_group threads;
+    for (size_t t=0; t<n_threads; ++t)
+      threads.create_thread(boost::bind(&detail::thread_run<TOp>,
+        boost::cref(op), t, t*size/n_threads, (t+1)*size/n_threads,
+        boost::ref(errors[t])));
+    threads.join_all();
+
+    for (size_t t=0; t<n_threads; ++t)
+      if (!errors[t].empty()) throw std::runtime_error(errors[t]);
+  }
+
+  /**
+   * @brief Returns the instance of a workspace which belongs to the calling
+   * thread, default-constructing it on the first call of each thread. This
+   * lets const methods use working arrays without sharing them between
+   * threads.
+   *
+   * @param workspace The thread-specific storage, typically a static
+   * variable of the translation unit of the method
+   */
+  template <typename T>
+  T& thread_workspace(boost::thread_specific_ptr<T>& workspace)
+  {
+    if (!workspace.get()) workspace.reset(new T());
+    return *workspace;
+  }
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_CORE_THREADS_H */
@@ -123,6 +123,14 @@ namespace io {
        */
       virtual void write (const bob::core::array::interface& buffer) =0;
 
+      /**
+       * Writes the data which is buffered in memory (if any) to the file.
+       * Unlike the destructor, which can only log them, this method raises
+       * the errors of the writing: it should be called once all the data has
+       * been appended.
+       */
+      virtual void flush () {}
+
     public: //blitz::Array specific API
 
       /**
@@ -71,13 +71,15 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        * b) Will contain the exact number of dimensions of the input type.
        *
        * When you set "list" to true (the default), datasets are created with
-       * chunking automatically enabled (the chunk size is set to the size of
-       * the given variable) and an extra dimension is inserted to accommodate
-       * list operations.
+       * chunking automatically enabled and an extra dimension is inserted to
+       * accommodate list operations. By default, each chunk holds a single
+       * variable. If chunk_size is set, each chunk holds as many variables as
+       * fit in chunk_size bytes (at least one), which makes appending and
+       * reading many small variables a lot faster.
        */
       Dataset(boost::shared_ptr<Group> parent, const std::string& name,
           const bob::io::HDF5Type& type, bool list=true,
-          size_t compression=0);
+          size_t compression=0, size_t chunk_size=0);
 
     public: //api
 
@@ -211,6 +213,34 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
           read_buffer(index, dest_type, reinterpret_cast<void*>(value.data()));
         }
 
+      /**
+       * Reads the arrays (or scalars) at positions [begin, end) of the
+       * current dataset at once into a single array, which has one more
+       * dimension than the stored objects. This reads a single hyperslab of
+       * the file, instead of end-begin selections.
+       *
+       * @param begin The position of the first object to read
+       * @param end The position after the last object to read
+       * @param value The output array, of extent end-begin on its first
+       * dimension. This variable has to be a zero-based C-style contiguous
+       * storage array. If that is not the case, we will raise an exception.
+       */
+      template <typename T, int N>
+        void readArray(size_t begin, size_t end, blitz::Array<T,N>& value) {
+          bob::core::array::assertCZeroBaseContiguous(value);
+          if (end < begin || (size_t)value.extent(0) != end - begin) {
+            boost::format m("cannot read the elements [%d, %d) of `%s' into an array with %d rows");
+            m % begin % end % url() % value.extent(0);
+            throw std::runtime_error(m.str());
+          }
+          bob::io::HDF5Type array_type(value);
+          bob::io::HDF5Shape shape(array_type.shape());
+          if (N > 1) shape <<= 1; ///< type of the objects
+          else shape[0] = 1; ///< scalars
+          read_buffer(begin, end-begin, bob::io::HDF5Type(array_type.type(), shape),
+              reinterpret_cast<void*>(value.data()));
+        }
+
       /**
        * Reads data from the file into an array allocated dynamically. The same
        * conditions as for readArray(index, value) apply.
@@ -389,6 +419,14 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       std::vector<bob::io::HDF5Descriptor>::iterator select (size_t index,
           const bob::io::HDF5Type& dest);
 
+      /**
+       * Selects count consecutive objects of the file, starting at index,
+       * and creates the memory space holding them contiguously.
+       */
+      std::vector<bob::io::HDF5Descriptor>::iterator select (size_t index,
+          size_t count, const bob::io::HDF5Type& dest,
+          boost::shared_ptr<hid_t>& memspace);
+
     public: //direct access for other bindings -- don't use these!
 
       /**
@@ -396,6 +434,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       void read_buffer (size_t index, const bob::io::HDF5Type& dest, void* buffer);
 
+      /**
+       * Reads count consecutive objects, starting at index, into the given
+       * (user) buffer, with a single read operation.
+       */
+      void read_buffer (size_t index, size_t count,
+          const bob::io::HDF5Type& dest, void* buffer);
+
       /**
        * Writes the contents of a given buffer into the file. The area that the
        * data will occupy should have been selected beforehand.
@@ -403,11 +448,36 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       void write_buffer (size_t index, const bob::io::HDF5Type& dest,
           const void* buffer);
 
+      /**
+       * Writes count consecutive objects, starting at index, from the given
+       * buffer, with a single write operation.
+       */
+      void write_buffer (size_t index, size_t count,
+          const bob::io::HDF5Type& dest, const void* buffer);
+
       /**
        * Extend the dataset with one extra variable.
        */
       void extend_buffer (const bob::io::HDF5Type& dest, const void* buffer);
 
+      /**
+       * Extend the dataset with count extra variables, stored contiguously in
+       * the given buffer, with a single extension and write operation.
+       */
+      void extend_buffer (const bob::io::HDF5Type& dest, size_t count,
+          const void* buffer);
+
+    public: //chunk cache
+
+      /**
+       * Sets the size in bytes and the number of slots (a prime number, about
+       * 100 times the number of chunks which fit in the cache, works best) of
+       * the raw data chunk cache of this dataset. A value of 0 keeps the
+       * current setting. Chunks that are read (and decompressed) remain in
+       * the cache, which speeds up random accesses to compressed datasets.
+       */
+      void set_chunk_cache(size_t cache_size, size_t cache_slots=0);
+
     public: //attribute support
 
       /**
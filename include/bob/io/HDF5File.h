@@ -56,15 +56,22 @@ namespace bob { namespace io {
 
       /**
        * Constructor, starts a new HDF5File object giving it a file name and an
-       * action: excl/trunc/in/inout
+       * action: excl/trunc/in/inout. Optionally, sets the size in bytes and
+       * the number of slots of the raw data chunk cache of each dataset of
+       * the file (0 keeps the HDF5 defaults, see setChunkCache()).
        */
-      HDF5File (const std::string& filename, mode_t mode);
+      HDF5File (const std::string& filename, mode_t mode,
+          const size_t cache_size=0, const size_t cache_slots=0);
 
       /**
        * Constructor, starts a new HDF5File object giving it a file name and an
        * action: 'r' (read-only), 'a' (read/write/append), 'w' (read/write/truncate) or 'x' (read/write/exclusive)
+       * Optionally, sets the size in bytes and the number of slots of the
+       * raw data chunk cache of each dataset of the file (0 keeps the HDF5
+       * defaults, see setChunkCache()).
        */
-      HDF5File (const std::string& filename, const char mode='r');
+      HDF5File (const std::string& filename, const char mode='r',
+          const size_t cache_size=0, const size_t cache_slots=0);
 
       /**
        * Destructor virtualization
@@ -137,6 +144,39 @@ namespace bob { namespace io {
        */
       void rename (const std::string& from, const std::string& to);
 
+      /**
+       * Sets the size in bytes and the number of slots of the raw data chunk
+       * cache of a dataset, for as long as this file is opened (or until a
+       * dataset is renamed). A value of 0 keeps the current setting. Chunks read (and decompressed) remain in
+       * the cache, which speeds up random accesses to compressed datasets:
+       * the cache should hold the chunks which are accessed repeatedly, and
+       * the number of slots should be a prime number about 100 times larger
+       * than the number of chunks which fit in the cache. Relative paths are
+       * accepted.
+       */
+      void setChunkCache(const std::string& path, const size_t cache_size,
+          const size_t cache_slots=0);
+
+      /**
+       * Tells if the bytes of the datasets which are compressed, and created
+       * from now on through this file, are shuffled before compression (off
+       * by default). Shuffling usually improves the compression of numerical
+       * data.
+       */
+      bool getShuffle() const { return m_file->shuffle(); }
+      void setShuffle(bool v) { m_file->shuffle(v); }
+
+      /**
+       * Tells if the datasets which are compressed, and created from now on
+       * through this file, use the LZF filter, which compresses less but a
+       * lot faster than gzip (off by default). The compression level is
+       * then ignored. The LZF filter is a plugin of the HDF5 library: gzip
+       * is used if it is not available. Note that other programs reading
+       * these datasets also need the LZF filter.
+       */
+      bool getFastCompression() const { return m_file->fast_compression(); }
+      void setFastCompression(bool v) { m_file->fast_compression(v); }
+
       /**
        * Accesses all existing paths in one shot. Input has to be a std
        * container with T = std::string and accepting push_back()
@@ -217,6 +257,18 @@ namespace bob { namespace io {
         (*m_cwd)[path]->readArray(pos, value);
       }
 
+      /**
+       * Reads the arrays (or scalars) at positions [begin, end) of a dataset
+       * at once, into a single array with one more dimension, of extent
+       * end-begin on its first dimension. This reads a single hyperslab of
+       * the file. Raises an exception if the type is incompatible. Relative
+       * paths are accepted.
+       */
+      template <typename T, int N> void readArray(const std::string& path,
+          size_t begin, size_t end, blitz::Array<T,N>& value) {
+        (*m_cwd)[path]->readArray(begin, end, value);
+      }
+
       /**
        * Reads data from the file into a array. Raises an exception if the type
        * is incompatible. Relative paths are accepted. Destination array is
@@ -319,16 +371,19 @@ namespace bob { namespace io {
        * level. Note this setting has no effect if the Dataset already exists
        * on file, in which case the current setting for that dataset is
        * respected. The maximum value for the gzip compression is 9. The value
-       * of zero turns compression off (the default).
+       * of zero turns compression off (the default). In the same way, the
+       * chunk_size sets the target size in bytes of the chunks of a new
+       * dataset, which then hold several arrays each. The value of zero
+       * stores each array in its own chunk (the default).
        */
       template <typename T> void appendArray(const std::string& path,
-          const T& value, size_t compression=0) {
+          const T& value, size_t compression=0, size_t chunk_size=0) {
         if (!m_file->writeable()) {
           boost::format m("cannot append array to dataset '%s' at path '%s' of file '%s' because it is not writeable");
           m % path % m_cwd->path() % m_file->filename();
           throw std::runtime_error(m.str());
         }
-        if (!contains(path)) m_cwd->create_dataset(path, bob::io::HDF5Type(value), true, compression);
+        if (!contains(path)) m_cwd->create_dataset(path, bob::io::HDF5Type(value), true, compression, chunk_size);
         (*m_cwd)[path]->addArray(value);
       }
 
@@ -373,10 +428,12 @@ namespace bob { namespace io {
 
       /**
        * creates a new dataset. If the dataset already exists, checks if the
-       * existing data is compatible with the required type.
+       * existing data is compatible with the required type. For new lists,
+       * chunk_size sets the target size in bytes of the chunks (0 for one
+       * object per chunk).
        */
       void create (const std::string& path, const HDF5Type& dest, bool list,
-          size_t compression);
+          size_t compression, size_t chunk_size=0);
 
       /**
        * Reads data from the file into a buffer. The given buffer contains
@@ -387,6 +444,13 @@ namespace bob { namespace io {
       void read_buffer (const std::string& path, size_t pos,
           const HDF5Type& type, void* buffer) const;
 
+      /**
+       * Reads count consecutive objects, starting at pos, into a buffer
+       * large enough to hold them, with a single read operation.
+       */
+      void read_buffer (const std::string& path, size_t pos, size_t count,
+          const HDF5Type& type, void* buffer) const;
+
       /**
        * writes the contents of a given buffer into the file. the area that the
        * data will occupy should have been selected beforehand.
@@ -400,6 +464,13 @@ namespace bob { namespace io {
       void extend_buffer (const std::string& path,
           const HDF5Type& type, const void* buffer);
 
+      /**
+       * extend the dataset with count extra variables, stored one after the
+       * other in the buffer, with a single write operation.
+       */
+      void extend_buffer (const std::string& path,
+          const HDF5Type& type, size_t count, const void* buffer);
+
       /**
        * Copy construct an already opened HDF5File; just creates a shallow copy
        * of the file
@@ -0,0 +1,166 @@
+/**
+ * @file bob/io/HDF5Prefetcher.h
+ * @date Sat Oct 17 19:05:12 2026 +0200
+ *
+ * @brief Sequential reader of HDF5 datasets, which reads (and decompresses)
+ * the next blocks of objects on a background thread
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_IO_HDF5PREFETCHER_H
+#define BOB_IO_HDF5PREFETCHER_H
+
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstring>
+
+#include <boost/format.hpp>
+#include <boost/thread.hpp>
+#include <blitz/array.h>
+
+#include <bob/core/check.h>
+#include <bob/io/HDF5File.h>
+
+namespace bob { namespace io {
+
+  /**
+   * Reads a dataset of an HDF5 file from its first to its last object, by
+   * blocks of consecutive objects. While the caller processes a block, a
+   * background thread reads (and decompresses) the next ones, with a single
+   * read operation per block.
+   *
+   * @warning The HDF5 library is called from the background thread. Unless
+   * the HDF5 library was built thread-safe, it should not be used by other
+   * threads (including the one using this object) before this object is
+   * destroyed or next() returned the last block.
+   */
+  class HDF5Prefetcher {
+
+    public: //api
+
+      /**
+       * Starts reading a dataset of the given file. Relative paths are
+       * accepted.
+       *
+       * @param block_size The number of objects per block (the last block
+       * may be smaller). Blocks which are multiples of the chunks of the
+       * dataset work best.
+       * @param n_blocks The maximum number of blocks read ahead
+       */
+      HDF5Prefetcher(const HDF5File& file, const std::string& path,
+          const size_t block_size=1024, const size_t n_blocks=2);
+
+      /**
+       * Stops the background thread
+       */
+      virtual ~HDF5Prefetcher();
+
+      /**
+       * The number of objects in the dataset
+       */
+      size_t size() const { return m_size; }
+
+      /**
+       * The number of objects per block
+       */
+      size_t getBlockSize() const { return m_block_size; }
+
+      /**
+       * The type of the objects in the dataset
+       */
+      const HDF5Type& type() const { return m_type; }
+
+      /**
+       * Waits for the next block and copies it into the given buffer, which
+       * holds at least getBlockSize() objects of type(). Returns the number
+       * of objects copied, which is 0 once all the blocks have been read.
+       * Errors of the background thread are raised here.
+       */
+      size_t next(void* buffer);
+
+      /**
+       * Waits for the next block and copies it into the given array, which
+       * is resized to the number of objects in the block on its first
+       * dimension, and to the shape of the objects on the others. Returns
+       * false once all the blocks have been read. The element type of the
+       * array has to be the one of the dataset.
+       */
+      template <typename T, int N> bool next(blitz::Array<T,N>& block) {
+        bob::io::HDF5Type dest_type(block);
+        const HDF5Shape& shape = m_type.shape();
+        if (dest_type.type() != m_type.type() || !(N == (int)shape.n()+1 ||
+              (N == 1 && shape.n() == 1 && shape[0] == 1))) {
+          boost::format m("cannot read blocks of `%s' into arrays of `%s' with %d dimensions");
+          m % m_type.str() % dest_type.str() % N;
+          throw std::runtime_error(m.str());
+        }
+        const size_t count = pop();
+        if (!count) return false;
+        blitz::TinyVector<int,N> block_shape;
+        block_shape(0) = count;
+        for (int k=1; k<N; ++k) block_shape(k) = shape[k-1];
+        if (!bob::core::array::isCZeroBaseContiguous(block) ||
+            blitz::any(block.shape() != block_shape))
+          block.resize(block_shape);
+        std::memcpy(block.data(), &m_current[0], count * m_object_size);
+        return true;
+      }
+
+    private: //helpers
+
+      /**
+       * Waits for the next block, moves it to m_current and returns its
+       * number of objects (0 at the end)
+       */
+      size_t pop();
+
+      /**
+       * Reads the blocks (background thread)
+       */
+      void run();
+
+      /**
+       * Copies -- not implemented
+       */
+      HDF5Prefetcher(const HDF5Prefetcher& other);
+      HDF5Prefetcher& operator= (const HDF5Prefetcher& other);
+
+    private: //representation
+
+      HDF5File m_file; ///< shallow copy of the file
+      std::string m_path; ///< the dataset
+      HDF5Type m_type; ///< type of the objects
+      size_t m_size; ///< number of objects
+      size_t m_object_size; ///< size of an object in bytes
+      size_t m_block_size; ///< number of objects per block
+      size_t m_n_blocks; ///< maximum number of blocks read ahead
+
+      boost::mutex m_mutex; ///< protects the members below
+      boost::condition_variable m_cond; ///< a block was read or consumed
+      std::deque<std::vector<char> > m_blocks; ///< blocks read ahead
+      std::deque<size_t> m_counts; ///< number of objects of each block
+      bool m_done; ///< all the blocks were read (or an error occurred)
+      bool m_stop; ///< asks the background thread to stop
+      std::string m_error; ///< error of the background thread
+      std::vector<char> m_current; ///< block being copied to the caller
+
+      boost::thread m_thread; ///< the background thread
+  };
+
+}}
+
+#endif /* BOB_IO_HDF5PREFETCHER_H */
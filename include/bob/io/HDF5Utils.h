@@ -57,10 +57,13 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
 
       /**
        * Creates a new HDF5 file. Optionally set the userblock size (multiple
-       * of 2 number of bytes).
+       * of 2 number of bytes), and the size in bytes and number of slots of
+       * the raw data chunk cache of each dataset (0 keeps the HDF5
+       * defaults).
        */
       File(const boost::filesystem::path& path, unsigned int flags,
-          size_t userblock_size=0);
+          size_t userblock_size=0, size_t cache_size=0,
+          size_t cache_slots=0);
 
       /**
        * Copies a file by creating a copy of each of its groups
@@ -128,6 +131,20 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
        */
       bool writeable() const;
 
+      /**
+       * Tells if the bytes of new compressed datasets are shuffled before
+       * compression (off by default)
+       */
+      bool shuffle() const { return m_shuffle; }
+      void shuffle(bool v) { m_shuffle = v; }
+
+      /**
+       * Tells if new compressed datasets use the (fast) LZF filter instead of
+       * gzip, when the LZF filter is available (off by default)
+       */
+      bool fast_compression() const { return m_fast_compression; }
+      void fast_compression(bool v) { m_fast_compression = v; }
+
     private: //representation
 
       const boost::filesystem::path m_path; ///< path to the file
@@ -135,6 +152,8 @@ namespace bob { namespace io { namespace detail { namespace hdf5 {
       boost::shared_ptr<hid_t> m_fcpl; ///< file creation property lists
       boost::shared_ptr<hid_t> m_id; ///< the HDF5 id attributed to this file.
       boost::shared_ptr<RootGroup> m_root;
+      bool m_shuffle; ///< shuffle filter for new compressed datasets
+      bool m_fast_compression; ///< LZF filter for new compressed datasets
   };
 
 }}}}
@@ -23,7 +23,9 @@
 #ifndef BOB_IO_TENSORFILE_H
 #define BOB_IO_TENSORFILE_H
 
+#include <algorithm>
 #include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
 #include <stdexcept>
 
 #include <bob/core/blitz_array.h>
@@ -36,10 +38,13 @@ namespace bob { namespace io {
    * containing blitz arrays.
    */
   enum _TensorFileFlag {
-    _unset   = 0,
-    _append  = 1L << 0,
-    _in      = 1L << 3,
-    _out     = 1L << 4
+    _unset      = 0,
+    _append     = 1L << 0,
+    _in         = 1L << 3,
+    _out        = 1L << 4,
+    _mapped     = 1L << 5,
+    _sequential = 1L << 6,
+    _random     = 1L << 7
   };
 
   /**
@@ -58,6 +63,20 @@ namespace bob { namespace io {
       static const openmode in      = _in;
       static const openmode out     = _out;
 
+      /**
+       * Maps the file in memory instead of reading it through a stream. Only
+       * valid together with `in'. See view().
+       */
+      static const openmode mapped  = _mapped;
+
+      /**
+       * Access hints for mapped files: the arrays will be read in order
+       * (pages are read ahead and dropped once read) or at random positions
+       * (no read ahead). See advise().
+       */
+      static const openmode sequential = _sequential;
+      static const openmode random  = _random;
+
       /**
        * Constructor
        */
@@ -110,6 +129,38 @@ namespace bob { namespace io {
        */
       void peek(bob::core::array::typeinfo& info) const;
 
+      /**
+       * Tells if the file was opened with the `mapped' flag
+       */
+      inline bool isMapped() const { return m_mapping.get() != 0; }
+
+      /**
+       * Tells if the arrays of this file can be viewed in place, that is if
+       * the file is mapped, was written with the byte order of this machine,
+       * has aligned elements (64-bit elements are not, as the header has 28
+       * bytes) and stores its arrays with the same layout in memory as
+       * C-ordered blitz arrays (the file is column-major, so at most one
+       * dimension may be larger than 1). Otherwise, view() and view_all()
+       * copy the data.
+       */
+      bool isViewable() const;
+
+      /**
+       * Gives the kernel a hint on how the mapped file will be accessed:
+       * `sequential', `random' or none of them (default read ahead). Has no
+       * effect if the file is not mapped.
+       */
+      void advise(openmode hint);
+
+      /**
+       * Returns a read-only bob::core::array::interface referring to the
+       * mapped pages of the array at the given position. The interface keeps
+       * the mapping alive, even after this file is closed.
+       *
+       * @warning An exception is thrown if !isViewable()
+       */
+      boost::shared_ptr<bob::core::array::interface> view(size_t index) const;
+
       /**
        * Gets the number of samples/arrays written so far
        *
@@ -175,6 +226,17 @@ namespace bob { namespace io {
        */
       void initHeader(const bob::core::array::typeinfo& info);
 
+      /**
+       * Maps the whole file in memory
+       */
+      void map(const std::string& filename);
+
+      /**
+       * Returns the address of the array at the given position in the mapped
+       * file
+       */
+      void* mappedArray(size_t index) const;
+
     public:
 
       /********************************************************************
@@ -214,6 +276,58 @@ namespace bob { namespace io {
         return bob::core::array::cast<T,D>(buf);
       }
 
+      /**
+       * Returns the array at the given position without copying it, if
+       * isViewable() and T is the element type of the file. Otherwise, this
+       * is the same as read<T,D>(index).
+       *
+       * @warning The returned view refers to the mapped pages: it is only
+       * valid until this file is closed or destroyed. Modifications of the
+       * view are private to this process and are never written to the file.
+       */
+      template <typename T, int D> blitz::Array<T,D> view(size_t index) {
+        bob::core::array::typeinfo info;
+        peek(info);
+        if (!isViewable() || info.dtype != bob::core::array::getElementType<T>()
+            || D != (int)info.nd)
+          return read<T,D>(index);
+        blitz::TinyVector<int,D> shape;
+        for (int k=0; k<D; ++k) shape(k) = info.shape[k];
+        return blitz::Array<T,D>(static_cast<T*>(mappedArray(index)), shape,
+            blitz::neverDeleteData);
+      }
+
+      /**
+       * Returns all the arrays of the file in a single array, whose first
+       * dimension indexes the arrays (D has to be the number of dimensions of
+       * the arrays + 1). Like view(index), no data is copied if isViewable()
+       * and T is the element type of the file, and the same warning applies.
+       */
+      template <typename T, int D> blitz::Array<T,D> view_all() {
+        bob::core::array::typeinfo info;
+        peek(info);
+        if (D != (int)info.nd + 1) {
+          boost::format m("cannot view the arrays of type '%s' of tensor file as a single array with %d dimensions");
+          m % info.str() % D;
+          throw std::runtime_error(m.str());
+        }
+        blitz::TinyVector<int,D> shape;
+        shape(0) = size();
+        for (int k=1; k<D; ++k) shape(k) = info.shape[k-1];
+        if (size() && isViewable() &&
+            info.dtype == bob::core::array::getElementType<T>())
+          return blitz::Array<T,D>(static_cast<T*>(mappedArray(0)), shape,
+              blitz::neverDeleteData);
+        blitz::Array<T,D> retval(shape);
+        const size_t n_elements = info.size();
+        for (size_t i=0; i<size(); ++i) {
+          blitz::Array<T,D-1> tmp = read<T,D-1>(i);
+          std::copy(tmp.data(), tmp.data() + n_elements,
+              retval.data() + i*n_elements);
+        }
+        return retval;
+      }
+
     private: //representation
 
       bool m_header_init;
@@ -223,6 +337,8 @@ namespace bob { namespace io {
       detail::TensorFileHeader m_header;
       openmode m_openmode;
       boost::shared_ptr<void> m_buffer;
+      boost::shared_ptr<void> m_mapping; ///< the mapped file (if mapped)
+      size_t m_mapped_size; ///< size of the mapping, in bytes
   };
 
   inline _TensorFileFlag operator&(_TensorFileFlag a, _TensorFileFlag b) {
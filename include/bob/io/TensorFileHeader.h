@@ -72,7 +72,8 @@ namespace bob { namespace io {
       void write(std::ostream& str) const;
 
       /**
-       * Reads the header from an input stream
+       * Reads the header from an input stream. Headers written on machines
+       * of the other byte order are detected (and m_swap is set).
        */
       void read(std::istream& str);
 
@@ -97,6 +98,7 @@ namespace bob { namespace io {
 
       //representation
       TensorType m_tensor_type; ///< array element type 
+      bool m_swap; ///< file was written with the other byte order
       bob::core::array::typeinfo m_type; ///< the type information
       size_t m_n_samples; ///< total number of arrays in the file
       size_t m_tensor_size; ///< the number of dimensions in each array
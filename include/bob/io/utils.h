@@ -40,6 +40,25 @@ namespace bob { namespace io {
   boost::shared_ptr<File> open (const std::string& filename, char mode, 
       const std::string& pretend_extension);
 
+  /**
+   * Opens a file with the HDF5 codec (whatever its extension), with options
+   * for the arrays which are appended to a new file. The codec that open()
+   * uses for the HDF5 extensions stores them in chunks of about 4 KiB, and
+   * writes each of them at once.
+   *
+   * @param chunk_size The target size of the chunks in bytes, each chunk
+   * holding as many arrays as fit (at least one)
+   * @param buffer_size The size in bytes of a write-behind buffer for the
+   * appended arrays, which are then written by blocks with a single
+   * extension of the dataset. The buffer is written before any read, by
+   * File::flush() (which raises the errors of the writing) and when the
+   * file is destroyed (which can only log them). Other handles on the file
+   * do not see the buffered arrays. The value of zero (the default) writes
+   * each array at once.
+   */
+  boost::shared_ptr<File> open_hdf5 (const std::string& filename, char mode,
+      size_t chunk_size, size_t buffer_size=0);
+
   /**
    * Peeks the file and returns the typeinfo for reading individual frames (or
    * samples) from the file.
@@ -226,8 +226,16 @@ class DCTFeatures
     double m_norm_epsilon;
 
     void setCheckSqrtNDctCoefs();
-    void normalizeBlock(const blitz::Array<double,2>& src) const;
-    void extractRowDCTCoefs(blitz::Array<double,1>& coefs) const;
+    void normalizeBlock(const blitz::Array<double,2>& src,
+      blitz::Array<double,2>& dst) const;
+    /**
+      * @brief Copies (and normalizes if required) the blocks of src into
+      *   m_cache_blocks, and computes all their DCTs at once (with a single
+      *   batched DCT2D) into m_cache_dct_blocks
+      */
+    void computeBlocksDCT(const blitz::Array<double,2>& src) const;
+    void extractRowDCTCoefs(const blitz::Array<double,2>& dct_block,
+      blitz::Array<double,1>& coefs) const;
 
     /**
       * Working arrays/variables in cache
@@ -236,8 +244,8 @@ class DCTFeatures
     void resetCacheBlock() const;
     void resetCacheDct() const;
 
-    mutable blitz::Array<double,2> m_cache_block1;
-    mutable blitz::Array<double,2> m_cache_block2;
+    mutable blitz::Array<double,3> m_cache_blocks;
+    mutable blitz::Array<double,3> m_cache_dct_blocks;
     mutable blitz::Array<double,1> m_cache_dct_full;
     mutable blitz::Array<double,1> m_cache_dct1;
     mutable blitz::Array<double,1> m_cache_dct2;
@@ -31,6 +31,7 @@
 
 #include "bob/io/HDF5File.h"
 #include "bob/sp/FFT2D.h"
+#include "bob/sp/RFFT2D.h"
 
 namespace bob {
 
@@ -140,6 +141,14 @@ namespace bob {
           blitz::Array<std::complex<double>,3>& trafo_image
         );
 
+        //! \brief performs Gabor wavelet transform of a real image and returns
+        //! vector of complex images (the forward FFT only computes half of
+        //! the Hermitian spectrum of the image)
+        void performGWT(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<std::complex<double>,3>& trafo_image
+        );
+
         //! \brief performs Gabor wavelet transform and creates 4D image
         //! (absolute part and phase part)
         void computeJetImage(
@@ -148,6 +157,14 @@ namespace bob {
           bool do_normalize = true
         );
 
+        //! \brief performs Gabor wavelet transform of a real image and
+        //! creates 4D image (absolute part and phase part)
+        void computeJetImage(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<double,4>& jet_image,
+          bool do_normalize = true
+        );
+
         //! \brief performs Gabor wavelet transform and creates 3D image
         //! (absolute parts of the responses only)
         void computeJetImage(
@@ -156,6 +173,14 @@ namespace bob {
           bool do_normalize = true
         );
 
+        //! \brief performs Gabor wavelet transform of a real image and
+        //! creates 3D image (absolute parts of the responses only)
+        void computeJetImage(
+          const blitz::Array<double,2>& gray_image,
+          blitz::Array<double,3>& jet_image,
+          bool do_normalize = true
+        );
+
         //! \brief saves the parameters of this Gabor wavelet family to file
         void save(bob::io::HDF5File& file) const;
 
@@ -166,6 +191,16 @@ namespace bob {
 
         void computeKernelFrequencies();
 
+        //! computes the spectrum of a complex image into m_frequency_image
+        void computeFrequencyImage(const blitz::Array<std::complex<double>,2>& gray_image);
+        //! computes the spectrum of a real image into m_frequency_image
+        void computeFrequencyImage(const blitz::Array<double,2>& gray_image);
+
+        //! the transforms of the image in m_frequency_image
+        void performGWT_(blitz::Array<std::complex<double>,3>& trafo_image);
+        void computeJetImage_(blitz::Array<double,4>& jet_image, bool do_normalize);
+        void computeJetImage_(blitz::Array<double,3>& jet_image, bool do_normalize);
+
         double m_sigma;
         double m_pow_of_k;
         double m_k_max;
@@ -177,8 +212,9 @@ namespace bob {
 
         bob::sp::FFT2D m_fft;
         bob::sp::IFFT2D m_ifft;
+        bob::sp::RFFT2D m_rfft;
 
-        blitz::Array<std::complex<double>,2> m_temp_array, m_frequency_image;
+        blitz::Array<std::complex<double>,2> m_temp_array, m_frequency_image, m_half_frequency_image;
 
         //! The number of scales (levels, frequencies) of this family
         unsigned m_number_of_scales;
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <boost/shared_ptr.hpp>
+#include <blitz/array.h>
 #include "bob/io/HDF5File.h"
 
 namespace bob { namespace machine {
@@ -57,6 +58,23 @@ namespace bob { namespace machine {
        */
       virtual double f_prime_from_f (double a) const =0;
 
+      /**
+       * Computes the activated values of a batch of inputs, in place. The
+       * default implementation calls f() on each element, and is overridden
+       * by the activation functions below with a loop that does not involve
+       * any virtual call.
+       */
+      virtual void f_batch (blitz::Array<double,2>& z) const;
+
+      /**
+       * Multiplies each element of x by the derivative of the activation,
+       * given the corresponding activated value of a (the output of
+       * f_batch()), as required by the back-propagation of errors. The
+       * default implementation calls f_prime_from_f() on each element.
+       */
+      virtual void mult_f_prime_from_f_batch (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& x) const;
+
       /**
        * Saves itself to an HDF5File
        */
@@ -109,6 +127,9 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_batch (blitz::Array<double,2>& z) const;
+      virtual void mult_f_prime_from_f_batch (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& x) const;
       virtual void save(bob::io::HDF5File&) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -128,6 +149,9 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_batch (blitz::Array<double,2>& z) const;
+      virtual void mult_f_prime_from_f_batch (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& x) const;
       double C() const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
@@ -150,6 +174,9 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_batch (blitz::Array<double,2>& z) const;
+      virtual void mult_f_prime_from_f_batch (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& x) const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
@@ -169,6 +196,9 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_batch (blitz::Array<double,2>& z) const;
+      virtual void mult_f_prime_from_f_batch (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& x) const;
       double C() const;
       double M() const;
       virtual void save(bob::io::HDF5File& f) const;
@@ -193,6 +223,9 @@ namespace bob { namespace machine {
       virtual double f (double z) const;
       virtual double f_prime (double z) const;
       virtual double f_prime_from_f (double a) const;
+      virtual void f_batch (blitz::Array<double,2>& z) const;
+      virtual void mult_f_prime_from_f_batch (const blitz::Array<double,2>& a,
+          blitz::Array<double,2>& x) const;
       virtual void save(bob::io::HDF5File& f) const;
       virtual void load(bob::io::HDF5File&);
       virtual std::string unique_identifier() const;
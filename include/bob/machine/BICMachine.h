@@ -71,7 +71,7 @@ namespace bob { namespace machine {
       //! Similarity operator
       bool is_similar_to(const BICMachine& other, const double r_epsilon=1e-5, const double a_epsilon=1e-8) const;
 
-      //! computes the BIC probability score for the given input difference vector
+      //! computes the BIC probability score for the given input difference vector (the working arrays belong to the calling thread)
       void forward_(const blitz::Array<double,1>& input, double& output) const;
 
       //! performs some checks before calling the forward_ method
@@ -97,9 +97,6 @@ namespace bob { namespace machine {
 
     private:
 
-      //! initializes internal data storages for the given class
-      void initialize(bool clazz, int input_length, int projected_length);
-
       //! project data?
       bool m_project_data;
 
@@ -116,9 +113,6 @@ namespace bob { namespace machine {
       blitz::Array<double, 2> m_Phi_I, m_Phi_E;
       //! averaged eigenvalues to calculate DFFS
       double m_rho_I, m_rho_E;
-      //! temporary storage
-      mutable blitz::Array<double, 1> m_diff_I, m_diff_E;
-      mutable blitz::Array<double, 1> m_proj_I, m_proj_E;
 
   };
 
@@ -39,9 +39,98 @@ namespace bob { namespace machine {
  * @{
  */
 
+/**
+ * @brief Scratch space used by a GMMMachine to compute log likelihoods and
+ * to accumulate statistics.
+ * @details The GMMMachine methods taking a GMMWorkspace as argument do not
+ * write to any member of the machine. A single GMMMachine can hence be used
+ * concurrently by several threads, as long as each thread has its own
+ * GMMWorkspace (and GMMStats).
+ */
+class GMMWorkspace
+{
+  public:
+    /**
+     * Default constructor
+     */
+    GMMWorkspace();
+
+    /**
+     * Constructor
+     * @param[in] n_gaussians  The number of Gaussian components
+     * @param[in] n_inputs     The feature dimensionality
+     */
+    GMMWorkspace(const size_t n_gaussians, const size_t n_inputs);
+
+    /**
+     * Copy constructor
+     * (allocates new scratch arrays of the same size, which are not shared
+     * with the other workspace)
+     */
+    GMMWorkspace(const GMMWorkspace& other);
+
+    /**
+     * Assignment
+     * (allocates new scratch arrays of the same size)
+     */
+    GMMWorkspace& operator=(const GMMWorkspace& other);
+
+    /**
+     * Allocates the scratch arrays
+     * @param[in] n_gaussians  The number of Gaussian components
+     * @param[in] n_inputs     The feature dimensionality
+     */
+    void resize(const size_t n_gaussians, const size_t n_inputs);
+
+    /**
+     * For each Gaussian, i: log(weight_i*p(x|Gaussian_i))
+     */
+    blitz::Array<double,1> log_weighted_gaussian_likelihoods;
+
+    /**
+     * For each Gaussian, i: the responsibility P(Gaussian_i|x)
+     */
+    blitz::Array<double,1> P;
+
+    /**
+     * For each Gaussian, i: the responsibility times the sample
+     */
+    blitz::Array<double,2> Px;
+
+    /**
+     * Packed parameters of the Gaussian components: means, precisions
+     * (inverse variances) and log(weight_i) - 0.5*g_norm_i
+     */
+    blitz::Array<double,2> packed_means;
+    blitz::Array<double,2> packed_precisions;
+    blitz::Array<double,1> packed_constants;
+
+    /**
+     * Block of samples and their weighted log likelihoods
+     */
+    blitz::Array<double,2> block_x;
+    blitz::Array<double,2> block_log_likelihoods;
+
+    /**
+     * Indices of the components selected by a GMMSelector
+     */
+    blitz::Array<int,1> selection;
+
+    /**
+     * Log likelihoods of the clusters of a GMMSelector, and cluster indices
+     * (allocated on first use)
+     */
+    blitz::Array<double,1> cluster_log_likelihoods;
+    blitz::Array<int,1> cluster_selection;
+};
+
+class GMMSelector;
+
 /**
  * @brief This class implements a multivariate diagonal Gaussian distribution.
  * @details See Section 2.3.9 of Bishop, "Pattern recognition and machine learning", 2006
+ * The methods which do not take a GMMWorkspace as argument rely on an
+ * internal one, and are therefore not thread-safe.
  */
 class GMMMachine: public Machine<blitz::Array<double,1>, double>
 {
@@ -237,6 +326,64 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     double logLikelihood_(const blitz::Array<double, 1> &x) const;
 
+    /**
+     * Output the log likelihood of the sample, x, i.e. log(p(x|GMM))
+     * @param[in]  x         The sample
+     * @param[in]  workspace The scratch space to use
+     * Dimensions of the parameters are checked
+     */
+    double logLikelihood(const blitz::Array<double, 1> &x, GMMWorkspace &workspace) const;
+
+    /**
+     * Output the log likelihood of the sample, x, i.e. log(p(x|GMM))
+     * @param[in]  x         The sample
+     * @param[in]  workspace The scratch space to use
+     * @warning Dimensions of the parameters are not checked
+     */
+    double logLikelihood_(const blitz::Array<double, 1> &x, GMMWorkspace &workspace) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x,
+     * i.e. log(p(x_t|GMMMachine)). The samples are scored by blocks against
+     * a packed (structure-of-arrays) copy of the Gaussian components.
+     * @param[in]  x      The samples (one sample per row)
+     * @param[out] output For each sample t, log(p(x_t|GMMMachine))
+     * Dimensions of the parameters are checked
+     */
+    void logLikelihood(const blitz::Array<double,2> &x, blitz::Array<double,1> &output) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x,
+     * i.e. log(p(x_t|GMMMachine)). The samples are scored by blocks against
+     * a packed (structure-of-arrays) copy of the Gaussian components.
+     * @param[in]  x      The samples (one sample per row)
+     * @param[out] output For each sample t, log(p(x_t|GMMMachine))
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihood_(const blitz::Array<double,2> &x, blitz::Array<double,1> &output) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x,
+     * i.e. log(p(x_t|GMMMachine)).
+     * @param[in]  x         The samples (one sample per row)
+     * @param[out] output    For each sample t, log(p(x_t|GMMMachine))
+     * @param[in]  workspace The scratch space to use
+     * Dimensions of the parameters are checked
+     */
+    void logLikelihood(const blitz::Array<double,2> &x, blitz::Array<double,1> &output,
+      GMMWorkspace &workspace) const;
+
+    /**
+     * Output the log likelihood of each sample (row) of x,
+     * i.e. log(p(x_t|GMMMachine)).
+     * @param[in]  x         The samples (one sample per row)
+     * @param[out] output    For each sample t, log(p(x_t|GMMMachine))
+     * @param[in]  workspace The scratch space to use
+     * @warning Dimensions of the parameters are not checked
+     */
+    void logLikelihood_(const blitz::Array<double,2> &x, blitz::Array<double,1> &output,
+      GMMWorkspace &workspace) const;
+
     /**
      * Output the log likelihood of the sample, x
      * (overrides Machine::forward)
@@ -283,6 +430,98 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     void accStatistics_(const blitz::Array<double,1> &x, GMMStats &stats) const;
 
+    /**
+     * Accumulates the GMM statistics over a set of samples.
+     * @param[in]  input     The samples (one sample per row)
+     * @param[out] stats     The accumulated statistics
+     * @param[in]  workspace The scratch space to use
+     * Dimensions of the parameters are checked
+     */
+    void accStatistics(const blitz::Array<double,2>& input, GMMStats &stats,
+      GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulates the GMM statistics over a set of samples.
+     * @param[in]  input     The samples (one sample per row)
+     * @param[out] stats     The accumulated statistics
+     * @param[in]  workspace The scratch space to use
+     * @warning Dimensions of the parameters are not checked
+     */
+    void accStatistics_(const blitz::Array<double,2>& input, GMMStats &stats,
+      GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulate the GMM statistics for this sample.
+     * @param[in]  x         The current sample
+     * @param[out] stats     The accumulated statistics
+     * @param[in]  workspace The scratch space to use
+     * Dimensions of the parameters are checked
+     */
+    void accStatistics(const blitz::Array<double,1> &x, GMMStats &stats,
+      GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulate the GMM statistics for this sample.
+     * @param[in]  x         The current sample
+     * @param[out] stats     The accumulated statistics
+     * @param[in]  workspace The scratch space to use
+     * @warning Dimensions of the parameters are not checked
+     */
+    void accStatistics_(const blitz::Array<double,1> &x, GMMStats &stats,
+      GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulates approximate GMM statistics over a set of samples, using
+     * only the components chosen by the selector for each sample (the other
+     * components get a zero responsibility).
+     * @param[in]  input     The samples (one sample per row)
+     * @param[out] stats     The accumulated statistics
+     * @param[in]  selector  The Gaussian selector
+     * @param[in]  workspace The scratch space to use
+     * Dimensions of the parameters are checked
+     */
+    void accStatistics(const blitz::Array<double,2>& input, GMMStats &stats,
+      const GMMSelector &selector, GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulates approximate GMM statistics over a set of samples, using
+     * only the components chosen by the selector for each sample.
+     * @warning Dimensions of the parameters are not checked
+     */
+    void accStatistics_(const blitz::Array<double,2>& input, GMMStats &stats,
+      const GMMSelector &selector, GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulates approximate GMM statistics for this sample, using only
+     * the components chosen by the selector. The log likelihood added to
+     * the statistics is the one of the selected components.
+     * @param[in]  x         The current sample
+     * @param[out] stats     The accumulated statistics
+     * @param[in]  selector  The Gaussian selector
+     * @param[in]  workspace The scratch space to use
+     * Dimensions of the parameters are checked
+     */
+    void accStatistics(const blitz::Array<double,1> &x, GMMStats &stats,
+      const GMMSelector &selector, GMMWorkspace &workspace) const;
+
+    /**
+     * Accumulates approximate GMM statistics for this sample, using only
+     * the components chosen by the selector.
+     * @warning Dimensions of the parameters are not checked
+     */
+    void accStatistics_(const blitz::Array<double,1> &x, GMMStats &stats,
+      const GMMSelector &selector, GMMWorkspace &workspace) const;
+
+    /**
+     * Output log(weight_i*p(x|Gaussian_i)) for a single Gaussian component
+     * @param[in] i The index of the Gaussian component
+     * @param[in] x The sample
+     * @warning Dimensions of the parameters are not checked
+     */
+    double logWeightedGaussianLikelihood_(const size_t i,
+        const blitz::Array<double,1> &x) const
+    { return m_cache_log_weights(i) + m_gaussians[i]->logLikelihood_(x); }
+
     /**
      * Get a pointer to a particular Gaussian component
      * @param[in] i The index of the Gaussian component
@@ -361,6 +600,11 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      */
     void initCache() const;
 
+    /**
+     * Check that the workspace has been allocated for this machine
+     */
+    void checkWorkspace(const GMMWorkspace& workspace) const;
+
     /**
      * Accumulate the GMM statistics for this sample.
      * Called by accStatistics() and accStatistics_()
@@ -368,17 +612,28 @@ class GMMMachine: public Machine<blitz::Array<double,1>, double>
      * @param[in]  x     The current sample
      * @param[out] stats The accumulated statistics
      * @param[in]  log_likelihood  The current log_likelihood
+     * @param[in]  workspace The scratch space, which contains the weighted
+     *   Gaussian log likelihoods of the current sample
      * @warning Dimensions of the parameters are not checked
      */
     void accStatisticsInternal(const blitz::Array<double,1> &x,
-      GMMStats &stats, const double log_likelihood) const;
+      GMMStats &stats, const double log_likelihood,
+      GMMWorkspace &workspace) const;
+
+    /**
+     * Copy the parameters of the Gaussian components into the packed
+     * arrays of the workspace used by the block log-likelihood computation:
+     * one row of means and one row of precisions (inverse variances) per
+     * component, and log(weight_i) - 0.5*g_norm_i as constant term.
+     */
+    void packParameters(GMMWorkspace &workspace) const;
 
 
-    /// Some cache arrays to avoid re-allocation when computing log-likelihoods
+    /// Cache of the logarithm of the weights
     mutable blitz::Array<double,1> m_cache_log_weights;
-    mutable blitz::Array<double,1> m_cache_log_weighted_gaussian_likelihoods;
-    mutable blitz::Array<double,1> m_cache_P;
-    mutable blitz::Array<double,2> m_cache_Px;
+
+    /// Workspace used by the methods not taking one as argument
+    mutable GMMWorkspace m_cache_workspace;
 
     mutable blitz::Array<double,1> m_cache_mean_supervector;
     mutable blitz::Array<double,1> m_cache_variance_supervector;
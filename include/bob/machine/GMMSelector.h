@@ -0,0 +1,179 @@
+/**
+ * @file bob/machine/GMMSelector.h
+ * @date Sat Oct 17 14:05:12 2026 +0200
+ *
+ * @brief Selection of the most likely Gaussian components of a GMMMachine
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_MACHINE_GMMSELECTOR_H
+#define BOB_MACHINE_GMMSELECTOR_H
+
+#include <bob/machine/GMMMachine.h>
+#include <blitz/array.h>
+#include <vector>
+
+namespace bob { namespace machine {
+/**
+ * @ingroup MACHINE
+ * @{
+ */
+
+/**
+ * @brief This class selects, for a given sample, the n_top Gaussian
+ * components of a GMMMachine with the highest weighted likelihoods
+ * (Gaussian selection).
+ * @details By default, all the components are evaluated to find the n_top
+ * best ones. Alternatively, the components can be grouped into clusters,
+ * each cluster being represented by a single Gaussian which merges its
+ * members. For a given sample, the n_best_clusters clusters with the highest
+ * likelihoods are first found, and only the members of these clusters are
+ * then evaluated. With a few tens of clusters, this pre-screening avoids the
+ * evaluation of most components of a large GMMMachine (e.g. a UBM).
+ */
+class GMMSelector
+{
+  public:
+    /**
+     * Default constructor (exhaustive selection)
+     * @param[in] n_top The number of components to select
+     */
+    GMMSelector(const size_t n_top=5);
+
+    /**
+     * Constructor (clustered selection)
+     * @param[in] machine         The GMMMachine whose components are selected
+     * @param[in] n_top           The number of components to select
+     * @param[in] n_clusters      The number of clusters of components
+     * @param[in] n_best_clusters The number of clusters whose members are
+     *   evaluated for a given sample
+     */
+    GMMSelector(const GMMMachine& machine, const size_t n_top,
+      const size_t n_clusters, const size_t n_best_clusters);
+
+    /**
+     * Copy constructor
+     */
+    GMMSelector(const GMMSelector& other);
+
+    /**
+     * Destructor
+     */
+    virtual ~GMMSelector();
+
+    /**
+     * Assignment
+     */
+    GMMSelector& operator=(const GMMSelector& other);
+
+    /**
+     * Groups the components of the given machine into n_clusters clusters,
+     * using k-means over the means of the components (normalized by the
+     * average variances). The Gaussian representing a cluster has the
+     * total weight, mean and variance of its members.
+     * @warning The clusters should be rebuilt if the parameters of the
+     *   machine are significantly modified.
+     */
+    void cluster(const GMMMachine& machine, const size_t n_clusters,
+      const size_t n_best_clusters);
+
+    /**
+     * Removes the clusters, all the components being evaluated
+     */
+    void unsetClusters();
+
+    /**
+     * Returns the number of components to select
+     */
+    size_t getNTop() const
+    { return m_n_top; }
+
+    /**
+     * Sets the number of components to select
+     */
+    void setNTop(const size_t n_top);
+
+    /**
+     * Returns the number of clusters (0 if all the components are evaluated)
+     */
+    size_t getNClusters() const
+    { return m_members.size(); }
+
+    /**
+     * Returns the number of clusters whose members are evaluated
+     */
+    size_t getNBestClusters() const
+    { return m_n_best_clusters; }
+
+    /**
+     * Returns the cluster of each component
+     */
+    const blitz::Array<int,1>& getClusterIndices() const
+    { return m_cluster_indices; }
+
+    /**
+     * Returns the machine whose Gaussians represent the clusters
+     */
+    const GMMMachine& getClusterMachine() const
+    { return m_cluster_machine; }
+
+    /**
+     * Selects the best components of the machine for the sample x.
+     * @param[in]  machine   The GMMMachine
+     * @param[in]  x         The sample
+     * @param[out] workspace The workspace: workspace.selection(0..n-1)
+     *   contains the indices of the selected components, in decreasing order
+     *   of likelihood, and workspace.log_weighted_gaussian_likelihoods
+     *   contains log(weight_i*p(x|Gaussian_i)) for these components.
+     * @return The number of selected components n (at most n_top)
+     * @warning Dimensions of the parameters are not checked
+     */
+    size_t select_(const GMMMachine& machine, const blitz::Array<double,1>& x,
+      GMMWorkspace& workspace) const;
+
+  private:
+    /**
+     * The number of components to select
+     */
+    size_t m_n_top;
+
+    /**
+     * The number of clusters whose members are evaluated
+     */
+    size_t m_n_best_clusters;
+
+    /**
+     * The Gaussians representing the clusters
+     */
+    GMMMachine m_cluster_machine;
+
+    /**
+     * The cluster of each component
+     */
+    blitz::Array<int,1> m_cluster_indices;
+
+    /**
+     * The components of each cluster
+     */
+    std::vector<std::vector<int> > m_members;
+};
+
+/**
+ * @}
+ */
+}}
+
+#endif
@@ -174,6 +174,14 @@ class Gaussian: public Machine<blitz::Array<double,1>, double>
      */
     void applyVarianceThresholds();
 
+    /**
+     * Get the normalization constant g_norm of the log likelihood,
+     * i.e. n_inputs*log(2*pi) + log(det(variance))
+     * @see preComputeConstants()
+     */
+    inline double getGNorm() const
+    { return m_g_norm; }
+
     /**
      * Output the log likelihood of the sample, x
      * @param x The data sample (feature vector)
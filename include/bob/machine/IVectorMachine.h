@@ -26,6 +26,7 @@
 #include "GMMMachine.h"
 #include "GMMStats.h"
 #include <bob/io/HDF5File.h>
+#include <vector>
 
 namespace bob { namespace machine {
 /**
@@ -229,6 +230,25 @@ class IVectorMachine: public bob::machine::Machine<bob::machine::GMMStats, blitz
      */
     void computeTtSigmaInvFnorm(const bob::machine::GMMStats& input, blitz::Array<double,1>& output) const;
 
+    /**
+     * @brief Computes \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$
+     * for the GMM statistics input[begin], ..., input[begin+N-1], N being
+     * the number of rows of output. The rt x rt matrices are flattened in
+     * the rows of output, and are computed by a single matrix product.
+     * @warning No check is perform
+     */
+    void computeIdTtSigmaInvT(const std::vector<bob::machine::GMMStats>& input,
+      const size_t begin, blitz::Array<double,2>& output) const;
+
+    /**
+     * @brief Computes \f$T^{T} \Sigma^{-1} \sum_{c=1}^{C} (F_c - N_c ubmmean_{c})\f$
+     * for the GMM statistics input[begin], ..., input[begin+N-1], N being
+     * the number of rows of output, by a single matrix product.
+     * @warning No check is perform
+     */
+    void computeTtSigmaInvFnorm(const std::vector<bob::machine::GMMStats>& input,
+      const size_t begin, blitz::Array<double,2>& output) const;
+
     /**
      * @brief Extracts an ivector from the input GMM statistics
      *
@@ -246,6 +266,31 @@ class IVectorMachine: public bob::machine::Machine<bob::machine::GMMStats, blitz
      */
     void forward_(const bob::machine::GMMStats& input, blitz::Array<double,1>& output) const;
 
+    /**
+     * @brief Extracts the ivectors of several GMM statistics at once.
+     * The first order statistics of the utterances are stacked into a
+     * matrix projected by a single product, and the precision matrices
+     * \f$(Id + \sum_{c=1}^{C} N_{i,j,c} T^{T} \Sigma_{c}^{-1} T)\f$ are
+     * obtained by a single product of the zeroth order statistics with the
+     * flattened \f$T_{c}^{T} \Sigma_{c}^{-1} T_{c}\f$ matrices. The linear
+     * systems are then solved (Cholesky decomposition) in parallel.
+     *
+     * @param input GMM statistics of the utterances
+     * @param output I-vectors computed by the machine, one per row
+     * @param n_threads Number of threads used to solve the linear systems
+     *   (0 for the number of hardware threads)
+     */
+    void forward(const std::vector<bob::machine::GMMStats>& input,
+      blitz::Array<double,2>& output, const size_t n_threads=1) const;
+
+    /**
+     * @brief Extracts the ivectors of several GMM statistics at once
+     * @see forward()
+     * @warning Inputs are NOT checked
+     */
+    void forward_(const std::vector<bob::machine::GMMStats>& input,
+      blitz::Array<double,2>& output, const size_t n_threads=1) const;
+
   protected:
     /**
      * @brief Apply the variance flooring thresholds.
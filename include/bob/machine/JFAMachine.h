@@ -24,6 +24,7 @@
 #define BOB_MACHINE_FABASE_H
 
 #include <stdexcept>
+#include <vector>
 
 #include "Machine.h"
 #include "GMMMachine.h"
@@ -241,6 +242,49 @@ class FABase
      */
     void estimateX(const bob::machine::GMMStats& gmm_stats, blitz::Array<double,1>& x) const;
 
+    /**
+     * @brief Estimates the session offsets U.x of several probes at once
+     * (considering the LPT assumption, see estimateX()), by blocks of
+     * probes which are split across threads. Ux(p,:) is the offset of the
+     * probe p, which can be cached and given to computeScores().
+     * @param n_threads The number of threads (0 for the number of hardware
+     * threads). The offsets do not depend on it.
+     * @warning Only local working arrays are used, such that several
+     * threads can use the same FABase.
+     */
+    void estimateUx(const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      blitz::Array<double,2>& Ux, const size_t n_threads=1) const;
+
+    /**
+     * @brief Computes the linear scores of several models against several
+     * probes at once. scores(m,p) is the score that the forward() method of
+     * a machine with the mean supervector models(m,:) gives to the probe p.
+     * The offset U.x of each probe is estimated once (by blocks of probes,
+     * which are split across threads), and the scores of a block are
+     * computed with a single matrix product (see linearScoring()).
+     * @param models The mean supervectors m+V.y+D.z of the models (one per
+     * row)
+     * @param probes The statistics of the probes
+     * @param scores The scores (number of models x number of probes)
+     * @param n_threads The number of threads (0 for the number of hardware
+     * threads). The scores do not depend on it.
+     * @warning Only local working arrays are used, such that several
+     * threads can use the same FABase.
+     */
+    void computeScores(const blitz::Array<double,2>& models,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      blitz::Array<double,2>& scores, const size_t n_threads=1) const;
+
+    /**
+     * @brief Computes the linear scores of several models against several
+     * probes at once, given the offsets Ux of the probes computed by
+     * estimateUx() (one per row)
+     */
+    void computeScores(const blitz::Array<double,2>& models,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      const blitz::Array<double,2>& Ux, blitz::Array<double,2>& scores,
+      const size_t n_threads=1) const;
+
     /**
      * @brief Compute and put U^{T}.Sigma^{-1} matrix in cache
      * @warning Should only be used by the trainer for efficiency reason,
@@ -280,6 +324,15 @@ class FABase
      */
     void estimateX(const blitz::Array<double,2>& IdPlusUSProdInv,
       const blitz::Array<double,1>& Fn_x, blitz::Array<double,1>& x) const;
+    /**
+     * @brief Estimates the offsets Ux of the probes (if Ux is given) and/or
+     * scores them against the models (if models is given), see
+     * estimateUx() and computeScores()
+     */
+    void processProbes(const blitz::Array<double,2>* models,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      const blitz::Array<double,2>* cached_Ux, blitz::Array<double,2>* Ux,
+      blitz::Array<double,2>* scores, const size_t n_threads) const;
 
 
     // UBM
@@ -512,6 +565,37 @@ class JFABase
     void estimateX(const bob::machine::GMMStats& gmm_stats, blitz::Array<double,1>& x) const
     { m_base.estimateX(gmm_stats, x); }
 
+    /**
+     * @brief Estimates the session offsets U.x of several probes at once
+     * (see FABase::estimateUx())
+     */
+    void estimateUx(const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      blitz::Array<double,2>& Ux, const size_t n_threads=1) const
+    { m_base.estimateUx(probes, Ux, n_threads); }
+
+    /**
+     * @brief Computes the scores of several JFAMachines against several
+     * probes at once. scores(m,p) is the score that a JFAMachine with the
+     * latent variables y(m,:) and z(m,:) gives to the probe p. The offset
+     * U.x of each probe is only estimated once (see FABase::computeScores()).
+     * The JFAMachines (and their caches) are not used.
+     */
+    void computeScores(const blitz::Array<double,2>& y,
+      const blitz::Array<double,2>& z,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      blitz::Array<double,2>& scores, const size_t n_threads=1) const;
+
+    /**
+     * @brief Computes the scores of several JFAMachines against several
+     * probes at once, given the offsets Ux of the probes computed by
+     * estimateUx() (one per row)
+     */
+    void computeScores(const blitz::Array<double,2>& y,
+      const blitz::Array<double,2>& z,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      const blitz::Array<double,2>& Ux, blitz::Array<double,2>& scores,
+      const size_t n_threads=1) const;
+
     /**
      * @brief Precompute (put U^{T}.Sigma^{-1} matrix in cache)
      * @warning Should only be used by the trainer for efficiency reason,
@@ -713,6 +797,35 @@ class ISVBase
     void estimateX(const bob::machine::GMMStats& gmm_stats, blitz::Array<double,1>& x) const
     { m_base.estimateX(gmm_stats, x); }
 
+    /**
+     * @brief Estimates the session offsets U.x of several probes at once
+     * (see FABase::estimateUx())
+     */
+    void estimateUx(const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      blitz::Array<double,2>& Ux, const size_t n_threads=1) const
+    { m_base.estimateUx(probes, Ux, n_threads); }
+
+    /**
+     * @brief Computes the scores of several ISVMachines against several
+     * probes at once. scores(m,p) is the score that an ISVMachine with the
+     * latent variable z(m,:) gives to the probe p. The offset U.x of each
+     * probe is only estimated once (see FABase::computeScores()). The
+     * ISVMachines (and their caches) are not used.
+     */
+    void computeScores(const blitz::Array<double,2>& z,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      blitz::Array<double,2>& scores, const size_t n_threads=1) const;
+
+    /**
+     * @brief Computes the scores of several ISVMachines against several
+     * probes at once, given the offsets Ux of the probes computed by
+     * estimateUx() (one per row)
+     */
+    void computeScores(const blitz::Array<double,2>& z,
+      const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+      const blitz::Array<double,2>& Ux, blitz::Array<double,2>& scores,
+      const size_t n_threads=1) const;
+
     /**
      * @brief Precompute (put U^{T}.Sigma^{-1} matrix in cache)
      * @warning Should only be used by the trainer for efficiency reason,
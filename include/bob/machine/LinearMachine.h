@@ -122,20 +122,46 @@ namespace bob { namespace machine {
        *
        * The input and output are NOT checked for compatibility each time. It
        * is your responsibility to do it.
+       *
+       * The working array belongs to the calling thread, such that the same
+       * machine can be used concurrently by several threads.
        */
       void forward_ (const blitz::Array<double,1>& input,
           blitz::Array<double,1>& output) const;
 
+      /**
+       * Forwards data through the network, using the given working array
+       * for the normalized input (resized if required).
+       *
+       * The input and output are NOT checked for compatibility each time. It
+       * is your responsibility to do it.
+       */
+      void forward_ (const blitz::Array<double,1>& input,
+          blitz::Array<double,1>& output, blitz::Array<double,1>& buffer) const;
+
       /**
        * Forwards data through the network, outputs the values of each linear
        * component the input signal is decomposed at.
        *
        * The input and output are checked for compatibility each time the
        * forward method is applied.
+       *
+       * The working array belongs to the calling thread, such that the same
+       * machine can be used concurrently by several threads.
        */
       void forward (const blitz::Array<double,1>& input,
           blitz::Array<double,1>& output) const;
 
+      /**
+       * Forwards data through the network, using the given working array
+       * for the normalized input (resized if required).
+       *
+       * The input and output are checked for compatibility each time the
+       * forward method is applied.
+       */
+      void forward (const blitz::Array<double,1>& input,
+          blitz::Array<double,1>& output, blitz::Array<double,1>& buffer) const;
+
       /**
        * Resizes the machine. If either the input or output increases in size,
        * the weights and other factors should be considered uninitialized. If
@@ -280,8 +306,6 @@ namespace bob { namespace machine {
       blitz::Array<double, 2> m_weight; ///< weights
       blitz::Array<double, 1> m_bias; ///< biases for the output
       boost::shared_ptr<Activation> m_activation; ///< currently set activation type
-
-      mutable blitz::Array<double, 1> m_buffer; ///< a buffer for speed
   
   };
 
@@ -153,9 +153,23 @@ namespace bob { namespace machine {
        *
        * The input and output are NOT checked for compatibility each time. It
        * is your responsibility to do it.
+       *
+       * The working arrays belong to the calling thread, such that the same
+       * machine can be used concurrently by several threads.
+       */
+      void forward_ (const blitz::Array<double,1>& input,
+          blitz::Array<double,1>& output) const;
+
+      /**
+       * Forwards data through the network, using the given working arrays
+       * for the inputs of each layer (resized if required).
+       *
+       * The input and output are NOT checked for compatibility each time. It
+       * is your responsibility to do it.
        */
       void forward_ (const blitz::Array<double,1>& input,
-          blitz::Array<double,1>& output);
+          blitz::Array<double,1>& output,
+          std::vector<blitz::Array<double,1> >& buffer) const;
 
       /**
        * Forwards data through the network, outputs the values of each output
@@ -163,9 +177,23 @@ namespace bob { namespace machine {
        *
        * The input and output are checked for compatibility each time the
        * forward method is applied.
+       *
+       * The working arrays belong to the calling thread, such that the same
+       * machine can be used concurrently by several threads.
+       */
+      void forward (const blitz::Array<double,1>& input,
+          blitz::Array<double,1>& output) const;
+
+      /**
+       * Forwards data through the network, using the given working arrays
+       * for the inputs of each layer (resized if required).
+       *
+       * The input and output are checked for compatibility each time the
+       * forward method is applied.
        */
       void forward (const blitz::Array<double,1>& input,
-          blitz::Array<double,1>& output);
+          blitz::Array<double,1>& output,
+          std::vector<blitz::Array<double,1> >& buffer) const;
 
       /**
        * Forwards data through the network, outputs the values of each output
@@ -173,11 +201,40 @@ namespace bob { namespace machine {
        * matrix with inputs arranged row-wise (i.e., every row contains an
        * individual input).
        *
+       * The inputs are forwarded by blocks of a fixed number of rows, with
+       * working arrays which belong to the calling thread: their size does
+       * not depend on the size of the batch.
+       *
+       * The input and output are NOT checked for compatibility each time. It
+       * is your responsibility to do it.
+       */
+      void forward_ (const blitz::Array<double,2>& input,
+          blitz::Array<double,2>& output) const;
+
+      /**
+       * Forwards a batch of inputs (one per row) through the network, using
+       * the given working arrays for the inputs of each layer (resized if
+       * required). Each layer is computed for the whole batch at once, by
+       * forwardLayer_().
+       *
        * The input and output are NOT checked for compatibility each time. It
        * is your responsibility to do it.
        */
       void forward_ (const blitz::Array<double,2>& input,
-          blitz::Array<double,2>& output);
+          blitz::Array<double,2>& output,
+          std::vector<blitz::Array<double,2> >& buffer) const;
+
+      /**
+       * Computes the outputs of the layer k for a batch of inputs of this
+       * layer (one per row), with a single matrix product followed by the
+       * activation of the whole batch. The input is NOT normalized, as it is
+       * the output of the previous layer (or a normalized input).
+       *
+       * The input and output are NOT checked for compatibility. It is your
+       * responsibility to do it.
+       */
+      void forwardLayer_ (const size_t k, const blitz::Array<double,2>& input,
+          blitz::Array<double,2>& output) const;
 
       /**
        * Forwards data through the network, outputs the values of each output
@@ -189,7 +246,7 @@ namespace bob { namespace machine {
        * forward method is applied.
        */
       void forward (const blitz::Array<double,2>& input,
-          blitz::Array<double,2>& output);
+          blitz::Array<double,2>& output) const;
 
       /**
        * Resizes the machine. This causes this MLP to be completely
@@ -385,7 +442,6 @@ namespace bob { namespace machine {
       std::vector<blitz::Array<double, 1> > m_bias; ///< biases for the output
       boost::shared_ptr<Activation> m_hidden_activation; ///< currently set activation type
       boost::shared_ptr<Activation> m_output_activation; ///< currently set activation type
-      mutable std::vector<blitz::Array<double, 1> > m_buffer; ///< buffer for the outputs of each layer
   
   };
 
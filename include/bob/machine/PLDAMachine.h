@@ -371,6 +371,31 @@ class PLDABase
     double computeLogLikelihoodPointEstimate(const blitz::Array<double,1>& xij,
       const blitz::Array<double,1>& hi, const blitz::Array<double,1>& wij) const;
 
+    /**
+     * @brief Computes the log-likelihood ratio scores of several probe
+     * samples against several enrolled models at once.\n
+     * scores(m,p) is the score that the PLDAMachine m, enrolled by the
+     * PLDATrainer, would give to the probe p. The models are grouped by
+     * number of enrolment samples \f$a\f$, such that the scores of a group
+     * are computed with a few matrix products, using \f$\gamma_{a+1}\f$.
+     * The terms which only depend on the enrolment samples cancel out, and
+     * are hence not required.
+     * @param weighted_sums The weighted sums of the models (one per row),
+     * as given by PLDAMachine::getWeightedSum()
+     * @param n_samples The numbers of enrolment samples of the models
+     * @param probes The probe samples (one per row)
+     * @param scores The scores (number of models x number of probes)
+     * @param n_threads The number of threads (0 for the number of hardware
+     * threads). The scores do not depend on it.
+     * @warning The maps of the machine are neither used nor updated, such
+     * that several threads can score with the same PLDABase.
+     */
+    void computeLogLikelihoodRatios(
+      const blitz::Array<double,2>& weighted_sums,
+      const blitz::Array<uint64_t,1>& n_samples,
+      const blitz::Array<double,2>& probes, blitz::Array<double,2>& scores,
+      const size_t n_threads=1) const;
+
     // Friend method declaration
     friend std::ostream& operator<<(std::ostream& os, const PLDABase& m);
 
@@ -62,6 +62,20 @@ namespace math {
       C = blitz::sum(A(i,k) * B(k,j), k);
     }
 
+  /**
+   * @brief Performs the matrix multiplication C=A*B of double matrices
+   *
+   * The product is computed by the BLAS (dgemm) when each matrix is stored
+   * contiguously along one of its dimensions (C or Fortran order, which
+   * includes transposed arrays and row or column ranges of such arrays),
+   * and by a cache-blocked loop otherwise.
+   *
+   * @warning No checks are performed on the array sizes. C should not
+   * overlap A or B.
+   */
+  void prod_(const blitz::Array<double,2>& A, const blitz::Array<double,2>& B,
+      blitz::Array<double,2>& C);
+
   /**
    * @brief Performs the matrix multiplication C=A*B
    *
@@ -108,6 +122,18 @@ namespace math {
       c = blitz::sum(A(i,j) * b(j), j);
     }
 
+  /**
+   * @brief Performs the matrix-vector multiplication c=A*b of double arrays
+   *
+   * The product is computed by the BLAS (dgemv) when A is stored
+   * contiguously along one of its dimensions, and by a loop otherwise.
+   *
+   * @warning No checks are performed on the array sizes. c should not
+   * overlap A or b.
+   */
+  void prod_(const blitz::Array<double,2>& A, const blitz::Array<double,1>& b,
+      blitz::Array<double,1>& c);
+
   /**
    * @brief Performs the matrix-vector multiplication c=A*b
    *
@@ -153,6 +179,18 @@ namespace math {
       c = blitz::sum(a(j) * B(j,i), j);
     }
 
+  /**
+   * @brief Performs the vector-matrix multiplication c=a*B of double arrays
+   *
+   * The product is computed by the BLAS (dgemv) when B is stored
+   * contiguously along one of its dimensions, and by a loop otherwise.
+   *
+   * @warning No checks are performed on the array sizes. c should not
+   * overlap a or B.
+   */
+  void prod_(const blitz::Array<double,1>& a, const blitz::Array<double,2>& B,
+      blitz::Array<double,1>& c);
+
   /**
    * @brief Performs the vector-matrix multiplication c=a*B
    *
@@ -198,6 +236,18 @@ namespace math {
       C = a(i) * b(j);
     }
 
+  /**
+   * @brief Performs the outer product C=a*b' of double vectors
+   *
+   * The product is computed by the BLAS (dger) when C is stored
+   * contiguously along one of its dimensions, and by a loop otherwise.
+   *
+   * @warning No checks are performed on the array sizes. C should not
+   * overlap a or b.
+   */
+  void prod_(const blitz::Array<double,1>& a, const blitz::Array<double,1>& b,
+      blitz::Array<double,2>& C);
+
   /**
    * @brief Performs the outer product between two vectors generating a matrix.
    *
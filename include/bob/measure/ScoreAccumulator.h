@@ -0,0 +1,356 @@
+/**
+ * @file bob/measure/ScoreAccumulator.h
+ * @date Mon Oct 19 10:12:44 2026 +0200
+ *
+ * @brief Accumulators of negative and positive scores which are given by
+ * chunks, and which evaluate the error rates without keeping all the scores
+ * in memory
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_MEASURE_SCOREACCUMULATOR_H
+#define BOB_MEASURE_SCOREACCUMULATOR_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <blitz/array.h>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <bob/io/HDF5File.h>
+
+namespace bob { namespace measure {
+
+  /**
+   * Receives the distinct scores of a ScoreAccumulator, in increasing order
+   */
+  class ScoreVisitor {
+
+    public:
+
+      virtual ~ScoreVisitor() {}
+
+      /**
+       * Visits a score
+       *
+       * @param score The score
+       * @param threshold A threshold above the score and not above the next
+       * score, at which the error rates of the accumulator are exact
+       * @param negatives The number of negative scores equal to score
+       * @param positives The number of positive scores equal to score
+       */
+      virtual void operator()(double score, double threshold,
+          size_t negatives, size_t positives) =0;
+
+  };
+
+  /**
+   * Accumulates negative and positive scores given by chunks (see
+   * bob::measure::farfrr() for their meaning), and evaluates the error rates
+   * like the functions of bob/measure/error.h, with one or a few sweeps over
+   * the accumulated scores in increasing order. The scores are never all in
+   * memory.
+   */
+  class ScoreAccumulator {
+
+    public:
+
+      ScoreAccumulator();
+
+      virtual ~ScoreAccumulator() {}
+
+      /**
+       * Adds a chunk of negative and positive scores
+       */
+      virtual void add(const blitz::Array<double,1>& negatives,
+          const blitz::Array<double,1>& positives) =0;
+
+      /**
+       * Visits the distinct (possibly quantized) scores in increasing order
+       */
+      virtual void sweep(ScoreVisitor& visitor) const =0;
+
+      /**
+       * Saves the scores into an HDF5 file, such that accumulators of
+       * several processes can be merged
+       */
+      virtual void save(bob::io::HDF5File& config) const =0;
+
+      /**
+       * Returns the number of negative scores
+       */
+      size_t getNNegatives() const { return m_n_negatives; }
+
+      /**
+       * Returns the number of positive scores
+       */
+      size_t getNPositives() const { return m_n_positives; }
+
+      /**
+       * Returns the smallest score (the largest double if there is none)
+       */
+      double getMin() const { return m_min; }
+
+      /**
+       * Returns the largest score (minus the largest double if there is
+       * none)
+       */
+      double getMax() const { return m_max; }
+
+      /**
+       * Calculates the FA ratio and the FR ratio at the given threshold (see
+       * bob::measure::farfrr())
+       */
+      std::pair<double, double> farfrr(double threshold) const;
+
+      /**
+       * Calculates the threshold which minimizes exactly |FAR - FRR| (see
+       * bob::measure::exactEerThreshold())
+       */
+      double eerThreshold() const;
+
+      /**
+       * Calculates the threshold which minimizes exactly the weighted error
+       * rate (see bob::measure::exactMinWeightedErrorRateThreshold())
+       */
+      double minWeightedErrorRateThreshold(double cost) const;
+
+      /**
+       * Calculates the ROC curve on points thresholds distributed uniformly
+       * in [getMin(), getMax()] (see bob::measure::roc())
+       */
+      blitz::Array<double,2> roc(size_t points) const;
+
+      /**
+       * Calculates the DET curve (see bob::measure::det())
+       */
+      blitz::Array<double,2> det(size_t points) const;
+
+      /**
+       * Calculates the ROC curve at the given FAR values (see
+       * bob::measure::roc_for_far()). The CAR of each FAR is the one after
+       * the smallest number of negatives whose ratio is above 1-FAR.
+       */
+      blitz::Array<double,2> roc_for_far(
+          const blitz::Array<double,1>& far_list) const;
+
+    protected:
+
+      /**
+       * Updates the number of scores and their range with a chunk
+       */
+      void count(const blitz::Array<double,1>& negatives,
+          const blitz::Array<double,1>& positives);
+
+      /**
+       * Updates the number of scores and their range with the ones of
+       * another accumulator
+       */
+      void count(const ScoreAccumulator& other);
+
+      size_t m_n_negatives;
+      size_t m_n_positives;
+      double m_min;
+      double m_max;
+
+  };
+
+  /**
+   * Accumulates the scores exactly. The scores are buffered in memory, and
+   * once the buffers hold run_size scores, they are sorted and written to
+   * temporary files (see bob::core::tmpfile()), which are merged on the fly
+   * by the sweeps. Beyond 64 runs of negative (or positive) scores, the
+   * smallest runs are merged into a single one, such that a sweep never
+   * reads more than 64 files of each kind at once. The results are the
+   * same as the ones of the functions of bob/measure/error.h on all the
+   * scores. The sweeps do not modify the accumulator, and may be run
+   * concurrently.
+   */
+  class ExactScoreAccumulator: public ScoreAccumulator, boost::noncopyable {
+
+    public:
+
+      /**
+       * Constructor
+       *
+       * @param run_size The number of scores kept in memory
+       */
+      ExactScoreAccumulator(size_t run_size=1<<22);
+
+      /**
+       * Constructs an accumulator from the scores saved in an HDF5 file
+       */
+      ExactScoreAccumulator(bob::io::HDF5File& config, size_t run_size=1<<22);
+
+      /**
+       * Removes the temporary files
+       */
+      virtual ~ExactScoreAccumulator();
+
+      virtual void add(const blitz::Array<double,1>& negatives,
+          const blitz::Array<double,1>& positives);
+
+      virtual void sweep(ScoreVisitor& visitor) const;
+
+      /**
+       * Saves the sorted negative and positive scores into the HDF5 file, by
+       * blocks
+       */
+      virtual void save(bob::io::HDF5File& config) const;
+
+      /**
+       * Adds the scores saved in an HDF5 file
+       */
+      void load(bob::io::HDF5File& config);
+
+      /**
+       * Adds the scores of another accumulator
+       */
+      void merge(const ExactScoreAccumulator& other);
+
+      /**
+       * Returns the number of scores kept in memory
+       */
+      size_t getRunSize() const { return m_run_size; }
+
+      /**
+       * Returns the number of sorted runs written to temporary files (at
+       * most 64 of negative and 64 of positive scores)
+       */
+      size_t getNRuns() const
+      { return m_negative_runs.size() + m_positive_runs.size(); }
+
+      /**
+       * A sorted run of scores in a temporary file
+       */
+      struct Run {
+        std::string path;
+        size_t size;
+      };
+
+    private:
+
+      /**
+       * Writes the buffers to sorted runs once they are full
+       */
+      void spill();
+
+      size_t m_run_size;
+      std::vector<Run> m_negative_runs;
+      std::vector<Run> m_positive_runs;
+      std::vector<double> m_negatives;
+      std::vector<double> m_positives;
+
+  };
+
+  /**
+   * Accumulates the number of scores in n_bins bins of equal width in [min,
+   * max], with the scores below min and above max in two extra bins, in
+   * constant memory. The scores are quantized to the lower edge of their
+   * bin (those below min to the smallest score), and the results are the
+   * exact ones of the quantized scores: the error rates are exact at the
+   * edges of the bins, and the thresholds are edges of the bins. Between
+   * two edges, the error rates are bounded by the ones at the edges.
+   */
+  class HistogramScoreAccumulator: public ScoreAccumulator {
+
+    public:
+
+      /**
+       * Constructor
+       *
+       * @param min The lower edge of the first bin
+       * @param max The upper edge of the last bin
+       * @param n_bins The number of bins in [min, max]
+       */
+      HistogramScoreAccumulator(double min, double max, size_t n_bins=1<<16);
+
+      /**
+       * Constructs an accumulator from the histograms saved in an HDF5 file
+       */
+      HistogramScoreAccumulator(bob::io::HDF5File& config);
+
+      virtual ~HistogramScoreAccumulator() {}
+
+      virtual void add(const blitz::Array<double,1>& negatives,
+          const blitz::Array<double,1>& positives);
+
+      virtual void sweep(ScoreVisitor& visitor) const;
+
+      virtual void save(bob::io::HDF5File& config) const;
+
+      /**
+       * Replaces the histograms by the ones saved in an HDF5 file
+       */
+      void load(bob::io::HDF5File& config);
+
+      /**
+       * Adds the scores of another accumulator, which has the same bins
+       */
+      void merge(const HistogramScoreAccumulator& other);
+
+      /**
+       * Returns the lower edge of the first bin
+       */
+      double getRangeMin() const { return m_range_min; }
+
+      /**
+       * Returns the upper edge of the last bin
+       */
+      double getRangeMax() const { return m_range_max; }
+
+      /**
+       * Returns the number of bins in [min, max]
+       */
+      size_t getNBins() const { return m_n_bins; }
+
+      /**
+       * Returns the number of negative scores of the bins, the first one
+       * being below min and the last one above max
+       */
+      const blitz::Array<uint64_t,1>& getNegativeCounts() const
+      { return m_negative_counts; }
+
+      /**
+       * Returns the number of positive scores of the bins, the first one
+       * being below min and the last one above max
+       */
+      const blitz::Array<uint64_t,1>& getPositiveCounts() const
+      { return m_positive_counts; }
+
+    private:
+
+      /**
+       * Returns the lower edge of the i-th bin of [min, max]
+       */
+      double edge(size_t i) const;
+
+      /**
+       * Returns the bin of a score, 0 being below min and n_bins+1 above max
+       */
+      size_t bin(double score) const;
+
+      double m_range_min;
+      double m_range_max;
+      size_t m_n_bins;
+      blitz::Array<uint64_t,1> m_negative_counts;
+      blitz::Array<uint64_t,1> m_positive_counts;
+
+  };
+
+}}
+
+#endif /* BOB_MEASURE_SCOREACCUMULATOR_H */
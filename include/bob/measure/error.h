@@ -24,6 +24,9 @@
 #define BOB_MEASURE_ERROR_H
 
 #include <blitz/array.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -68,6 +71,33 @@ namespace bob { namespace measure {
   std::pair<double, double> farfrr(const blitz::Array<double,1>& negatives,
       const blitz::Array<double,1>& positives, double threshold);
 
+  /**
+   * Copies the scores into 'sorted' and sorts them ascendingly. Large arrays
+   * are sorted by chunks in n_threads threads (0 for the number of hardware
+   * threads), which are then merged.
+   */
+  void sort(const blitz::Array<double,1>& scores, std::vector<double>& sorted,
+      size_t n_threads=0);
+
+  /**
+   * Calculates the FA ratio and the FR ratio exactly as farfrr(), given
+   * negative and positive scores sorted ascendingly (see sort()), with two
+   * binary searches.
+   */
+  inline std::pair<double, double> sortedFarfrr(
+      const std::vector<double>& negatives,
+      const std::vector<double>& positives, double threshold) {
+    size_t false_accepts = negatives.end() -
+      std::lower_bound(negatives.begin(), negatives.end(), threshold);
+    size_t false_rejects =
+      std::lower_bound(positives.begin(), positives.end(), threshold) -
+      positives.begin();
+    size_t total_negatives = std::max(negatives.size(), (size_t)1);
+    size_t total_positives = std::max(positives.size(), (size_t)1);
+    return std::make_pair(false_accepts/(double)total_negatives,
+        false_rejects/(double)total_positives);
+  }
+
   /**
    * Calculates the precision and recall (sensitiveness) values given positive and negative
    * scores and a threshold. 'positives' holds the score information for
@@ -123,11 +153,12 @@ namespace bob { namespace measure {
   /**
    * Recursively minimizes w.r.t. to the given predicate method. Please refer
    * to minimizingThreshold() for a full explanation. This method is only
-   * supposed to be used through that method.
+   * supposed to be used through that method. The scores are sorted
+   * ascendingly (see sort()).
    */
   template <typename T>
-  static double recursive_minimization(const blitz::Array<double,1>& negatives,
-      const blitz::Array<double,1>& positives, T& predicate,
+  static double recursive_minimization(const std::vector<double>& negatives,
+      const std::vector<double>& positives, T& predicate,
       double min, double max, size_t steps) {
     static const double QUIT_THRESHOLD = 1e-10;
     const double diff = max - min;
@@ -148,7 +179,7 @@ namespace bob { namespace measure {
       double threshold = ((double)i * step_size) + min;
 
       std::pair<double, double> ratios =
-        farfrr(negatives, positives, threshold);
+        sortedFarfrr(negatives, positives, threshold);
 
       double current_cost = predicate(ratios.first, ratios.second);
 
@@ -175,6 +206,40 @@ namespace bob { namespace measure {
     return accumulator[accumulator.size()/2];
   }
 
+  /**
+   * Returns the smallest and the largest of the (sorted) negative and
+   * positive scores, with the conventions of blitz::min() and blitz::max()
+   * for empty arrays
+   */
+  inline std::pair<double, double> sortedRange(
+      const std::vector<double>& negatives,
+      const std::vector<double>& positives) {
+    double min = std::numeric_limits<double>::max();
+    double max = -std::numeric_limits<double>::max();
+    if (negatives.size()) {
+      min = std::min(min, negatives.front());
+      max = std::max(max, negatives.back());
+    }
+    if (positives.size()) {
+      min = std::min(min, positives.front());
+      max = std::max(max, positives.back());
+    }
+    return std::make_pair(min, max);
+  }
+
+  /**
+   * Same as minimizingThreshold(), for negative and positive scores sorted
+   * ascendingly (see sort())
+   */
+  template <typename T> double
+    sortedMinimizingThreshold(const std::vector<double>& negatives,
+        const std::vector<double>& positives, T& predicate) {
+      const size_t N = 100; ///< number of steps in each iteration
+      std::pair<double, double> range = sortedRange(negatives, positives);
+      return recursive_minimization(negatives, positives, predicate,
+          range.first, range.second, N);
+    }
+
   /**
    * This method can calculate a threshold based on a set of scores (positives
    * and negatives) given a certain minimization criteria, input as a
@@ -204,15 +269,101 @@ namespace bob { namespace measure {
    * The procedure continues until all calculated predicates in a given round
    * give the same minimum. At this point, the center threshold is picked up and
    * returned.
+   *
+   * The scores are sorted once, such that each threshold is evaluated in
+   * O(log N) operations. See exactMinimizingThreshold() for the exact
+   * minimum of any predicate.
    */
   template <typename T> double
     minimizingThreshold(const blitz::Array<double,1>& negatives,
         const blitz::Array<double,1>& positives, T& predicate) {
-      const size_t N = 100; ///< number of steps in each iteration
-      double min = std::min(blitz::min(negatives), blitz::min(positives));
-      double max = std::max(blitz::max(negatives), blitz::max(positives));
-      return recursive_minimization(negatives, positives, predicate, min,
-          max, N);
+      std::vector<double> negatives_, positives_;
+      sort(negatives, negatives_);
+      sort(positives, positives_);
+      return sortedMinimizingThreshold(negatives_, positives_, predicate);
+    }
+
+  /**
+   * Calculates the threshold that minimizes exactly the given predicate (see
+   * minimizingThreshold()), for negative and positive scores sorted
+   * ascendingly (see sort()).
+   *
+   * The FA and FR ratios only change at the score values. A single sweep
+   * over the merged scores evaluates the predicate once between each pair
+   * of consecutive distinct scores (as well as below the smallest one and
+   * above the largest one), in O(N) operations. The returned threshold is
+   * in the middle of the interval of the minimum. If several intervals give
+   * the same minimum, the center one is picked up.
+   */
+  template <typename T> double
+    sortedExactMinimizingThreshold(const std::vector<double>& negatives,
+        const std::vector<double>& positives, T& predicate) {
+      const size_t n_neg = negatives.size();
+      const size_t n_pos = positives.size();
+      const double total_negatives = std::max(n_neg, (size_t)1);
+      const double total_positives = std::max(n_pos, (size_t)1);
+      if (n_neg + n_pos == 0) return 0.;
+      std::pair<double, double> range = sortedRange(negatives, positives);
+
+      //the thresholds of the intervals of the minimum; the first interval is
+      //below the smallest score (all the scores are accepted)
+      std::vector<double> accumulator;
+      double min_value = predicate(n_neg / total_negatives, 0.0);
+      accumulator.push_back(range.first);
+
+      //threshold just above each distinct score: accepts the larger ones
+      size_t i_neg = 0, i_pos = 0;
+      while (i_neg < n_neg || i_pos < n_pos) {
+        double score = (i_pos == n_pos || (i_neg < n_neg &&
+              negatives[i_neg] < positives[i_pos])) ?
+          negatives[i_neg] : positives[i_pos];
+        while (i_neg < n_neg && negatives[i_neg] == score) ++i_neg;
+        while (i_pos < n_pos && positives[i_pos] == score) ++i_pos;
+
+        double threshold;
+        if (i_neg < n_neg || i_pos < n_pos) {
+          double next = (i_pos == n_pos || (i_neg < n_neg &&
+                negatives[i_neg] < positives[i_pos])) ?
+            negatives[i_neg] : positives[i_pos];
+          threshold = 0.5 * (score + next);
+          if (threshold <= score) threshold = next; //consecutive doubles
+        }
+        else {
+          //above the largest score (all the scores are rejected)
+          threshold = score + 0.5 * (range.second - range.first) /
+            (n_neg + n_pos);
+          if (threshold <= score)
+            threshold = score + std::max(std::abs(score), 1.) *
+              std::numeric_limits<double>::epsilon();
+        }
+
+        double current_cost = predicate((n_neg - i_neg) / total_negatives,
+            i_pos / total_positives);
+        if (current_cost < min_value) {
+          min_value = current_cost;
+          accumulator.clear();
+          accumulator.push_back(threshold);
+        }
+        else if (std::abs(current_cost - min_value) < 1e-16) {
+          accumulator.push_back(threshold);
+        }
+      }
+
+      return accumulator[accumulator.size()/2];
+    }
+
+  /**
+   * Calculates the threshold that minimizes exactly the given predicate (see
+   * minimizingThreshold()), with one sort of the scores and one sweep over
+   * them. Please refer to sortedExactMinimizingThreshold() for details.
+   */
+  template <typename T> double
+    exactMinimizingThreshold(const blitz::Array<double,1>& negatives,
+        const blitz::Array<double,1>& positives, T& predicate) {
+      std::vector<double> negatives_, positives_;
+      sort(negatives, negatives_);
+      sort(positives, positives_);
+      return sortedExactMinimizingThreshold(negatives_, positives_, predicate);
     }
 
   /**
@@ -224,6 +375,14 @@ namespace bob { namespace measure {
   double eerThreshold(const blitz::Array<double,1>& negatives,
       const blitz::Array<double,1>& positives);
 
+  /**
+   * Calculates the threshold which minimizes exactly |FAR - FRR| given the
+   * input data, with a single sweep over the sorted scores (see
+   * exactMinimizingThreshold()).
+   */
+  double exactEerThreshold(const blitz::Array<double,1>& negatives,
+      const blitz::Array<double,1>& positives);
+
   /**
    * Calculates the equal-error-rate (EER) given the input data, on the ROC 
    * Convex Hull, as performed in the Bosaris toolkit.
@@ -248,6 +407,15 @@ namespace bob { namespace measure {
   double minWeightedErrorRateThreshold(const blitz::Array<double,1>& negatives,
       const blitz::Array<double,1>& positives, double cost);
 
+  /**
+   * Calculates the threshold which minimizes exactly the weighted error rate
+   * (see minWeightedErrorRateThreshold()), with a single sweep over the
+   * sorted scores (see exactMinimizingThreshold()).
+   */
+  double exactMinWeightedErrorRateThreshold(
+      const blitz::Array<double,1>& negatives,
+      const blitz::Array<double,1>& positives, double cost);
+
   /**
    * Calculates the minWeightedErrorRateThreshold() when the cost is 0.5.
    */
@@ -75,6 +75,13 @@ class DCT2DAbstract
     virtual void operator()(const blitz::Array<double,2>& src, 
       blitz::Array<double,2>& dst) const = 0;
 
+    /**
+     * @brief process a stack of 2D arrays of the same shape at once, by
+     * applying the DCT to each src(k,:,:)
+     */
+    virtual void operator()(const blitz::Array<double,3>& src, 
+      blitz::Array<double,3>& dst) const = 0;
+
     /**
      * @brief Reset the DCT2D object for the given 2D shape
      */
@@ -152,6 +159,13 @@ class DCT2D: public DCT2DAbstract
      */
     virtual void operator()(const blitz::Array<double,2>& src, 
       blitz::Array<double,2>& dst) const;
+
+    /**
+     * @brief process a stack of arrays (height x width) at once by
+     * applying the direct DCT to each src(k,:,:), with a single call to FFTW
+     */
+    virtual void operator()(const blitz::Array<double,3>& src, 
+      blitz::Array<double,3>& dst) const;
 };
 
 
@@ -187,6 +201,13 @@ class IDCT2D: public DCT2DAbstract
      */
     virtual void operator()(const blitz::Array<double,2>& src, 
       blitz::Array<double,2>& dst) const;
+
+    /**
+     * @brief process a stack of arrays (height x width) at once by
+     * applying the inverse DCT to each src(k,:,:), with a single call to FFTW
+     */
+    virtual void operator()(const blitz::Array<double,3>& src, 
+      blitz::Array<double,3>& dst) const;
 };
 
 /**
@@ -77,6 +77,13 @@ class FFT1DAbstract
     virtual void operator()(const blitz::Array<std::complex<double>,1>& src, 
       blitz::Array<std::complex<double>,1>& dst) const = 0;
 
+    /**
+     * @brief process several signals of the same length at once, by
+     * applying the FFT to each row of a 2D array (one signal per row)
+     */
+    virtual void operator()(const blitz::Array<std::complex<double>,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const = 0;
+
     /**
      * @brief Reset the FFT1D object for the given 1D shape
      */
@@ -131,6 +138,13 @@ class FFT1D: public FFT1DAbstract
      */
     virtual void operator()(const blitz::Array<std::complex<double>,1>& src, 
       blitz::Array<std::complex<double>,1>& dst) const;
+
+    /**
+     * @brief process several signals at once by applying the direct FFT to
+     * each row of src, with a single call to FFTW
+     */
+    virtual void operator()(const blitz::Array<std::complex<double>,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const;
 };
 
 
@@ -166,6 +180,13 @@ class IFFT1D: public FFT1DAbstract
      */
     virtual void operator()(const blitz::Array<std::complex<double>,1>& src, 
       blitz::Array<std::complex<double>,1>& dst) const;
+
+    /**
+     * @brief process several signals at once by applying the inverse FFT to
+     * each row of src, with a single call to FFTW
+     */
+    virtual void operator()(const blitz::Array<std::complex<double>,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const;
 };
 
 /**
@@ -0,0 +1,212 @@
+/**
+ * @file bob/sp/FFTWPlanCache.h
+ * @date Sat Oct 17 15:21:40 2026 +0200
+ *
+ * @brief Thread-safe cache of the FFTW plans used by the FFT and DCT
+ * classes, and persistence of the FFTW wisdom
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_FFTWPLANCACHE_H
+#define BOB_SP_FFTWPLANCACHE_H
+
+#include <complex>
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+// Opaque FFTW plan type (fftw_plan is a pointer to this structure)
+struct fftw_plan_s;
+
+namespace bob { namespace sp {
+/**
+ * @ingroup SP
+ * @{
+ */
+
+/**
+ * @brief The FFTWPlanCache creates the FFTW plans used by the FFT and DCT
+ * classes once per kind of transform, size, batch size (a fixed number of
+ * transforms, or a single one), placement (in-place or not) and alignment,
+ * and keeps them for the lifetime of the program.
+ * @details Plans are created on scratch buffers and executed on the arrays
+ * of the caller with the FFTW new-array execute functions, which are
+ * thread-safe. The creation of plans (as well as any access to the FFTW
+ * wisdom) is serialized by a mutex.
+ */
+class FFTWPlanCache
+{
+  public: //static access
+
+    /**
+     * Returns the singleton
+     */
+    static boost::shared_ptr<FFTWPlanCache> instance();
+
+  public: //object access
+
+    /**
+     * The planning rigor: FFTW_ESTIMATE (default), FFTW_MEASURE or
+     * FFTW_PATIENT. The more rigorous, the longer the creation of a plan,
+     * and the faster its execution.
+     */
+    typedef enum { ESTIMATE=0, MEASURE, PATIENT } rigor_t;
+
+    /**
+     * The kinds of transforms
+     */
+    typedef enum { DFT_FORWARD=0, DFT_BACKWARD, DCT, IDCT, RFFT, IRFFT } kind_t;
+
+    /**
+     * Destructor: destroys all the plans
+     */
+    virtual ~FFTWPlanCache();
+
+    /**
+     * Returns the planning rigor used for new plans
+     */
+    rigor_t getRigor() const;
+
+    /**
+     * Sets the planning rigor used for new plans. Plans previously created
+     * with another rigor are kept, but not used anymore.
+     */
+    void setRigor(const rigor_t rigor);
+
+    /**
+     * Imports FFTW wisdom from the given file
+     * @return false if the file could not be read
+     */
+    bool importWisdom(const std::string& filename);
+
+    /**
+     * Exports the FFTW wisdom accumulated so far to the given file
+     */
+    void exportWisdom(const std::string& filename);
+
+    /**
+     * Forgets the FFTW wisdom and destroys all the plans
+     * @warning No transform should be running while this method is called
+     */
+    void forgetWisdom();
+
+    /**
+     * Destroys all the plans
+     * @warning No transform should be running while this method is called
+     */
+    void clear();
+
+    /**
+     * Returns the number of plans in the cache
+     */
+    size_t size() const;
+
+    /**
+     * Computes the (unnormalized) complex DFT of src into dst
+     * @param kind DFT_FORWARD or DFT_BACKWARD
+     * @param rank 1 or 2
+     * @param n0 The first dimension
+     * @param n1 The second dimension (ignored if rank is 1)
+     * @param howmany The number of transforms to compute, using the FFTW
+     * advanced interface: src and dst then contain howmany consecutive
+     * arrays. The transforms are computed by batches of a fixed size (and
+     * the remaining ones one at a time), so that the number of plans does
+     * not depend on howmany.
+     * @warning src and dst should be C-contiguous arrays of howmany x n0
+     * (x n1) elements. They may be the same array (in-place transform).
+     */
+    void executeDFT(const kind_t kind, const int rank, const int n0,
+      const int n1, const std::complex<double>* src,
+      std::complex<double>* dst, const int howmany=1);
+
+    /**
+     * Computes the (unnormalized) DCT-II (kind DCT) or DCT-III (kind IDCT)
+     * of src into dst
+     * @see executeDFT()
+     */
+    void executeR2R(const kind_t kind, const int rank, const int n0,
+      const int n1, const double* src, double* dst, const int howmany=1);
+
+    /**
+     * Computes the (unnormalized) DFT of the real array src (of n0 (x n1)
+     * elements) into dst, which contains the non-redundant half of the
+     * Hermitian spectrum: n0/2+1 elements if rank is 1, n0 x (n1/2+1)
+     * elements if rank is 2
+     * @see executeDFT()
+     */
+    void executeR2C(const int rank, const int n0, const int n1,
+      const double* src, std::complex<double>* dst, const int howmany=1);
+
+    /**
+     * Computes the (unnormalized) inverse DFT of the half Hermitian
+     * spectrum src into the real array dst (of n0 (x n1) elements)
+     * @see executeR2C()
+     * @warning If rank is 2, src is overwritten (FFTW cannot preserve the
+     * input of multi-dimensional complex-to-real transforms)
+     */
+    void executeC2R(const int rank, const int n0, const int n1,
+      std::complex<double>* src, double* dst, const int howmany=1);
+
+  private:
+
+    FFTWPlanCache();
+
+    // Not implemented
+    FFTWPlanCache(const FFTWPlanCache&);
+
+    /**
+     * Key of a plan
+     */
+    struct PlanKey {
+      PlanKey(const kind_t kind, const int rank, const int n0, const int n1,
+          const int howmany, const bool in_place, const bool aligned,
+          const rigor_t rigor);
+      bool operator<(const PlanKey& other) const;
+
+      kind_t kind;
+      int rank;
+      int n0;
+      int n1;
+      int howmany;
+      bool in_place;
+      bool aligned;
+      rigor_t rigor;
+    };
+
+    /**
+     * Returns the plan for the given key, creating it if required
+     */
+    fftw_plan_s* getPlan(const kind_t kind, const int rank, const int n0,
+      const int n1, const int howmany, const bool in_place,
+      const bool aligned);
+
+    /**
+     * Destroys all the plans (the mutex should be locked)
+     */
+    void destroyPlans();
+
+    std::map<PlanKey, fftw_plan_s*> m_plans;
+    rigor_t m_rigor;
+    mutable boost::mutex m_mutex;
+};
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_SP_FFTWPLANCACHE_H */
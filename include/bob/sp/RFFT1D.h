@@ -0,0 +1,190 @@
+/**
+ * @file bob/sp/RFFT1D.h
+ * @date Sat Oct 17 16:02:18 2026 +0200
+ *
+ * @brief Implement a blitz-based 1D Fast Fourier Transform of real signals
+ * using FFTW functions
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_RFFT1D_H
+#define BOB_SP_RFFT1D_H
+
+#include <complex>
+#include <blitz/array.h>
+
+namespace bob { namespace sp {
+/**
+ * @ingroup SP
+ * @{
+ */
+
+/**
+ * @brief This class implements a 1D Discrete Fourier Transform of real
+ * signals based on the FFTW library. It is used as a base class for RFFT1D
+ * and IRFFT1D classes.
+ * @details The DFT of a real signal of length N is Hermitian: only its
+ * N/2+1 first (non-redundant) coefficients are computed.
+ */
+class RFFT1DAbstract
+{
+  public:
+    /**
+     * @brief Constructor
+     */
+    RFFT1DAbstract(const size_t length);
+
+    /**
+     * @brief Copy constructor
+     */
+    RFFT1DAbstract(const RFFT1DAbstract& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~RFFT1DAbstract();
+
+    /**
+     * @brief Assignment operator
+     */
+    RFFT1DAbstract& operator=(const RFFT1DAbstract& other);
+
+    /**
+     * @brief Equal operator
+     */
+    bool operator==(const RFFT1DAbstract& other) const;
+
+    /**
+     * @brief Not equal operator
+     */
+    bool operator!=(const RFFT1DAbstract& other) const;
+
+    /**
+     * @brief Reset the object for the given length of the real signal
+     */
+    void reset(const size_t length);
+
+    /**
+     * @brief Getters
+     */
+    size_t getLength() const { return m_length; }
+    size_t getHalfLength() const { return m_length/2+1; }
+    /**
+     * @brief Setters
+     */
+    void setLength(const size_t length);
+
+  protected:
+    /**
+     * Private attributes
+     */
+    size_t m_length;
+};
+
+
+/**
+ * @brief This class implements a direct 1D Discrete Fourier Transform of
+ * real signals based on the FFTW library
+ */
+class RFFT1D: public RFFT1DAbstract
+{
+  public:
+    /**
+     * @brief Constructor
+     */ 
+    RFFT1D();
+
+    /**
+     * @brief Constructor
+     */ 
+    RFFT1D(const size_t length);
+
+    /**
+     * @brief Copy constructor
+     */
+    RFFT1D(const RFFT1D& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~RFFT1D();
+
+    /**
+     * @brief process a real array of length N by applying the direct FFT,
+     * the output being the N/2+1 first coefficients of the spectrum
+     */
+    void operator()(const blitz::Array<double,1>& src, 
+      blitz::Array<std::complex<double>,1>& dst) const;
+
+    /**
+     * @brief process several real signals at once by applying the direct
+     * FFT to each row of src (of length N), with a single call to FFTW.
+     * Each row of dst contains the N/2+1 first coefficients of a spectrum.
+     */
+    void operator()(const blitz::Array<double,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const;
+};
+
+
+/**
+ * @brief This class implements an inverse 1D Discrete Fourier Transform 
+ * of Hermitian spectra based on the FFTW library
+ */
+class IRFFT1D: public RFFT1DAbstract
+{
+  public:
+    /**
+     * @brief Constructor
+     */ 
+    IRFFT1D();
+
+    /**
+     * @brief Constructor
+     */ 
+    IRFFT1D(const size_t length);
+
+    /**
+     * @brief Copy constructor
+     */
+    IRFFT1D(const IRFFT1D& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~IRFFT1D();
+
+    /**
+     * @brief process the N/2+1 first coefficients of a Hermitian spectrum
+     * by applying the inverse FFT, the output being a real array of
+     * length N
+     */
+    void operator()(const blitz::Array<std::complex<double>,1>& src, 
+      blitz::Array<double,1>& dst) const;
+
+    /**
+     * @brief process several half spectra at once by applying the inverse
+     * FFT to each row of src (of length N/2+1), with a single call to FFTW
+     */
+    void operator()(const blitz::Array<std::complex<double>,2>& src, 
+      blitz::Array<double,2>& dst) const;
+};
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_SP_RFFT1D_H */
@@ -0,0 +1,178 @@
+/**
+ * @file bob/sp/RFFT2D.h
+ * @date Sat Oct 17 16:02:18 2026 +0200
+ *
+ * @brief Implement a blitz-based 2D Fast Fourier Transform of real signals
+ * using FFTW functions
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_SP_RFFT2D_H
+#define BOB_SP_RFFT2D_H
+
+#include <complex>
+#include <blitz/array.h>
+
+namespace bob { namespace sp {
+/**
+ * @ingroup SP
+ * @{
+ */
+
+/**
+ * @brief This class implements a 2D Discrete Fourier Transform of real
+ * signals based on the FFTW library. It is used as a base class for RFFT2D
+ * and IRFFT2D classes.
+ * @details The DFT of a real HxW signal is Hermitian: only its Hx(W/2+1)
+ * first (non-redundant) coefficients are computed.
+ */
+class RFFT2DAbstract
+{
+  public:
+    /**
+     * @brief Constructor
+     */
+    RFFT2DAbstract(const size_t height, const size_t width);
+
+    /**
+     * @brief Copy constructor
+     */
+    RFFT2DAbstract(const RFFT2DAbstract& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~RFFT2DAbstract();
+
+    /**
+     * @brief Assignment operator
+     */
+    RFFT2DAbstract& operator=(const RFFT2DAbstract& other);
+
+    /**
+     * @brief Equal operator
+     */
+    bool operator==(const RFFT2DAbstract& other) const;
+
+    /**
+     * @brief Not equal operator
+     */
+    bool operator!=(const RFFT2DAbstract& other) const;
+
+    /**
+     * @brief Reset the object for the given 2D shape of the real signal
+     */
+    void reset(const size_t height, const size_t width);
+
+    /**
+     * @brief Getters
+     */
+    size_t getHeight() const { return m_height; }
+    size_t getWidth() const { return m_width; }
+    size_t getHalfWidth() const { return m_width/2+1; }
+    /**
+     * @brief Setters
+     */
+    void setHeight(const size_t height);
+    void setWidth(const size_t width);
+
+  protected:
+    /**
+     * Private attributes
+     */
+    size_t m_height;
+    size_t m_width;
+};
+
+
+/**
+ * @brief This class implements a direct 2D Discrete Fourier Transform of
+ * real signals based on the FFTW library
+ */
+class RFFT2D: public RFFT2DAbstract
+{
+  public:
+    /**
+     * @brief Constructor
+     */ 
+    RFFT2D();
+
+    /**
+     * @brief Constructor
+     */ 
+    RFFT2D(const size_t height, const size_t width);
+
+    /**
+     * @brief Copy constructor
+     */
+    RFFT2D(const RFFT2D& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~RFFT2D();
+
+    /**
+     * @brief process a real HxW array by applying the direct FFT, the
+     * output being the Hx(W/2+1) first coefficients of the spectrum
+     */
+    void operator()(const blitz::Array<double,2>& src, 
+      blitz::Array<std::complex<double>,2>& dst) const;
+};
+
+
+/**
+ * @brief This class implements an inverse 2D Discrete Fourier Transform 
+ * of Hermitian spectra based on the FFTW library
+ */
+class IRFFT2D: public RFFT2DAbstract
+{
+  public:
+    /**
+     * @brief Constructor
+     */ 
+    IRFFT2D();
+
+    /**
+     * @brief Constructor
+     */ 
+    IRFFT2D(const size_t height, const size_t width);
+
+    /**
+     * @brief Copy constructor
+     */
+    IRFFT2D(const IRFFT2D& other);
+
+    /**
+     * @brief Destructor
+     */
+    virtual ~IRFFT2D();
+
+    /**
+     * @brief process the Hx(W/2+1) first coefficients of a Hermitian
+     * spectrum by applying the inverse FFT, the output being a real HxW
+     * array
+     */
+    void operator()(const blitz::Array<std::complex<double>,2>& src, 
+      blitz::Array<double,2>& dst) const;
+};
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_SP_RFFT2D_H */
@@ -25,6 +25,7 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <cstdlib>
 #include <blitz/array.h>
 #include <boost/format.hpp>
 
@@ -51,71 +52,189 @@ namespace Conv {
     Same,
     Valid
   } SizeOption;
+
+  /**
+   * @brief Enumerations of the possible algorithms: the direct computation
+   * of the sums, the product of the Fourier transforms (for double arrays
+   * only), or the fastest one given the sizes of the arrays
+   */
+  typedef enum Algorithm_ {
+    Auto,
+    Direct,
+    FFT
+  } Algorithm;
 }
 
 namespace detail {
+  /**
+   * @brief Returns the index in the full convolution of the first sample of
+   * the output, for a kernel of size N
+   */
+  inline int convShift(const int N, const Conv::SizeOption size_opt)
+  {
+    if (size_opt == Conv::Full) return 0;
+    else if (size_opt == Conv::Same) return N-1-N/2;
+    else return N-1;
+  }
+
+  /**
+   * @brief y += alpha*x on n (strided) elements. The unit stride loop is
+   * vectorized by the compiler.
+   */
   template <typename T>
-  void convInternal(const blitz::Array<T,1> a, const blitz::Array<T,1> b,
-    blitz::Array<T,1> c, const int offset_0, const int offset_1)
+  inline void convAxpy(const int n, const T alpha, const T* x, const int sx,
+    T* y, const int sy)
   {
-    const int M = a.extent(0);
-    const int P = c.extent(0);
+    if (sx == 1 && sy == 1)
+      for (int k=0; k<n; ++k) y[k] += alpha * x[k];
+    else
+      for (int k=0; k<n; ++k) y[k*sy] += alpha * x[k*sx];
+  }
 
-    int bl_offset = 0;
-    int bu_offset = offset_1-1;
-    int al_offset = 0;
-    for (int i=0; i<P; ++i)
+  /**
+   * @brief Direct 1D convolution of (strided) arrays: c(i), 0<=i<P, is the
+   * sample i+shift of the full convolution of a (of size M) and b (of size
+   * N). Each sample of the kernel is accumulated over the whole output.
+   */
+  template <typename T>
+  void convDirect(const T* a, const int sa, const int M, const T* b,
+    const int sb, const int N, T* c, const int sc, const int P,
+    const int shift)
+  {
+    for (int i=0; i<P; ++i) c[i*sc] = T();
+    for (int k=0; k<N; ++k)
     {
-      blitz::Array<T,1> b_s = b(blitz::Range(bu_offset,bl_offset,-1));
-      blitz::Array<T,1> a_s =
-        a(blitz::Range(al_offset,al_offset+bu_offset-bl_offset));
-      c(i) = blitz::sum(a_s * b_s);
-      if (i < offset_0) ++bu_offset;
-      else ++al_offset;
-      if (i >= M-offset_1) ++bl_offset;
+      // c(i) += b(k) * a(i+shift-k), for 0 <= i+shift-k < M
+      const int i0 = std::max(0, k-shift);
+      const int i1 = std::min(P, M+k-shift);
+      if (i0 < i1)
+        convAxpy(i1-i0, b[k*sb], a + (i0+shift-k)*sa, sa, c + i0*sc, sc);
     }
   }
 
+  template <typename T>
+  void convInternal(const blitz::Array<T,1> a, const blitz::Array<T,1> b,
+    blitz::Array<T,1> c, const int shift)
+  {
+    convDirect(a.data(), a.stride(0), a.extent(0), b.data(), b.stride(0),
+      b.extent(0), c.data(), c.stride(0), c.extent(0), shift);
+  }
+
   template <typename T>
   void convInternal(const blitz::Array<T,2> A, const blitz::Array<T,2> B,
-    blitz::Array<T,2> C, const int offset0_0, const int offset0_1,
-    const int offset1_0, const int offset1_1)
+    blitz::Array<T,2> C, const int shift0, const int shift1)
   {
     const int M0 = A.extent(0);
     const int M1 = A.extent(1);
+    const int N0 = B.extent(0);
+    const int N1 = B.extent(1);
     const int P0 = C.extent(0);
     const int P1 = C.extent(1);
+    const T* a = A.data();
+    T* c = C.data();
 
-    int bl_offset0 = 0;
-    int bu_offset0 = offset0_1-1;
-    int al_offset0 = 0;
-
-    int bl_offset1;
-    int bu_offset1;
-    int al_offset1;
+    // Row by row of the output, the rows of the kernel and of the input
+    // which overlap being accumulated along the rows
     for (int i=0; i<P0; ++i)
     {
-      blitz::Range r_b0(bu_offset0,bl_offset0,-1);
-      blitz::Range r_a0(al_offset0,al_offset0+bu_offset0-bl_offset0);
-      bl_offset1 = 0;
-      bu_offset1 = offset1_1-1;
-      al_offset1 = 0;
+      T* c_i = c + i*C.stride(0);
+      for (int j=0; j<P1; ++j) c_i[j*C.stride(1)] = T();
+      const int p0 = std::max(0, i+shift0-M0+1);
+      const int p1 = std::min(N0, i+shift0+1);
+      for (int p=p0; p<p1; ++p)
+      {
+        const T* a_p = a + (i+shift0-p)*A.stride(0);
+        for (int q=0; q<N1; ++q)
+        {
+          // C(i,j) += B(p,q) * A(i+shift0-p, j+shift1-q)
+          const int j0 = std::max(0, q-shift1);
+          const int j1 = std::min(P1, M1+q-shift1);
+          if (j0 < j1)
+            convAxpy(j1-j0, B(p,q), a_p + (j0+shift1-q)*A.stride(1),
+              A.stride(1), c_i + j0*C.stride(1), C.stride(1));
+        }
+      }
+    }
+  }
 
-      for (int j=0; j<P1; ++j)
+  /**
+   * @brief Direct convolution of the columns of A (along the dimension 0)
+   * with the 1D kernel b. The loops are ordered such that the innermost
+   * one runs along the dimension with the smallest stride.
+   */
+  template <typename T>
+  void convSepInternal(const blitz::Array<T,2>& A, const blitz::Array<T,1>& b,
+    blitz::Array<T,2>& C, const int shift)
+  {
+    const int M = A.extent(0);
+    const int N = b.extent(0);
+    const int P = C.extent(0);
+    const int n_lines = A.extent(1);
+    if (std::abs(A.stride(0)) <= std::abs(A.stride(1)))
+    {
+      // Columns are contiguous: one 1D convolution per column
+      for (int j=0; j<n_lines; ++j)
+        convDirect(A.data() + j*A.stride(1), A.stride(0), M, b.data(),
+          b.stride(0), N, C.data() + j*C.stride(1), C.stride(0), P, shift);
+    }
+    else
+    {
+      // Rows are contiguous: the rows of A are accumulated into the ones
+      // of C
+      for (int i=0; i<P; ++i)
       {
-        blitz::Array<T,2> B_s = B(r_b0,blitz::Range(bu_offset1,bl_offset1,-1));
-        blitz::Array<T,2> A_s = A(r_a0,blitz::Range(al_offset1,al_offset1+bu_offset1-bl_offset1));
-        C(i,j) = blitz::sum(A_s * B_s);
-        if (j < offset1_0) ++bu_offset1;
-        else ++al_offset1;
-        if (j >= M1-offset1_1) ++bl_offset1;
+        T* c_i = C.data() + i*C.stride(0);
+        for (int j=0; j<n_lines; ++j) c_i[j*C.stride(1)] = T();
+        const int k0 = std::max(0, i+shift-M+1);
+        const int k1 = std::min(N, i+shift+1);
+        for (int k=k0; k<k1; ++k)
+          convAxpy(n_lines, b(k), A.data() + (i+shift-k)*A.stride(0),
+            A.stride(1), c_i, C.stride(1));
       }
-      if (i < offset0_0) ++bu_offset0;
-      else ++al_offset0;
-      if (i >= M0-offset0_1) ++bl_offset0;
     }
   }
 
+  /**
+   * @brief Convolutions based on the FFT, only available for double
+   * arrays. The methods return false (without computing anything) if the
+   * direct convolution should be used instead, that is to say if the
+   * algorithm is Direct, or if it is Auto and the direct convolution is
+   * expected to be faster.
+   */
+  template <typename T>
+  struct ConvFFT
+  {
+    static bool conv(const blitz::Array<T,1>&, const blitz::Array<T,1>&,
+        blitz::Array<T,1>&, const int, const Conv::Algorithm)
+    { return false; }
+    static bool conv(const blitz::Array<T,2>&, const blitz::Array<T,2>&,
+        blitz::Array<T,2>&, const int, const int, const Conv::Algorithm)
+    { return false; }
+    static bool convSep(const blitz::Array<T,2>&, const blitz::Array<T,1>&,
+        blitz::Array<T,2>&, const int, const Conv::Algorithm)
+    { return false; }
+  };
+
+  /**
+   * @brief FFT-based convolutions of double arrays: overlap-add of blocks
+   * of the input in 1D, product of the transforms of the zero-padded
+   * arrays in 2D, and batched transforms of all the (zero-padded) columns
+   * for the separable convolution
+   */
+  template <>
+  struct ConvFFT<double>
+  {
+    static bool conv(const blitz::Array<double,1>& a,
+        const blitz::Array<double,1>& b, blitz::Array<double,1>& c,
+        const int shift, const Conv::Algorithm algorithm);
+    static bool conv(const blitz::Array<double,2>& A,
+        const blitz::Array<double,2>& B, blitz::Array<double,2>& C,
+        const int shift0, const int shift1, const Conv::Algorithm algorithm);
+    static bool convSep(const blitz::Array<double,2>& A,
+        const blitz::Array<double,1>& b, blitz::Array<double,2>& C,
+        const int shift, const Conv::Algorithm algorithm);
+  };
+
 }
 
 /**
@@ -265,12 +384,17 @@ const blitz::TinyVector<int,N> getConvSepOutputSize(const blitz::Array<T,N>& A,
  * @param size_opt:  * Full: full size (default)
  *                   * Same: same size as the largest between A and B
  *                   * Valid: valid (part without padding)
+ * @param algorithm: * Auto: the fastest algorithm given the sizes
+ *                   * Direct: direct computation of the sums (default)
+ *                   * FFT: overlap-add of FFT-based convolutions of
+ *                       blocks of a (for double arrays only)
  * @warning a should be larger than the kernel b
  *    The output c should have the correct size
  */
 template <typename T>
 void conv(const blitz::Array<T,1> a, const blitz::Array<T,1> b,
-  blitz::Array<T,1> c, const Conv::SizeOption size_opt = Conv::Full)
+  blitz::Array<T,1> c, const Conv::SizeOption size_opt = Conv::Full,
+  const Conv::Algorithm algorithm = Conv::Direct)
 {
   const int N = b.extent(0);
 
@@ -280,12 +404,9 @@ void conv(const blitz::Array<T,1> a, const blitz::Array<T,1> b,
     throw std::runtime_error(m.str());
   }
 
-  if (size_opt == Conv::Full)
-    detail::convInternal(a, b, c, N-1, 1);
-  else if (size_opt == Conv::Same)
-    detail::convInternal(a, b, c, N/2, (N+1)/2);
-  else
-    detail::convInternal(a, b, c, 0, N);
+  const int shift = detail::convShift(N, size_opt);
+  if (!detail::ConvFFT<T>::conv(a, b, c, shift, algorithm))
+    detail::convInternal(a, b, c, shift);
 }
 
 /**
@@ -296,12 +417,17 @@ void conv(const blitz::Array<T,1> a, const blitz::Array<T,1> b,
  * @param size_opt:  * Full: full size (default)
  *                   * Same: same size as the largest between A and B
  *                   * Valid: valid (part without padding)
+ * @param algorithm: * Auto: the fastest algorithm given the sizes
+ *                   * Direct: direct computation of the sums (default)
+ *                   * FFT: product of the FFT of the zero-padded arrays
+ *                       (for double arrays only)
  * @warning A should have larger dimensions than the kernel B
  *   The output C should have the correct size
  */
 template <typename T>
 void conv(const blitz::Array<T,2> A, const blitz::Array<T,2> B,
-  blitz::Array<T,2> C, const Conv::SizeOption size_opt = Conv::Full)
+  blitz::Array<T,2> C, const Conv::SizeOption size_opt = Conv::Full,
+  const Conv::Algorithm algorithm = Conv::Direct)
 {
   const int N0 = B.extent(0);
   const int N1 = B.extent(1);
@@ -317,53 +443,49 @@ void conv(const blitz::Array<T,2> A, const blitz::Array<T,2> B,
     throw std::runtime_error(m.str());
   }
 
-  if (size_opt == Conv::Full)
-    detail::convInternal(A, B, C, N0-1, 1, N1-1, 1);
-  else if (size_opt == Conv::Same)
-    detail::convInternal(A, B, C, N0/2, (N0+1)/2, N1/2, (N1+1)/2);
-  else
-    detail::convInternal(A, B, C, 0, N0, 0, N1);
+  const int shift0 = detail::convShift(N0, size_opt);
+  const int shift1 = detail::convShift(N1, size_opt);
+  if (!detail::ConvFFT<T>::conv(A, B, C, shift0, shift1, algorithm))
+    detail::convInternal(A, B, C, shift0, shift1);
 }
 
 namespace detail {
 
   template<typename T> void convSep(const blitz::Array<T,2>& A,
     const blitz::Array<T,1>& b, blitz::Array<T,2>& C,
-    const Conv::SizeOption size_opt = Conv::Full)
+    const Conv::SizeOption size_opt = Conv::Full,
+    const Conv::Algorithm algorithm = Conv::Direct)
   {
-    for (int i=0; i<A.extent(1); ++i)
-    {
-      const blitz::Array<T,1> Arow = A(blitz::Range::all(), i);
-      blitz::Array<T,1> Crow = C(blitz::Range::all(), i);
-      conv(Arow, b, Crow, size_opt);
-    }
+    const int shift = convShift(b.extent(0), size_opt);
+    if (!ConvFFT<T>::convSep(A, b, C, shift, algorithm))
+      convSepInternal(A, b, C, shift);
   }
 
  template<typename T> void convSep(const blitz::Array<T,3>& A,
     const blitz::Array<T,1>& b, blitz::Array<T,3>& C,
-    const Conv::SizeOption size_opt = Conv::Full)
+    const Conv::SizeOption size_opt = Conv::Full,
+    const Conv::Algorithm algorithm = Conv::Direct)
   {
-    for (int i=0; i<A.extent(1); ++i)
-      for (int j=0; j<A.extent(2); ++j)
-      {
-        const blitz::Array<T,1> Arow = A(blitz::Range::all(), i, j);
-        blitz::Array<T,1> Crow = C(blitz::Range::all(), i, j);
-        conv(Arow, b, Crow, size_opt);
-      }
+    for (int k=0; k<A.extent(2); ++k)
+    {
+      const blitz::Array<T,2> Aslice = A(blitz::Range::all(), blitz::Range::all(), k);
+      blitz::Array<T,2> Cslice = C(blitz::Range::all(), blitz::Range::all(), k);
+      convSep(Aslice, b, Cslice, size_opt, algorithm);
+    }
   }
 
   template<typename T> void convSep(const blitz::Array<T,4>& A,
     const blitz::Array<T,1>& b, blitz::Array<T,4>& C,
-    const Conv::SizeOption size_opt = Conv::Full)
+    const Conv::SizeOption size_opt = Conv::Full,
+    const Conv::Algorithm algorithm = Conv::Direct)
   {
-    for (int i=0; i<A.extent(1); ++i)
-      for (int j=0; j<A.extent(2); ++j)
-        for (int k=0; k<A.extent(3); ++k)
-        {
-          const blitz::Array<T,1> Arow = A(blitz::Range::all(), i, j, k);
-          blitz::Array<T,1> Crow = C(blitz::Range::all(), i, j, k);
-          conv(Arow, b, Crow, size_opt);
-        }
+    for (int j=0; j<A.extent(2); ++j)
+      for (int k=0; k<A.extent(3); ++k)
+      {
+        const blitz::Array<T,2> Aslice = A(blitz::Range::all(), blitz::Range::all(), j, k);
+        blitz::Array<T,2> Cslice = C(blitz::Range::all(), blitz::Range::all(), j, k);
+        convSep(Aslice, b, Cslice, size_opt, algorithm);
+      }
   }
 }
 
@@ -377,12 +499,17 @@ namespace detail {
  * @param size_opt:  * Full: full size (default)
  *                   * Same: same size as the largest between A and b
  *                   * Valid: valid (part without padding)
+ * @param algorithm: * Auto: the fastest algorithm given the sizes
+ *                   * Direct: direct computation of the sums (default)
+ *                   * FFT: batched FFT of the zero-padded lines of A
+ *                       (for double arrays only)
  * @warning A should have larger dimensions than the kernel b
  *   The output C should have the correct size
  */
 template<typename T, int N> void convSep(const blitz::Array<T,N>& A,
   const blitz::Array<T,1>& b, blitz::Array<T,N>& C, const size_t dim,
-  const Conv::SizeOption size_opt = Conv::Full)
+  const Conv::SizeOption size_opt = Conv::Full,
+  const Conv::Algorithm algorithm = Conv::Direct)
 {
   // Gets the expected size for the results
   const blitz::TinyVector<int,N> Csize = getConvSepOutputSize(A, b, dim, size_opt);
@@ -401,7 +528,7 @@ template<typename T, int N> void convSep(const blitz::Array<T,N>& A,
       m % A.extent(0) % b.extent(0);
       throw std::runtime_error(m.str());
     }
-    detail::convSep(A, b, C, size_opt);
+    detail::convSep(A, b, C, size_opt, algorithm);
   }
   else if ((int)dim<N)
   {
@@ -416,7 +543,7 @@ template<typename T, int N> void convSep(const blitz::Array<T,N>& A,
     const blitz::Array<T,N> Ap =
       (const_cast<blitz::Array<T,N> *>(&A))->transpose(dim,0);
     blitz::Array<T,N> Cp = C.transpose(dim,0);
-    detail::convSep(Ap, b, Cp, size_opt);
+    detail::convSep(Ap, b, Cp, size_opt, algorithm);
   }
   else {
     boost::format m("Cannot perform a separable convolution along dimension %d. The maximal dimension index for this array is %d. (Please note that indices starts at 0.");
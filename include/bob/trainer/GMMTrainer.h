@@ -28,6 +28,7 @@
 #include <bob/machine/GMMMachine.h>
 #include <bob/machine/GMMStats.h>
 #include <limits>
+#include <vector>
 
 namespace bob { namespace trainer {
 /**
@@ -76,6 +77,11 @@ class GMMTrainer: public EMTrainer<bob::machine::GMMMachine, blitz::Array<double
      * 
      * The statistics, m_ss, will be used in the mStep() that follows.
      * Implements EMTrainer::eStep(double &)
+     *
+     * The dataset is split into shards of consecutive samples, which are
+     * processed by up to getNThreads() threads. The statistics of the
+     * shards are summed in the order of the shards, such that the result
+     * does not depend on the number of threads.
      */
     virtual void eStep(bob::machine::GMMMachine& gmm,
       const blitz::Array<double,2>& data);
@@ -125,6 +131,17 @@ class GMMTrainer: public EMTrainer<bob::machine::GMMMachine, blitz::Array<double
      * E-step
      */
     void setGMMStats(const bob::machine::GMMStats& stats); 
+
+    /**
+     * @brief Returns the number of threads used by the E-step
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
+
+    /**
+     * @brief Sets the number of threads used by the E-step
+     */
+    void setNThreads(const size_t n_threads);
      
   protected:
     /**
@@ -155,6 +172,16 @@ class GMMTrainer: public EMTrainer<bob::machine::GMMMachine, blitz::Array<double
      * because of numerical issue. This threshold is used to avoid such divisions.
      */
     double m_mean_var_update_responsibilities_threshold;
+
+    /**
+     * number of threads used by the E-step
+     */
+    size_t m_n_threads;
+
+  private:
+    /// statistics and workspace of each thread of the E-step
+    std::vector<bob::machine::GMMStats> m_cache_shard_stats;
+    std::vector<bob::machine::GMMWorkspace> m_cache_workspaces;
 };
 
 /**
@@ -78,6 +78,12 @@ class IVectorTrainer: public bob::trainer::EMTrainer<bob::machine::IVectorMachin
      * - m_acc_Snormij (only if update_sigma is enabled)
      * 
      * These statistics will be used in the mStep() that follows.
+     *
+     * The posteriors of the hidden variables are computed in parallel over
+     * the utterances, and the accumulators are updated in parallel over
+     * the Gaussian components, using getNThreads() threads. Each
+     * accumulator sums the utterances in the same order whatever the
+     * number of threads, which gives identical statistics.
      */
     virtual void eStep(bob::machine::IVectorMachine& ivector, 
       const std::vector<bob::machine::GMMStats>& data);
@@ -122,6 +128,34 @@ class IVectorTrainer: public bob::trainer::EMTrainer<bob::machine::IVectorMachin
     bool is_similar_to(const IVectorTrainer& b, const double r_epsilon=1e-5,
       const double a_epsilon=1e-8) const;
 
+    /**
+     * @brief Returns the number of threads used by the eStep()
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
+
+    /**
+     * @brief Sets the number of threads used by the eStep() (0 for the
+     * number of hardware threads)
+     */
+    void setNThreads(const size_t n_threads)
+    { m_n_threads = n_threads; }
+
+    /**
+     * @brief Tells if the posteriors of the eStep() are obtained by a
+     * Cholesky decomposition (rather than by an explicit LU-based inverse)
+     */
+    bool getUseCholesky() const
+    { return m_use_cholesky; }
+
+    /**
+     * @brief Sets if the posteriors of the eStep() are obtained by a
+     * Cholesky decomposition of the (symmetric positive definite) precision
+     * matrices, rather than by an explicit LU-based inverse
+     */
+    void setUseCholesky(const bool use_cholesky)
+    { m_use_cholesky = use_cholesky; }
+
     /**
      * @brief Getters for the accumulators
      */
@@ -154,6 +188,8 @@ class IVectorTrainer: public bob::trainer::EMTrainer<bob::machine::IVectorMachin
   protected:
     // Attributes
     bool m_update_sigma;
+    size_t m_n_threads;
+    bool m_use_cholesky;
 
     // Acccumulators
     blitz::Array<double,3> m_acc_Nij_wij2;
@@ -162,14 +198,8 @@ class IVectorTrainer: public bob::trainer::EMTrainer<bob::machine::IVectorMachin
     blitz::Array<double,2> m_acc_Snormij;
     
     // Working arrays
-    mutable blitz::Array<double,1> m_tmp_wij;
-    mutable blitz::Array<double,2> m_tmp_wij2;
     mutable blitz::Array<double,1> m_tmp_d1;
-    mutable blitz::Array<double,1> m_tmp_t1;
     mutable blitz::Array<double,2> m_tmp_dd1;
-    mutable blitz::Array<double,2> m_tmp_dt1;
-    mutable blitz::Array<double,2> m_tmp_tt1;
-    mutable blitz::Array<double,2> m_tmp_tt2;
 };
 
 /**
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <bob/core/array_copy.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/random.hpp>
@@ -120,13 +121,17 @@ class FABaseTrainer
      */
     void updateY_i(const size_t id);
     /**
-     * @brief Updates y and the accumulators to compute V 
+     * @brief Updates y and the accumulators to compute V, in parallel over
+     * the identities
      */
     void updateY(const bob::machine::FABase& m,
       const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats);
     /**
      * @brief Computes the accumulators m_acc_V_A1 and m_acc_V_A2 for V
      * V = A2 * A1^-1
+     * The statistics of the identities are computed in parallel, and summed
+     * in parallel over the Gaussian components, in the order of the
+     * identities: the accumulators do not depend on the number of threads.
      */
     void computeAccumulatorsV(const bob::machine::FABase& m, 
       const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats);
@@ -163,13 +168,16 @@ class FABaseTrainer
      */
     void updateX_ih(const size_t id, const size_t h);
     /**
-     * @brief Updates x
+     * @brief Updates x, in parallel over the sessions
      */
     void updateX(const bob::machine::FABase& m,
       const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats);
     /**
      * @brief Computes the accumulators m_acc_U_A1 and m_acc_U_A2 for U
      * U = A2 * A1^-1
+     * The statistics of the sessions are computed in parallel, and summed
+     * in parallel over the Gaussian components, in the order of the
+     * sessions: the accumulators do not depend on the number of threads.
      */
     void computeAccumulatorsU(const bob::machine::FABase& m,
       const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats);
@@ -206,13 +214,17 @@ class FABaseTrainer
      */
     void updateZ_i(const size_t id);
     /**
-     * @brief Updates z and the accumulators to compute D
+     * @brief Updates z and the accumulators to compute D, in parallel over
+     * the identities
      */
     void updateZ(const bob::machine::FABase& m,
       const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats);
     /**
      * @brief Computes the accumulators m_acc_D_A1 and m_acc_D_A2 for d
      * d = A2 * A1^-1
+     * The statistics of the identities are computed in parallel, and summed
+     * in parallel over the Gaussian components, in the order of the
+     * identities: the accumulators do not depend on the number of threads.
      */
     void computeAccumulatorsD(const bob::machine::FABase& m,
       const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats);
@@ -307,8 +319,52 @@ class FABaseTrainer
     { bob::core::array::assertSameShape(acc, m_acc_D_A2);
       m_acc_D_A2 = acc; }
 
+    /**
+     * @brief Gets the number of threads of the loops over the identities
+     * and sessions
+     */
+    size_t getNThreads() const
+    { return m_n_threads; }
+    /**
+     * @brief Sets the number of threads of the loops over the identities
+     * and sessions (0 for the number of hardware threads)
+     */
+    void setNThreads(const size_t n_threads)
+    { m_n_threads = n_threads; }
+
 
   private:
+    /**
+     * @brief Computes y_i (if not accumulate) or the statistics of the
+     * accumulators of V (if accumulate) of the identities b0+[begin,end),
+     * the statistics going to the rows [begin,end) of the block arrays.
+     * Called concurrently by the threads: only uses its own working arrays,
+     * and local wrappers of the shared arrays (as the reference counting of
+     * blitz arrays is not thread-safe).
+     */
+    void processV(const bob::machine::FABase& m,
+      const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats,
+      const bool accumulate, const size_t b0, const size_t begin,
+      const size_t end);
+    /**
+     * @brief Computes x_{i,h} or the statistics of the accumulators of U
+     * of the sessions b0+[begin,end) (see processV())
+     */
+    void processU(const bob::machine::FABase& m,
+      const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats,
+      const std::vector<std::pair<size_t,size_t> >& sessions,
+      const bool accumulate, const size_t b0, const size_t begin,
+      const size_t end);
+    /**
+     * @brief Computes z_i or the statistics of the accumulators of d of the
+     * identities b0+[begin,end) (see processV())
+     */
+    void processD(const bob::machine::FABase& m,
+      const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats,
+      const bool accumulate, const size_t b0, const size_t begin,
+      const size_t end);
+
+    size_t m_n_threads; // Number of threads of the loops over the identities and sessions
     size_t m_Nid; // Number of identities 
     size_t m_dim_C; // Number of Gaussian components of the UBM GMM
     size_t m_dim_D; // Dimensionality of the feature space
@@ -355,6 +411,12 @@ class FABaseTrainer
     mutable blitz::Array<double,1> m_tmp_ru;
     mutable blitz::Array<double,1> m_tmp_CD;
     mutable blitz::Array<double,1> m_tmp_CD_b;
+
+    // Statistics of a block of identities (or sessions) for the accumulators
+    blitz::Array<double,2> m_block_A1; // (I+Ut*diag(sigma)^-1*Ni*U)^-1 + x*xt (or the V/d equivalent)
+    blitz::Array<double,2> m_block_Fn; // normalised first order statistics
+    blitz::Array<double,2> m_block_w; // x_{i,h}, y_i or z_i
+    blitz::Array<double,2> m_block_N; // zeroth order statistics
 };
 
 
@@ -558,6 +620,20 @@ class JFATrainer
     void setAccDA2(const blitz::Array<double,1>& acc)
     { m_base_trainer.setAccDA2(acc); }
 
+    /**
+     * @brief Gets the number of threads of the loops over the identities
+     * and sessions
+     */
+    size_t getNThreads() const
+    { return m_base_trainer.getNThreads(); }
+    /**
+     * @brief Sets the number of threads of the loops over the identities
+     * and sessions (0 for the number of hardware threads). The results do
+     * not depend on it.
+     */
+    void setNThreads(const size_t n_threads)
+    { m_base_trainer.setNThreads(n_threads); }
+
 
   private:
     // Attributes
@@ -682,6 +758,20 @@ class ISVTrainer: public EMTrainer<bob::machine::ISVBase, std::vector<std::vecto
     void setAccUA2(const blitz::Array<double,2>& acc)
     { m_base_trainer.setAccUA2(acc); }
 
+    /**
+     * @brief Gets the number of threads of the loops over the identities
+     * and sessions
+     */
+    size_t getNThreads() const
+    { return m_base_trainer.getNThreads(); }
+    /**
+     * @brief Sets the number of threads of the loops over the identities
+     * and sessions (0 for the number of hardware threads). The results do
+     * not depend on it.
+     */
+    void setNThreads(const size_t n_threads)
+    { m_base_trainer.setNThreads(n_threads); }
+
 
   private:
     /**
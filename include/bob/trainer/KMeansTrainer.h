@@ -24,6 +24,7 @@
 #include <bob/machine/KMeansMachine.h>
 #include <bob/trainer/EMTrainer.h>
 #include <boost/version.hpp>
+#include <vector>
 
 namespace bob { namespace trainer {
 /**
@@ -97,6 +98,14 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      */
     virtual std::string name() const { return "KMeansTrainer"; }
    
+    /**
+     * @brief Trains the machine with the EM algorithm. The bounds of the
+     * pruning (if any) are reused between its iterations, and discarded
+     * at the beginning and at the end of the training.
+     */
+    virtual void train(bob::machine::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& data);
+
     /**
      * @brief Initialise the means randomly. 
      * Data is split into as many chunks as there are means, 
@@ -110,6 +119,14 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * - zeroeth and first order statistics
      * - average (Square Euclidean) distance from the closest mean 
      * Implements EMTrainer::eStep(double &)
+     *
+     * The distances of blocks of samples to all the means are computed at
+     * once as \f$|x|^2 - 2x^T\mu + |\mu|^2\f$, with a matrix product.
+     * The means which are close to the smallest of these distances (given
+     * a bound of the round-off errors) are then compared using the exact
+     * distances, such that the closest means and the statistics are the
+     * same as the ones of KMeansMachine::getClosestMean(). The blocks are
+     * processed by getNThreads() threads.
      */
     virtual void eStep(bob::machine::KMeansMachine& kmeans,
       const blitz::Array<double,2>& data);
@@ -149,6 +166,59 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
     const boost::shared_ptr<boost::mt19937> getRng() const
     { return m_rng; }
 
+    /**
+     * @brief Returns the number of threads used by the eStep()
+     */
+    size_t getNThreads() const { return m_n_threads; }
+
+    /**
+     * @brief Sets the number of threads used by the eStep() (0 for the
+     * number of hardware threads). The statistics do not depend on it.
+     */
+    void setNThreads(const size_t n_threads) { m_n_threads = n_threads; }
+
+    /**
+     * @brief Tells if the eStep() skips the samples which cannot change of
+     * closest mean
+     */
+    bool getUsePruning() const { return m_use_pruning; }
+
+    /**
+     * @brief Sets if the eStep() keeps, for each sample, a lower bound of
+     * the distance to the second closest mean (Hamerly, "Making k-means
+     * even faster", 2010). As the means move, the bound decreases by the
+     * largest move, and the samples whose closest mean is still closer than
+     * this bound are not compared to the other means. The closest means are
+     * the same as without pruning.
+     * The bounds are only kept between the iterations of train(), unless
+     * setReuseBounds() is used.
+     */
+    void setUsePruning(const bool use_pruning)
+    { m_use_pruning = use_pruning; m_cache_bounds_valid = false; }
+
+    /**
+     * @brief Tells if eStep() reuses the bounds of the previous call to
+     * eStep(), outside of train()
+     */
+    bool getReuseBounds() const { return m_reuse_bounds; }
+
+    /**
+     * @brief Sets if eStep() reuses the bounds of the previous call to
+     * eStep(), outside of train() (which always reuses them between its
+     * own iterations). This is only correct if the data array given to
+     * both calls is the same and has not been modified in between.
+     * Otherwise, each call to eStep() computes new bounds.
+     */
+    void setReuseBounds(const bool reuse_bounds)
+    { m_reuse_bounds = reuse_bounds; m_cache_bounds_valid = false; }
+
+    /**
+     * @brief Discards the bounds of the previous call to eStep(), for
+     * instance after having modified the data array when setReuseBounds()
+     * is used
+     */
+    void resetCache() { m_cache_bounds_valid = false; }
+
     /**
      * @brief Sets the initialization method used to generate the initial means
      */
@@ -172,6 +242,18 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
     void setFirstOrderStats(const blitz::Array<double,2>& firstOrderStats);
     void setAverageMinDistance(const double value) { m_average_min_distance = value; }
 
+    /**
+     * @brief Returns the index of the closest mean of each sample of the
+     * last call to eStep()
+     */
+    const std::vector<size_t>& getClosestMeans() const { return m_cache_closest; }
+
+    /**
+     * @brief Returns the (square Euclidean) distance of each sample of the
+     * last call to eStep() to its closest mean
+     */
+    const std::vector<double>& getMinDistances() const { return m_cache_min_distance; }
+
 
   protected:
     /**
@@ -184,6 +266,23 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * @brief The random number generator for the inialization
      */
     boost::shared_ptr<boost::mt19937> m_rng;
+
+    /**
+     * @brief The number of threads of the E-step
+     */
+    size_t m_n_threads;
+
+    /**
+     * @brief Whether the E-step skips the samples which cannot change of
+     * closest mean
+     */
+    bool m_use_pruning;
+
+    /**
+     * @brief Whether eStep() reuses the bounds of the previous call to
+     * eStep(), outside of train()
+     */
+    bool m_reuse_bounds;
    
     /**
      * @brief Average min (Square Euclidean) distance
@@ -203,6 +302,20 @@ class KMeansTrainer: public EMTrainer<bob::machine::KMeansMachine, blitz::Array<
      * equation 9.4, Bishop, "Pattern recognition and machine learning", 2006
      */
     blitz::Array<double,2> m_firstOrderStats;
+
+  private:
+    /**
+     * @brief Closest mean, distance to it, and lower bound of the distance
+     * to the other means of each sample, as well as the means and the data
+     * they were computed for (used by the pruning)
+     */
+    std::vector<size_t> m_cache_closest;
+    std::vector<double> m_cache_min_distance;
+    std::vector<double> m_cache_lower_bound;
+    blitz::Array<double,2> m_cache_means;
+    const double* m_cache_data;
+    bool m_cache_bounds_valid;
+    bool m_in_train;
 };
 
 /**
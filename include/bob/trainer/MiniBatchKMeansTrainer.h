@@ -0,0 +1,219 @@
+/**
+ * @file bob/trainer/MiniBatchKMeansTrainer.h
+ * @date Sun Oct 18 14:02:37 2026 +0200
+ *
+ * @brief Mini-batch k-means, for data sets which do not fit in memory
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_TRAINER_MINIBATCHKMEANSTRAINER_H
+#define BOB_TRAINER_MINIBATCHKMEANSTRAINER_H
+
+#include <bob/machine/KMeansMachine.h>
+#include <bob/trainer/KMeansTrainer.h>
+#include <bob/trainer/SampleSource.h>
+#include <bob/trainer/Trainer.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/random.hpp>
+
+namespace bob { namespace trainer {
+/**
+ * @ingroup TRAINER
+ * @{
+ */
+
+/**
+ * @brief Trains a KMeans machine with batches of samples read from a
+ * SampleSource, such that the memory only depends on the size of the
+ * batches and on the number of means.
+ * @details See Sculley, "Web-scale k-means clustering", 2010.
+ * The means are initialized with k-means|| (Bahmani et al., "Scalable
+ * k-means++", 2012), which reads the data a few times by batches. Each
+ * iteration then reads a batch of consecutive samples at a random position,
+ * and moves each mean towards the average of its samples, with a learning
+ * rate which is the inverse of the number of samples it got so far.
+ */
+class MiniBatchKMeansTrainer: public Trainer<bob::machine::KMeansMachine, SampleSource>
+{
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param batch_size The number of samples of the batches
+     * @param max_iterations The maximum number of batches
+     * @param convergence_threshold The training stops once the relative
+     * change of the (exponentially smoothed) average distance of the
+     * samples of the batches to their closest means is below this threshold
+     */
+    MiniBatchKMeansTrainer(const size_t batch_size=1000,
+      const size_t max_iterations=100,
+      const double convergence_threshold=1e-4);
+
+    /**
+     * @brief Copy constructor
+     */
+    MiniBatchKMeansTrainer(const MiniBatchKMeansTrainer& other);
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~MiniBatchKMeansTrainer() {}
+
+    /**
+     * @brief Assignment operator
+     */
+    MiniBatchKMeansTrainer& operator=(const MiniBatchKMeansTrainer& other);
+
+    /**
+     * @brief Equal to
+     */
+    bool operator==(const MiniBatchKMeansTrainer& b) const;
+
+    /**
+     * @brief Not equal to
+     */
+    bool operator!=(const MiniBatchKMeansTrainer& b) const;
+
+    /**
+     * @brief Initializes the means with k-means||, and resets the counts
+     * of the samples of the means. The data is read getNRounds()+2 times.
+     */
+    void initialize(bob::machine::KMeansMachine& kmeans,
+      const SampleSource& source);
+
+    /**
+     * @brief Updates the means given a batch of samples
+     */
+    void step(bob::machine::KMeansMachine& kmeans,
+      const blitz::Array<double,2>& batch);
+
+    /**
+     * @brief Initializes the means and updates them with batches of samples
+     * until convergence
+     */
+    virtual void train(bob::machine::KMeansMachine& kmeans,
+      const SampleSource& source);
+
+    /**
+     * @brief Returns the number of samples of the batches
+     */
+    size_t getBatchSize() const { return m_batch_size; }
+
+    /**
+     * @brief Sets the number of samples of the batches
+     */
+    void setBatchSize(const size_t batch_size);
+
+    /**
+     * @brief Returns the maximum number of batches of train()
+     */
+    size_t getMaxIterations() const { return m_max_iterations; }
+
+    /**
+     * @brief Sets the maximum number of batches of train()
+     */
+    void setMaxIterations(const size_t max_iterations)
+    { m_max_iterations = max_iterations; }
+
+    /**
+     * @brief Returns the convergence threshold of train()
+     */
+    double getConvergenceThreshold() const { return m_convergence_threshold; }
+
+    /**
+     * @brief Sets the convergence threshold of train()
+     */
+    void setConvergenceThreshold(const double threshold)
+    { m_convergence_threshold = threshold; }
+
+    /**
+     * @brief Returns the number of sampling rounds of k-means||
+     */
+    size_t getNRounds() const { return m_n_rounds; }
+
+    /**
+     * @brief Sets the number of sampling rounds of k-means||
+     */
+    void setNRounds(const size_t n_rounds) { m_n_rounds = n_rounds; }
+
+    /**
+     * @brief Returns the oversampling factor of k-means||, i.e. the
+     * expected number of candidate means per round divided by the number
+     * of means
+     */
+    double getOversamplingFactor() const { return m_oversampling_factor; }
+
+    /**
+     * @brief Sets the oversampling factor of k-means||
+     */
+    void setOversamplingFactor(const double factor);
+
+    /**
+     * @brief Returns the number of threads used to find the closest means
+     */
+    size_t getNThreads() const { return m_trainer.getNThreads(); }
+
+    /**
+     * @brief Sets the number of threads used to find the closest means (0
+     * for the number of hardware threads)
+     */
+    void setNThreads(const size_t n_threads)
+    { m_trainer.setNThreads(n_threads); }
+
+    /**
+     * @brief Returns the number of samples each mean got so far
+     */
+    const blitz::Array<double,1>& getCounts() const { return m_counts; }
+
+    /**
+     * @brief Returns the average (square Euclidean) distance of the samples
+     * of the last batch given to step() to their closest mean (before the
+     * update of the means)
+     */
+    double getAverageMinDistance() const { return m_average_min_distance; }
+
+    /**
+     * @brief Sets the Random Number Generator
+     */
+    void setRng(const boost::shared_ptr<boost::mt19937> rng)
+    { m_rng = rng; }
+
+    /**
+     * @brief Gets the Random Number Generator
+     */
+    const boost::shared_ptr<boost::mt19937> getRng() const
+    { return m_rng; }
+
+  private:
+    size_t m_batch_size;
+    size_t m_max_iterations;
+    double m_convergence_threshold;
+    size_t m_n_rounds;
+    double m_oversampling_factor;
+    boost::shared_ptr<boost::mt19937> m_rng;
+
+    KMeansTrainer m_trainer; ///< finds the closest means of the batches
+    blitz::Array<double,1> m_counts;
+    double m_average_min_distance;
+    blitz::Array<double,2> m_cache_batch;
+};
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_TRAINER_MINIBATCHKMEANSTRAINER_H */
@@ -0,0 +1,129 @@
+/**
+ * @file bob/trainer/SampleSource.h
+ * @date Sun Oct 18 14:02:37 2026 +0200
+ *
+ * @brief Sources of samples which are read by blocks, such that trainers
+ * may process data sets which do not fit in memory
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOB_TRAINER_SAMPLESOURCE_H
+#define BOB_TRAINER_SAMPLESOURCE_H
+
+#include <string>
+#include <blitz/array.h>
+#include <boost/shared_ptr.hpp>
+#include <bob/io/HDF5File.h>
+
+namespace bob { namespace trainer {
+/**
+ * @ingroup TRAINER
+ * @{
+ */
+
+/**
+ * @brief A source of samples of the same dimensionality, which are read by
+ * ranges of consecutive samples
+ */
+class SampleSource
+{
+  public:
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~SampleSource() {}
+
+    /**
+     * @brief Returns the number of samples
+     */
+    virtual size_t size() const = 0;
+
+    /**
+     * @brief Returns the dimensionality of the samples
+     */
+    virtual size_t getNInputs() const = 0;
+
+    /**
+     * @brief Reads the samples [begin, begin+samples.extent(0)) into the
+     * rows of samples, whose number of columns must be getNInputs()
+     */
+    virtual void read(const size_t begin, blitz::Array<double,2>& samples) const = 0;
+};
+
+/**
+ * @brief A source of samples stored in the rows of an array in memory
+ */
+class ArraySampleSource: public SampleSource
+{
+  public:
+    /**
+     * @brief Constructor. The array is referenced, not copied.
+     */
+    ArraySampleSource(const blitz::Array<double,2>& data);
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~ArraySampleSource() {}
+
+    virtual size_t size() const { return m_data.extent(0); }
+    virtual size_t getNInputs() const { return m_data.extent(1); }
+    virtual void read(const size_t begin, blitz::Array<double,2>& samples) const;
+
+  private:
+    blitz::Array<double,2> m_data;
+};
+
+/**
+ * @brief A source of samples stored in a dataset of an HDF5 file, one
+ * (1D) array per position (as written by HDF5File::appendArray()). Only the
+ * samples which are read are loaded in memory, each call to read() reading a
+ * single hyperslab of the dataset.
+ */
+class HDF5SampleSource: public SampleSource
+{
+  public:
+    /**
+     * @brief Constructor
+     *
+     * @param file The HDF5 file
+     * @param path The path of the dataset in the file
+     */
+    HDF5SampleSource(boost::shared_ptr<bob::io::HDF5File> file,
+      const std::string& path);
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~HDF5SampleSource() {}
+
+    virtual size_t size() const { return m_size; }
+    virtual size_t getNInputs() const { return m_n_inputs; }
+    virtual void read(const size_t begin, blitz::Array<double,2>& samples) const;
+
+  private:
+    boost::shared_ptr<bob::io::HDF5File> m_file;
+    std::string m_path;
+    size_t m_size;
+    size_t m_n_inputs;
+};
+
+/**
+ * @}
+ */
+}}
+
+#endif /* BOB_TRAINER_SAMPLESOURCE_H */
@@ -462,3 +462,47 @@ class CepsTest(unittest.TestCase):
     self.assertFalse(c0 != c1)
     self.assertFalse(c0 == c2)
     self.assertTrue( c0 != c2)
+
+  def test_cepstral_stream(self):
+    import pkg_resources
+    rate_wavsample = _read(pkg_resources.resource_filename(__name__, os.path.join('data', 'sample.wav')))
+    signal = rate_wavsample[1].astype('float64')
+
+    configurations = [(20, 10, True, True, True, 2), (25, 10, True, True, False, 3),
+                      (20, 10, False, False, False, 2), (10, 15, True, True, True, 1)]
+    for (win_length_ms, win_shift_ms, with_energy, with_delta, with_delta_delta, delta_win) in configurations:
+      c = bob.ap.Ceps(rate_wavsample[0], win_length_ms, win_shift_ms, 24, 19, 0., 4000., delta_win, 0.97, True, True)
+      c.with_energy = with_energy
+      c.with_delta = with_delta
+      c.with_delta_delta = with_delta_delta
+      reference = c(signal)
+
+      s = bob.ap.CepsStream(c)
+      self.assertEqual(s.n_features, reference.shape[1])
+      self.assertEqual(s.lookahead, delta_win * (int(with_delta) + int(with_delta_delta)))
+
+      # Pushes chunks of varying sizes, and checks the latency
+      features = []
+      start = 0
+      chunk_sizes = [1, 7, 160, 1000, 33, 4096]
+      k = 0
+      while start < len(signal):
+        chunk = signal[start:start+chunk_sizes[k % len(chunk_sizes)]]
+        start += len(chunk)
+        k += 1
+        s.push(chunk)
+        self.assertEqual(s.n_ready_frames + sum([f.shape[0] for f in features]), max(0, s.n_frames - s.lookahead))
+        features.append(s.read())
+      s.finish()
+      features.append(s.read())
+      self.assertEqual(s.n_ready_frames, 0)
+
+      features = numpy.vstack(features)
+      self.assertEqual(features.shape, reference.shape)
+      self.assertTrue(numpy.allclose(features, reference, rtol=1e-10, atol=1e-10))
+
+      # A new stream gives the same features
+      s.reset()
+      s.push(signal)
+      s.finish()
+      self.assertTrue(numpy.allclose(s.read(), reference, rtol=1e-10, atol=1e-10))
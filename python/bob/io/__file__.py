@@ -27,3 +27,16 @@ def file_iter(self):
   raise StopIteration
 File.__iter__ = file_iter
 del file_iter
+
+def file_enter(self):
+  """Allows Files to be used in with statements"""
+  return self
+File.__enter__ = file_enter
+del file_enter
+
+def file_exit(self, exc_type, exc_value, traceback):
+  """Writes the buffered arrays at the end of with statements, raising the
+  errors of the writing"""
+  if exc_type is None: self.flush()
+File.__exit__ = file_exit
+del file_exit
@@ -153,7 +153,10 @@ def append(array, filename):
   filename
     The name of the file where you need the contents saved to
   """
-  return File(filename, 'a').append(array)
+  f = File(filename, 'a')
+  retval = f.append(array)
+  f.flush() #raises the errors of the writing, unlike the destruction
+  return retval
 
 def peek(filename):
   """Returns the type of array (frame or sample) saved in the given file.
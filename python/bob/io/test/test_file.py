@@ -26,7 +26,7 @@ import sys
 import numpy
 import nose.tools
 
-from .. import load, write, File
+from .. import load, write, File, open_hdf5
 from ...test import utils as testutils
 
 def transcode(filename):
@@ -123,6 +123,30 @@ def test_hdf5():
   transcode(testutils.datafile('matlab_1d.hdf5', __name__))
   transcode(testutils.datafile('matlab_2d.hdf5', __name__))
 
+def test_hdf5_buffered_append():
+
+  arrays = [numpy.random.normal(size=(20,)) for k in range(100)]
+  tmpname = testutils.temporary_filename(suffix='.hdf5')
+  try:
+    # explicit flush of the write-behind buffer
+    f = open_hdf5(tmpname, 'w', chunk_size=1024, buffer_size=4096)
+    for k in arrays: f.append(k)
+    f.flush()
+    nose.tools.eq_(len(f), len(arrays))
+    del f
+    reloaded = File(tmpname, 'r').read()
+    assert numpy.array_equal(numpy.vstack(arrays), reloaded)
+
+    # flush at the end of a with statement
+    with open_hdf5(tmpname, 'w', buffer_size=4096) as f:
+      for k in arrays: f.append(k)
+    del f
+    for k, array in enumerate(arrays):
+      assert numpy.array_equal(array, File(tmpname, 'r').read(k))
+
+  finally:
+    if os.path.exists(tmpname): os.unlink(tmpname)
+
 @testutils.extension_available('.bindata')
 def test_torch3_binary():
 
@@ -231,6 +255,40 @@ def test_tensorfile():
   # complete transcoding test
   transcode(testutils.datafile('torch.tensor', __name__))
 
+@testutils.extension_available('.mtensor')
+def test_mapped_tensorfile():
+
+  vectors = [numpy.random.normal(size=(7,)).astype('float32') for k in range(5)]
+  matrices = [numpy.random.normal(size=(3,4)).astype('float32') for k in range(5)]
+
+  tmpname = testutils.temporary_filename(suffix='.tensor')
+  try:
+    f = File(tmpname, 'w')
+    for k in vectors: f.append(k)
+    del f
+
+    # vectors refer to the mapped pages (read-only), even after closing
+    f = File(tmpname, 'r', '.mtensor')
+    assert f.codec_name == 'bob.tensor.mapped'
+    reloaded = [f.read(k) for k in range(len(vectors))]
+    del f
+    for array, mapped in zip(vectors, reloaded):
+      assert not mapped.flags.writeable
+      assert numpy.array_equal(array, mapped)
+
+    nose.tools.assert_raises(RuntimeError, File, tmpname, 'a', '.mtensor')
+
+    # column-major matrices are copied
+    f = File(tmpname, 'w')
+    for k in matrices: f.append(k)
+    del f
+    f = File(tmpname, 'r', '.mtensor')
+    for k, array in enumerate(matrices):
+      assert numpy.array_equal(array, f.read(k))
+
+  finally:
+    if os.path.exists(tmpname): os.unlink(tmpname)
+
 @testutils.extension_available('.pgm')
 @testutils.extension_available('.pbm')
 @testutils.extension_available('.ppm')
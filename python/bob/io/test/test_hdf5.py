@@ -420,3 +420,24 @@ def test_append_compression():
   finally:
 
     os.unlink(tmpname)
+
+def test_compression_filters():
+
+  try:
+
+    tmpname = testutils.temporary_filename()
+    outfile = HDF5File(tmpname, 'w', cache_size=4*1024*1024, cache_slots=521)
+    outfile.shuffle = True
+    assert outfile.shuffle
+    data = numpy.random.random((50,50))
+    for k in range(len(data)): outfile.append('data', data[k], compression=6)
+    outfile.fast_compression = True
+    outfile.set('fast', data, compression=1)
+    outfile.set_chunk_cache('data', 1024*1024, 101)
+    assert numpy.array_equal(data[7], outfile.lread('data', 7))
+    assert numpy.array_equal(data, outfile.read('data'))
+    assert numpy.array_equal(data, outfile.read('fast'))
+
+  finally:
+
+    os.unlink(tmpname)
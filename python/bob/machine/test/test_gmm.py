@@ -229,3 +229,100 @@ class GMMMachineTest(unittest.TestCase):
     # implementation
     matlab_ll_ref = -2.361583051672024e+02
     self.assertTrue( abs(gmm(data) - matlab_ll_ref) < 1e-10)
+
+  def test05_GMMMachine(self):
+    # Test a GMMMachine (block log-likelihood computation)
+
+    numpy.random.seed(0)
+    n_gaussians = 17
+    n_inputs = 23
+    gmm = bob.machine.GMMMachine(n_gaussians, n_inputs)
+    weights = numpy.random.uniform(0.1, 1., (n_gaussians,))
+    gmm.weights = weights / weights.sum()
+    gmm.means = numpy.random.normal(0., 2., (n_gaussians, n_inputs))
+    gmm.variances = numpy.random.uniform(0.5, 3., (n_gaussians, n_inputs))
+
+    # More samples than a single block, and a last incomplete block
+    data = numpy.random.normal(0., 3., (150, n_inputs))
+    ll = gmm.log_likelihood(data)
+    self.assertEqual(ll.shape, (150,))
+    for t in range(data.shape[0]):
+      self.assertTrue( abs(ll[t] - gmm.log_likelihood(data[t,:])) < 1e-10 * abs(ll[t]) )
+
+    # Compares with the reference log-likelihood on a single sample
+    data = bob.io.load(F('data.hdf5'))
+    gmm = bob.machine.GMMMachine(2, 50)
+    gmm.weights   = bob.io.load(F('weights.hdf5'))
+    gmm.means     = bob.io.load(F('means.hdf5'))
+    gmm.variances = bob.io.load(F('variances.hdf5'))
+    matlab_ll_ref = -2.361583051672024e+02
+    ll = gmm.log_likelihood(data.reshape((1,50)))
+    self.assertTrue( abs(ll[0] - matlab_ll_ref) < 1e-10)
+
+  def test06_GMMSelector(self):
+    # Test the Gaussian selection of a GMMMachine
+
+    numpy.random.seed(1)
+    n_gaussians = 32
+    n_inputs = 5
+    gmm = bob.machine.GMMMachine(n_gaussians, n_inputs)
+    weights = numpy.random.uniform(0.1, 1., (n_gaussians,))
+    gmm.weights = weights / weights.sum()
+    gmm.means = numpy.random.normal(0., 4., (n_gaussians, n_inputs))
+    gmm.variances = numpy.random.uniform(0.5, 2., (n_gaussians, n_inputs))
+    data = numpy.random.normal(0., 4., (200, n_inputs))
+
+    stats_ref = bob.machine.GMMStats(n_gaussians, n_inputs)
+    gmm.acc_statistics(data, stats_ref)
+
+    # Selecting all the components gives the exact statistics
+    selector = bob.machine.GMMSelector(n_gaussians)
+    self.assertEqual(selector.n_clusters, 0)
+    stats = bob.machine.GMMStats(n_gaussians, n_inputs)
+    gmm.acc_statistics(data, stats, selector)
+    self.assertTrue(stats.is_similar_to(stats_ref, 1e-8, 1e-10))
+
+    # ... and so does evaluating the members of all the clusters
+    selector = bob.machine.GMMSelector(gmm, n_gaussians, 4, 4)
+    self.assertEqual(selector.n_clusters, 4)
+    self.assertEqual(selector.cluster_indices.shape, (n_gaussians,))
+    self.assertEqual(selector.cluster_machine.shape, (4, n_inputs))
+    stats = bob.machine.GMMStats(n_gaussians, n_inputs)
+    gmm.acc_statistics(data, stats, selector)
+    self.assertTrue(stats.is_similar_to(stats_ref, 1e-8, 1e-10))
+
+    # The n_top selected components are the most likely ones
+    selector = bob.machine.GMMSelector(3)
+    ll = numpy.ndarray((n_gaussians,), numpy.float64)
+    for t in range(10):
+      gmm.log_likelihood(data[t,:], ll)
+      selection = selector.select(gmm, data[t,:])
+      self.assertTrue( (selection == numpy.argsort(-ll)[:3]).all() )
+
+    # Only the selected components are updated
+    stats = bob.machine.GMMStats(n_gaussians, n_inputs)
+    gmm.acc_statistics(data[0,:], stats, selector)
+    selection = selector.select(gmm, data[0,:])
+    self.assertEqual(numpy.count_nonzero(stats.n), 3)
+    self.assertTrue( (stats.n[selection] > 0).all() )
+    self.assertTrue( abs(stats.n.sum() - 1.) < 1e-10 )
+    self.assertTrue( stats.log_likelihood <= gmm.log_likelihood(data[0,:]) )
+
+    # Clustered selection with few clusters is a close approximation
+    selector = bob.machine.GMMSelector(gmm, 8, 8, 3)
+    stats = bob.machine.GMMStats(n_gaussians, n_inputs)
+    gmm.acc_statistics(data, stats, selector)
+    self.assertEqual(stats.t, stats_ref.t)
+    self.assertTrue( abs(stats.log_likelihood - stats_ref.log_likelihood) < 5e-2 * abs(stats_ref.log_likelihood) )
+
+    # Invalid parameters
+    self.assertRaises(RuntimeError, bob.machine.GMMSelector, 0)
+    self.assertRaises(RuntimeError, selector.cluster, gmm, n_gaussians+1, 1)
+
+    # A selector clustered for another GMM cannot be used
+    larger = bob.machine.GMMMachine(2*n_gaussians, n_inputs)
+    larger.means = numpy.random.normal(0., 4., (2*n_gaussians, n_inputs))
+    selector = bob.machine.GMMSelector(larger, 8, 8, 3)
+    self.assertRaises(RuntimeError, selector.select, gmm, data[0,:])
+    self.assertRaises(RuntimeError, gmm.acc_statistics, data, stats, selector)
+    self.assertRaises(RuntimeError, selector.cluster, gmm, 4, 5)
@@ -166,3 +166,34 @@ class IVectorTests(unittest.TestCase):
     wij = mc.forward(gs)
     self.assertTrue(numpy.allclose(wij_ref, wij, 1e-5))
 
+  def test02_forward_batch(self):
+    # Ubm
+    ubm = bob.machine.GMMMachine(2,3)
+    ubm.weights = numpy.array([0.4,0.6])
+    ubm.means = numpy.array([[1.,7,4],[4,5,3]])
+    ubm.variances = numpy.array([[0.5,1.,1.5],[1.,1.5,2.]])
+
+    # IVector
+    m = bob.machine.IVectorMachine(ubm, 2)
+    m.t = numpy.array([[1.,2],[4,1],[0,3],[5,8],[7,10],[11,1]])
+    m.sigma = numpy.array([1.,2.,1.,3.,2.,4.])
+
+    # Random GMMStats
+    numpy.random.seed(0)
+    data = []
+    for i in range(11):
+      gs = bob.machine.GMMStats(2,3)
+      gs.t = 5
+      gs.n = numpy.random.uniform(0.1, 3., (2,))
+      gs.sum_px = numpy.random.normal(0., 3., (2,3))
+      gs.sum_pxx = numpy.random.normal(0., 3., (2,3))
+      data.append(gs)
+
+    # The batch extraction should match the one of each utterance, whatever
+    # the number of threads
+    ref = numpy.vstack([m.forward(gs) for gs in data])
+    for n_threads in (1, 3, 0):
+      wij = m.forward(data, n_threads)
+      self.assertEqual(wij.shape, (11, 2))
+      self.assertTrue(numpy.allclose(ref, wij, 1e-10, 1e-12))
+
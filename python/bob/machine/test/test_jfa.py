@@ -384,3 +384,67 @@ class FATest(unittest.TestCase):
 
     # Clean-up
     os.unlink(filename)
+
+  def test05_BatchScoring(self):
+
+    # Creates a UBM
+    weights = numpy.array([0.4, 0.6], 'float64')
+    means = numpy.array([[1, 6, 2], [4, 3, 2]], 'float64')
+    variances = numpy.array([[1, 2, 1], [2, 1, 2]], 'float64')
+    ubm = bob.machine.GMMMachine(2,3)
+    ubm.weights = weights
+    ubm.means = means
+    ubm.variances = variances
+
+    U = numpy.array([[1, 2], [3, 4], [5, 6], [7, 8], [9, 10], [11, 12]], 'float64')
+    V = numpy.array([[6, 5], [4, 3], [2, 1], [1, 2], [3, 4], [5, 6]], 'float64')
+    d = numpy.array([0, 1, 0, 1, 0, 1], 'float64')
+    jfa_base = bob.machine.JFABase(ubm,2,2)
+    jfa_base.u = U
+    jfa_base.v = V
+    jfa_base.d = d
+    isv_base = bob.machine.ISVBase(ubm,2)
+    isv_base.u = U
+    isv_base.d = d
+
+    # Defines several models and probes (one of them without any frame)
+    numpy.random.seed(0)
+    y = numpy.random.randn(3,2)
+    z = numpy.random.randn(3,6)
+    probes = []
+    for i in range(7):
+      gs = bob.machine.GMMStats(2,3)
+      if i != 4:
+        gs.t = 10
+        gs.n = numpy.random.rand(2) * 5.
+        gs.sum_px = numpy.random.randn(2,3) * 3.
+      probes.append(gs)
+
+    # JFA: compares with the scores of each JFAMachine
+    eps = 1e-10
+    scores = jfa_base.compute_scores(y, z, probes)
+    self.assertEqual(scores.shape, (3,7))
+    for k in range(3):
+      m = bob.machine.JFAMachine(jfa_base)
+      m.y = y[k,:]
+      m.z = z[k,:]
+      for p in range(7):
+        self.assertTrue( abs(scores[k,p] - m.forward(probes[p])) < eps )
+    ux = jfa_base.estimate_ux(probes)
+    self.assertEqual(ux.shape, (7,6))
+    self.assertTrue( numpy.allclose(jfa_base.compute_scores(y, z, probes, ux), scores, eps) )
+    self.assertTrue( numpy.allclose(jfa_base.compute_scores(y, z, probes, n_threads=3), scores, eps) )
+
+    # ISV: compares with the scores of each ISVMachine
+    scores = isv_base.compute_scores(z, probes)
+    self.assertEqual(scores.shape, (3,7))
+    for k in range(3):
+      m = bob.machine.ISVMachine(isv_base)
+      m.z = z[k,:]
+      for p in range(7):
+        self.assertTrue( abs(scores[k,p] - m.forward(probes[p])) < eps )
+        ux_p = numpy.ndarray((6,), numpy.float64)
+        m.estimate_ux(probes[p], ux_p)
+        self.assertTrue( numpy.allclose(ux[p,:], ux_p, eps) )
+    self.assertTrue( numpy.allclose(isv_base.compute_scores(z, probes, ux), scores, eps) )
+    self.assertTrue( numpy.allclose(isv_base.compute_scores(z, probes, n_threads=0), scores, eps) )
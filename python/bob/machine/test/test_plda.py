@@ -571,3 +571,40 @@ class PLDAMachineTest(unittest.TestCase):
     # and [x3] separately
     llr_ref = -4.43695386675
     self.assertTrue(abs((llX - (llY + llZ)) - llr_ref) < 1e-10)
+
+  def test06_plda_base_log_likelihood_ratios(self):
+    # Defines base machine
+    sigma = numpy.ndarray(C_dim_d, 'float64')
+    sigma.fill(0.01)
+    mu = numpy.random.randn(C_dim_d)
+    mb = bob.machine.PLDABase(C_dim_d, C_dim_f, C_dim_g)
+    mb.mu = mu
+    mb.f = C_F
+    mb.g = C_G
+    mb.sigma = sigma
+
+    # Enrols models with different numbers of samples (the models with 0
+    # samples are left as constructed, and are scored through gamma_0)
+    t = bob.trainer.PLDATrainer()
+    machines = []
+    for n in [1, 3, 0, 1, 2, 3, 0, 5]:
+      m = bob.machine.PLDAMachine(mb)
+      if n > 0: t.enrol(m, numpy.random.randn(n, C_dim_d))
+      machines.append(m)
+    # The weighted sum of a model without samples must be ignored: random
+    # values are passed instead of the (uninitialized) one of the machine
+    weighted_sums = numpy.vstack([m.weighted_sum if m.n_samples > 0 else
+      numpy.random.randn(C_dim_f) for m in machines])
+    n_samples = numpy.array([m.n_samples for m in machines], 'uint64')
+
+    # Scores computed by the machines (one probe at a time)
+    probes = numpy.random.randn(300, C_dim_d)
+    scores_ref = numpy.array([[m.forward(p) for p in probes] for m in machines])
+
+    scores = mb.compute_log_likelihood_ratios(weighted_sums, n_samples, probes)
+    self.assertEqual(scores.shape, (len(machines), probes.shape[0]))
+    self.assertTrue(numpy.allclose(scores, scores_ref, rtol=1e-8, atol=1e-8))
+    # The scores do not depend on the number of threads
+    for n_threads in [2, 3, 0]:
+      scores_t = mb.compute_log_likelihood_ratios(weighted_sums, n_samples, probes, n_threads)
+      self.assertTrue((scores_t == scores).all())
@@ -71,6 +71,42 @@ def split_four_column(filename):
 
   return (numpy.array(neg, numpy.float64), numpy.array(pos, numpy.float64))
 
+def _accumulate(filename, accumulator, chunk_size, n_columns, claimed, real):
+  """Adds the scores of a score file with n_columns columns to an
+  accumulator, by chunks of chunk_size scores"""
+
+  neg = []
+  pos = []
+  for i, l in enumerate(open(filename, 'rt')):
+    s = l.strip()
+    if len(s) == 0 or s[0] == '#': continue #empty or comment
+    field = s.split()
+    if len(field) < n_columns:
+      raise SyntaxError('Line %d of file "%s" is invalid: %s' % (i, filename, l))
+    try:
+      score = float(field[n_columns-1])
+    except:
+      raise SyntaxError('Cannot convert score to float at line %d of file "%s": %s' % (i, filename, l))
+    if field[claimed] == field[real]: pos.append(score)
+    else: neg.append(score)
+    if len(neg) + len(pos) >= chunk_size:
+      accumulator.add(numpy.array(neg, numpy.float64), numpy.array(pos, numpy.float64))
+      neg = []
+      pos = []
+
+  accumulator.add(numpy.array(neg, numpy.float64), numpy.array(pos, numpy.float64))
+  return accumulator
+
+def accumulate_four_column(filename, accumulator, chunk_size=100000):
+  """Adds the scores of a file in the 4 column format (see four_column()) to
+  a ScoreAccumulator, by chunks of chunk_size scores, such that the scores
+  of the file are never all in memory.
+
+  Returns the accumulator.
+  """
+
+  return _accumulate(filename, accumulator, chunk_size, 4, 0, 1)
+
 def cmc_four_column(filename):
   """Loads scores to compute CMC curves from a file in four column format.
   The four column file needs to be in the same format as described in the four_column function,
@@ -184,6 +220,16 @@ def split_five_column(filename):
 
   return (numpy.array(neg, numpy.float64), numpy.array(pos, numpy.float64))
 
+def accumulate_five_column(filename, accumulator, chunk_size=100000):
+  """Adds the scores of a file in the 5 column format (see five_column()) to
+  a ScoreAccumulator, by chunks of chunk_size scores, such that the scores
+  of the file are never all in memory.
+
+  Returns the accumulator.
+  """
+
+  return _accumulate(filename, accumulator, chunk_size, 5, 0, 2)
+
 def cmc_five_column(filename):
   """Loads scores to compute CMC curves from a file in five column format.
   The four column file needs to be in the same format as described in the five_column function,
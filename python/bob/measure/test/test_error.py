@@ -22,6 +22,7 @@
 
 import os, sys
 import unittest
+import tempfile
 import numpy
 import bob
 import pkg_resources
@@ -180,6 +181,31 @@ class ErrorTest(unittest.TestCase):
     ccn = count(bob.measure.correctly_classified_negatives(negatives,threshold2))
     self.assertEqual(ccp, ccn)
 
+  def test03b_exact_thresholds(self):
+
+    # The exact thresholds are not worse than the ones of the recursive
+    # search, and separate the separable sets
+    positives = bob.io.load(F('linsep-positives.hdf5'))
+    negatives = bob.io.load(F('linsep-negatives.hdf5'))
+    threshold = bob.measure.exact_eer_threshold(negatives, positives)
+    self.assertEqual(bob.measure.farfrr(negatives, positives, threshold), (0., 0.))
+    threshold = bob.measure.exact_min_weighted_error_rate_threshold(negatives, positives, 0.3)
+    self.assertEqual(bob.measure.farfrr(negatives, positives, threshold), (0., 0.))
+
+    positives = bob.io.load(F('nonsep-positives.hdf5'))
+    negatives = bob.io.load(F('nonsep-negatives.hdf5'))
+    far, frr = bob.measure.farfrr(negatives, positives, bob.measure.eer_threshold(negatives, positives))
+    far_e, frr_e = bob.measure.farfrr(negatives, positives, bob.measure.exact_eer_threshold(negatives, positives))
+    self.assertTrue( abs(far_e - frr_e) <= abs(far - frr) )
+    for cost in (0.1, 0.5, 0.9):
+      far, frr = bob.measure.farfrr(negatives, positives, bob.measure.min_weighted_error_rate_threshold(negatives, positives, cost))
+      far_e, frr_e = bob.measure.farfrr(negatives, positives, bob.measure.exact_min_weighted_error_rate_threshold(negatives, positives, cost))
+      self.assertTrue( cost*far_e + (1-cost)*frr_e <= cost*far + (1-cost)*frr + 1e-12 )
+      # no score gives a lower weighted error
+      for t in numpy.hstack((negatives, positives)):
+        far_t, frr_t = bob.measure.farfrr(negatives, positives, t)
+        self.assertTrue( cost*far_e + (1-cost)*frr_e <= cost*far_t + (1-cost)*frr_t + 1e-12 )
+
   def test04_plots(self):
 
     # This test set is not separable.
@@ -307,4 +333,90 @@ class ErrorTest(unittest.TestCase):
     self.assertAlmostEqual(cllr, 3.61833457)
     self.assertAlmostEqual(min_cllr, 0.337364136)
 
+  def test08_score_accumulators(self):
 
+    positives = bob.io.load(F('nonsep-positives.hdf5'))
+    negatives = bob.io.load(F('nonsep-negatives.hdf5'))
+    far_list = numpy.array([0.01, 0.05, 0.1, 0.5])
+
+    # a few scores in memory, such that the accumulator writes sorted runs
+    acc = bob.measure.ExactScoreAccumulator(run_size=50)
+    for k in range(0, max(len(negatives), len(positives)), 37):
+      acc.add(negatives[k:k+37], positives[k:k+37])
+    self.assertTrue(acc.n_runs > 0)
+    self.assertEqual(acc.n_negatives, len(negatives))
+    self.assertEqual(acc.n_positives, len(positives))
+    self.assertEqual(acc.min, min(negatives.min(), positives.min()))
+    self.assertEqual(acc.max, max(negatives.max(), positives.max()))
+
+    # same results as the functions on all the scores
+    def check_exact(acc):
+      for t in (-1., 0., 0.5, 3.):
+        self.assertEqual(acc.farfrr(t), bob.measure.farfrr(negatives, positives, t))
+      self.assertEqual(acc.eer_threshold(), bob.measure.exact_eer_threshold(negatives, positives))
+      self.assertEqual(acc.min_weighted_error_rate_threshold(0.3), bob.measure.exact_min_weighted_error_rate_threshold(negatives, positives, 0.3))
+      self.assertTrue( numpy.array_equal(acc.roc(100), bob.measure.roc(negatives, positives, 100)) )
+      self.assertTrue( numpy.array_equal(acc.det(100), bob.measure.det(negatives, positives, 100)) )
+      self.assertTrue( numpy.allclose(acc.roc_for_far(far_list), bob.measure.roc_for_far(negatives, positives, far_list), atol=1e-15) )
+    check_exact(acc)
+
+    # merges the accumulators of two halves, one of them saved into a file
+    first = bob.measure.ExactScoreAccumulator(run_size=50)
+    first.add(negatives[:25], positives[:30])
+    second = bob.measure.ExactScoreAccumulator(run_size=50)
+    second.add(negatives[25:], positives[30:])
+    fd, filename = tempfile.mkstemp(".hdf5")
+    os.close(fd)
+    second.save(bob.io.HDF5File(filename, 'w'))
+    first.merge(bob.measure.ExactScoreAccumulator(bob.io.HDF5File(filename)))
+    check_exact(first)
+    os.unlink(filename)
+
+    # the smallest runs are merged beyond 64 runs of each kind
+    acc = bob.measure.ExactScoreAccumulator(run_size=1)
+    acc.add(negatives, positives)
+    self.assertTrue(acc.n_runs <= 128)
+    check_exact(acc)
+    acc.merge(acc)
+    self.assertTrue(acc.n_runs <= 128)
+    self.assertEqual(acc.n_negatives, 2 * len(negatives))
+
+    # the error rates of the histograms are exact at the edges of the bins
+    low = min(negatives.min(), positives.min())
+    high = max(negatives.max(), positives.max())
+    hist = bob.measure.HistogramScoreAccumulator(low, high, 1000)
+    hist.add(negatives, positives)
+    self.assertEqual(hist.negative_counts.sum(), len(negatives))
+    self.assertEqual(hist.positive_counts.sum(), len(positives))
+    for i in (0, 10, 500, 999):
+      t = low + (high - low) * (i / 1000.)
+      self.assertEqual(hist.farfrr(t), bob.measure.farfrr(negatives, positives, t))
+    # the thresholds are edges of the bins, nearly as good as the exact ones
+    far, frr = bob.measure.farfrr(negatives, positives, hist.eer_threshold())
+    far_e, frr_e = bob.measure.farfrr(negatives, positives, bob.measure.exact_eer_threshold(negatives, positives))
+    self.assertTrue( abs(far - frr) <= abs(far_e - frr_e) + 0.01 )
+
+    # the histograms of several processes are summed
+    first = bob.measure.HistogramScoreAccumulator(low, high, 1000)
+    first.add(negatives[:25], positives[:30])
+    second = bob.measure.HistogramScoreAccumulator(low, high, 1000)
+    second.add(negatives[25:], positives[30:])
+    fd, filename = tempfile.mkstemp(".hdf5")
+    os.close(fd)
+    second.save(bob.io.HDF5File(filename, 'w'))
+    first.merge(bob.measure.HistogramScoreAccumulator(bob.io.HDF5File(filename)))
+    os.unlink(filename)
+    self.assertTrue( (first.negative_counts == hist.negative_counts).all() )
+    self.assertTrue( (first.positive_counts == hist.positive_counts).all() )
+    self.assertEqual(first.eer_threshold(), hist.eer_threshold())
+    self.assertRaises(RuntimeError, first.merge, bob.measure.HistogramScoreAccumulator(low, high, 100))
+
+    # score files are read by chunks
+    filename = F('dev-4col.txt')
+    neg, pos = bob.measure.load.split_four_column(filename)
+    acc = bob.measure.load.accumulate_four_column(filename, bob.measure.ExactScoreAccumulator(run_size=100), chunk_size=64)
+    self.assertEqual(acc.eer_threshold(), bob.measure.exact_eer_threshold(neg, pos))
+    filename = F('dev-5col.txt')
+    neg, pos = bob.measure.load.split_five_column(filename)
+    acc = bob.measure.load.accumulate_five_column(filename, bob.measure.ExactScoreAccumulator(), chunk_size=64)
+    self.assertTrue( numpy.array_equal(acc.roc(50), bob.measure.roc(neg, pos, 50)) )
@@ -219,3 +219,94 @@ class TransformTest(unittest.TestCase):
 
       # call the test function
       _fft2D(M, N, t, 1e-3, self)
+
+  def test_fftw_plan_cache(self):
+    # Plans are created once per size and reused
+    fftw_clear_plan_cache()
+    self.assertEqual(fftw_plan_cache_size(), 0)
+    t = numpy.array([random.uniform(1, 10) for i in range(128)], 'complex128')
+    op = FFT1D(128)
+    r1 = op(t)
+    n_plans = fftw_plan_cache_size()
+    self.assertTrue(n_plans > 0)
+    r2 = op(t)
+    self.assertEqual(fftw_plan_cache_size(), n_plans)
+    self.assertTrue((r1 == r2).all())
+    self.assertTrue(numpy.allclose(r1, numpy.fft.fft(t)))
+
+    # More rigorous plans give the same results
+    rigor = fftw_get_plan_rigor()
+    fftw_set_plan_rigor(FFTWPlanRigor.MEASURE)
+    try:
+      self.assertEqual(fftw_get_plan_rigor(), FFTWPlanRigor.MEASURE)
+      t_copy = t.copy()
+      r3 = op(t)
+      # the input is not overwritten while planning
+      self.assertTrue((t == t_copy).all())
+      self.assertTrue(numpy.allclose(r3, r1))
+      self.assertTrue(numpy.allclose(IFFT1D(128)(r3), t))
+      x = numpy.array([random.uniform(1, 10) for i in range(96)], 'float64')
+      self.assertTrue(numpy.allclose(IDCT1D(96)(DCT1D(96)(x)), x))
+    finally:
+      fftw_set_plan_rigor(rigor)
+
+    # Wisdom persistence
+    import tempfile
+    (fd, filename) = tempfile.mkstemp('.wisdom')
+    os.close(fd)
+    try:
+      fftw_export_wisdom(filename)
+      fftw_forget_wisdom()
+      self.assertEqual(fftw_plan_cache_size(), 0)
+      self.assertTrue(fftw_import_wisdom(filename))
+    finally:
+      os.unlink(filename)
+    self.assertFalse(fftw_import_wisdom(filename))
+
+  def test_rfft1D_range1to64(self):
+    # Real-input FFTs against numpy, for odd and even lengths
+    for N in range(1,65):
+      x = numpy.array([random.uniform(-10, 10) for i in range(N)], 'float64')
+      op = RFFT1D(N)
+      self.assertEqual(op.half_length, N//2+1)
+      X = op(x)
+      self.assertEqual(X.shape, (N//2+1,))
+      self.assertTrue(numpy.allclose(X, numpy.fft.rfft(x)))
+      self.assertTrue(numpy.allclose(X, FFT1D(N)(x.astype('complex128'))[0:N//2+1]))
+      X_copy = X.copy()
+      y = numpy.zeros((N,), 'float64')
+      IRFFT1D(N)(X, y)
+      # the input is not overwritten by the inverse transform
+      self.assertTrue((X == X_copy).all())
+      self.assertTrue(numpy.allclose(y, x))
+
+  def test_rfft2D_range1x1to16x16(self):
+    for H in range(1,17):
+      for W in (1, 2, 7, 8, 15, 16):
+        x = numpy.array([random.uniform(-10, 10) for i in range(H*W)], 'float64').reshape(H,W)
+        op = RFFT2D(H,W)
+        X = op(x)
+        self.assertEqual(X.shape, (H,W//2+1))
+        self.assertTrue(numpy.allclose(X, numpy.fft.rfft2(x)))
+        X_copy = X.copy()
+        y = IRFFT2D(H,W)(X)
+        self.assertTrue((X == X_copy).all())
+        self.assertTrue(numpy.allclose(y, x))
+
+  def test_batch_fft1D(self):
+    # One FFT per row of a 2D array, with a single call to FFTW
+    t = numpy.array([random.uniform(1, 10) for i in range(31*40)], 'complex128').reshape(31,40)
+    T = FFT1D(40)(t)
+    self.assertEqual(T.shape, (31,40))
+    self.assertTrue(numpy.allclose(T, numpy.fft.fft(t, axis=1)))
+    self.assertTrue(numpy.allclose(IFFT1D(40)(T), t))
+
+  def test_batch_dct2D(self):
+    # One DCT per 2D array of a 3D stack, with a single call to FFTW
+    t = numpy.array([random.uniform(1, 10) for i in range(17*8*6)], 'float64').reshape(17,8,6)
+    op = DCT2D(8,6)
+    T = op(t)
+    self.assertEqual(T.shape, (17,8,6))
+    for k in range(17):
+      self.assertTrue(numpy.allclose(T[k,:,:], op(t[k,:,:])))
+    self.assertTrue(numpy.allclose(IDCT2D(8,6)(T), t))
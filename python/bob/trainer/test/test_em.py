@@ -260,3 +260,29 @@ class GMMTest(unittest.TestCase):
     
     for i in range(0, 2):
       self.assertTrue((ar[i+1] == machine.means[i, :]).all())
+
+  def test08_gmm_ML_threads(self):
+
+    # Trains a GMMMachine with ML_GMMTrainer using several threads, and checks
+    # that the result does not depend on the number of threads
+
+    numpy.random.seed(0)
+    data = numpy.vstack((numpy.random.normal(-2., 1., (6000, 3)),
+      numpy.random.normal(3., 2., (6000, 3))))
+
+    gmms = []
+    for n_threads in (1, 2, 3):
+      gmm = bob.machine.GMMMachine(4, 3)
+      gmm.means = numpy.array([[-1, -1, -1], [0, 0, 0], [1, 1, 1], [2, 2, 2]], 'float64')
+      gmm.variances = numpy.ones((4, 3), 'float64')
+      gmm.set_variance_thresholds(0.001)
+      trainer = bob.trainer.ML_GMMTrainer(True, True, True)
+      trainer.max_iterations = 5
+      trainer.n_threads = n_threads
+      self.assertEqual(trainer.n_threads, n_threads)
+      trainer.train(gmm, data)
+      gmms.append(gmm)
+
+    self.assertTrue(gmms[0] == gmms[1])
+    self.assertTrue(gmms[0] == gmms[2])
+    self.assertRaises(RuntimeError, setattr, trainer, 'n_threads', 0)
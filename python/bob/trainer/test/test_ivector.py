@@ -373,3 +373,54 @@ class IVectorTests(unittest.TestCase):
       self.assertTrue(numpy.allclose(t_ref[it], m.t, 1e-5))
       self.assertTrue(numpy.allclose(sigma_ref[it], m.sigma, 1e-5))
 
+
+  def test03_trainer_threads(self):
+    # Ubm
+    dim_c = 4
+    dim_d = 3
+    ubm = bob.machine.GMMMachine(dim_c,dim_d)
+    ubm.weights = numpy.array([0.1,0.2,0.3,0.4])
+    ubm.means = numpy.array([[1.,7,4],[4,5,3],[2,3,1],[6,1,2]])
+    ubm.variances = numpy.array([[0.5,1.,1.5],[1.,1.5,2.],[1.,1.,1.],[2.,0.5,1.]])
+
+    # Random GMMStats
+    numpy.random.seed(0)
+    data = []
+    for i in range(23):
+      gs = bob.machine.GMMStats(dim_c,dim_d)
+      gs.t = 10
+      gs.n = numpy.random.uniform(0.1, 3., (dim_c,))
+      gs.sum_px = numpy.random.normal(3., 2., (dim_c,dim_d))
+      gs.sum_pxx = numpy.random.uniform(20., 40., (dim_c,dim_d))
+      data.append(gs)
+
+    t = numpy.random.normal(0., 1., (dim_c*dim_d,3))
+    sigma = numpy.random.uniform(1., 2., (dim_c*dim_d,))
+
+    def train(n_threads, use_cholesky):
+      m = bob.machine.IVectorMachine(ubm, 3)
+      m.variance_threshold = 1e-5
+      trainer = bob.trainer.IVectorTrainer(update_sigma=True)
+      trainer.n_threads = n_threads
+      trainer.use_cholesky = use_cholesky
+      trainer.initialize(m, data)
+      m.t = t
+      m.sigma = sigma
+      for it in range(2):
+        trainer.e_step(m, data)
+        trainer.m_step(m, data)
+      return (trainer.acc_nij_wij2, trainer.acc_fnormij_wij, trainer.acc_snormij, m.t, m.sigma)
+
+    # The results should be identical for any number of threads
+    ref = train(1, False)
+    for n_threads in (2, 3, 0):
+      res = train(n_threads, False)
+      for k in range(len(ref)):
+        self.assertTrue(numpy.array_equal(ref[k], res[k]))
+
+    # The Cholesky decomposition should give the same results (up to the
+    # numerical precision)
+    for n_threads in (1, 3):
+      res = train(n_threads, True)
+      for k in range(len(ref)):
+        self.assertTrue(numpy.allclose(ref[k], res[k], 1e-8, 1e-10))
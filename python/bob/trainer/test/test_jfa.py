@@ -330,3 +330,53 @@ class FATrainerTest(unittest.TestCase):
     
     self.assertTrue( numpy.allclose(u1, u2, eps) )
     self.assertTrue( numpy.allclose(d1, d2, eps) )
+
+  def test08_ThreadedTraining(self):
+    # Check that the results do not depend on the number of threads
+
+    rng = numpy.random.RandomState(3)
+    stats = []
+    for i in range(7):
+      sessions = []
+      for h in range(i % 3 + 1):
+        gs = bob.machine.GMMStats(2,3)
+        gs.n = rng.uniform(0.1, 1., 2)
+        gs.sum_px = rng.uniform(-1., 1., (2,3))
+        sessions.append(gs)
+      stats.append(sessions)
+
+    ubm = bob.machine.GMMMachine(2,3)
+    ubm.mean_supervector = UBM_MEAN
+    ubm.variance_supervector = UBM_VAR
+
+    # JFA
+    results = []
+    for n_threads in (1, 3):
+      mb = bob.machine.JFABase(ubm, 2, 2)
+      t = bob.trainer.JFATrainer(5)
+      t.n_threads = n_threads
+      self.assertEqual(t.n_threads, n_threads)
+      t.rng = bob.core.random.mt19937(0)
+      t.train(mb, stats)
+      results.append((mb.u, mb.v, mb.d, t.acc_u_a1, t.acc_u_a2, t.acc_v_a1, t.acc_v_a2))
+    for a, b in zip(results[0], results[1]):
+      self.assertTrue( (a == b).all() )
+
+    # ISV
+    results = []
+    for n_threads in (1, 3):
+      mb = bob.machine.ISVBase(ubm, 2)
+      t = bob.trainer.ISVTrainer(5, 4.)
+      t.n_threads = n_threads
+      t.rng = bob.core.random.mt19937(0)
+      t.train(mb, stats)
+      m = bob.machine.ISVMachine(mb)
+      t.enrol(m, stats[0], 5)
+      results.append((mb.u, mb.d, t.acc_u_a1, t.acc_u_a2, m.z))
+    for a, b in zip(results[0], results[1]):
+      self.assertTrue( (a == b).all() )
+
+    # The copies keep the number of threads
+    t = bob.trainer.ISVTrainer(5, 4.)
+    t.n_threads = 3
+    self.assertEqual(bob.trainer.ISVTrainer(t).n_threads, 3)
@@ -25,6 +25,7 @@ import bob
 import random
 import numpy
 import pkg_resources
+from ...test import utils as testutils
 
 def F(f, module=None):
   """Returns the test file on the "data" subdirectory"""
@@ -197,3 +198,102 @@ class KMeansTest(unittest.TestCase):
     trainer.train(machine, data)
     self.assertFalse( numpy.isnan(machine.means).any())
 
+  def test04_kmeans_fast_estep(self):
+
+    # The closest means (hence the statistics) do not depend on the number
+    # of threads nor on the pruning
+    numpy.random.seed(5)
+    data = numpy.vstack([numpy.random.randn(700, 5) + 3. * numpy.random.randn(5) for k in range(4)])
+    # Duplicates the first mean, whose ties go to the first one
+    data[1] = data[0]
+
+    def train(n_threads, use_pruning):
+      machine = bob.machine.KMeansMachine(6, 5)
+      trainer = bob.trainer.KMeansTrainer(0., 8)
+      trainer.rng = bob.core.random.mt19937(3)
+      trainer.n_threads = n_threads
+      trainer.use_pruning = use_pruning
+      trainer.train(machine, data)
+      return machine, trainer
+
+    ref_machine, ref_trainer = train(1, False)
+    for n_threads, use_pruning in [(1, True), (3, False), (4, True)]:
+      machine, trainer = train(n_threads, use_pruning)
+      self.assertTrue( (machine.means == ref_machine.means).all() )
+      self.assertEqual( trainer.average_min_distance, ref_trainer.average_min_distance )
+      self.assertTrue( (trainer.zeroeth_order_statistics == ref_trainer.zeroeth_order_statistics).all() )
+
+    # The closest means are the ones of the machine
+    trainer = bob.trainer.KMeansTrainer()
+    trainer.n_threads = 2
+    trainer.initialize(ref_machine, data)
+    ref_machine.means = ref_trainer.first_order_statistics / ref_trainer.zeroeth_order_statistics.reshape(6, 1)
+    trainer.e_step(ref_machine, data)
+    distances = [ref_machine.get_distance_from_mean(x, i) for x in data for i in range(6)]
+    distances = numpy.array(distances).reshape(data.shape[0], 6)
+    zeroeth = numpy.bincount(numpy.argmin(distances, axis=1), minlength=6)
+    self.assertTrue( (trainer.zeroeth_order_statistics == zeroeth).all() )
+    average = 0.
+    for d in numpy.min(distances, axis=1): average += d
+    self.assertEqual( trainer.average_min_distance, average / data.shape[0] )
+
+    # The bounds of an E-step are not reused for a refilled data array,
+    # unless requested
+    trainer = bob.trainer.KMeansTrainer()
+    trainer.use_pruning = True
+    buf = data.copy()
+    trainer.e_step(ref_machine, buf)
+    buf[:] = data[::-1]
+    trainer.e_step(ref_machine, buf)
+    self.assertTrue( (trainer.zeroeth_order_statistics == zeroeth).all() )
+    trainer.reuse_bounds = True
+    trainer.e_step(ref_machine, buf)
+    buf[:] = data
+    trainer.reset_cache()
+    trainer.e_step(ref_machine, buf)
+    self.assertTrue( (trainer.zeroeth_order_statistics == zeroeth).all() )
+
+  def test05_minibatch_kmeans(self):
+
+    # Sources of samples, in memory and in an HDF5 file
+    data = bob.io.load(F("samplesFrom2G_f64.hdf5"))
+    source = bob.trainer.ArraySampleSource(data)
+    self.assertEqual( len(source), data.shape[0] )
+    self.assertEqual( source.dim_d, data.shape[1] )
+    self.assertTrue( (source.read(10, 5) == data[10:15]).all() )
+    self.assertRaises( RuntimeError, source.read, data.shape[0]-2, 5 )
+
+    tmpname = testutils.temporary_filename()
+    f = bob.io.HDF5File(tmpname, 'w')
+    for x in data: f.append('samples', x)
+    del f
+    hdf5_source = bob.trainer.HDF5SampleSource(bob.io.HDF5File(tmpname), 'samples')
+    self.assertEqual( len(hdf5_source), data.shape[0] )
+    self.assertEqual( hdf5_source.dim_d, data.shape[1] )
+    self.assertTrue( (hdf5_source.read(10, 5) == data[10:15]).all() )
+
+    # Trains a KMeansMachine on draws from N(-10,1) and N(10,1), with batches
+    # of 50 samples read from the file
+    machine = bob.machine.KMeansMachine(2, 1)
+    trainer = bob.trainer.MiniBatchKMeansTrainer(50, 40)
+    trainer.rng = bob.core.random.mt19937(0)
+    trainer.train(machine, hdf5_source)
+    means = numpy.sort(machine.means[:,0])
+    self.assertTrue(equals(means, numpy.array([-10.,10.]), 5e-1))
+    self.assertTrue( trainer.counts.sum() > 0 )
+
+    # The same batches from memory give the same means
+    machine2 = bob.machine.KMeansMachine(2, 1)
+    trainer2 = bob.trainer.MiniBatchKMeansTrainer(50, 40)
+    trainer2.rng = bob.core.random.mt19937(0)
+    trainer2.train(machine2, source)
+    self.assertTrue( (machine.means == machine2.means).all() )
+
+    # Check comparison operators
+    trainer1 = bob.trainer.MiniBatchKMeansTrainer()
+    trainer2 = bob.trainer.MiniBatchKMeansTrainer()
+    trainer1.rng = trainer2.rng
+    self.assertTrue( trainer1 == trainer2 )
+    trainer1.batch_size = 17
+    self.assertTrue( trainer1 != trainer2 )
+    os.unlink(tmpname)
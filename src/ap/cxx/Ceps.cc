@@ -24,7 +24,7 @@
 
 #include <bob/ap/Ceps.h>
 #include <bob/core/assert.h>
-#include <bob/core/cast.h>
+#include <bob/math/linear.h>
 
 bob::ap::Ceps::Ceps(const double sampling_frequency,
     const double win_length_ms, const double win_shift_ms,
@@ -155,26 +155,39 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   int n_frames=feature_shape(0);
 
   blitz::Range r1(0,m_n_ceps-1);
-  for (int i=0; i<n_frames; ++i) 
+
+  // Process the frames by blocks
+  for (int first=0; first<n_frames; first+=s_n_block_frames)
   {
-    // Set padded frame to zero
-    extractNormalizeFrame(input, i, m_cache_frame_d);
+    const int n_block = std::min(s_n_block_frames, n_frames-first);
+    const blitz::Range rb(first, first+n_block-1);
+    // Extract and normalize the frames of the block
+    extractNormalizeFrames(input, first, n_block);
+    blitz::Array<double,2> frames(m_cache_frames(blitz::Range(0,n_block-1), blitz::Range::all()));
 
     // Update output with energy if required
     if (m_with_energy)
-      ceps_matrix(i,(int)m_n_ceps) = logEnergy(m_cache_frame_d);
-
-    // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
-    // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Take the power spectrum of the first part of the FFT
-    powerSpectrumFFT(m_cache_frame_d);
+      for (int i=0; i<n_block; ++i)
+      {
+        blitz::Array<double,1> frame(frames(i,blitz::Range::all()));
+        ceps_matrix(first+i,(int)m_n_ceps) = logEnergy(frame);
+      }
+
+    // Apply pre-emphasis and the Hamming window
+    preEmphasisHammingWindow(frames);
+    // Take the power spectrum of the first part of the FFT of all the frames
+    // (with a single batched FFT)
+    powerSpectrumFFT(frames);
     // Filter with the triangular filter bank (either in linear or Mel domain)
-    filterBank(m_cache_frame_d);
-    // Apply DCT kernel and update the output 
-    blitz::Array<double,1> ceps_matrix_row(ceps_matrix(i,r1));
-    applyDct(ceps_matrix_row);
+    if (m_cache_block_filters.extent(0) < n_block ||
+        m_cache_block_filters.extent(1) != (int)m_n_filters)
+      m_cache_block_filters.resize(std::max(n_block, s_n_block_frames), m_n_filters);
+    blitz::Array<double,2> filters(m_cache_block_filters(blitz::Range(0,n_block-1), blitz::Range::all()));
+    filterBank(frames, filters);
+    // Apply the DCT kernel to all the frames with a single matrix product,
+    // and update the output
+    blitz::Array<double,2> ceps_block(ceps_matrix(rb,r1));
+    bob::math::prod_(filters, m_dct_kernel.transpose(1,0), ceps_block);
   }
 
   //compute the center of the cut-off frequencies
@@ -197,6 +210,29 @@ void bob::ap::Ceps::operator()(const blitz::Array<double,1>& input,
   }
 }
 
+void bob::ap::Ceps::cepstralFrame(const blitz::Array<double,1>& input,
+  const size_t i, blitz::Array<double,1>& ceps_row)
+{
+  // Extract and normalize frame
+  extractNormalizeFrame(input, i, m_cache_frame_d);
+
+  // Update output with energy if required
+  if (m_with_energy)
+    ceps_row((int)m_n_ceps) = logEnergy(m_cache_frame_d);
+
+  // Apply pre-emphasis
+  pre_emphasis(m_cache_frame_d);
+  // Apply the Hamming window
+  hammingWindow(m_cache_frame_d);
+  // Take the power spectrum of the first part of the FFT
+  powerSpectrumFFT(m_cache_frame_d);
+  // Filter with the triangular filter bank (either in linear or Mel domain)
+  filterBank(m_cache_frame_d);
+  // Apply DCT kernel
+  blitz::Array<double,1> ceps_row_c(ceps_row(blitz::Range(0,m_n_ceps-1)));
+  applyDct(ceps_row_c);
+}
+
 void bob::ap::Ceps::applyDct(blitz::Array<double,1>& ceps_row) const
 {
   blitz::firstIndex i;
@@ -204,44 +240,24 @@ void bob::ap::Ceps::applyDct(blitz::Array<double,1>& ceps_row) const
   ceps_row = blitz::sum(m_cache_filters(j) * m_dct_kernel(i,j), j);
 }
 
+/**
+ * Rows of a 2D array, as accessed by Ceps::derivativeRow()
+ */
+struct MatrixRows {
+  MatrixRows(const blitz::Array<double,2>& m): m_m(m) {}
+  const blitz::Array<double,1> operator()(const int j) const
+  { return m_m(j, blitz::Range::all()); }
+  const blitz::Array<double,2>& m_m;
+};
+
 void bob::ap::Ceps::addDerivative(const blitz::Array<double,2>& input, blitz::Array<double,2>& output) const
 {
-  // Initialize output to zero
-  output = 0.;
-
   const int n_frames = input.extent(0);
-  blitz::Range rall = blitz::Range::all();
-
-  // Fill in the inner part as follows:
-  // \f$output[i] += \sum_{l=1}^{DW} l * (input[i+l] - input[i-l])\f$
-  for (int l=1; l<=(int)m_delta_win; ++l) {
-    blitz::Range rout(l,n_frames-l-1);
-    blitz::Range rp(2*l,n_frames-1);
-    blitz::Range rn(0,n_frames-2*l-1);
-    output(rout,rall) += l*(input(rp,rall) - input(rn,rall));
-  }
-
-  const double factor = m_delta_win*(m_delta_win+1)/2;
-  // Continue to fill the left boundary part as follows:
-  // \f$output[i] += (\sum_{l=1+i}^{DW} l*input[i+l]) - (\sum_{l=i+1}^{DW}l)*input[0])\f$
-  for (int i=0; i<(int)m_delta_win; ++i) {
-    output(i,rall) -= (factor - i*(i+1)/2) * input(0,rall);
-    for (int l=1+i; l<=(int)m_delta_win; ++l) {
-      output(i,rall) += l*(input(i+l,rall));
-    }
-  }
-  // Continue to fill the right boundary part as follows:
-  // \f$output[i] += (\sum_{l=Nframes-1-i}^{DW}l)*input[Nframes-1]) - (\sum_{l=Nframes-1-i}^{DW} l*input[i-l])\f$
-  for (int i=n_frames-(int)m_delta_win; i<n_frames; ++i) {
-    int ii = (n_frames-1)-i;
-    output(i,rall) += (factor - ii*(ii+1)/2) * input(n_frames-1,rall);
-    for (int l=1+ii; l<=(int)m_delta_win; ++l) {
-      output(i,rall) -= l*input(i-l,rall);
-    }
+  const MatrixRows rows(input);
+  for (int i=0; i<n_frames; ++i) {
+    blitz::Array<double,1> output_row(output(i, blitz::Range::all()));
+    derivativeRow(rows, i, n_frames, output_row);
   }
-  // Sum of the integer squared from 1 to delta_win
-  const double sum = m_delta_win*(m_delta_win+1)*(2*m_delta_win+1)/3;
-  output /= sum;
 }
 
 /*
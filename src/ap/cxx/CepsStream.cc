@@ -0,0 +1,287 @@
+/**
+ * @file ap/cxx/CepsStream.cc
+ * @date Sat Oct 17 17:02:45 2026 +0200
+ *
+ * @brief Online extraction of Linear and Mel Frequency Cepstral
+ * Coefficients (MFCC and LFCC) from an audio stream
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/ap/CepsStream.h>
+#include <bob/core/assert.h>
+#include <bob/core/array_copy.h>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Rows of a stream, as accessed by Ceps::derivativeRow(): the first row is
+ * always available, the other ones from the given index only
+ */
+struct StreamRows {
+  StreamRows(const blitz::Array<double,1>& first,
+      const std::deque<blitz::Array<double,1> >& rows, const size_t begin):
+    m_first(first), m_rows(rows), m_begin(begin) {}
+  const blitz::Array<double,1>& operator()(const int j) const
+  { return (j == 0 ? m_first : m_rows[j - m_begin]); }
+  const blitz::Array<double,1>& m_first;
+  const std::deque<blitz::Array<double,1> >& m_rows;
+  const size_t m_begin;
+};
+
+/**
+ * Deep copy of a sequence of rows
+ */
+static void copyRows(const std::deque<blitz::Array<double,1> >& src,
+  std::deque<blitz::Array<double,1> >& dst)
+{
+  dst.clear();
+  for (size_t k=0; k<src.size(); ++k)
+    dst.push_back(bob::core::array::ccopy(src[k]));
+}
+
+/**
+ * Removes the rows of index smaller than end
+ */
+static void trimRows(std::deque<blitz::Array<double,1> >& rows,
+  size_t& begin, const int end)
+{
+  while (!rows.empty() && (int)begin < end) {
+    rows.pop_front();
+    ++begin;
+  }
+}
+
+bob::ap::CepsStream::CepsStream(const bob::ap::Ceps& ceps):
+  m_ceps(ceps)
+{
+  m_n_coefs = (m_ceps.getWithEnergy() ? m_ceps.getNCeps() + 1 : m_ceps.getNCeps());
+  m_with_delta = m_ceps.getWithDelta();
+  m_with_delta_delta = m_ceps.getWithDelta() && m_ceps.getWithDeltaDelta();
+  m_n_features = m_n_coefs * (1 + (m_with_delta ? 1 : 0) + (m_with_delta_delta ? 1 : 0));
+  reset();
+}
+
+bob::ap::CepsStream::CepsStream(const bob::ap::CepsStream& other):
+  m_ceps(other.m_ceps), m_n_coefs(other.m_n_coefs),
+  m_n_features(other.m_n_features), m_with_delta(other.m_with_delta),
+  m_with_delta_delta(other.m_with_delta_delta), m_samples(other.m_samples),
+  m_skip(other.m_skip), m_finished(other.m_finished),
+  m_first_static(bob::core::array::ccopy(other.m_first_static)),
+  m_statics_begin(other.m_statics_begin), m_n_statics(other.m_n_statics),
+  m_first_delta(bob::core::array::ccopy(other.m_first_delta)),
+  m_deltas_begin(other.m_deltas_begin), m_n_deltas(other.m_n_deltas),
+  m_delta_deltas_begin(other.m_delta_deltas_begin),
+  m_n_delta_deltas(other.m_n_delta_deltas), m_n_done(other.m_n_done)
+{
+  copyRows(other.m_statics, m_statics);
+  copyRows(other.m_deltas, m_deltas);
+  copyRows(other.m_delta_deltas, m_delta_deltas);
+  copyRows(other.m_ready, m_ready);
+}
+
+bob::ap::CepsStream::~CepsStream()
+{
+}
+
+bob::ap::CepsStream& bob::ap::CepsStream::operator=(const bob::ap::CepsStream& other)
+{
+  if (this != &other)
+  {
+    m_ceps = other.m_ceps;
+    m_n_coefs = other.m_n_coefs;
+    m_n_features = other.m_n_features;
+    m_with_delta = other.m_with_delta;
+    m_with_delta_delta = other.m_with_delta_delta;
+    m_samples = other.m_samples;
+    m_skip = other.m_skip;
+    m_finished = other.m_finished;
+    m_first_static.reference(bob::core::array::ccopy(other.m_first_static));
+    copyRows(other.m_statics, m_statics);
+    m_statics_begin = other.m_statics_begin;
+    m_n_statics = other.m_n_statics;
+    m_first_delta.reference(bob::core::array::ccopy(other.m_first_delta));
+    copyRows(other.m_deltas, m_deltas);
+    m_deltas_begin = other.m_deltas_begin;
+    m_n_deltas = other.m_n_deltas;
+    copyRows(other.m_delta_deltas, m_delta_deltas);
+    m_delta_deltas_begin = other.m_delta_deltas_begin;
+    m_n_delta_deltas = other.m_n_delta_deltas;
+    copyRows(other.m_ready, m_ready);
+    m_n_done = other.m_n_done;
+  }
+  return *this;
+}
+
+size_t bob::ap::CepsStream::getLookahead() const
+{
+  size_t lookahead = 0;
+  if (m_with_delta) lookahead += m_ceps.getDeltaWin();
+  if (m_with_delta_delta) lookahead += m_ceps.getDeltaWin();
+  return lookahead;
+}
+
+void bob::ap::CepsStream::reset()
+{
+  m_samples.clear();
+  m_skip = 0;
+  m_finished = false;
+  m_first_static.resize(0);
+  m_statics.clear();
+  m_statics_begin = 0;
+  m_n_statics = 0;
+  m_first_delta.resize(0);
+  m_deltas.clear();
+  m_deltas_begin = 0;
+  m_n_deltas = 0;
+  m_delta_deltas.clear();
+  m_delta_deltas_begin = 0;
+  m_n_delta_deltas = 0;
+  m_ready.clear();
+  m_n_done = 0;
+}
+
+void bob::ap::CepsStream::push(const blitz::Array<double,1>& samples)
+{
+  if (m_finished)
+    throw std::runtime_error("CepsStream: cannot push samples after the end of the stream (reset() should be called first)");
+
+  // Skips the samples which do not belong to any frame
+  const size_t n_samples = samples.extent(0);
+  const size_t n_skipped = std::min(m_skip, n_samples);
+  m_skip -= n_skipped;
+  m_samples.reserve(m_samples.size() + n_samples - n_skipped);
+  for (size_t k=n_skipped; k<n_samples; ++k)
+    m_samples.push_back(samples((int)k));
+
+  processSamples();
+  processFrames();
+}
+
+void bob::ap::CepsStream::finish()
+{
+  if (m_finished) return;
+  m_finished = true;
+  m_samples.clear();
+  processFrames();
+}
+
+size_t bob::ap::CepsStream::read(blitz::Array<double,2>& output)
+{
+  bob::core::array::assertSameDimensionLength(output.extent(1), m_n_features);
+  const size_t n_read = std::min((size_t)output.extent(0), m_ready.size());
+  for (size_t k=0; k<n_read; ++k)
+  {
+    output((int)k, blitz::Range::all()) = m_ready.front();
+    m_ready.pop_front();
+  }
+  return n_read;
+}
+
+void bob::ap::CepsStream::processSamples()
+{
+  const size_t win_length = m_ceps.getWinLength();
+  const size_t win_shift = m_ceps.getWinShift();
+
+  // Extracts the static features of the complete frames
+  size_t start = 0;
+  while (m_samples.size() >= start + win_length)
+  {
+    const blitz::Array<double,1> frame(&m_samples[start],
+      blitz::shape(win_length), blitz::neverDeleteData);
+    blitz::Array<double,1> row(m_n_coefs);
+    m_ceps.cepstralFrame(frame, 0, row);
+    if (m_n_statics == 0) m_first_static.reference(row);
+    m_statics.push_back(row);
+    ++m_n_statics;
+    start += win_shift;
+  }
+
+  // Keeps the samples of the next frames only
+  if (start >= m_samples.size())
+  {
+    m_skip = start - m_samples.size();
+    m_samples.clear();
+  }
+  else
+    m_samples.erase(m_samples.begin(), m_samples.begin() + start);
+}
+
+void bob::ap::CepsStream::processFrames()
+{
+  const size_t delta_win = m_ceps.getDeltaWin();
+
+  if (m_with_delta)
+  {
+    // First order derivatives of the frames followed by delta_win frames
+    // (of all the frames at the end of the stream)
+    const StreamRows statics(m_first_static, m_statics, m_statics_begin);
+    while (m_n_deltas < m_n_statics &&
+        (m_finished || m_n_deltas + delta_win < m_n_statics))
+    {
+      blitz::Array<double,1> row(m_n_coefs);
+      m_ceps.derivativeRow(statics, m_n_deltas, m_n_statics, row);
+      if (m_n_deltas == 0) m_first_delta.reference(row);
+      m_deltas.push_back(row);
+      ++m_n_deltas;
+    }
+
+    // Second order derivatives, in the same way
+    if (m_with_delta_delta)
+    {
+      const StreamRows deltas(m_first_delta, m_deltas, m_deltas_begin);
+      while (m_n_delta_deltas < m_n_deltas &&
+          (m_finished || m_n_delta_deltas + delta_win < m_n_deltas))
+      {
+        blitz::Array<double,1> row(m_n_coefs);
+        m_ceps.derivativeRow(deltas, m_n_delta_deltas, m_n_deltas, row);
+        m_delta_deltas.push_back(row);
+        ++m_n_delta_deltas;
+      }
+    }
+  }
+
+  // Moves the complete feature vectors into the ready queue
+  const size_t n_complete = (m_with_delta_delta ? m_n_delta_deltas :
+    (m_with_delta ? m_n_deltas : m_n_statics));
+  const blitz::Range r0(0, m_n_coefs-1);
+  const blitz::Range r1(m_n_coefs, 2*m_n_coefs-1);
+  const blitz::Range r2(2*m_n_coefs, 3*m_n_coefs-1);
+  for (; m_n_done<n_complete; ++m_n_done)
+  {
+    blitz::Array<double,1> features(m_n_features);
+    features(r0) = m_statics[m_n_done - m_statics_begin];
+    if (m_with_delta)
+      features(r1) = m_deltas[m_n_done - m_deltas_begin];
+    if (m_with_delta_delta)
+      features(r2) = m_delta_deltas[m_n_done - m_delta_deltas_begin];
+    m_ready.push_back(features);
+  }
+
+  trimHistory();
+}
+
+void bob::ap::CepsStream::trimHistory()
+{
+  // The derivative of the frame i requires the frames i-delta_win to
+  // i+delta_win (and the first frame, which is kept apart)
+  const int delta_win = m_ceps.getDeltaWin();
+  const int n_done = m_n_done;
+  trimRows(m_statics, m_statics_begin,
+    m_with_delta ? std::min(n_done, (int)m_n_deltas - delta_win) : n_done);
+  trimRows(m_deltas, m_deltas_begin,
+    m_with_delta_delta ? std::min(n_done, (int)m_n_delta_deltas - delta_win) : n_done);
+  trimRows(m_delta_deltas, m_delta_deltas_begin, n_done);
+}
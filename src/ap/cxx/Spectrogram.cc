@@ -23,7 +23,9 @@
 #include <bob/ap/Spectrogram.h>
 #include <bob/core/check.h>
 #include <bob/core/assert.h>
-#include <bob/core/cast.h>
+#include <algorithm>
+
+const int bob::ap::Spectrogram::s_n_block_frames = 256;
 
 bob::ap::Spectrogram::Spectrogram(const double sampling_frequency,
     const double win_length_ms, const double win_shift_ms,
@@ -277,8 +279,7 @@ void bob::ap::Spectrogram::initWinSize()
 {
   bob::ap::Energy::initWinSize();
   m_fft.reset(m_win_size);
-  m_cache_frame_c1.resize(m_win_size);
-  m_cache_frame_c2.resize(m_win_size);
+  m_cache_frame_c.resize(m_win_size/2+1);
 }
 
 void bob::ap::Spectrogram::pre_emphasis(blitz::Array<double,1> &data) const
@@ -302,17 +303,92 @@ void bob::ap::Spectrogram::hammingWindow(blitz::Array<double,1> &data) const
 
 void bob::ap::Spectrogram::powerSpectrumFFT(blitz::Array<double,1>& x)
 {
-  // Apply the FFT
-  m_cache_frame_c1 = bob::core::array::cast<std::complex<double> >(x);
-  m_fft(m_cache_frame_c1, m_cache_frame_c2);
-
-  // Take the the power spectrum of the first part of the output of the FFT
-  blitz::Range r(0,(int)m_win_size/2);
-  blitz::Array<double,1> x_half(x(r));
-  blitz::Array<std::complex<double>,1> complex_half(m_cache_frame_c2(r));
-  x_half = blitz::abs(complex_half);
+  // Apply the FFT of the real frame, which only computes the first
+  // (non-redundant) part of its Hermitian spectrum
+  m_fft(x, m_cache_frame_c);
+
+  // Take the the power spectrum of this first part
+  const int n_half = (int)m_win_size/2+1;
+  double* y = x.data();
+  const std::complex<double>* c = m_cache_frame_c.data();
   if (m_energy_filter) // Apply the filter bank to the energy
-    x_half = blitz::pow2(x_half);
+    for (int k=0; k<n_half; ++k) y[k] = std::norm(c[k]);
+  else
+    for (int k=0; k<n_half; ++k) y[k] = std::abs(c[k]);
+}
+
+void bob::ap::Spectrogram::powerSpectrumFFT(blitz::Array<double,2>& frames)
+{
+  // Apply the FFT of all the real frames at once
+  const int n_frames = frames.extent(0);
+  const int n_half = (int)m_win_size/2+1;
+  if (m_cache_frames_c.extent(0) < n_frames ||
+      m_cache_frames_c.extent(1) != n_half)
+    m_cache_frames_c.resize(n_frames, n_half);
+  blitz::Array<std::complex<double>,2> frames_c(m_cache_frames_c(blitz::Range(0,n_frames-1), blitz::Range::all()));
+  m_fft(frames, frames_c);
+
+  // Take the the power spectrum of the first part of each frame
+  for (int i=0; i<n_frames; ++i)
+  {
+    double* x = &frames(i,0);
+    const std::complex<double>* c = &frames_c(i,0);
+    if (m_energy_filter) // Apply the filter bank to the energy
+      for (int k=0; k<n_half; ++k) x[k] = std::norm(c[k]);
+    else
+      for (int k=0; k<n_half; ++k) x[k] = std::abs(c[k]);
+  }
+}
+
+void bob::ap::Spectrogram::extractNormalizeFrames(const blitz::Array<double,1>& input,
+  const int first_frame, const int n_frames)
+{
+  if (m_cache_frames.extent(0) < n_frames ||
+      m_cache_frames.extent(1) != (int)m_win_size)
+    m_cache_frames.resize(std::max(n_frames, s_n_block_frames), m_win_size);
+
+  const int win_length = m_win_length;
+  const int win_size = m_win_size;
+  const int stride = input.stride(0);
+  for (int i=0; i<n_frames; ++i)
+  {
+    // Copy the samples of the frame, and pad with zeros
+    const double* src = input.data() + (first_frame+i)*(int)m_win_shift*stride;
+    double* frame = &m_cache_frames(i,0);
+    double sum = 0.;
+    for (int k=0; k<win_length; ++k)
+    {
+      frame[k] = src[k*stride];
+      sum += frame[k];
+    }
+    for (int k=win_length; k<win_size; ++k)
+      frame[k] = 0.;
+    // Subtract mean value
+    const double mean = sum / win_size;
+    for (int k=0; k<win_size; ++k)
+      frame[k] -= mean;
+  }
+}
+
+void bob::ap::Spectrogram::preEmphasisHammingWindow(blitz::Array<double,2>& frames) const
+{
+  const int win_length = m_win_length;
+  const double a = m_pre_emphasis_coeff;
+  const double* hamming = m_hamming_kernel.data();
+  for (int i=0; i<frames.extent(0); ++i)
+  {
+    double* x = &frames(i,0);
+    if (a != 0.)
+    {
+      // \f$x_{n} := (x_{n} - a*x_{n-1}) * h_{n}\f$, from the last sample
+      for (int k=win_length-1; k>0; --k)
+        x[k] = (x[k] - a * x[k-1]) * hamming[k];
+      x[0] = (x[0] * (1. - a)) * hamming[0];
+    }
+    else
+      for (int k=0; k<win_length; ++k)
+        x[k] *= hamming[k];
+  }
 }
 
 void bob::ap::Spectrogram::filterBank(blitz::Array<double,1>& x)
@@ -342,6 +418,30 @@ void bob::ap::Spectrogram::triangularFilterBank(blitz::Array<double,1>& data) co
   }
 }
 
+void bob::ap::Spectrogram::filterBank(const blitz::Array<double,2>& frames,
+  blitz::Array<double,2>& filters) const
+{
+  for (int i=0; i<frames.extent(0); ++i)
+  {
+    const double* x = &frames(i,0);
+    double* y = &filters(i,0);
+    for (int j=0; j<(int)m_n_filters; ++j)
+    {
+      // Non-zero coefficients of the filter j, from the bin m_p_index(j)
+      const double* w = m_filter_bank[j].data();
+      const double* xj = x + m_p_index(j);
+      const int n = m_filter_bank[j].extent(0);
+      double res = 0.;
+      for (int k=0; k<n; ++k)
+        res += xj[k] * w[k];
+      if (m_log_filter)
+        y[j] = (res < m_fb_out_floor ? m_log_fb_out_floor : log(res));
+      else
+        y[j] = res;
+    }
+  }
+}
+
 void bob::ap::Spectrogram::operator()(const blitz::Array<double,1>& input,
   blitz::Array<double,2>& spectrogram_matrix)
 {
@@ -355,28 +455,33 @@ void bob::ap::Spectrogram::operator()(const blitz::Array<double,1>& input,
   blitz::Range r1 = blitz::Range(0,m_win_size/2);
   if (m_energy_bands)
     r1 = blitz::Range(0,m_n_filters-1);
-  for (int i=0; i<n_frames; ++i)
-  {
-    // Extract and normalize frame
-    extractNormalizeFrame(input, i, m_cache_frame_d);
-
-    // Apply pre-emphasis
-    pre_emphasis(m_cache_frame_d);
-    // Apply the Hamming window
-    hammingWindow(m_cache_frame_d);
-    // Take the power spectrum of the first part of the FFT
-    powerSpectrumFFT(m_cache_frame_d);
-
-    // Filter with the triangular filter bank (either in linear or Mel domain)
-    if (m_energy_bands)
-      filterBank(m_cache_frame_d);
 
-    blitz::Array<double,1> spec_matrix_row(spectrogram_matrix(i,r1));
+  // Process the frames by blocks
+  for (int first=0; first<n_frames; first+=s_n_block_frames)
+  {
+    const int n_block = std::min(s_n_block_frames, n_frames-first);
+    const blitz::Range rb(first, first+n_block-1);
+    // Extract and normalize the frames of the block
+    extractNormalizeFrames(input, first, n_block);
+    blitz::Array<double,2> frames(m_cache_frames(blitz::Range(0,n_block-1), blitz::Range::all()));
+    // Apply pre-emphasis and the Hamming window
+    preEmphasisHammingWindow(frames);
+    // Take the power spectrum of the first part of the FFT of all the frames
+    // (with a single batched FFT)
+    powerSpectrumFFT(frames);
+
+    blitz::Array<double,2> spec_block(spectrogram_matrix(rb,r1));
     if (m_energy_bands)
-      spec_matrix_row = m_cache_filters(r1);
+    {
+      // Filter with the triangular filter bank (either in linear or Mel domain)
+      if (m_cache_block_filters.extent(0) < n_block ||
+          m_cache_block_filters.extent(1) != (int)m_n_filters)
+        m_cache_block_filters.resize(std::max(n_block, s_n_block_frames), m_n_filters);
+      blitz::Array<double,2> filters(m_cache_block_filters(blitz::Range(0,n_block-1), blitz::Range::all()));
+      filterBank(frames, filters);
+      spec_block = filters;
+    }
     else
-      spec_matrix_row = m_cache_frame_d(r1);
+      spec_block = frames(blitz::Range::all(),r1);
   }
 }
-
-
@@ -0,0 +1,197 @@
+/**
+ * @file ap/cxx/benchmark/ceps.cc
+ * @date Sat Oct 17 18:11:03 2026 +0200
+ *
+ * @brief Benchmark of the cepstral feature extraction: the original frame
+ * by frame extraction vs. blocks of frames
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/core/array_random.h>
+#include <bob/ap/Ceps.h>
+#include <bob/ap/CepsStream.h>
+
+#include <boost/random.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <iostream>
+
+/**
+ * The cepstral features as computed before the extraction by blocks of
+ * frames: Ceps::operator() used to process each frame on its own, from the
+ * extraction of the frame to its DCT, and then computed the derivatives on
+ * the whole matrix of features
+ */
+class FrameByFrameCeps: public bob::ap::Ceps
+{
+  public:
+    FrameByFrameCeps(const bob::ap::Ceps& ceps):
+      bob::ap::Ceps(ceps)
+    {
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      m_kernel.resize(getNCeps(), m_n_filters);
+      const double dct_coeff = getDctNorm() ?
+        (double)sqrt(2./(double)(m_n_filters)) : 1.;
+      m_kernel = dct_coeff * blitz::cos(M_PI*(i+1)*(j+0.5)/(double)(m_n_filters));
+    }
+
+    void operator()(const blitz::Array<double,1>& input,
+      blitz::Array<double,2>& ceps_matrix)
+    {
+      const int n_ceps = getNCeps();
+      const int n_frames = getShape(input)(0);
+      blitz::Range r1(0,n_ceps-1);
+      blitz::firstIndex i;
+      blitz::secondIndex j;
+      for (int k=0; k<n_frames; ++k)
+      {
+        extractNormalizeFrame(input, k, m_cache_frame_d);
+        if (getWithEnergy())
+          ceps_matrix(k,n_ceps) = logEnergy(m_cache_frame_d);
+        pre_emphasis(m_cache_frame_d);
+        hammingWindow(m_cache_frame_d);
+        powerSpectrumFFT(m_cache_frame_d);
+        filterBank(m_cache_frame_d);
+        blitz::Array<double,1> ceps_matrix_row(ceps_matrix(k,r1));
+        ceps_matrix_row = blitz::sum(m_cache_filters(j) * m_kernel(i,j), j);
+      }
+
+      const int n_coefs = (getWithEnergy() ? n_ceps + 1 : n_ceps);
+      blitz::Range rall = blitz::Range::all();
+      blitz::Range ro0(0,n_coefs-1);
+      blitz::Range ro1(n_coefs,2*n_coefs-1);
+      blitz::Range ro2(2*n_coefs,3*n_coefs-1);
+      if (getWithDelta())
+      {
+        blitz::Array<double,2> ceps_matrix_0(ceps_matrix(rall,ro0));
+        blitz::Array<double,2> ceps_matrix_1(ceps_matrix(rall,ro1));
+        addDerivative(ceps_matrix_0, ceps_matrix_1);
+        if (getWithDeltaDelta())
+        {
+          blitz::Array<double,2> ceps_matrix_2(ceps_matrix(rall,ro2));
+          addDerivative(ceps_matrix_1, ceps_matrix_2);
+        }
+      }
+    }
+
+  private:
+    void addDerivative(const blitz::Array<double,2>& input,
+      blitz::Array<double,2>& output) const
+    {
+      const int delta_win = getDeltaWin();
+      output = 0.;
+      const int n_frames = input.extent(0);
+      blitz::Range rall = blitz::Range::all();
+      for (int l=1; l<=delta_win; ++l) {
+        blitz::Range rout(l,n_frames-l-1);
+        blitz::Range rp(2*l,n_frames-1);
+        blitz::Range rn(0,n_frames-2*l-1);
+        output(rout,rall) += l*(input(rp,rall) - input(rn,rall));
+      }
+      const double factor = delta_win*(delta_win+1)/2;
+      for (int i=0; i<delta_win; ++i) {
+        output(i,rall) -= (factor - i*(i+1)/2) * input(0,rall);
+        for (int l=1+i; l<=delta_win; ++l)
+          output(i,rall) += l*(input(i+l,rall));
+      }
+      for (int i=n_frames-delta_win; i<n_frames; ++i) {
+        int ii = (n_frames-1)-i;
+        output(i,rall) += (factor - ii*(ii+1)/2) * input(n_frames-1,rall);
+        for (int l=1+ii; l<=delta_win; ++l)
+          output(i,rall) -= l*input(i-l,rall);
+      }
+      const double sum = delta_win*(delta_win+1)*(2*delta_win+1)/3;
+      output /= sum;
+    }
+
+    blitz::Array<double,2> m_kernel;
+};
+
+/**
+ * MFCC (with energy, deltas and delta-deltas) of a signal: the original
+ * frame by frame extraction vs. the fused extraction of blocks of frames of
+ * Ceps::operator() (and the stream extractor fed with the whole signal)
+ */
+void benchmark_ceps(const blitz::Array<double,1> signal,
+  const double sampling_frequency)
+{
+  bob::ap::Ceps ceps(sampling_frequency, 20., 10., 24, 19, 0.,
+    sampling_frequency/2., 2, 0.97, true, true);
+  ceps.setWithEnergy(true);
+  ceps.setWithDelta(true);
+  ceps.setWithDeltaDelta(true);
+  const blitz::TinyVector<int,2> shape = ceps.getShape(signal);
+  blitz::Array<double,2> features_frame(shape), features_block(shape),
+    features_stream(shape);
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << "MFCC of " << signal.extent(0)/sampling_frequency << "s of audio at "
+    << sampling_frequency << "Hz (" << shape(0) << " frames)..." << std::endl;
+
+  // frame by frame (once to create the FFTW plans, then timed)
+  FrameByFrameCeps frame_ceps(ceps);
+  frame_ceps(signal, features_frame);
+  t1 = boost::posix_time::microsec_clock::local_time();
+  frame_ceps(signal, features_frame);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  const double frame_us = diff.total_microseconds();
+  std::cout << "  frame by frame duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  // blocks of frames (once to create the FFTW plans, then timed)
+  ceps(signal, features_block);
+  t1 = boost::posix_time::microsec_clock::local_time();
+  ceps(signal, features_block);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  blocks of frames duration in (microseconds) " << diff.total_microseconds() << std::endl;
+  std::cout << "  speed-up " << frame_us / std::max(1., (double)diff.total_microseconds())
+    << ", max. difference " << blitz::max(blitz::abs(features_frame - features_block)) << std::endl;
+
+  // stream extractor
+  bob::ap::CepsStream stream(ceps);
+  t1 = boost::posix_time::microsec_clock::local_time();
+  stream.push(signal);
+  stream.finish();
+  stream.read(features_stream);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  stream duration in (microseconds) " << diff.total_microseconds()
+    << ", max. difference " << blitz::max(blitz::abs(features_frame - features_stream)) << std::endl;
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char** argv)
+{
+  boost::mt19937 rng(0);
+
+  // 10 minutes of (white noise) telephone and wideband audio
+  double rates[2] = {8000., 16000.};
+  for(int i=0; i<2; ++i)
+  {
+    blitz::Array<double,1> signal((int)(600*rates[i]));
+    bob::core::array::randn(rng, signal);
+    signal *= 1000.;
+    // Benchmark
+    benchmark_ceps(signal, rates[i]);
+  }
+
+  return 0;
+}
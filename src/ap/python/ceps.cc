@@ -26,6 +26,7 @@
 #include <bob/ap/Energy.h>
 #include <bob/ap/Spectrogram.h>
 #include <bob/ap/Ceps.h>
+#include <bob/ap/CepsStream.h>
 #include <bob/python/ndarray.h>
 
 using namespace boost::python;
@@ -35,6 +36,7 @@ static const char* FRAME_EXTRACTOR_DOC = "Objects of this class, after configura
 static const char* ENERGY_DOC = "Objects of this class, after configuration, can extract the energy of frames extracted from a 1D audio array/signal.";
 static const char* SPECTROGRAM_DOC = "Objects of this class, after configuration, can extract spectrograms from a 1D audio array/signal.";
 static const char* CEPS_DOC = "Objects of this class, after configuration, can extract cepstral coefficients from a 1D audio array/signal.";
+static const char* CEPS_STREAM_DOC = "Objects of this class extract cepstral coefficients from an audio stream, given as 1D arrays of samples of any size. The feature vector of a frame is available once the 'lookahead' next frames have been pushed (or once the end of the stream is notified), and is the one computed by the given Ceps on the whole signal.";
 
 static boost::python::tuple py_extractor_get_shape(bob::ap::FrameExtractor& ext, object input_object)
 {
@@ -95,6 +97,21 @@ static object py_ceps_call(bob::ap::Ceps& ceps, bob::python::const_ndarray input
   return ceps_matrix.self();
 }
 
+static void py_ceps_stream_push(bob::ap::CepsStream& stream, bob::python::const_ndarray samples)
+{
+  stream.push(samples.bz<double,1>());
+}
+
+static object py_ceps_stream_read(bob::ap::CepsStream& stream)
+{
+  // Allocates a numpy array for all the available feature vectors
+  bob::python::ndarray features(bob::core::array::t_float64,
+    stream.getNReadyFrames(), stream.getNFeatures());
+  blitz::Array<double,2> features_ = features.bz<double,2>();
+  stream.read(features_);
+  return features.self();
+}
+
 void bind_ap_ceps()
 {
   class_<bob::ap::FrameExtractor, boost::shared_ptr<bob::ap::FrameExtractor> >("FrameExtractor", FRAME_EXTRACTOR_DOC, init<const double, optional<const double, const double> >((arg("self"), arg("sampling_frequency"), arg("win_length_ms")=20., arg("win_shift_ms")=10.)))
@@ -148,5 +165,18 @@ void bind_ap_ceps()
     .add_property("with_delta_delta", &bob::ap::Ceps::getWithDeltaDelta, &bob::ap::Ceps::setWithDeltaDelta, "Tells if we add the second derivatives to the output feature")
     .def("__call__", &py_ceps_call, (arg("self"), arg("input")), "Computes the cepstral coefficients")
   ;
-}
 
+  class_<bob::ap::CepsStream, boost::shared_ptr<bob::ap::CepsStream> >("CepsStream", CEPS_STREAM_DOC, init<const bob::ap::Ceps&>((arg("self"), arg("ceps")), "Constructs a new stream extractor, using the configuration of the given Ceps (which is copied)."))
+    .def(init<bob::ap::CepsStream&>((arg("self"), arg("other")), "Constructs a new stream extractor from an existing one, using the copy constructor."))
+    .add_property("ceps", make_function(&bob::ap::CepsStream::getCeps, return_value_policy<copy_const_reference>()), "The cepstral feature extractor")
+    .add_property("n_features", &bob::ap::CepsStream::getNFeatures, "The dimension of the feature vectors")
+    .add_property("lookahead", &bob::ap::CepsStream::getLookahead, "The number of frames that should follow a frame before its feature vector is available")
+    .add_property("n_ready_frames", &bob::ap::CepsStream::getNReadyFrames, "The number of feature vectors which can be read")
+    .add_property("n_frames", &bob::ap::CepsStream::getNFrames, "The number of frames extracted since the beginning of the stream")
+    .add_property("finished", &bob::ap::CepsStream::getFinished, "Tells if the end of the stream has been notified")
+    .def("reset", &bob::ap::CepsStream::reset, (arg("self")), "Starts a new stream, discarding the samples and the feature vectors which have not been read")
+    .def("push", &py_ceps_stream_push, (arg("self"), arg("samples")), "Appends the given 1D array of samples to the stream")
+    .def("finish", &bob::ap::CepsStream::finish, (arg("self")), "Notifies the end of the stream, which makes the feature vectors of the last frames available")
+    .def("read", &py_ceps_stream_read, (arg("self")), "Returns the feature vectors which are available, as a 2D array (one row per frame), and removes them from the stream")
+  ;
+}
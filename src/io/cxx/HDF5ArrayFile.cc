@@ -27,21 +27,37 @@
 #include <bob/io/CodecRegistry.h>
 
 #include <bob/io/HDF5File.h>
+#include <bob/io/utils.h>
 
 #include <bob/core/logging.h>
 
+#include <algorithm>
+#include <cstring>
+
 /**
  * Read and write arrays in HDF5 format
+ *
+ * The arrays are stored in chunks of about chunk_size bytes. By default,
+ * each appended array is written to the file at once. If buffer_size is set
+ * (see bob::io::open_hdf5()), appended arrays are instead kept in a
+ * write-behind buffer of buffer_size bytes, which is written to the file
+ * with a single extension of the dataset when it is full, before any read
+ * operation, by flush() and when this object is destroyed (which can only
+ * log the errors).
  */
 class HDF5ArrayFile: public bob::io::File {
 
   public:
 
-    HDF5ArrayFile (const std::string& filename, bob::io::HDF5File::mode_t mode):
+    HDF5ArrayFile (const std::string& filename, bob::io::HDF5File::mode_t mode,
+        size_t chunk_size=s_chunk_size, size_t buffer_size=0):
       m_file(filename, mode),
       m_filename(filename),
       m_size_arrayset(0),
-      m_newfile(true) {
+      m_newfile(true),
+      m_chunk_size(chunk_size),
+      m_buffer_size(buffer_size),
+      m_buffered(0) {
 
         //tries to update the current descriptors
         std::vector<std::string> paths;
@@ -75,7 +91,14 @@ class HDF5ArrayFile: public bob::io::File {
 
       }
 
-    virtual ~HDF5ArrayFile() { }
+    virtual ~HDF5ArrayFile() {
+      try {
+        flush();
+      }
+      catch (std::exception& e) {
+        bob::core::error << "could not write the buffered arrays to the HDF5 file at '" << m_filename << "': " << e.what() << std::endl;
+      }
+    }
 
     virtual const std::string& filename() const {
       return m_filename;
@@ -105,6 +128,8 @@ class HDF5ArrayFile: public bob::io::File {
         throw std::runtime_error(f.str());
       }
 
+      flush();
+
       if(!buffer.type().is_compatible(m_type_array)) buffer.set(m_type_array);
 
       m_file.read_buffer(m_path, 0, buffer.type(), buffer.ptr());
@@ -118,6 +143,8 @@ class HDF5ArrayFile: public bob::io::File {
         throw std::runtime_error(f.str());
       }
 
+      flush();
+
       if(!buffer.type().is_compatible(m_type_arrayset)) buffer.set(m_type_arrayset);
 
       m_file.read_buffer(m_path, index, buffer.type(), buffer.ptr());
@@ -128,7 +155,7 @@ class HDF5ArrayFile: public bob::io::File {
       if (m_newfile) {
         //creates non-compressible, extensible dataset on HDF5 file
         m_newfile = false;
-        m_file.create(m_path, buffer.type(), true, 0);
+        m_file.create(m_path, buffer.type(), true, 0, m_chunk_size);
         m_file.describe(m_path)[0].type.copy_to(m_type_arrayset);
         m_file.describe(m_path)[1].type.copy_to(m_type_array);
 
@@ -136,9 +163,33 @@ class HDF5ArrayFile: public bob::io::File {
         if (m_type_array.shape[0] == 1) m_type_array = m_type_arrayset;
       }
 
-      m_file.extend_buffer(m_path, buffer.type(), buffer.ptr());
+      if (!m_buffer_size) {
+        m_file.extend_buffer(m_path, buffer.type(), buffer.ptr());
+        ++m_size_arrayset;
+        return m_size_arrayset - 1; ///< index of this object in the file
+      }
+
+      //checks the type here, as the array may only be written later on
+      if (!(bob::io::HDF5Type(buffer.type()) == bob::io::HDF5Type(m_type_arrayset))) {
+        boost::format m("trying to append `%s' to the HDF5 file at '%s' that only accepts `%s'");
+        m % buffer.type().str() % m_filename % m_type_arrayset.str();
+        throw std::runtime_error(m.str());
+      }
+
+      const size_t nbytes = m_type_arrayset.buffer_size();
+      if (m_buffer.empty()) {
+        if (!m_file.describe(m_path)[0].expandable) {
+          boost::format m("trying to append to the HDF5 file at '%s' whose dataset '%s' is not expandible");
+          m % m_filename % m_path;
+          throw std::runtime_error(m.str());
+        }
+        m_buffer.resize(std::max(m_buffer_size, nbytes));
+      }
+      if ((m_buffered + 1) * nbytes > m_buffer.size()) flush();
+
+      std::memcpy(&m_buffer[m_buffered * nbytes], buffer.ptr(), nbytes);
+      ++m_buffered;
       ++m_size_arrayset;
-      //needs to flush the data to the file
       return m_size_arrayset - 1; ///< index of this object in the file
 
     }
@@ -164,6 +215,16 @@ class HDF5ArrayFile: public bob::io::File {
       m_file.write_buffer(m_path, 0, buffer.type(), buffer.ptr());
     }
 
+    /**
+     * Writes the buffered arrays to the file at once
+     */
+    virtual void flush() {
+      if (!m_buffered) return;
+      m_file.extend_buffer(m_path, bob::io::HDF5Type(m_type_arrayset),
+          m_buffered, &m_buffer[0]);
+      m_buffered = 0;
+    }
+
   private: //representation
 
     bob::io::HDF5File m_file;
@@ -173,12 +234,18 @@ class HDF5ArrayFile: public bob::io::File {
     size_t       m_size_arrayset; ///< number of arrays in arrayset mode
     std::string  m_path; ///< default path to use
     bool         m_newfile; ///< path check optimization
+    size_t       m_chunk_size; ///< target size of the chunks, in bytes
+    size_t       m_buffer_size; ///< size of the buffer (0 for none), in bytes
+    std::vector<char> m_buffer; ///< arrays appended, but not yet written
+    size_t       m_buffered; ///< number of arrays in m_buffer
 
     static std::string  s_codecname;
+    static const size_t s_chunk_size = 1 << 12; ///< default, in bytes
 
 };
 
 std::string HDF5ArrayFile::s_codecname = "bob.hdf5";
+const size_t HDF5ArrayFile::s_chunk_size;
 
 /**
  * From this point onwards we have the registration procedure. If you are
@@ -206,16 +273,25 @@ std::string HDF5ArrayFile::s_codecname = "bob.hdf5";
  *
  * @note: This method can be static.
  */
+static bob::io::HDF5File::mode_t hdf5_mode (char mode) {
+  if (mode == 'r') return bob::io::HDF5File::in;
+  else if (mode == 'w') return bob::io::HDF5File::trunc;
+  else if (mode == 'a') return bob::io::HDF5File::inout;
+  else throw std::runtime_error("unsupported file opening mode");
+}
+
 static boost::shared_ptr<bob::io::File>
 make_file (const std::string& path, char mode) {
 
-  bob::io::HDF5File::mode_t h5mode;
-  if (mode == 'r') h5mode = bob::io::HDF5File::in;
-  else if (mode == 'w') h5mode = bob::io::HDF5File::trunc;
-  else if (mode == 'a') h5mode = bob::io::HDF5File::inout;
-  else throw std::runtime_error("unsupported file opening mode");
+  return boost::make_shared<HDF5ArrayFile>(path, hdf5_mode(mode));
+
+}
+
+boost::shared_ptr<bob::io::File> bob::io::open_hdf5 (const std::string& filename,
+    char mode, size_t chunk_size, size_t buffer_size) {
 
-  return boost::make_shared<HDF5ArrayFile>(path, h5mode);
+  return boost::make_shared<HDF5ArrayFile>(filename, hdf5_mode(mode),
+      chunk_size, buffer_size);
 
 }
 
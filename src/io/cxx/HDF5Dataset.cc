@@ -49,7 +49,8 @@ static void delete_h5dataset (hid_t* p) {
 }
 
 static boost::shared_ptr<hid_t> open_dataset
-(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name) {
+(boost::shared_ptr<bob::io::detail::hdf5::Group>& par, const std::string& name,
+ hid_t dapl=H5P_DEFAULT) {
   if (!name.size() || name == "." || name == "..") {
     boost::format m("Cannot open dataset with illegal name `%s' at `%s:%s'");
     m % name % par->file()->filename() % par->path();
@@ -58,7 +59,7 @@ static boost::shared_ptr<hid_t> open_dataset
 
   boost::shared_ptr<hid_t> retval(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
-  *retval = H5Dopen2(*par->location(), name.c_str(), H5P_DEFAULT);
+  *retval = H5Dopen2(*par->location(), name.c_str(), dapl);
   if (*retval < 0) {
     throw status_error("H5Dopen2", *retval);
   }
@@ -242,12 +243,51 @@ bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
   }
 }
 
+/**
+ * Identifier of the (third-party) LZF filter, as registered with the HDF
+ * Group
+ */
+static const H5Z_filter_t LZF_FILTER = 32000;
+
+/**
+ * Sets the compression filters of a new (chunked) dataset, following the
+ * settings of its file: the bytes may be shuffled before compression, and
+ * the LZF filter may be used instead of gzip, if the HDF5 library can load
+ * it.
+ */
+static void set_compression(boost::shared_ptr<bob::io::detail::hdf5::Group> par,
+    hid_t dcpl, size_t compression) {
+  boost::shared_ptr<bob::io::detail::hdf5::File> file = par->file();
+
+  if (file->shuffle()) {
+    herr_t status = H5Pset_shuffle(dcpl);
+    if (status < 0) throw status_error("H5Pset_shuffle", status);
+  }
+
+  if (file->fast_compression()) {
+    if (H5Zfilter_avail(LZF_FILTER) > 0) {
+      herr_t status = H5Pset_filter(dcpl, LZF_FILTER, H5Z_FLAG_OPTIONAL, 0, 0);
+      if (status < 0) throw status_error("H5Pset_filter", status);
+      return;
+    }
+    static bool warned = false;
+    if (!warned) {
+      bob::core::warn << "the LZF filter is not available to the HDF5 library - using gzip compression instead" << std::endl;
+      warned = true;
+    }
+  }
+
+  if (compression > 9) compression = 9;
+  herr_t status = H5Pset_deflate(dcpl, compression);
+  if (status < 0) throw status_error("H5Pset_deflate", status);
+}
+
 /**
  * Creates and writes an "empty" Dataset in an existing file.
  */
 static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
  const std::string& name, const bob::io::HDF5Type& type, bool list,
- size_t compression) {
+ size_t compression, size_t chunk_size) {
 
   if (!name.size() || name == "." || name == "..") {
     boost::format m("Cannot create dataset with illegal name `%s' at `%s:%s'");
@@ -276,21 +316,26 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //supposed to be a list -- HDF5 only supports expandability like this.
   boost::shared_ptr<hid_t> dcpl = open_plist(H5P_DATASET_CREATE);
 
+  boost::shared_ptr<hid_t> cls = type.htype();
+
   //according to the HDF5 manual, chunks have to have the same rank as the
   //array shape.
   bob::io::HDF5Shape chunking(xshape);
   chunking[0] = 1;
+  if (list && chunk_size) { ///< as many list elements as fit in chunk_size
+    size_t element_size = H5Tget_size(*cls);
+    for (size_t k=1; k<chunking.n(); ++k) element_size *= chunking[k];
+    if (element_size && chunk_size > element_size)
+      chunking[0] = chunk_size / element_size;
+  }
   if (list || compression) { ///< note: compression requires chunking
     herr_t status = H5Pset_chunk(*dcpl, chunking.n(), chunking.get());
     if (status < 0) throw status_error("H5Pset_chunk", status);
   }
 
-  //if the user has decided to compress the dataset, do it with gzip.
-  if (compression) {
-    if (compression > 9) compression = 9;
-    herr_t status = H5Pset_deflate(*dcpl, compression);
-    if (status < 0) throw status_error("H5Pset_deflate", status);
-  }
+  //if the user has decided to compress the dataset, do it with gzip or with
+  //the faster LZF filter, optionally shuffling the bytes first.
+  if (compression) set_compression(par, *dcpl, compression);
 
   //our link creation property list for HDF5
   boost::shared_ptr<hid_t> lcpl = open_plist(H5P_LINK_CREATE);
@@ -301,8 +346,6 @@ static void create_dataset (boost::shared_ptr<bob::io::detail::hdf5::Group> par,
   //please note that we don't define the fill value as in the example, but
   //according to the HDF5 documentation, this value is set to zero by default.
 
-  boost::shared_ptr<hid_t> cls = type.htype();
-
   //finally create the dataset on the file.
   boost::shared_ptr<hid_t> dataset(new hid_t(-1),
       std::ptr_fun(delete_h5dataset));
@@ -367,7 +410,7 @@ static void create_string_dataset (boost::shared_ptr<bob::io::detail::hdf5::Grou
 
 bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     const std::string& name, const bob::io::HDF5Type& type,
-    bool list, size_t compression):
+    bool list, size_t compression, size_t chunk_size):
   m_parent(parent),
   m_name(name),
   m_id(),
@@ -385,7 +428,7 @@ bob::io::detail::hdf5::Dataset::Dataset(boost::shared_ptr<Group> parent,
     if (type.type() == bob::io::s)
       create_string_dataset(parent, m_name, type, compression);
     else
-      create_dataset(parent, m_name, type, list, compression);
+      create_dataset(parent, m_name, type, list, compression, chunk_size);
   }
   else H5Dclose(set_id); //close it, will re-open it properly
 
@@ -493,6 +536,42 @@ bob::io::detail::hdf5::Dataset::select (size_t index, const bob::io::HDF5Type& d
   return it;
 }
 
+std::vector<bob::io::HDF5Descriptor>::iterator
+bob::io::detail::hdf5::Dataset::select (size_t index, size_t count,
+    const bob::io::HDF5Type& dest, boost::shared_ptr<hid_t>& memspace) {
+
+  //finds compatibility type
+  std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
+
+  //if we cannot find a compatible type, we throw
+  if (it == m_descr.end()) {
+    boost::format m("trying to read or write `%s' at `%s' that only accepts `%s'");
+    m % dest.str() % url() % m_descr[0].type.str();
+    throw std::runtime_error(m.str());
+  }
+
+  //checks indexing
+  if (index + count > it->size) {
+    boost::format m("trying to access elements [%d, %d) in Dataset '%s' that only contains %d elements");
+    m % index % (index + count) % url() % it->size;
+    throw std::runtime_error(m.str());
+  }
+
+  //the objects are stored one after the other along the first dimension
+  bob::io::HDF5Shape start(it->hyperslab_start);
+  bob::io::HDF5Shape extent(it->hyperslab_count);
+  start[0] = index * it->hyperslab_count[0];
+  extent[0] = count * it->hyperslab_count[0];
+
+  memspace = open_memspace(extent);
+
+  herr_t status = H5Sselect_hyperslab(*m_filespace, H5S_SELECT_SET,
+      start.get(), 0, extent.get(), 0);
+  if (status < 0) throw status_error("H5Sselect_hyperslab", status);
+
+  return it;
+}
+
 void bob::io::detail::hdf5::Dataset::read_buffer (size_t index, const bob::io::HDF5Type& dest, void* buffer) {
 
   std::vector<bob::io::HDF5Descriptor>::iterator it = select(index, dest);
@@ -514,7 +593,40 @@ void bob::io::detail::hdf5::Dataset::write_buffer (size_t index, const bob::io::
   if (status < 0) throw status_error("H5Dwrite", status);
 }
 
+void bob::io::detail::hdf5::Dataset::read_buffer (size_t index, size_t count,
+    const bob::io::HDF5Type& dest, void* buffer) {
+
+  if (!count) return;
+
+  boost::shared_ptr<hid_t> memspace;
+  std::vector<bob::io::HDF5Descriptor>::iterator it = select(index, count, dest, memspace);
+
+  herr_t status = H5Dread(*m_id, *it->type.htype(),
+      *memspace, *m_filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw status_error("H5Dread", status);
+}
+
+void bob::io::detail::hdf5::Dataset::write_buffer (size_t index, size_t count,
+    const bob::io::HDF5Type& dest, const void* buffer) {
+
+  if (!count) return;
+
+  boost::shared_ptr<hid_t> memspace;
+  std::vector<bob::io::HDF5Descriptor>::iterator it = select(index, count, dest, memspace);
+
+  herr_t status = H5Dwrite(*m_id, *it->type.htype(),
+      *memspace, *m_filespace, H5P_DEFAULT, buffer);
+
+  if (status < 0) throw status_error("H5Dwrite", status);
+}
+
 void bob::io::detail::hdf5::Dataset::extend_buffer (const bob::io::HDF5Type& dest, const void* buffer) {
+  extend_buffer(dest, 1, buffer);
+}
+
+void bob::io::detail::hdf5::Dataset::extend_buffer (const bob::io::HDF5Type& dest,
+    size_t count, const void* buffer) {
 
   //finds compatibility type
   std::vector<bob::io::HDF5Descriptor>::iterator it = find_type_index(m_descr, dest);
@@ -532,27 +644,55 @@ void bob::io::detail::hdf5::Dataset::extend_buffer (const bob::io::HDF5Type& des
     throw std::runtime_error(m.str());
   }
 
+  if (!count) return;
+
   //if it is expandible, try expansion
   bob::io::HDF5Shape tmp(it->type.shape());
   tmp >>= 1;
-  tmp[0] = it->size + 1;
+  tmp[0] = it->size + count;
   herr_t status = H5Dset_extent(*m_id, tmp.get());
   if (status < 0) throw status_error("H5Dset_extent", status);
 
   //if expansion succeeded, update all compatible types
   for (size_t k=0; k<m_descr.size(); ++k) {
     if (m_descr[k].expandable) { //updated only the length
-      m_descr[k].size += 1;
+      m_descr[k].size += count;
     }
     else { //not expandable, update the shape/count for a straight read/write
-      m_descr[k].type.shape()[0] += 1;
-      m_descr[k].hyperslab_count[0] += 1;
+      m_descr[k].type.shape()[0] += count;
+      m_descr[k].hyperslab_count[0] += count;
     }
   }
 
   m_filespace = open_filespace(m_id); //update filespace
 
-  write_buffer(tmp[0]-1, dest, buffer);
+  if (count == 1) write_buffer(tmp[0]-1, dest, buffer);
+  else write_buffer(tmp[0]-count, count, dest, buffer);
+}
+
+void bob::io::detail::hdf5::Dataset::set_chunk_cache(size_t cache_size,
+    size_t cache_slots) {
+
+  boost::shared_ptr<hid_t> dapl = open_plist(H5P_DATASET_ACCESS);
+
+  //keeps the current values of the settings which are not given
+  size_t rdcc_nslots, rdcc_nbytes;
+  double rdcc_w0;
+  boost::shared_ptr<hid_t> current(new hid_t(-1), std::ptr_fun(delete_h5plist));
+  *current = H5Dget_access_plist(*m_id);
+  if (*current < 0) throw status_error("H5Dget_access_plist", *current);
+  herr_t status = H5Pget_chunk_cache(*current, &rdcc_nslots, &rdcc_nbytes,
+      &rdcc_w0);
+  if (status < 0) throw status_error("H5Pget_chunk_cache", status);
+  if (cache_size) rdcc_nbytes = cache_size;
+  if (cache_slots) rdcc_nslots = cache_slots;
+  status = H5Pset_chunk_cache(*dapl, rdcc_nslots, rdcc_nbytes, rdcc_w0);
+  if (status < 0) throw status_error("H5Pset_chunk_cache", status);
+
+  //the chunk cache can only be set when opening the dataset
+  boost::shared_ptr<bob::io::detail::hdf5::Group> par = parent();
+  m_id = open_dataset(par, m_name, *dapl);
+  m_filespace = open_filespace(m_id);
 }
 
 void bob::io::detail::hdf5::Dataset::gettype_attribute(const std::string& name,
@@ -38,13 +38,16 @@ static unsigned int getH5Access (bob::io::HDF5File::mode_t v) {
   }
 }
 
-bob::io::HDF5File::HDF5File(const std::string& filename, mode_t mode):
-  m_file(new bob::io::detail::hdf5::File(filename, getH5Access(mode))),
+bob::io::HDF5File::HDF5File(const std::string& filename, mode_t mode,
+    const size_t cache_size, const size_t cache_slots):
+  m_file(new bob::io::detail::hdf5::File(filename, getH5Access(mode), 0,
+        cache_size, cache_slots)),
   m_cwd(m_file->root()) ///< we start by looking at the root directory
 {
 }
 
-bob::io::HDF5File::HDF5File(const std::string& filename, const char mode):
+bob::io::HDF5File::HDF5File(const std::string& filename, const char mode,
+    const size_t cache_size, const size_t cache_slots):
 m_file(),
 m_cwd()
 {
@@ -57,7 +60,8 @@ m_cwd()
     default:
       throw std::runtime_error("Supported flags are 'r' (read-only), 'a' (read/write/append), 'w' (read/write/truncate) or 'x' (read/write/exclusive)");
   }
-  m_file.reset(new bob::io::detail::hdf5::File(filename, getH5Access(new_mode)));
+  m_file.reset(new bob::io::detail::hdf5::File(filename, getH5Access(new_mode),
+        0, cache_size, cache_slots));
   m_cwd = m_file->root(); ///< we start by looking at the root directory
 
 }
@@ -130,6 +134,11 @@ void bob::io::HDF5File::rename (const std::string& from, const std::string& to)
   m_cwd = m_cwd->cd(current_path); //go back to the path we were before
 }
 
+void bob::io::HDF5File::setChunkCache(const std::string& path,
+    const size_t cache_size, const size_t cache_slots) {
+  (*m_cwd)[path]->set_chunk_cache(cache_size, cache_slots);
+}
+
 void bob::io::HDF5File::copy (HDF5File& other) {
   if (!m_file->writeable()) {
     boost::format m("cannot copy data of file '%s' to path '%s' of file '%s' because it is not writeable");
@@ -155,13 +164,14 @@ void bob::io::HDF5File::copy (HDF5File& other) {
 }
 
 void bob::io::HDF5File::create (const std::string& path, const bob::io::HDF5Type& type,
-    bool list, size_t compression) {
+    bool list, size_t compression, size_t chunk_size) {
   if (!m_file->writeable()) {
     boost::format m("cannot create dataset '%s' at path '%s' of file '%s' because it is not writeable");
     m % path % m_cwd->path() % m_file->filename();
     throw std::runtime_error(m.str());
   }
-  if (!contains(path)) m_cwd->create_dataset(path, type, list, compression);
+  if (!contains(path)) m_cwd->create_dataset(path, type, list, compression,
+      chunk_size);
   else (*m_cwd)[path]->size(type);
 }
 
@@ -170,6 +180,11 @@ void bob::io::HDF5File::read_buffer (const std::string& path, size_t pos,
   (*m_cwd)[path]->read_buffer(pos, type, buffer);
 }
 
+void bob::io::HDF5File::read_buffer (const std::string& path, size_t pos,
+    size_t count, const bob::io::HDF5Type& type, void* buffer) const {
+  (*m_cwd)[path]->read_buffer(pos, count, type, buffer);
+}
+
 void bob::io::HDF5File::write_buffer (const std::string& path,
     size_t pos, const bob::io::HDF5Type& type, const void* buffer) {
   if (!m_file->writeable()) {
@@ -190,6 +205,16 @@ void bob::io::HDF5File::extend_buffer(const std::string& path,
   (*m_cwd)[path]->extend_buffer(type, buffer);
 }
 
+void bob::io::HDF5File::extend_buffer(const std::string& path,
+    const bob::io::HDF5Type& type, size_t count, const void* buffer) {
+  if (!m_file->writeable()) {
+    boost::format m("cannot extend object '%s' at path '%s' of file '%s' because the file is not writeable");
+    m % path % m_cwd->path() % m_file->filename();
+    throw std::runtime_error(m.str());
+  }
+  (*m_cwd)[path]->extend_buffer(type, count, buffer);
+}
+
 bool bob::io::HDF5File::hasAttribute(const std::string& path,
     const std::string& name) const {
   if (m_cwd->has_dataset(path)) {
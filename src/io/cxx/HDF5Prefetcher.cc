@@ -0,0 +1,114 @@
+/**
+ * @file io/cxx/HDF5Prefetcher.cc
+ * @date Sat Oct 17 19:05:12 2026 +0200
+ *
+ * @brief Implementation of the HDF5Prefetcher class
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <bob/io/HDF5Prefetcher.h>
+
+bob::io::HDF5Prefetcher::HDF5Prefetcher(const bob::io::HDF5File& file,
+    const std::string& path, const size_t block_size, const size_t n_blocks):
+  m_file(file),
+  m_path(path),
+  m_type(m_file.describe(path)[0].type),
+  m_size(m_file.describe(path)[0].size),
+  m_object_size(H5Tget_size(*m_type.htype())),
+  m_block_size(std::max(block_size, (size_t)1)),
+  m_n_blocks(std::max(n_blocks, (size_t)1)),
+  m_done(false),
+  m_stop(false)
+{
+  const HDF5Shape& shape = m_type.shape();
+  for (size_t k=0; k<shape.n(); ++k) m_object_size *= shape[k];
+  m_thread = boost::thread(boost::bind(&bob::io::HDF5Prefetcher::run, this));
+}
+
+bob::io::HDF5Prefetcher::~HDF5Prefetcher() {
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+}
+
+void bob::io::HDF5Prefetcher::run() {
+  try {
+    for (size_t begin=0; begin<m_size; begin+=m_block_size) {
+      {
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        while (m_blocks.size() >= m_n_blocks && !m_stop) m_cond.wait(lock);
+        if (m_stop) return;
+      }
+      const size_t count = std::min(m_block_size, m_size - begin);
+      std::vector<char> block(count * m_object_size);
+      m_file.read_buffer(m_path, begin, count, m_type, &block[0]);
+      {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        m_blocks.push_back(std::vector<char>());
+        m_blocks.back().swap(block);
+        m_counts.push_back(count);
+      }
+      m_cond.notify_all();
+    }
+  }
+  catch (std::exception& e) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_error = e.what();
+    if (m_error.empty()) m_error = "unknown error while reading a block";
+  }
+  catch (...) {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_error = "unknown error while reading a block";
+  }
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_done = true;
+  }
+  m_cond.notify_all();
+}
+
+size_t bob::io::HDF5Prefetcher::pop() {
+  size_t count = 0;
+  {
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while (m_blocks.empty() && !m_done) m_cond.wait(lock);
+    if (m_blocks.empty()) {
+      if (!m_error.empty()) {
+        boost::format m("cannot read dataset '%s' of file '%s': %s");
+        m % m_path % m_file.filename() % m_error;
+        throw std::runtime_error(m.str());
+      }
+      return 0;
+    }
+    m_current.swap(m_blocks.front());
+    m_blocks.pop_front();
+    count = m_counts.front();
+    m_counts.pop_front();
+  }
+  m_cond.notify_all();
+  return count;
+}
+
+size_t bob::io::HDF5Prefetcher::next(void* buffer) {
+  const size_t count = pop();
+  if (count) std::memcpy(buffer, &m_current[0], count * m_object_size);
+  return count;
+}
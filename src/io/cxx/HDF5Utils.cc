@@ -55,7 +55,8 @@ static void delete_h5p (hid_t* p) {
 }
 
 static boost::shared_ptr<hid_t> open_file(const boost::filesystem::path& path,
-    unsigned int flags, boost::shared_ptr<hid_t>& fcpl) {
+    unsigned int flags, boost::shared_ptr<hid_t>& fcpl,
+    const boost::shared_ptr<hid_t>& fapl) {
 
   boost::shared_ptr<hid_t> retval(new hid_t(-1), std::ptr_fun(delete_h5file));
 
@@ -67,7 +68,7 @@ static boost::shared_ptr<hid_t> open_file(const boost::filesystem::path& path,
   }
 
   if (boost::filesystem::exists(path) && flags != H5F_ACC_TRUNC) { //open
-    *retval = H5Fopen(path.string().c_str(), flags, H5P_DEFAULT);
+    *retval = H5Fopen(path.string().c_str(), flags, *fapl);
     if (*retval < 0) {
       boost::format m("call to HDF5 C-function H5Fopen() returned error %d. HDF5 error statck follows:\n%s");
       m % *retval % bob::io::format_hdf5_error();
@@ -84,7 +85,7 @@ static boost::shared_ptr<hid_t> open_file(const boost::filesystem::path& path,
   }
   else { //file needs to be created or truncated (can set user block)
     *retval = H5Fcreate(path.string().c_str(), H5F_ACC_TRUNC,
-        *fcpl, H5P_DEFAULT);
+        *fcpl, *fapl);
     if (*retval < 0) {
       boost::format m("call to HDF5 C-function H5Fcreate() returned error %d. HDF5 error statck follows:\n%s");
       m % *retval % bob::io::format_hdf5_error();
@@ -113,12 +114,50 @@ static boost::shared_ptr<hid_t> create_fcpl(hsize_t userblock_size) {
   return retval;
 }
 
+/**
+ * Creates the file access property list, which sets the default raw data
+ * chunk cache of the datasets
+ */
+static boost::shared_ptr<hid_t> create_fapl(size_t cache_size,
+    size_t cache_slots) {
+  if (!cache_size && !cache_slots) return boost::make_shared<hid_t>(H5P_DEFAULT);
+  boost::shared_ptr<hid_t> retval(new hid_t(-1), std::ptr_fun(delete_h5p));
+  *retval = H5Pcreate(H5P_FILE_ACCESS);
+  if (*retval < 0) {
+    boost::format m("call to HDF5 C-function H5Pcreate() returned error %d. HDF5 error statck follows:\n%s");
+    m % *retval % bob::io::format_hdf5_error();
+    throw std::runtime_error(m.str());
+  }
+  //keeps the current values of the settings which are not given
+  int mdc_nelmts;
+  size_t rdcc_nslots, rdcc_nbytes;
+  double rdcc_w0;
+  herr_t err = H5Pget_cache(*retval, &mdc_nelmts, &rdcc_nslots, &rdcc_nbytes,
+      &rdcc_w0);
+  if (err < 0) {
+    boost::format m("call to HDF5 C-function H5Pget_cache() returned error %d. HDF5 error statck follows:\n%s");
+    m % err % bob::io::format_hdf5_error();
+    throw std::runtime_error(m.str());
+  }
+  if (cache_size) rdcc_nbytes = cache_size;
+  if (cache_slots) rdcc_nslots = cache_slots;
+  err = H5Pset_cache(*retval, mdc_nelmts, rdcc_nslots, rdcc_nbytes, rdcc_w0);
+  if (err < 0) {
+    boost::format m("call to HDF5 C-function H5Pset_cache() returned error %d. HDF5 error statck follows:\n%s");
+    m % err % bob::io::format_hdf5_error();
+    throw std::runtime_error(m.str());
+  }
+  return retval;
+}
+
 bob::io::detail::hdf5::File::File(const boost::filesystem::path& path, unsigned int flags,
-    size_t userblock_size):
+    size_t userblock_size, size_t cache_size, size_t cache_slots):
   m_path(path),
   m_flags(flags),
   m_fcpl(create_fcpl(userblock_size)),
-  m_id(open_file(m_path, m_flags, m_fcpl))
+  m_id(open_file(m_path, m_flags, m_fcpl, create_fapl(cache_size, cache_slots))),
+  m_shuffle(false),
+  m_fast_compression(false)
 {
 }
 
@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <bob/core/blitz_array.h>
 #include <bob/io/TensorFile.h>
 #include <bob/io/CodecRegistry.h>
 
@@ -52,15 +53,12 @@ class TensorArrayFile: public bob::io::File {
     }
 
     virtual const std::string& name() const {
-      return s_codecname;
+      return m_file.isMapped()? s_mapped_codecname : s_codecname;
     }
 
     virtual void read_all(bob::core::array::interface& buffer) {
 
-      if(!m_file) 
-        throw std::runtime_error("uninitialized binary file cannot be read");
-
-      m_file.read(0, buffer);
+      read(buffer, 0);
 
     }
 
@@ -69,6 +67,13 @@ class TensorArrayFile: public bob::io::File {
       if(!m_file) 
         throw std::runtime_error("uninitialized binary file cannot be read");
 
+      // blitz::Array<>'s cannot keep the mapping alive: copy into those
+      if (m_file.isViewable() &&
+          !dynamic_cast<bob::core::array::blitz_array*>(&buffer)) {
+        buffer.set(m_file.view(index));
+        return;
+      }
+
       m_file.read(index, buffer);
 
     }
@@ -97,10 +102,12 @@ class TensorArrayFile: public bob::io::File {
     std::string m_filename;
 
     static std::string s_codecname;
+    static std::string s_mapped_codecname;
 
 };
 
 std::string TensorArrayFile::s_codecname = "bob.tensor";
+std::string TensorArrayFile::s_mapped_codecname = "bob.tensor.mapped";
 
 /**
  * From this point onwards we have the registration procedure. If you are
@@ -141,6 +148,22 @@ make_file (const std::string& path, char mode) {
 
 }
 
+/**
+ * Read-only variant mapping the file in memory. Arrays that can be viewed in
+ * place are not copied, but refer to the mapped pages (see
+ * bob::io::TensorFile::view()).
+ */
+static boost::shared_ptr<bob::io::File>
+make_mapped_file (const std::string& path, char mode) {
+
+  if (mode != 'r')
+    throw std::runtime_error("mapped tensor files can only be opened for reading");
+
+  return boost::make_shared<TensorArrayFile>(path,
+      bob::io::TensorFile::in | bob::io::TensorFile::mapped);
+
+}
+
 /**
  * Takes care of codec registration per se.
  */
@@ -150,6 +173,7 @@ static bool register_codec() {
     bob::io::CodecRegistry::instance();
   
   instance->registerExtension(".tensor", "torch3vision v2.1 tensor files", &make_file);
+  instance->registerExtension(".mtensor", "torch3vision v2.1 tensor files (mapped in memory, read-only)", &make_mapped_file);
 
   return true;
 
@@ -20,23 +20,115 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <boost/make_shared.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include <bob/core/array_type.h>
+#include <bob/core/logging.h>
 #include <bob/io/TensorFile.h>
 #include <bob/io/reorder.h>
 
+/**
+ * Reverses the bytes of each element of an array read from a file written on
+ * a machine of the other byte order
+ */
+static void swap_bytes(void* buffer, const bob::core::array::typeinfo& info) {
+  const size_t item_size = info.item_size();
+  const size_t n_elements = info.size();
+  char* p = static_cast<char*>(buffer);
+  for (size_t i=0; i<n_elements; ++i, p+=item_size)
+    std::reverse(p, p + item_size);
+}
+
+#ifndef _WIN32
+/**
+ * Unmaps the file once the last reference to the mapping goes away
+ */
+struct munmap_deleter {
+  size_t size;
+  munmap_deleter(size_t size_): size(size_) { }
+  void operator()(void* addr) const { ::munmap(addr, size); }
+};
+#endif
+
+/**
+ * A read-only array referring to the mapped pages of a tensor file, which
+ * keeps the mapping alive
+ */
+class MappedTensorArray: public bob::core::array::interface {
+
+  public: //api
+
+    MappedTensorArray(boost::shared_ptr<void> mapping, void* ptr,
+        const bob::core::array::typeinfo& type):
+      m_mapping(mapping),
+      m_ptr(ptr),
+      m_type(type) {
+      }
+
+    virtual ~MappedTensorArray() { }
+
+    virtual void set(const bob::core::array::interface&) {
+      throw std::runtime_error("cannot set a view of a mapped tensor file");
+    }
+
+    virtual void set(boost::shared_ptr<bob::core::array::interface>) {
+      throw std::runtime_error("cannot set a view of a mapped tensor file");
+    }
+
+    virtual void set(const bob::core::array::typeinfo&) {
+      throw std::runtime_error("cannot set a view of a mapped tensor file");
+    }
+
+    virtual const bob::core::array::typeinfo& type() const { return m_type; }
+
+    virtual void* ptr() { return m_ptr; }
+    virtual const void* ptr() const { return m_ptr; }
+
+    virtual boost::shared_ptr<void> owner() {
+      return boost::shared_ptr<void>(m_mapping, m_ptr);
+    }
+
+    virtual boost::shared_ptr<const void> owner() const {
+      return boost::shared_ptr<const void>(m_mapping, m_ptr);
+    }
+
+  private: //representation
+
+    boost::shared_ptr<void> m_mapping;
+    void* m_ptr;
+    bob::core::array::typeinfo m_type;
+
+};
+
 bob::io::TensorFile::TensorFile(const std::string& filename,
     bob::io::TensorFile::openmode flag):
   m_header_init(false),
   m_current_array(0),
   m_n_arrays_written(0),
-  m_openmode(flag)
+  m_openmode(flag),
+  m_mapped_size(0)
 {
+  if((flag & bob::io::TensorFile::mapped) && (flag & bob::io::TensorFile::out))
+    throw std::runtime_error("mapped tensor files can only be opened for reading");
+
   if((flag & bob::io::TensorFile::out) && (flag & bob::io::TensorFile::in)) {
     m_stream.open(filename.c_str(), std::ios::in | std::ios::out |
         std::ios::binary);
     if(m_stream)
     {
       m_header.read(m_stream);
+      if (m_header.m_swap)
+        throw std::runtime_error("cannot write to a tensor file with the byte order of another machine");
       m_buffer.reset(new char[m_header.m_type.buffer_size()]);
       m_header_init = true;
       m_n_arrays_written = m_header.m_n_samples;
@@ -52,6 +144,8 @@ bob::io::TensorFile::TensorFile(const std::string& filename,
       m_stream.open(filename.c_str(), std::ios::out | std::ios::in |
           std::ios::binary);
       m_header.read(m_stream);
+      if (m_header.m_swap)
+        throw std::runtime_error("cannot write to a tensor file with the byte order of another machine");
       m_buffer.reset(new char[m_header.m_type.buffer_size()]);
       m_header_init = true;
       m_n_arrays_written = m_header.m_n_samples;
@@ -72,6 +166,11 @@ bob::io::TensorFile::TensorFile(const std::string& filename,
       if (flag & bob::io::TensorFile::append) {
         throw std::runtime_error("cannot append data in read only mode");
       }
+
+      if (flag & bob::io::TensorFile::mapped) {
+        map(filename);
+        advise(flag);
+      }
     }
   }
   else {
@@ -93,6 +192,95 @@ void bob::io::TensorFile::close() {
   if(m_openmode & bob::io::TensorFile::out) m_header.write(m_stream);
 
   m_stream.close();
+
+  // Views handed out by view(index) keep their own reference to the mapping
+  m_mapping.reset();
+  m_mapped_size = 0;
+}
+
+void bob::io::TensorFile::map(const std::string& filename) {
+#ifdef _WIN32
+  throw std::runtime_error("mapped tensor files are not supported on this platform");
+#else
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    boost::format m("cannot open tensor file '%s' for mapping: %s");
+    m % filename % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    boost::format m("cannot stat tensor file '%s': %s");
+    m % filename % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+
+  const size_t expected = m_header.getArrayIndex(m_header.m_n_samples);
+  if ((size_t)st.st_size < expected) {
+    ::close(fd);
+    boost::format m("tensor file '%s' declares %d arrays of %d bytes, but has only %d bytes");
+    m % filename % m_header.m_n_samples % m_header.m_tensor_size % st.st_size;
+    throw std::runtime_error(m.str());
+  }
+
+  // Private (copy-on-write) mapping: modifications of the views never reach
+  // the file
+  void* addr = ::mmap(0, expected, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    boost::format m("cannot map tensor file '%s': %s");
+    m % filename % std::strerror(errno);
+    throw std::runtime_error(m.str());
+  }
+
+  m_mapping.reset(addr, munmap_deleter(expected));
+  m_mapped_size = expected;
+#endif
+}
+
+void bob::io::TensorFile::advise(bob::io::TensorFile::openmode hint) {
+  if (!m_mapping) return;
+#ifndef _WIN32
+  int advice = MADV_NORMAL;
+  if (hint & bob::io::TensorFile::sequential) advice = MADV_SEQUENTIAL;
+  else if (hint & bob::io::TensorFile::random) advice = MADV_RANDOM;
+  if (::madvise(m_mapping.get(), m_mapped_size, advice) != 0) {
+    boost::format m("madvise() failed on mapped tensor file: %s");
+    m % std::strerror(errno);
+    bob::core::warn << m.str() << std::endl;
+  }
+#endif
+}
+
+bool bob::io::TensorFile::isViewable() const {
+  if (!m_mapping || m_header.m_swap) return false;
+
+  // The header has 7 integers: elements of 64 bits are not aligned
+  if (m_header.getArrayIndex(0) % m_header.m_type.item_size()) return false;
+
+  size_t non_unit = 0;
+  for (size_t k=0; k<m_header.m_type.nd; ++k)
+    if (m_header.m_type.shape[k] > 1) ++non_unit;
+  return non_unit <= 1;
+}
+
+void* bob::io::TensorFile::mappedArray(size_t index) const {
+  if (index >= m_header.m_n_samples) {
+    boost::format m("request to view list item at position %d which is outside the bounds of declared object with size %d");
+    m % index % m_header.m_n_samples;
+    throw std::runtime_error(m.str());
+  }
+  return static_cast<char*>(m_mapping.get()) + m_header.getArrayIndex(index);
+}
+
+boost::shared_ptr<bob::core::array::interface>
+bob::io::TensorFile::view(size_t index) const {
+  if (!isViewable())
+    throw std::runtime_error("the arrays of this tensor file cannot be viewed in place - read() them instead");
+  return boost::make_shared<MappedTensorArray>(m_mapping, mappedArray(index),
+      m_header.m_type);
 }
 
 void bob::io::TensorFile::initHeader(const bob::core::array::typeinfo& info) {
@@ -139,10 +327,22 @@ void bob::io::TensorFile::read (bob::core::array::interface& buf) {
   }
   if(!buf.type().is_compatible(m_header.m_type)) buf.set(m_header.m_type);
 
-  m_stream.read(reinterpret_cast<char*>(m_buffer.get()),
-      m_header.m_type.buffer_size());
-
-  bob::io::col_to_row_order(m_buffer.get(), buf.ptr(), m_header.m_type);
+  if (m_mapping) {
+    endOfFile();
+    const void* src = mappedArray(m_current_array);
+    if (m_header.m_swap) {
+      std::memcpy(m_buffer.get(), src, m_header.m_type.buffer_size());
+      swap_bytes(m_buffer.get(), m_header.m_type);
+      src = m_buffer.get();
+    }
+    bob::io::col_to_row_order(src, buf.ptr(), m_header.m_type);
+  }
+  else {
+    m_stream.read(reinterpret_cast<char*>(m_buffer.get()),
+        m_header.m_type.buffer_size());
+    if (m_header.m_swap) swap_bytes(m_buffer.get(), m_header.m_type);
+    bob::io::col_to_row_order(m_buffer.get(), buf.ptr(), m_header.m_type);
+  }
 
   ++m_current_array;
 }
@@ -157,7 +357,7 @@ void bob::io::TensorFile::read (size_t index, bob::core::array::interface& buf)
   }
 
   // Set the stream pointer at the correct position
-  m_stream.seekg( m_header.getArrayIndex(index) );
+  if (!m_mapping) m_stream.seekg( m_header.getArrayIndex(index) );
   m_current_array = index;
 
   // Put the content of the stream in the blitz array.
@@ -20,6 +20,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <boost/format.hpp>
 #include <bob/core/logging.h>
 
@@ -27,6 +28,7 @@
 
 bob::io::detail::TensorFileHeader::TensorFileHeader()
   : m_tensor_type(bob::io::Char),
+    m_swap(false),
     m_type(),
     m_n_samples(0),
     m_tensor_size(0)
@@ -40,31 +42,49 @@ size_t bob::io::detail::TensorFileHeader::getArrayIndex (size_t index) const {
   return header_size + index * m_tensor_size;
 }
 
+/**
+ * Reverses the bytes of an integer read from a file written on a machine of
+ * the other byte order
+ */
+static int swap_int(int val) {
+  char* p = reinterpret_cast<char*>(&val);
+  std::reverse(p, p + sizeof(int));
+  return val;
+}
+
+static int read_int(std::istream& str, bool swap) {
+  int val;
+  str.read( reinterpret_cast<char*>(&val), sizeof(int));
+  return swap ? swap_int(val) : val;
+}
+
 void bob::io::detail::TensorFileHeader::read(std::istream& str) {
   // Start reading at the beginning of the stream
   str.seekg(std::ios_base::beg);
 
-  int val;
-  str.read( reinterpret_cast<char*>(&val), sizeof(int));
+  // The first integer is the tensor type, which tells the byte order
+  int val = read_int(str, false);
+  m_swap = false;
+  if (val < bob::io::Char || val > bob::io::Double) {
+    int swapped = swap_int(val);
+    if (swapped >= bob::io::Char && swapped <= bob::io::Double) {
+      m_swap = true;
+      val = swapped;
+    }
+  }
   m_tensor_type = (bob::io::TensorType)val;
   m_type.dtype = bob::io::tensorTypeToArrayType(m_tensor_type);
 
-  str.read( reinterpret_cast<char*>(&val), sizeof(int));
-  m_n_samples = (size_t)val;
+  m_n_samples = (size_t)read_int(str, m_swap);
 
-  int nd;
-  str.read(reinterpret_cast<char*>(&nd), sizeof(int));
+  int nd = read_int(str, m_swap);
 
   int shape[BOB_MAX_DIM];
 
-  str.read( reinterpret_cast<char*>(&val), sizeof(int));
-  shape[0] = (size_t)val;
-  str.read( reinterpret_cast<char*>(&val), sizeof(int));
-  shape[1] = (size_t)val;
-  str.read( reinterpret_cast<char*>(&val), sizeof(int));
-  shape[2] = (size_t)val;
-  str.read( reinterpret_cast<char*>(&val), sizeof(int));
-  shape[3] = (size_t)val;
+  shape[0] = read_int(str, m_swap);
+  shape[1] = read_int(str, m_swap);
+  shape[2] = read_int(str, m_swap);
+  shape[3] = read_int(str, m_swap);
 
   m_type.set_shape(nd, shape);
 
@@ -0,0 +1,111 @@
+/**
+ * @file io/cxx/benchmark/hdf5.cc
+ * @date Sat Oct 17 18:32:40 2026 +0200
+ *
+ * @brief Benchmark of the HDF5 list datasets: one array per chunk and per
+ * write/read operation, compared to larger chunks, buffered appends and
+ * range reads
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/core/logging.h>
+#include <bob/io/HDF5File.h>
+#include <bob/io/utils.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <iostream>
+
+static void report(const char* what, const boost::posix_time::ptime& t1,
+  const std::string& filename)
+{
+  boost::posix_time::time_duration diff =
+    boost::posix_time::microsec_clock::local_time() - t1;
+  std::cout << "  " << what << " duration in (microseconds) "
+    << diff.total_microseconds();
+  if (filename.size())
+    std::cout << ", file size " << boost::filesystem::file_size(filename);
+  std::cout << std::endl;
+}
+
+void benchmark_frames(const int n_frames, const int dim, const int n_range)
+{
+  const std::string filename = bob::core::tmpfile();
+  blitz::Array<double,1> frame(dim);
+  boost::posix_time::ptime t1;
+
+  std::cout << "Appending and reading " << n_frames << " frames of dimension "
+    << dim << "..." << std::endl;
+
+  // One array per chunk, one extension and write per array
+  t1 = boost::posix_time::microsec_clock::local_time();
+  {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::trunc);
+    for (int k=0; k<n_frames; ++k) {
+      frame = k;
+      f.appendArray("array", frame);
+    }
+  }
+  report("append (one array per chunk)", t1, filename);
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::in);
+    for (int k=0; k<n_frames; ++k) f.readArray("array", k, frame);
+  }
+  report("read (one array per chunk and per read)", t1, "");
+
+  // Write-behind buffer of 1 MiB, with chunks of 64 KiB
+  t1 = boost::posix_time::microsec_clock::local_time();
+  {
+    boost::shared_ptr<bob::io::File> f = bob::io::open_hdf5(filename, 'w',
+      1<<16, 1<<20);
+    for (int k=0; k<n_frames; ++k) {
+      frame = k;
+      f->append(frame);
+    }
+  }
+  report("append (buffered)", t1, filename);
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::in);
+    for (int k=0; k<n_frames; ++k) f.readArray("array", k, frame);
+  }
+  report("read (one read per array)", t1, "");
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  {
+    bob::io::HDF5File f(filename, bob::io::HDF5File::in);
+    blitz::Array<double,2> frames(n_range, dim);
+    for (int k=0; k+n_range<=n_frames; k+=n_range)
+      f.readArray("array", k, k+n_range, frames);
+  }
+  report("read (ranges of arrays)", t1, "");
+
+  boost::filesystem::remove(filename);
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char** argv)
+{
+  // Cepstral features
+  benchmark_frames(100000, 60, 1000);
+  // GMM statistics supervectors
+  benchmark_frames(500, 512*40, 50);
+}
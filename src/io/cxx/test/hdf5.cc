@@ -34,6 +34,8 @@
 #include "bob/core/logging.h" // for bob::core::tmpdir()
 #include "bob/core/cast.h"
 #include "bob/io/HDF5File.h"
+#include "bob/io/HDF5Prefetcher.h"
+#include "bob/io/utils.h"
 
 struct T {
   blitz::Array<double,2> a;
@@ -146,4 +148,134 @@ BOOST_AUTO_TEST_CASE( hdf5_write_on_readonly )
   boost::filesystem::remove(filename);
 }
 
+BOOST_AUTO_TEST_CASE( hdf5_range_read )
+{
+  // Append the rows of a 2D array, several of them per chunk
+  const std::string filename = bob::core::tmpfile();
+  bob::io::HDF5File config(filename, bob::io::HDF5File::trunc);
+  for (int i=0; i<a.extent(0); ++i) {
+    blitz::Array<double,1> row = a(i, blitz::Range::all());
+    config.appendArray("rows", row, 0, 3*sizeof(double)*a.extent(1));
+    config.append("scalars", c(i));
+  }
+
+  // Read a range of rows at once and compare to original
+  blitz::Array<double,2> rows(2, a.extent(1));
+  config.readArray("rows", 1, 3, rows);
+  check_equal(blitz::Array<double,2>(a(blitz::Range(1,2), blitz::Range::all())), rows);
+  blitz::Array<double,1> scalars(a.extent(0));
+  config.readArray("scalars", 0, a.extent(0), scalars);
+  check_equal(blitz::Array<double,1>(c(blitz::Range(0,a.extent(0)-1))), scalars);
+
+  // Out of range
+  blitz::Array<double,2> too_many(a.extent(0), a.extent(1));
+  BOOST_REQUIRE_THROW(config.readArray("rows", 1, a.extent(0)+1, too_many), std::runtime_error);
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( hdf5_buffered_append )
+{
+  // Append more arrays than the write-behind buffer holds
+  const std::string filename = bob::core::tmpfile(".hdf5");
+  const int n_arrays = 20000;
+  blitz::Array<double,1> x(c.extent(0));
+  {
+    boost::shared_ptr<bob::io::File> f = bob::io::open_hdf5(filename, 'w',
+        1<<16, 1<<20);
+    for (int k=0; k<n_arrays; ++k) {
+      x = c + k;
+      BOOST_CHECK_EQUAL(f->append(x), (size_t)k);
+    }
+    // Buffered arrays can be read back
+    BOOST_CHECK_EQUAL(f->size(), (size_t)n_arrays);
+    check_equal(blitz::Array<double,1>(c + (n_arrays-1)), f->read<double,1>(n_arrays-1));
+  }
+
+  // And are in the file once it is closed
+  boost::shared_ptr<bob::io::File> f = bob::io::open(filename, 'r');
+  BOOST_CHECK_EQUAL(f->size(), (size_t)n_arrays);
+  blitz::Array<double,2> all = f->read_all<double,2>();
+  for (int k=0; k<n_arrays; k+=997) {
+    x = c + k;
+    check_equal(x, blitz::Array<double,1>(all(k, blitz::Range::all())));
+  }
+
+  // Clean-up
+  f.reset();
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( hdf5_small_arrayset )
+{
+  // The default codec writes each array at once, in small chunks: a few
+  // small arrays only take a few KiB
+  const std::string filename = bob::core::tmpfile(".hdf5");
+  {
+    boost::shared_ptr<bob::io::File> f = bob::io::open(filename, 'w');
+    for (int k=0; k<3; ++k) f->append(c);
+  }
+  BOOST_CHECK(boost::filesystem::file_size(filename) < (1<<14));
+  BOOST_CHECK_EQUAL(bob::io::open(filename, 'r')->size(), (size_t)3);
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( hdf5_prefetcher )
+{
+  // Append compressed and shuffled arrays, with a larger chunk cache
+  const std::string filename = bob::core::tmpfile();
+  const int n_arrays = 1000;
+  blitz::Array<double,1> x(c.extent(0));
+  {
+    bob::io::HDF5File config(filename, bob::io::HDF5File::trunc, 1 << 22, 521);
+    config.setShuffle(true);
+    BOOST_CHECK(config.getShuffle());
+    for (int k=0; k<n_arrays; ++k) {
+      x = c + k;
+      config.appendArray("x", x, 6, 16*sizeof(double)*x.extent(0));
+    }
+    config.setChunkCache("x", 1 << 20, 101);
+    blitz::Array<double,1> x_read;
+    x_read.reference(config.readArray<double,1>("x", 42));
+    x = c + 42;
+    check_equal(x, x_read);
+  }
+
+  // Read the arrays by blocks (the last one being smaller)
+  bob::io::HDF5File config(filename, bob::io::HDF5File::in);
+  int n_read = 0;
+  {
+    bob::io::HDF5Prefetcher prefetcher(config, "x", 64, 3);
+    BOOST_CHECK_EQUAL(prefetcher.size(), (size_t)n_arrays);
+    blitz::Array<double,2> block;
+    while (prefetcher.next(block)) {
+      BOOST_REQUIRE_EQUAL(block.extent(1), c.extent(0));
+      for (int i=0; i<block.extent(0); ++i) {
+        x = c + (n_read + i);
+        check_equal(x, blitz::Array<double,1>(block(i, blitz::Range::all())));
+      }
+      n_read += block.extent(0);
+    }
+    BOOST_CHECK(!prefetcher.next(block));
+
+    // Wrong element type
+    blitz::Array<float,2> wrong;
+    BOOST_CHECK_THROW(prefetcher.next(wrong), std::runtime_error);
+  }
+  BOOST_CHECK_EQUAL(n_read, n_arrays);
+
+  // Stops before the end
+  {
+    bob::io::HDF5Prefetcher prefetcher(config, "x", 10, 2);
+    blitz::Array<double,2> block;
+    BOOST_CHECK(prefetcher.next(block));
+  }
+
+  // Clean-up
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -26,10 +26,13 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/shared_array.hpp>
+#include <algorithm>
+#include <fstream>
 
 #include <blitz/array.h>
 #include "bob/core/logging.h"
 #include "bob/io/utils.h"
+#include "bob/io/TensorFile.h"
 
 struct T {
   blitz::Array<int8_t,2> a, b;
@@ -84,4 +87,124 @@ BOOST_AUTO_TEST_CASE( tensor_2d_read_T5alpha )
   check_equal( bob::io::load<int8_t,2>(testdata_path.string()), b );
 }
 
+BOOST_AUTO_TEST_CASE( tensor_mapped_view )
+{
+  std::string filename = bob::core::tmpfile(".tensor");
+  blitz::Array<float,1> v(7);
+  {
+    bob::io::TensorFile out(filename, bob::io::TensorFile::out);
+    for (int i=0; i<5; ++i) {
+      for (int j=0; j<7; ++j) v(j) = 10*i + j;
+      out.write(v);
+    }
+  }
+
+  bob::io::TensorFile in(filename, bob::io::TensorFile::in |
+      bob::io::TensorFile::mapped | bob::io::TensorFile::sequential);
+  BOOST_CHECK(in.isMapped());
+  BOOST_REQUIRE(in.isViewable());
+
+  blitz::Array<float,2> all = in.view_all<float,2>();
+  BOOST_REQUIRE_EQUAL(all.extent(0), 5);
+  BOOST_REQUIRE_EQUAL(all.extent(1), 7);
+  for (int i=0; i<5; ++i) {
+    blitz::Array<float,1> view = in.view<float,1>(i);
+    BOOST_CHECK_EQUAL(view.data(), all.data() + 7*i);
+    blitz::Array<double,1> converted = in.view<double,1>(i);
+    blitz::Array<float,1> copy = in.read<float,1>(i);
+    for (int j=0; j<7; ++j) {
+      BOOST_CHECK_EQUAL(all(i,j), 10*i + j);
+      BOOST_CHECK_EQUAL(view(j), 10*i + j);
+      BOOST_CHECK_EQUAL(converted(j), 10*i + j);
+      BOOST_CHECK_EQUAL(copy(j), 10*i + j);
+    }
+  }
+
+  // views are private to this process
+  in.advise(bob::io::TensorFile::random);
+  all(0,0) = -1.f;
+  BOOST_CHECK_EQUAL(bob::io::load<float,1>(filename)(0), 0.f);
+
+  // the mapped codec refers to the mapped pages when it can
+  boost::shared_ptr<bob::io::File> f = bob::io::open(filename, 'r', ".mtensor");
+  BOOST_CHECK_EQUAL(f->name(), "bob.tensor.mapped");
+  BOOST_CHECK_EQUAL(f->read<float,1>(3)(4), 34.f);
+  boost::shared_ptr<bob::core::array::interface> view = in.view(2);
+  in.close();
+  BOOST_CHECK_EQUAL(static_cast<const float*>(view->ptr())[6], 26.f);
+
+  boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE( tensor_mapped_copy )
+{
+  std::string filename = bob::core::tmpfile(".tensor");
+  bob::io::save(filename, a);
+
+  // column-major 2D arrays cannot be viewed in place
+  bob::io::TensorFile in(filename, bob::io::TensorFile::in |
+      bob::io::TensorFile::mapped);
+  BOOST_CHECK(!in.isViewable());
+  BOOST_CHECK_THROW(in.view(0), std::runtime_error);
+  check_equal( in.view<int8_t,2>(0), a );
+  blitz::Array<int8_t,3> all = in.view_all<int8_t,3>();
+  BOOST_REQUIRE_EQUAL(all.extent(0), 1);
+  check_equal( blitz::Array<int8_t,2>(all(0, blitz::Range::all(),
+          blitz::Range::all())), a );
+  check_equal( bob::io::open(filename, 'r', ".mtensor")->read<int8_t,2>(0), a );
+
+  BOOST_CHECK_THROW(bob::io::TensorFile(filename, bob::io::TensorFile::out |
+        bob::io::TensorFile::mapped), std::runtime_error);
+
+  boost::filesystem::remove(filename);
+}
+
+/**
+ * Writes an integer (or an element of an array) with the other byte order
+ */
+template <typename T> static void write_swapped(std::ostream& s, T value) {
+  char* p = reinterpret_cast<char*>(&value);
+  std::reverse(p, p + sizeof(T));
+  s.write(p, sizeof(T));
+}
+
+BOOST_AUTO_TEST_CASE( tensor_swapped )
+{
+  std::string filename = bob::core::tmpfile(".tensor");
+  {
+    std::ofstream s(filename.c_str(), std::ios::binary);
+    write_swapped<int>(s, bob::io::Int);
+    write_swapped<int>(s, 2); //samples
+    write_swapped<int>(s, 1); //dimensions
+    write_swapped<int>(s, 3);
+    write_swapped<int>(s, 0);
+    write_swapped<int>(s, 0);
+    write_swapped<int>(s, 0);
+    for (int32_t i=0; i<6; ++i) write_swapped<int32_t>(s, 1000*i - 1);
+  }
+
+  // the byte order is detected with and without mapping
+  bob::io::TensorFile stream(filename, bob::io::TensorFile::in);
+  bob::io::TensorFile mapped(filename, bob::io::TensorFile::in |
+      bob::io::TensorFile::mapped);
+  BOOST_CHECK(!mapped.isViewable());
+  BOOST_REQUIRE_EQUAL(stream.size(), 2);
+  BOOST_REQUIRE_EQUAL(mapped.size(), 2);
+  for (size_t i=0; i<2; ++i) {
+    blitz::Array<int32_t,1> s = stream.read<int32_t,1>(i);
+    blitz::Array<int32_t,1> m = mapped.view<int32_t,1>(i);
+    for (int j=0; j<3; ++j) {
+      BOOST_CHECK_EQUAL(s(j), 1000*(3*(int)i+j) - 1);
+      BOOST_CHECK_EQUAL(m(j), 1000*(3*(int)i+j) - 1);
+    }
+  }
+  stream.close();
+  mapped.close();
+
+  BOOST_CHECK_THROW(bob::io::TensorFile(filename, bob::io::TensorFile::in |
+        bob::io::TensorFile::out), std::runtime_error);
+
+  boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -51,6 +51,11 @@ static boost::shared_ptr<bob::io::File> string_open2 (const std::string& filenam
   return bob::io::open(filename, mode[0], pretend_extension);
 }
 
+static boost::shared_ptr<bob::io::File> string_open_hdf5 (const std::string& filename,
+    const std::string& mode, size_t chunk_size, size_t buffer_size) {
+  return bob::io::open_hdf5(filename, mode[0], chunk_size, buffer_size);
+}
+
 static void file_write(bob::io::File& f, object array) {
   bob::python::py_array a(array, object());
   f.write(a);
@@ -86,8 +91,11 @@ void bind_io_file() {
     .def("read", &file_read, (arg("self"), arg("index")), "Reads a single array from the file considering it to be an arrayset list")
     .def("__getitem__", &file_read, (arg("self"), arg("index")), "Reads a single array from the file considering it to be an arrayset list")
     .def("append", &file_append, (arg("self"), arg("array")), "Appends an array to a file. Compatibility requirements may be enforced.")
+    .def("flush", &bob::io::File::flush, (arg("self")), "Writes the arrays which are buffered in memory (if any) to the file, raising an exception on failure. The arrays are also written when the file is destroyed, but the errors can then only be logged.")
     ;
 
+  def("open_hdf5", &string_open_hdf5, (arg("filename"), arg("mode"), arg("chunk_size")=4096, arg("buffer_size")=0), "Opens a file with the HDF5 codec, whatever its extension. The arrays appended to a new file are stored in chunks of about chunk_size bytes. If buffer_size is not zero, they are kept in a write-behind buffer of buffer_size bytes, which is written by blocks, before any read, by flush() (which raises the errors of the writing) and when the file is destroyed (which can only log them). Other handles on the file do not see the buffered arrays.");
+
   def("extensions", &extensions, "Returns a dictionary containing all extensions and descriptions currently stored on the global codec registry");
 
 }
@@ -673,7 +673,7 @@ BOOST_PYTHON_FUNCTION_OVERLOADS(hdf5file_del_attributes_overloads, hdf5file_del_
 void bind_io_hdf5() {
   class_<bob::io::HDF5File, boost::shared_ptr<bob::io::HDF5File> >("HDF5File", "A HDF5File allows users to read and write data from and to files containing standard bob binary coded data in HDF5 format. For an introduction to HDF5, please visit http://www.hdfgroup.org/HDF5.", no_init)
     .def(init<const bob::io::HDF5File&> ((arg("self"), arg("other")), "Generates a shallow copy of the already opened file."))
-    .def(init<const std::string&, const char> ((arg("self"), arg("filename"), arg("openmode_string")='r'), "Opens a new file in one of these supported modes: 'r' (read-only), 'a' (read/write/append), 'w' (read/write/truncate) or 'x' (read/write/exclusive)"))
+    .def(init<const std::string&, const char, const size_t, const size_t> ((arg("self"), arg("filename"), arg("openmode_string")='r', arg("cache_size")=0, arg("cache_slots")=0), "Opens a new file in one of these supported modes: 'r' (read-only), 'a' (read/write/append), 'w' (read/write/truncate) or 'x' (read/write/exclusive). Optionally sets the size in bytes and the number of slots of the raw data chunk cache of each dataset of the file (0 keeps the HDF5 defaults, see set_chunk_cache())."))
     .def("cd", &bob::io::HDF5File::cd, (arg("self"), arg("path")), "Changes the current prefix path. When this object is started, the prefix path is empty, which means all following paths to data objects should be given using the full path. If you set this to a different value, it will be used as a prefix to any subsequent operation until you reset it. If path starts with '/', it is treated as an absolute path. '..' and '.' are supported. This object should be a std::string. If the value is relative, it is added to the current path. If it is absolute, it causes the prefix to be reset. Note all operations taking a relative path, following a cd(), will be considered relative to the value defined by the 'cwd' property of this object.")
     .def("has_group", &bob::io::HDF5File::hasGroup, (arg("self"), arg("path")), "Checks if a path exists inside a file - does not work for datasets, only for directories. If the given path is relative, it is take w.r.t. to the current working directory")
     .def("create_group", &bob::io::HDF5File::createGroup, (arg("self"), arg("path")), "Creates a new directory inside the file. A relative path is taken w.r.t. to the current directory. If the directory already exists (check it with hasGroup()), an exception will be raised.")
@@ -683,6 +683,9 @@ void bind_io_hdf5() {
     .def("describe", &hdf5file_describe, (arg("self"), arg("key")), "If a given path to an HDF5 dataset exists inside the file, return a type description of objects recorded in such a dataset, otherwise, raises an exception. The returned value type is a tuple of tuples (HDF5Type, number-of-objects, expandible) describing the capabilities if the file is read using theses formats.")
     .def("unlink", &bob::io::HDF5File::unlink, (arg("self"), arg("key")), "If a given path to an HDF5 dataset exists inside the file, unlinks it. Please note this will note remove the data from the file, just make it inaccessible. If you wish to cleanup, save the reacheable objects from this file to another HDF5File object using copy(), for example.")
     .def("rename", &bob::io::HDF5File::rename, (arg("self"), arg("from"), arg("to")), "If a given path to an HDF5 dataset exists in the file, rename it")
+    .def("set_chunk_cache", &bob::io::HDF5File::setChunkCache, (arg("self"), arg("key"), arg("cache_size"), arg("cache_slots")=0), "Sets the size in bytes and the number of slots of the raw data chunk cache of a dataset, for as long as this file is opened (or until a dataset is renamed). A value of 0 keeps the current setting. Chunks read (and decompressed) remain in the cache, which speeds up random accesses to compressed datasets: the cache should hold the chunks which are accessed repeatedly, and the number of slots should be a prime number about 100 times larger than the number of chunks which fit in the cache.")
+    .add_property("shuffle", &bob::io::HDF5File::getShuffle, &bob::io::HDF5File::setShuffle, "If set, the bytes of the datasets which are compressed, and created from now on through this object, are shuffled before compression (off by default). Shuffling usually improves the compression of numerical data.")
+    .add_property("fast_compression", &bob::io::HDF5File::getFastCompression, &bob::io::HDF5File::setFastCompression, "If set, the datasets which are compressed, and created from now on through this object, use the LZF filter, which compresses less but a lot faster than gzip (off by default). The compression level is then ignored. The LZF filter is a plugin of the HDF5 library: gzip is used if it is not available. Note that other programs reading these datasets also need the LZF filter.")
     .def("keys", &hdf5file_paths, (arg("self"), arg("relative") = false), "Synonym for 'paths'")
     .def("paths", &hdf5file_paths, (arg("self"), arg("relative") = false), "Returns all paths to datasets available inside this file, stored under the current working directory. If relative is set to True, the returned paths are relative to the current working directory, otherwise they are asbolute.")
     .def("sub_groups", &hdf5file_sub_groups, (arg("self"), arg("relative") = false, arg("recursive") = true), "Returns all the subgroups (sub-directories) in the current file.")
@@ -223,6 +223,7 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   m_dc_free(dc_free),
   m_fft(0,0),
   m_ifft(0,0),
+  m_rfft(0,0),
   m_number_of_scales(number_of_scales),
   m_number_of_directions(number_of_directions)
 {
@@ -240,6 +241,7 @@ bob::ip::GaborWaveletTransform::GaborWaveletTransform(
   m_dc_free(other.m_dc_free),
   m_fft(0,0),
   m_ifft(0,0),
+  m_rfft(0,0),
   m_number_of_scales(other.m_number_of_scales),
   m_number_of_directions(other.m_number_of_directions)
 {
@@ -259,6 +261,7 @@ bob::ip::GaborWaveletTransform::operator =
   m_dc_free = other.m_dc_free;
   m_fft = bob::sp::FFT2D(0,0);
   m_ifft = bob::sp::IFFT2D(0,0);
+  m_rfft = bob::sp::RFFT2D(0,0);
   m_number_of_scales = other.m_number_of_scales;
   m_number_of_directions = other.m_number_of_directions;
 
@@ -354,8 +357,10 @@ void bob::ip::GaborWaveletTransform::generateKernels(
     // reset fft sizes
     m_fft.reset(resolution[0], resolution[1]);
     m_ifft.reset(resolution[0], resolution[1]);
+    m_rfft.reset(resolution[0], resolution[1]);
     m_temp_array.resize(blitz::shape(resolution[0],resolution[1]));
     m_frequency_image.resize(m_temp_array.shape());
+    m_half_frequency_image.resize(blitz::shape(resolution[0],m_rfft.getHalfWidth()));
   }
 }
 
@@ -374,13 +379,12 @@ blitz::Array<double,3> bob::ip::GaborWaveletTransform::kernelImages() const{
 }
 
 /**
- * Computes the Gabor wavelet transformation for the given image (in spatial domain)
+ * Computes the spectrum of the given complex image into m_frequency_image,
+ * generating the kernels if required
  * @param gray_image  The source image in spatial domain
- * @param trafo_image The convolution result, in spatial domain
  */
-void bob::ip::GaborWaveletTransform::performGWT(
-  const blitz::Array<std::complex<double>,2>& gray_image,
-  blitz::Array<std::complex<double>,3>& trafo_image
+void bob::ip::GaborWaveletTransform::computeFrequencyImage(
+  const blitz::Array<std::complex<double>,2>& gray_image
 )
 {
   // first, check if we need to reset the kernels
@@ -388,9 +392,47 @@ void bob::ip::GaborWaveletTransform::performGWT(
 
   // perform Fourier transformation to image
   m_fft(gray_image, m_frequency_image);
+}
 
+/**
+ * Computes the spectrum of the given real image into m_frequency_image,
+ * generating the kernels if required. Only the first half of the spectrum
+ * is computed by the FFT, the second half being obtained from the Hermitian
+ * symmetry of the spectrum of a real image: F(y,x) = conj(F(-y,-x)).
+ * @param gray_image  The source image in spatial domain
+ */
+void bob::ip::GaborWaveletTransform::computeFrequencyImage(
+  const blitz::Array<double,2>& gray_image
+)
+{
+  // first, check if we need to reset the kernels
+  generateKernels(blitz::TinyVector<unsigned,2>(gray_image.extent(0),gray_image.extent(1)));
+
+  // perform Fourier transformation to image (first half of the spectrum)
+  m_rfft(gray_image, m_half_frequency_image);
+
+  // expand the Hermitian half spectrum into the full spectrum
+  const int height = gray_image.extent(0), width = gray_image.extent(1);
+  const int half_width = m_half_frequency_image.extent(1);
+  for (int y = 0; y < height; ++y){
+    const int y_sym = (height - y) % height;
+    for (int x = 0; x < half_width; ++x)
+      m_frequency_image(y,x) = m_half_frequency_image(y,x);
+    for (int x = half_width; x < width; ++x)
+      m_frequency_image(y,x) = std::conj(m_half_frequency_image(y_sym, width - x));
+  }
+}
+
+/**
+ * Computes the Gabor wavelet transformation of the image in m_frequency_image
+ * @param trafo_image The convolution result, in spatial domain
+ */
+void bob::ip::GaborWaveletTransform::performGWT_(
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
   // check that the shape is correct
-  bob::core::array::assertSameShape(trafo_image, blitz::shape(m_kernel_frequencies.size(),gray_image.extent(0),gray_image.extent(1)));
+  bob::core::array::assertSameShape(trafo_image, blitz::shape(m_kernel_frequencies.size(),m_frequency_image.extent(0),m_frequency_image.extent(1)));
 
   // now, let each kernel compute the transformation result
   for (unsigned j = 0; j < m_gabor_kernels.size(); ++j){
@@ -403,25 +445,17 @@ void bob::ip::GaborWaveletTransform::performGWT(
 }
 
 /**
- * Computes the Gabor jets including absolute values and phases for the given image (in spatial domain).
- * @param gray_image  The source image in spatial domain
+ * Computes the Gabor jets including absolute values and phases for the image in m_frequency_image.
  * @param jet_image   The resulting Gabor jet image, including absolute values and phases for each pixel
  * @param do_normalize Shall the Gabor jets be normalized?
  */
-void bob::ip::GaborWaveletTransform::computeJetImage(
-  const blitz::Array<std::complex<double>,2>& gray_image,
+void bob::ip::GaborWaveletTransform::computeJetImage_(
   blitz::Array<double,4>& jet_image,
   bool do_normalize
 )
 {
-  // first, check if we need to reset the kernels
-  generateKernels(blitz::TinyVector<unsigned,2>(gray_image.extent(0),gray_image.extent(1)));
-
-  // perform Fourier transformation to image
-  m_fft(gray_image, m_frequency_image);
-
   // check that the shape is correct
-  bob::core::array::assertSameShape(jet_image, blitz::shape(gray_image.extent(0), gray_image.extent(1), 2, m_kernel_frequencies.size()));
+  bob::core::array::assertSameShape(jet_image, blitz::shape(m_frequency_image.extent(0), m_frequency_image.extent(1), 2, m_kernel_frequencies.size()));
 
   // now, let each kernel compute the transformation result
   for (int j = 0; j < (int)m_gabor_kernels.size(); ++j){
@@ -449,25 +483,17 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
 }
 
 /**
- * Computes the Gabor jets including absolute values only for the given image (in spatial domain).
- * @param gray_image  The source image in spatial domain
+ * Computes the Gabor jets including absolute values only for the image in m_frequency_image.
  * @param jet_image   The resulting Gabor jet image, including only absolute values for each pixel
  * @param do_normalize Shall the Gabor jets be normalized?
  */
-void bob::ip::GaborWaveletTransform::computeJetImage(
-  const blitz::Array<std::complex<double>,2>& gray_image,
+void bob::ip::GaborWaveletTransform::computeJetImage_(
   blitz::Array<double,3>& jet_image,
   bool do_normalize
 )
 {
-  // first, check if we need to reset the kernels
-  generateKernels(blitz::TinyVector<int,2>(gray_image.extent(0),gray_image.extent(1)));
-
-  // perform Fourier transformation to image
-  m_fft(gray_image, m_frequency_image);
-
   // check that the shape is correct
-  bob::core::array::assertSameShape(jet_image, blitz::shape(gray_image.extent(0), gray_image.extent(1), m_kernel_frequencies.size()));
+  bob::core::array::assertSameShape(jet_image, blitz::shape(m_frequency_image.extent(0), m_frequency_image.extent(1), m_kernel_frequencies.size()));
 
   // now, let each kernel compute the transformation result
   for (int j = 0; j < (int)m_gabor_kernels.size(); ++j){
@@ -492,6 +518,98 @@ void bob::ip::GaborWaveletTransform::computeJetImage(
   }
 }
 
+/**
+ * Computes the Gabor wavelet transformation for the given image (in spatial domain)
+ * @param gray_image  The source image in spatial domain
+ * @param trafo_image The convolution result, in spatial domain
+ */
+void bob::ip::GaborWaveletTransform::performGWT(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
+  computeFrequencyImage(gray_image);
+  performGWT_(trafo_image);
+}
+
+/**
+ * Computes the Gabor wavelet transformation for the given real image (in spatial domain)
+ * @param gray_image  The source image in spatial domain
+ * @param trafo_image The convolution result, in spatial domain
+ */
+void bob::ip::GaborWaveletTransform::performGWT(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<std::complex<double>,3>& trafo_image
+)
+{
+  computeFrequencyImage(gray_image);
+  performGWT_(trafo_image);
+}
+
+/**
+ * Computes the Gabor jets including absolute values and phases for the given image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param jet_image   The resulting Gabor jet image, including absolute values and phases for each pixel
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  blitz::Array<double,4>& jet_image,
+  bool do_normalize
+)
+{
+  computeFrequencyImage(gray_image);
+  computeJetImage_(jet_image, do_normalize);
+}
+
+/**
+ * Computes the Gabor jets including absolute values and phases for the given real image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param jet_image   The resulting Gabor jet image, including absolute values and phases for each pixel
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<double,4>& jet_image,
+  bool do_normalize
+)
+{
+  computeFrequencyImage(gray_image);
+  computeJetImage_(jet_image, do_normalize);
+}
+
+/**
+ * Computes the Gabor jets including absolute values only for the given image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param jet_image   The resulting Gabor jet image, including only absolute values for each pixel
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<std::complex<double>,2>& gray_image,
+  blitz::Array<double,3>& jet_image,
+  bool do_normalize
+)
+{
+  computeFrequencyImage(gray_image);
+  computeJetImage_(jet_image, do_normalize);
+}
+
+/**
+ * Computes the Gabor jets including absolute values only for the given real image (in spatial domain).
+ * @param gray_image  The source image in spatial domain
+ * @param jet_image   The resulting Gabor jet image, including only absolute values for each pixel
+ * @param do_normalize Shall the Gabor jets be normalized?
+ */
+void bob::ip::GaborWaveletTransform::computeJetImage(
+  const blitz::Array<double,2>& gray_image,
+  blitz::Array<double,3>& jet_image,
+  bool do_normalize
+)
+{
+  computeFrequencyImage(gray_image);
+  computeJetImage_(jet_image, do_normalize);
+}
+
 void bob::ip::GaborWaveletTransform::save(bob::io::HDF5File& file) const{
   file.set("Sigma", m_sigma);
   file.set("PowOfK", m_pow_of_k);
@@ -232,4 +232,38 @@ BOOST_AUTO_TEST_CASE( test_GWT_output )
 
 }
 
+BOOST_AUTO_TEST_CASE( test_GWT_real_image )
+{
+  // an image with an odd height and an even width, to check the expansion
+  // of the Hermitian half spectrum of real images
+  const int height = 37, width = 46;
+  blitz::Array<double,2> real_image(height, width);
+  for (int y = 0; y < height; ++y)
+    for (int x = 0; x < width; ++x)
+      real_image(y,x) = 128. + 100. * std::sin(0.31*y + 0.17*x*x);
+  blitz::Array<std::complex<double>,2> complex_image = bob::core::array::cast<std::complex<double> >(real_image);
+
+  bob::ip::GaborWaveletTransform gwt;
+
+  // the real and complex inputs give the same transform
+  blitz::Array<std::complex<double>,3> real_trafo(gwt.numberOfKernels(), height, width);
+  blitz::Array<std::complex<double>,3> complex_trafo(gwt.numberOfKernels(), height, width);
+  gwt.performGWT(real_image, real_trafo);
+  gwt.performGWT(complex_image, complex_trafo);
+  test_close(real_trafo, complex_trafo, epsilon);
+
+  // ... and the same jets
+  blitz::Array<double,4> real_jets(height, width, 2, gwt.numberOfKernels());
+  blitz::Array<double,4> complex_jets(height, width, 2, gwt.numberOfKernels());
+  gwt.computeJetImage(real_image, real_jets);
+  gwt.computeJetImage(complex_image, complex_jets);
+  test_close(real_jets, complex_jets, epsilon);
+
+  blitz::Array<double,3> real_abs_jets(height, width, gwt.numberOfKernels());
+  blitz::Array<double,3> complex_abs_jets(height, width, gwt.numberOfKernels());
+  gwt.computeJetImage(real_image, real_abs_jets, false);
+  gwt.computeJetImage(complex_image, complex_abs_jets, false);
+  test_close(real_abs_jets, complex_abs_jets, epsilon);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
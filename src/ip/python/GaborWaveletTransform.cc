@@ -60,6 +60,38 @@ static inline const blitz::Array<std::complex<double>, 2> convert_image(bob::pyt
   }
 }
 
+template <class T>
+static inline const blitz::Array<double,2> real_cast (bob::python::const_ndarray input){
+  blitz::Array<T,2> gray(input.type().shape[1],input.type().shape[2]);
+  bob::ip::rgb_to_gray(input.bz<T,3>(), gray);
+  return bob::core::array::cast<double>(gray);
+}
+
+//! Converts a real (non-complex) input image into a gray image of type double
+static inline const blitz::Array<double, 2> convert_real_image(bob::python::const_ndarray input){
+  if (input.type().nd == 3){
+    // perform color type conversion
+    switch (input.type().dtype){
+      case bob::core::array::t_uint8: return real_cast<uint8_t>(input);
+      case bob::core::array::t_uint16: return real_cast<uint16_t>(input);
+      case bob::core::array::t_float64: return real_cast<double>(input);
+      default: throw std::runtime_error("unsupported input data type");
+    }
+  } else {
+    switch (input.type().dtype){
+      case bob::core::array::t_uint8: return bob::core::array::cast<double>(input.bz<uint8_t,2>());
+      case bob::core::array::t_uint16: return bob::core::array::cast<double>(input.bz<uint16_t,2>());
+      case bob::core::array::t_float64: return input.bz<double,2>();
+      default: throw std::runtime_error("unsupported input data type");
+    }
+  }
+}
+
+//! Real images are transformed with the (faster) real-input FFT
+static inline bool is_complex_image(bob::python::const_ndarray input){
+  return input.type().dtype == bob::core::array::t_complex128;
+}
+
 static inline void transform (bob::ip::GaborKernel& kernel, blitz::Array<std::complex<double>,2>& input, blitz::Array<std::complex<double>,2>& output){
  // perform fft on input image
   bob::sp::FFT2D fft(input.extent(0), input.extent(1));
@@ -103,36 +135,47 @@ static blitz::Array<std::complex<double>,3> empty_trafo_image (bob::ip::GaborWav
 }
 
 static void perform_gwt_1 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_trafo_image){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
   blitz::Array<std::complex<double>,3> trafo_image = output_trafo_image.bz<std::complex<double>,3>();
-  gwt.performGWT(image, trafo_image);
+  if (is_complex_image(input_image))
+    gwt.performGWT(convert_image(input_image), trafo_image);
+  else
+    gwt.performGWT(convert_real_image(input_image), trafo_image);
 }
 
 static blitz::Array<std::complex<double>,3> perform_gwt_2 (bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
-  blitz::Array<std::complex<double>,3> trafo_image(gwt.numberOfKernels(), image.shape()[0], image.shape()[1]);
-  gwt.performGWT(image, trafo_image);
+  blitz::Array<std::complex<double>,3> trafo_image = empty_trafo_image(gwt, input_image);
+  if (is_complex_image(input_image))
+    gwt.performGWT(convert_image(input_image), trafo_image);
+  else
+    gwt.performGWT(convert_real_image(input_image), trafo_image);
   return trafo_image;
 }
 
 static bob::python::ndarray empty_jet_image(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bool include_phases){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
+  int index = input_image.type().nd-2;
+  assert(index >= 0);
+  const int height = input_image.type().shape[index], width = input_image.type().shape[index+1];
   if (include_phases)
-    return bob::python::ndarray (bob::core::array::t_float64, image.extent(0), image.extent(1), 2, (int)gwt.numberOfKernels());
+    return bob::python::ndarray (bob::core::array::t_float64, height, width, 2, (int)gwt.numberOfKernels());
   else
-    return bob::python::ndarray (bob::core::array::t_float64, image.extent(0), image.extent(1), (int)gwt.numberOfKernels());
+    return bob::python::ndarray (bob::core::array::t_float64, height, width, (int)gwt.numberOfKernels());
 }
 
-static void compute_jets_1(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_jet_image, bool normalized){
-  const blitz::Array<std::complex<double>,2>& image = convert_image(input_image);
+template <int N>
+static void compute_jets(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_jet_image, bool normalized){
+  blitz::Array<double,N> jet_image = output_jet_image.bz<double,N>();
+  if (is_complex_image(input_image))
+    gwt.computeJetImage(convert_image(input_image), jet_image, normalized);
+  else
+    gwt.computeJetImage(convert_real_image(input_image), jet_image, normalized);
+}
 
+static void compute_jets_1(bob::ip::GaborWaveletTransform& gwt, bob::python::const_ndarray input_image, bob::python::ndarray output_jet_image, bool normalized){
   if (output_jet_image.type().nd == 3){
     // compute jet image with absolute values only
-    blitz::Array<double,3> jet_image = output_jet_image.bz<double,3>();
-    gwt.computeJetImage(image, jet_image, normalized);
+    compute_jets<3>(gwt, input_image, output_jet_image, normalized);
   } else if (output_jet_image.type().nd == 4){
-    blitz::Array<double,4> jet_image = output_jet_image.bz<double,4>();
-    gwt.computeJetImage(image, jet_image, normalized);
+    compute_jets<4>(gwt, input_image, output_jet_image, normalized);
   } else {
     boost::format m("parameter `output_jet_image' has an unexpected shape: %s");
     m % output_jet_image.type().str();
@@ -31,6 +31,26 @@
 #include <bob/math/linear.h>
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
+#include <bob/core/threads.h>
+
+/**
+ * Working arrays of BICMachine::forward_(), which belong to the calling
+ * thread such that the same machine can be used by several threads
+ */
+struct BICBuffers {
+  blitz::Array<double,1> diff_I, diff_E;
+  blitz::Array<double,1> proj_I, proj_E;
+};
+
+static boost::thread_specific_ptr<BICBuffers> s_buffers;
+
+/**
+ * Resizes a working array if it does not have the given size
+ */
+static void resizeBuffer(blitz::Array<double,1>& buffer, const int size)
+{
+  if (buffer.extent(0) != size) buffer.resize(size);
+}
 
 /**
  * Initializes an empty BIC Machine
@@ -162,14 +182,6 @@ bool bob::machine::BICMachine::is_similar_to(const BICMachine& other,
 }
 
 
-
-void bob::machine::BICMachine::initialize(bool clazz, int input_length, int projected_length){
-  blitz::Array<double,1>& diff = clazz ? m_diff_E : m_diff_I;
-  blitz::Array<double,1>& proj = clazz ? m_proj_E : m_proj_I;
-  diff.resize(input_length);
-  proj.resize(projected_length);
-}
-
 /**
  * Sets the parameters of the given class that are required for computing the IEC scores (Guenther, Wuertz)
  *
@@ -243,9 +255,6 @@ void bob::machine::BICMachine::setBIC(
 
   // check that rho has a reasonable value (if it is used)
   if (m_use_DFFS && rho_ < 1e-12) throw std::runtime_error("The given average eigenvalue (rho) is too close to zero");
-
-  // initialize temporaries
-  initialize(clazz, Phi.shape()[0], Phi.shape()[1]);
 }
 
 /**
@@ -271,7 +280,6 @@ void bob::machine::BICMachine::load(bob::io::HDF5File& config){
   if (m_project_data){
     m_use_DFFS = config.read<bool>("use_DFFS");
     m_Phi_I.reference(config.readArray<double,2>("intra_subspace"));
-    initialize(false, m_Phi_I.shape()[0], m_Phi_I.shape()[1]);
     m_rho_I = config.read<double>("intra_rho");
   }
 
@@ -279,7 +287,6 @@ void bob::machine::BICMachine::load(bob::io::HDF5File& config){
   m_lambda_E.reference(config.readArray<double,1>("extra_variance"));
   if (m_project_data){
     m_Phi_E.reference(config.readArray<double,2>("extra_subspace"));
-    initialize(true, m_Phi_E.shape()[0], m_Phi_E.shape()[1]);
     m_rho_E = config.read<double>("extra_rho");
   }
   // check that rho has reasonable values
@@ -320,22 +327,33 @@ void bob::machine::BICMachine::save(bob::io::HDF5File& config) const{
  */
 void bob::machine::BICMachine::forward_(const blitz::Array<double,1>& input, double& output) const{
   if (m_project_data){
+    // working arrays of the calling thread
+    BICBuffers& buffers = bob::core::thread_workspace(s_buffers);
+    blitz::Array<double,1>& diff_I = buffers.diff_I;
+    blitz::Array<double,1>& diff_E = buffers.diff_E;
+    blitz::Array<double,1>& proj_I = buffers.proj_I;
+    blitz::Array<double,1>& proj_E = buffers.proj_E;
+    resizeBuffer(diff_I, m_Phi_I.extent(0));
+    resizeBuffer(diff_E, m_Phi_E.extent(0));
+    resizeBuffer(proj_I, m_Phi_I.extent(1));
+    resizeBuffer(proj_E, m_Phi_E.extent(1));
+
     // subtract mean
-    m_diff_I = input - m_mu_I;
-    m_diff_E = input - m_mu_E;
+    diff_I = input - m_mu_I;
+    diff_E = input - m_mu_E;
     // project data to intrapersonal and extrapersonal subspace
-    bob::math::prod(m_diff_I, m_Phi_I, m_proj_I);
-    bob::math::prod(m_diff_E, m_Phi_E, m_proj_E);
+    bob::math::prod(diff_I, m_Phi_I, proj_I);
+    bob::math::prod(diff_E, m_Phi_E, proj_E);
 
     // compute Mahalanobis distance
-    output = blitz::sum(blitz::pow2(m_proj_E) / m_lambda_E) - blitz::sum(blitz::pow2(m_proj_I) / m_lambda_I);
+    output = blitz::sum(blitz::pow2(proj_E) / m_lambda_E) - blitz::sum(blitz::pow2(proj_I) / m_lambda_I);
 
     // add the DFFS?
     if (m_use_DFFS){
-      output += blitz::sum(blitz::pow2(m_diff_E) - blitz::pow2(m_proj_E)) / m_rho_E;
-      output -= blitz::sum(blitz::pow2(m_diff_I) - blitz::pow2(m_proj_I)) / m_rho_I;
+      output += blitz::sum(blitz::pow2(diff_E) - blitz::pow2(proj_E)) / m_rho_E;
+      output -= blitz::sum(blitz::pow2(diff_I) - blitz::pow2(proj_I)) / m_rho_I;
     }
-    output /= (m_proj_E.extent(0) + m_proj_I.extent(0));
+    output /= (proj_E.extent(0) + proj_I.extent(0));
   } else {
     // forward without projection
     output = blitz::mean( blitz::pow2(input - m_mu_E) / m_lambda_E
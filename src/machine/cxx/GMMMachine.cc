@@ -20,8 +20,109 @@
  */
 
 #include <bob/machine/GMMMachine.h>
+#include <bob/machine/GMMSelector.h>
 #include <bob/core/assert.h>
 #include <bob/math/log.h>
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Number of samples scored together by the block log-likelihood
+ * computation. The parameters of a Gaussian component are loaded once
+ * per block of samples rather than once per sample.
+ */
+static const int s_block_size = 64;
+
+/**
+ * Computes sum_d (x_d - mean_d)^2 * precision_d over contiguous buffers
+ */
+static inline double weightedSquaredDistance(const double* x,
+  const double* mean, const double* precision, const size_t n)
+{
+  size_t d = 0;
+  double z = 0.;
+#if defined(__SSE2__)
+  // Two independent accumulators of two doubles each
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  for (; d+4<=n; d+=4) {
+    __m128d diff0 = _mm_sub_pd(_mm_loadu_pd(x+d), _mm_loadu_pd(mean+d));
+    __m128d diff1 = _mm_sub_pd(_mm_loadu_pd(x+d+2), _mm_loadu_pd(mean+d+2));
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_mul_pd(diff0, diff0), _mm_loadu_pd(precision+d)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_mul_pd(diff1, diff1), _mm_loadu_pd(precision+d+2)));
+  }
+  double acc[2];
+  _mm_storeu_pd(acc, _mm_add_pd(acc0, acc1));
+  z = acc[0] + acc[1];
+#endif
+  for (; d<n; ++d) {
+    const double diff = x[d] - mean[d];
+    z += diff * diff * precision[d];
+  }
+  return z;
+}
+
+/**
+ * Computes log(sum_i exp(l_i)) over a contiguous buffer, shifting by the
+ * maximum value to avoid any overflow and calling log() only once
+ */
+static inline double logSumExp(const double* l, const size_t n)
+{
+  double l_max = bob::math::Log::LogZero;
+  for (size_t i=0; i<n; ++i)
+    if (l[i] > l_max) l_max = l[i];
+  if (l_max <= bob::math::Log::LogZero) return bob::math::Log::LogZero;
+
+  double sum = 0.;
+  for (size_t i=0; i<n; ++i)
+    sum += exp(l[i] - l_max);
+  return l_max + log(sum);
+}
+
+/**
+ * Returns a view of the i-th row of a 2D array with its own reference count.
+ * Slicing the array itself would update its reference count, which is not
+ * thread-safe, while the input can be shared by concurrent callers.
+ */
+static inline blitz::Array<double,1> rowView(const blitz::Array<double,2>& input,
+  const int i)
+{
+  return blitz::Array<double,1>(const_cast<double*>(input.data()) +
+    i*input.stride(0), blitz::shape(input.extent(1)),
+    blitz::shape(input.stride(1)), blitz::neverDeleteData);
+}
+
+bob::machine::GMMWorkspace::GMMWorkspace() {
+  resize(0,0);
+}
+
+bob::machine::GMMWorkspace::GMMWorkspace(const size_t n_gaussians, const size_t n_inputs) {
+  resize(n_gaussians,n_inputs);
+}
+
+bob::machine::GMMWorkspace::GMMWorkspace(const bob::machine::GMMWorkspace& other) {
+  resize(other.Px.extent(0),other.Px.extent(1));
+}
+
+bob::machine::GMMWorkspace& bob::machine::GMMWorkspace::operator=(const bob::machine::GMMWorkspace& other) {
+  if (this != &other)
+    resize(other.Px.extent(0),other.Px.extent(1));
+  return *this;
+}
+
+void bob::machine::GMMWorkspace::resize(const size_t n_gaussians, const size_t n_inputs) {
+  log_weighted_gaussian_likelihoods.resize(n_gaussians);
+  P.resize(n_gaussians);
+  Px.resize(n_gaussians,n_inputs);
+  packed_means.resize(n_gaussians,n_inputs);
+  packed_precisions.resize(n_gaussians,n_inputs);
+  packed_constants.resize(n_gaussians);
+  block_x.resize(s_block_size,n_inputs);
+  block_log_likelihoods.resize(s_block_size,n_gaussians);
+  selection.resize(n_gaussians);
+}
 
 bob::machine::GMMMachine::GMMMachine(): m_gaussians(0) {
   resize(0,0);
@@ -256,17 +357,105 @@ double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x
 }
 
 double bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 1> &x) const {
+  return logLikelihood(x, m_cache_workspace);
+}
+
+double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x) const {
+  return logLikelihood_(x, m_cache_workspace);
+}
+
+double bob::machine::GMMMachine::logLikelihood(const blitz::Array<double, 1> &x,
+  bob::machine::GMMWorkspace& workspace) const
+{
   // Check dimension
   bob::core::array::assertSameDimensionLength(x.extent(0), m_n_inputs);
+  checkWorkspace(workspace);
+  return logLikelihood_(x, workspace);
+}
+
+double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x,
+  bob::machine::GMMWorkspace& workspace) const
+{
   // Call the other logLikelihood_ (overloaded) function
   // (log_weighted_gaussian_likelihoods will be discarded)
-  return logLikelihood_(x,m_cache_log_weighted_gaussian_likelihoods);
+  return logLikelihood_(x, workspace.log_weighted_gaussian_likelihoods);
 }
 
-double bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double, 1> &x) const {
-  // Call the other logLikelihood (overloaded) function
-  // (log_weighted_gaussian_likelihoods will be discarded)
-  return logLikelihood_(x,m_cache_log_weighted_gaussian_likelihoods);
+void bob::machine::GMMMachine::logLikelihood(const blitz::Array<double,2> &x,
+  blitz::Array<double,1> &output) const
+{
+  logLikelihood(x, output, m_cache_workspace);
+}
+
+void bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double,2> &x,
+  blitz::Array<double,1> &output) const
+{
+  logLikelihood_(x, output, m_cache_workspace);
+}
+
+void bob::machine::GMMMachine::logLikelihood(const blitz::Array<double,2> &x,
+  blitz::Array<double,1> &output, bob::machine::GMMWorkspace& workspace) const
+{
+  // Check dimension
+  bob::core::array::assertSameDimensionLength(x.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(output.extent(0), x.extent(0));
+  checkWorkspace(workspace);
+  logLikelihood_(x, output, workspace);
+}
+
+void bob::machine::GMMMachine::logLikelihood_(const blitz::Array<double,2> &x,
+  blitz::Array<double,1> &output, bob::machine::GMMWorkspace& workspace) const
+{
+  packParameters(workspace);
+
+  const double* means = workspace.packed_means.data();
+  const double* precisions = workspace.packed_precisions.data();
+  const double* constants = workspace.packed_constants.data();
+  double* block_x = workspace.block_x.data();
+  double* block_ll = workspace.block_log_likelihoods.data();
+
+  // Raw access to the samples: slicing x would update its reference count
+  const double* x_data = x.data();
+  const int x_s0 = x.stride(0);
+  const int x_s1 = x.stride(1);
+  const int n_samples = x.extent(0);
+  for (int t0=0; t0<n_samples; t0+=s_block_size) {
+    // Copy the block of samples into a contiguous buffer
+    const int n_block = std::min(s_block_size, n_samples - t0);
+    for (int t=0; t<n_block; ++t)
+      for (size_t d=0; d<m_n_inputs; ++d)
+        block_x[t*m_n_inputs+d] = x_data[(t0+t)*x_s0 + d*x_s1];
+
+    // Weighted log likelihoods, log(weight_i*p(x_t|gaussian_i)), of the
+    // block: each Gaussian component is applied to all samples in turn
+    for (size_t i=0; i<m_n_gaussians; ++i) {
+      const double* mean_i = means + i*m_n_inputs;
+      const double* precision_i = precisions + i*m_n_inputs;
+      for (int t=0; t<n_block; ++t)
+        block_ll[t*m_n_gaussians+i] = constants[i] - 0.5 *
+          weightedSquaredDistance(block_x + t*m_n_inputs, mean_i, precision_i, m_n_inputs);
+    }
+
+    // log(p(x_t|GMMMachine))
+    for (int t=0; t<n_block; ++t)
+      output(t0+t) = logSumExp(block_ll + t*m_n_gaussians, m_n_gaussians);
+  }
+}
+
+void bob::machine::GMMMachine::packParameters(bob::machine::GMMWorkspace& workspace) const
+{
+  const blitz::Range a = blitz::Range::all();
+  for (size_t i=0; i<m_n_gaussians; ++i) {
+    workspace.packed_means(i,a) = m_gaussians[i]->getMean();
+    workspace.packed_precisions(i,a) = 1. / m_gaussians[i]->getVariance();
+    workspace.packed_constants(i) = m_cache_log_weights(i) - 0.5 * m_gaussians[i]->getGNorm();
+  }
+}
+
+void bob::machine::GMMMachine::checkWorkspace(const bob::machine::GMMWorkspace& workspace) const
+{
+  bob::core::array::assertSameDimensionLength(workspace.packed_means.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(workspace.packed_means.extent(1), m_n_inputs);
 }
 
 void bob::machine::GMMMachine::forward(const blitz::Array<double,1>& input, double& output) const {
@@ -286,54 +475,158 @@ void bob::machine::GMMMachine::forward_(const blitz::Array<double,1>& input,
 
 void bob::machine::GMMMachine::accStatistics(const blitz::Array<double,2>& input,
     bob::machine::GMMStats& stats) const {
+  accStatistics(input, stats, m_cache_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input, bob::machine::GMMStats& stats) const {
+  accStatistics_(input, stats, m_cache_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+  accStatistics(x, stats, m_cache_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+  accStatistics_(x, stats, m_cache_workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& workspace) const {
   // iterate over data
-  blitz::Range a = blitz::Range::all();
   for(int i=0; i<input.extent(0); ++i) {
     // Get example
-    blitz::Array<double,1> x(input(i,a));
+    blitz::Array<double,1> x(rowView(input,i));
     // Accumulate statistics
-    accStatistics(x,stats);
+    accStatistics(x,stats,workspace);
   }
 }
 
-void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input, bob::machine::GMMStats& stats) const {
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& workspace) const {
   // iterate over data
-  blitz::Range a = blitz::Range::all();
   for(int i=0; i<input.extent(0); ++i) {
     // Get example
-    blitz::Array<double,1> x(input(i, a));
+    blitz::Array<double,1> x(rowView(input,i));
     // Accumulate statistics
-    accStatistics_(x,stats);
+    accStatistics_(x,stats,workspace);
   }
 }
 
-void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x,
+    bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& workspace) const {
   // check GMMStats size
   bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), m_n_gaussians);
   bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
+  checkWorkspace(workspace);
 
   // Calculate Gaussian and GMM likelihoods
-  // - m_cache_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
+  // - workspace.log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
   // - log_likelihood = log(sum_i(weight_i*p(x|gaussian_i)))
-  double log_likelihood = logLikelihood(x, m_cache_log_weighted_gaussian_likelihoods);
+  double log_likelihood = logLikelihood(x, workspace.log_weighted_gaussian_likelihoods);
 
-  accStatisticsInternal(x, stats, log_likelihood);
+  accStatisticsInternal(x, stats, log_likelihood, workspace);
 }
 
-void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x, bob::machine::GMMStats& stats) const {
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x,
+    bob::machine::GMMStats& stats, bob::machine::GMMWorkspace& workspace) const {
   // Calculate Gaussian and GMM likelihoods
-  // - m_cache_log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
+  // - workspace.log_weighted_gaussian_likelihoods(i) = log(weight_i*p(x|gaussian_i))
   // - log_likelihood = log(sum_i(weight_i*p(x|gaussian_i)))
-  double log_likelihood = logLikelihood_(x, m_cache_log_weighted_gaussian_likelihoods);
+  double log_likelihood = logLikelihood_(x, workspace.log_weighted_gaussian_likelihoods);
+
+  accStatisticsInternal(x, stats, log_likelihood, workspace);
+}
 
-  accStatisticsInternal(x, stats, log_likelihood);
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats, const bob::machine::GMMSelector& selector,
+    bob::machine::GMMWorkspace& workspace) const {
+  // check GMMStats, workspace and selector sizes
+  bob::core::array::assertSameDimensionLength(input.extent(1), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
+  checkWorkspace(workspace);
+  if (selector.getNClusters() > 0) {
+    bob::core::array::assertSameDimensionLength(selector.getClusterIndices().extent(0), m_n_gaussians);
+    bob::core::array::assertSameDimensionLength(selector.getClusterMachine().getNInputs(), m_n_inputs);
+  }
+
+  accStatistics_(input, stats, selector, workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double,2>& input,
+    bob::machine::GMMStats& stats, const bob::machine::GMMSelector& selector,
+    bob::machine::GMMWorkspace& workspace) const {
+  // iterate over data
+  for(int i=0; i<input.extent(0); ++i) {
+    // Get example
+    blitz::Array<double,1> x(rowView(input,i));
+    // Accumulate statistics
+    accStatistics_(x,stats,selector,workspace);
+  }
+}
+
+void bob::machine::GMMMachine::accStatistics(const blitz::Array<double, 1>& x,
+    bob::machine::GMMStats& stats, const bob::machine::GMMSelector& selector,
+    bob::machine::GMMWorkspace& workspace) const {
+  // check GMMStats, workspace and selector sizes
+  bob::core::array::assertSameDimensionLength(x.extent(0), m_n_inputs);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(0), m_n_gaussians);
+  bob::core::array::assertSameDimensionLength(stats.sumPx.extent(1), m_n_inputs);
+  checkWorkspace(workspace);
+  if (selector.getNClusters() > 0) {
+    bob::core::array::assertSameDimensionLength(selector.getClusterIndices().extent(0), m_n_gaussians);
+    bob::core::array::assertSameDimensionLength(selector.getClusterMachine().getNInputs(), m_n_inputs);
+  }
+
+  accStatistics_(x, stats, selector, workspace);
+}
+
+void bob::machine::GMMMachine::accStatistics_(const blitz::Array<double, 1>& x,
+    bob::machine::GMMStats& stats, const bob::machine::GMMSelector& selector,
+    bob::machine::GMMWorkspace& workspace) const {
+  // Select the best components, sorted by decreasing likelihood
+  const size_t n_selected = selector.select_(*this, x, workspace);
+  const int* selection = workspace.selection.data();
+  const double* log_weighted_gaussian_likelihoods =
+    workspace.log_weighted_gaussian_likelihoods.data();
+
+  // Log likelihood over the selected components
+  const double l_max = (n_selected > 0 ?
+    log_weighted_gaussian_likelihoods[selection[0]] : bob::math::Log::LogZero);
+  double log_likelihood = bob::math::Log::LogZero;
+  if (l_max > bob::math::Log::LogZero) {
+    double sum = 0.;
+    for (size_t k=0; k<n_selected; ++k)
+      sum += exp(log_weighted_gaussian_likelihoods[selection[k]] - l_max);
+    log_likelihood = l_max + log(sum);
+  }
+
+  // Accumulate statistics
+  // - total likelihood
+  stats.log_likelihood += log_likelihood;
+
+  // - number of samples
+  stats.T++;
+
+  // - responsibilities, first and second order stats of the selected
+  //   components only
+  if (log_likelihood <= bob::math::Log::LogZero) return;
+  blitz::Range a = blitz::Range::all();
+  for (size_t k=0; k<n_selected; ++k) {
+    const int c = selection[k];
+    const double P = exp(log_weighted_gaussian_likelihoods[c] - log_likelihood);
+    stats.n(c) += P;
+    stats.sumPx(c,a) += P * x;
+    stats.sumPxx(c,a) += P * x * x;
+  }
 }
 
 void bob::machine::GMMMachine::accStatisticsInternal(const blitz::Array<double, 1>& x,
-  bob::machine::GMMStats& stats, const double log_likelihood) const
+  bob::machine::GMMStats& stats, const double log_likelihood,
+  bob::machine::GMMWorkspace& workspace) const
 {
   // Calculate responsibilities
-  m_cache_P = blitz::exp(m_cache_log_weighted_gaussian_likelihoods - log_likelihood);
+  workspace.P = blitz::exp(workspace.log_weighted_gaussian_likelihoods - log_likelihood);
 
   // Accumulate statistics
   // - total likelihood
@@ -343,18 +636,18 @@ void bob::machine::GMMMachine::accStatisticsInternal(const blitz::Array<double,
   stats.T++;
 
   // - responsibilities
-  stats.n += m_cache_P;
+  stats.n += workspace.P;
 
   // - first order stats
   blitz::firstIndex i;
   blitz::secondIndex j;
 
-  m_cache_Px = m_cache_P(i) * x(j);
+  workspace.Px = workspace.P(i) * x(j);
 
-  stats.sumPx += m_cache_Px;
+  stats.sumPx += workspace.Px;
 
   // - second order stats
-  stats.sumPxx += (m_cache_Px(i,j) * x(j));
+  stats.sumPxx += (workspace.Px(i,j) * x(j));
 }
 
 boost::shared_ptr<const bob::machine::Gaussian> bob::machine::GMMMachine::getGaussian(const size_t i) const {
@@ -432,9 +725,7 @@ void bob::machine::GMMMachine::initCache() const {
   // Initialise cache arrays
   m_cache_log_weights.resize(m_n_gaussians);
   recomputeLogWeights();
-  m_cache_log_weighted_gaussian_likelihoods.resize(m_n_gaussians);
-  m_cache_P.resize(m_n_gaussians);
-  m_cache_Px.resize(m_n_gaussians,m_n_inputs);
+  m_cache_workspace.resize(m_n_gaussians,m_n_inputs);
   m_cache_supervector = false;
 }
 
@@ -0,0 +1,240 @@
+/**
+ * @file machine/cxx/GMMSelector.cc
+ * @date Sat Oct 17 14:05:12 2026 +0200
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/machine/GMMSelector.h>
+#include <bob/core/array_copy.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+/**
+ * Number of k-means iterations used to cluster the components
+ */
+static const size_t s_n_kmeans_iterations = 10;
+
+/**
+ * Orders indices by decreasing score
+ */
+struct ScoreGreater {
+  ScoreGreater(const double* scores): m_scores(scores) {}
+  bool operator()(const int a, const int b) const
+  { return m_scores[a] > m_scores[b]; }
+  const double* m_scores;
+};
+
+bob::machine::GMMSelector::GMMSelector(const size_t n_top):
+  m_n_top(0), m_n_best_clusters(0)
+{
+  setNTop(n_top);
+}
+
+bob::machine::GMMSelector::GMMSelector(const bob::machine::GMMMachine& machine,
+    const size_t n_top, const size_t n_clusters, const size_t n_best_clusters):
+  m_n_top(0), m_n_best_clusters(0)
+{
+  setNTop(n_top);
+  cluster(machine, n_clusters, n_best_clusters);
+}
+
+bob::machine::GMMSelector::GMMSelector(const bob::machine::GMMSelector& other):
+  m_n_top(other.m_n_top), m_n_best_clusters(other.m_n_best_clusters),
+  m_cluster_machine(other.m_cluster_machine),
+  m_cluster_indices(bob::core::array::ccopy(other.m_cluster_indices)),
+  m_members(other.m_members)
+{
+}
+
+bob::machine::GMMSelector::~GMMSelector() {}
+
+bob::machine::GMMSelector& bob::machine::GMMSelector::operator=
+  (const bob::machine::GMMSelector& other)
+{
+  if (this != &other) {
+    m_n_top = other.m_n_top;
+    m_n_best_clusters = other.m_n_best_clusters;
+    m_cluster_machine = other.m_cluster_machine;
+    m_cluster_indices.reference(bob::core::array::ccopy(other.m_cluster_indices));
+    m_members = other.m_members;
+  }
+  return *this;
+}
+
+void bob::machine::GMMSelector::setNTop(const size_t n_top)
+{
+  if (n_top == 0)
+    throw std::runtime_error("GMMSelector: the number of components to select should be strictly positive");
+  m_n_top = n_top;
+}
+
+void bob::machine::GMMSelector::unsetClusters()
+{
+  m_n_best_clusters = 0;
+  m_cluster_machine.resize(0,0);
+  m_cluster_indices.resize(0);
+  m_members.clear();
+}
+
+void bob::machine::GMMSelector::cluster(const bob::machine::GMMMachine& machine,
+  const size_t n_clusters, const size_t n_best_clusters)
+{
+  const size_t n_gaussians = machine.getNGaussians();
+  const size_t n_inputs = machine.getNInputs();
+  if (n_clusters == 0 || n_clusters > n_gaussians)
+    throw std::runtime_error("GMMSelector: the number of clusters should be between 1 and the number of Gaussian components");
+  if (n_best_clusters == 0 || n_best_clusters > n_clusters)
+    throw std::runtime_error("GMMSelector: the number of best clusters should be between 1 and the number of clusters");
+
+  const blitz::Range a = blitz::Range::all();
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+
+  blitz::Array<double,2> means(n_gaussians, n_inputs);
+  blitz::Array<double,2> variances(n_gaussians, n_inputs);
+  machine.getMeans(means);
+  machine.getVariances(variances);
+  const blitz::Array<double,1>& weights = machine.getWeights();
+
+  // k-means over the means, each dimension being normalized by the average
+  // variance of the components
+  blitz::Array<double,1> scale(n_inputs);
+  scale = 1. / blitz::sqrt(blitz::mean(variances(j,i), j));
+  blitz::Array<double,2> points(n_gaussians, n_inputs);
+  points = means(i,j) * scale(j);
+
+  // Initial centroids: components evenly spread over the mixture
+  blitz::Array<double,2> centroids(n_clusters, n_inputs);
+  blitz::Array<double,2> previous(n_clusters, n_inputs);
+  for (size_t k=0; k<n_clusters; ++k)
+    centroids(k,a) = points(k*n_gaussians/n_clusters, a);
+
+  m_cluster_indices.resize(n_gaussians);
+  blitz::Array<int,1> counts(n_clusters);
+  for (size_t iter=0; iter<s_n_kmeans_iterations; ++iter) {
+    // Assigns each component to its closest centroid
+    for (size_t c=0; c<n_gaussians; ++c) {
+      double min_distance = std::numeric_limits<double>::max();
+      for (size_t k=0; k<n_clusters; ++k) {
+        const double distance = blitz::sum(blitz::pow2(points(c,a) - centroids(k,a)));
+        if (distance < min_distance) {
+          min_distance = distance;
+          m_cluster_indices(c) = k;
+        }
+      }
+    }
+
+    // Updates the centroids (an empty cluster keeps its previous centroid)
+    previous = centroids;
+    centroids = 0.;
+    counts = 0;
+    for (size_t c=0; c<n_gaussians; ++c) {
+      centroids(m_cluster_indices(c),a) += points(c,a);
+      ++counts(m_cluster_indices(c));
+    }
+    for (size_t k=0; k<n_clusters; ++k) {
+      if (counts(k) > 0) centroids(k,a) /= counts(k);
+      else centroids(k,a) = previous(k,a);
+    }
+  }
+
+  // Members of each cluster
+  m_members.assign(n_clusters, std::vector<int>());
+  for (size_t c=0; c<n_gaussians; ++c)
+    m_members[m_cluster_indices(c)].push_back(c);
+
+  // Gaussian of each cluster, with the total weight, mean and variance of
+  // its members
+  blitz::Array<double,1> cluster_weights(n_clusters);
+  blitz::Array<double,2> cluster_means(n_clusters, n_inputs);
+  blitz::Array<double,2> cluster_variances(n_clusters, n_inputs);
+  blitz::Array<double,2> average_variances(n_clusters, n_inputs);
+  cluster_weights = 0.;
+  cluster_means = 0.;
+  cluster_variances = 0.;
+  average_variances = 0.;
+  for (size_t c=0; c<n_gaussians; ++c) {
+    const int k = m_cluster_indices(c);
+    cluster_weights(k) += weights(c);
+    cluster_means(k,a) += weights(c) * means(c,a);
+    cluster_variances(k,a) += weights(c) * (variances(c,a) + blitz::pow2(means(c,a)));
+    average_variances(k,a) += weights(c) * variances(c,a);
+  }
+  for (size_t k=0; k<n_clusters; ++k) {
+    if (cluster_weights(k) > 0.) {
+      cluster_means(k,a) /= cluster_weights(k);
+      cluster_variances(k,a) = cluster_variances(k,a) / cluster_weights(k) - blitz::pow2(cluster_means(k,a));
+      average_variances(k,a) /= cluster_weights(k);
+      // The merged variance is never smaller than the average variance
+      // of the members (up to rounding errors)
+      cluster_variances(k,a) = blitz::where(cluster_variances(k,a) < average_variances(k,a),
+        average_variances(k,a), cluster_variances(k,a));
+    }
+    else
+      cluster_variances(k,a) = 1.;
+  }
+  cluster_weights /= blitz::sum(cluster_weights);
+
+  m_cluster_machine.resize(n_clusters, n_inputs);
+  m_cluster_machine.setWeights(cluster_weights);
+  m_cluster_machine.setMeans(cluster_means);
+  m_cluster_machine.setVariances(cluster_variances);
+  m_n_best_clusters = n_best_clusters;
+}
+
+size_t bob::machine::GMMSelector::select_(const bob::machine::GMMMachine& machine,
+  const blitz::Array<double,1>& x, bob::machine::GMMWorkspace& workspace) const
+{
+  int* selection = workspace.selection.data();
+  size_t n_candidates = 0;
+
+  if (m_members.empty()) {
+    // All the components are candidates
+    for (size_t c=0; c<machine.getNGaussians(); ++c)
+      selection[n_candidates++] = c;
+  }
+  else {
+    // Candidates: the members of the most likely clusters
+    const int n_clusters = m_members.size();
+    if (workspace.cluster_log_likelihoods.extent(0) != n_clusters) {
+      workspace.cluster_log_likelihoods.resize(n_clusters);
+      workspace.cluster_selection.resize(n_clusters);
+    }
+    m_cluster_machine.logLikelihood_(x, workspace.cluster_log_likelihoods);
+    int* clusters = workspace.cluster_selection.data();
+    for (int k=0; k<n_clusters; ++k) clusters[k] = k;
+    std::partial_sort(clusters, clusters+m_n_best_clusters, clusters+n_clusters,
+      ScoreGreater(workspace.cluster_log_likelihoods.data()));
+
+    for (size_t b=0; b<m_n_best_clusters; ++b) {
+      const std::vector<int>& members = m_members[clusters[b]];
+      for (size_t m=0; m<members.size(); ++m)
+        selection[n_candidates++] = members[m];
+    }
+  }
+
+  // Evaluates the candidates and keeps the n_top best ones
+  double* log_weighted_gaussian_likelihoods = workspace.log_weighted_gaussian_likelihoods.data();
+  for (size_t k=0; k<n_candidates; ++k)
+    log_weighted_gaussian_likelihoods[selection[k]] =
+      machine.logWeightedGaussianLikelihood_(selection[k], x);
+
+  const size_t n_selected = std::min(m_n_top, n_candidates);
+  std::partial_sort(selection, selection+n_selected, selection+n_candidates,
+    ScoreGreater(log_weighted_gaussian_likelihoods));
+  return n_selected;
+}
@@ -23,6 +23,44 @@
 #include <bob/core/check.h>
 #include <bob/math/linear.h>
 #include <bob/math/linsolve.h>
+#include <bob/core/threads.h>
+#include <algorithm>
+
+/**
+ * Maximum number of elements of the flattened precision matrices of a
+ * block of utterances processed at once (256MB)
+ */
+static const int s_max_block_elements = 1 << 25;
+
+/**
+ * Solves the linear systems of a block of utterances, given their
+ * flattened precision matrices and projected first order statistics. Only
+ * raw pointers are shared with the other threads, as the reference
+ * counting of blitz arrays is not thread-safe.
+ */
+struct IVectorSolver {
+  const double* precisions;
+  const double* projections;
+  double* ivectors;
+  int rt;
+  int stride0;
+  int stride1;
+
+  void operator()(const size_t, const size_t begin, const size_t end) const
+  {
+    blitz::Array<double,1> x(rt);
+    for (size_t i=begin; i<end; ++i)
+    {
+      const blitz::Array<double,2> A(const_cast<double*>(precisions + i*rt*rt),
+        blitz::shape(rt,rt), blitz::neverDeleteData);
+      const blitz::Array<double,1> b(const_cast<double*>(projections + i*rt),
+        blitz::shape(rt), blitz::neverDeleteData);
+      bob::math::linsolveSympos_(A, x, b);
+      double* ivector = ivectors + i*stride0;
+      for (int k=0; k<rt; ++k) ivector[k*stride1] = x(k);
+    }
+  }
+};
 
 bob::machine::IVectorMachine::IVectorMachine()
 {
@@ -259,3 +297,98 @@ void bob::machine::IVectorMachine::forward_(const bob::machine::GMMStats& gs,
   bob::math::linsolve(m_tmp_tt, ivector, m_tmp_t1);
 }
 
+void bob::machine::IVectorMachine::forward(
+  const std::vector<bob::machine::GMMStats>& gs,
+  blitz::Array<double,2>& ivectors, const size_t n_threads) const
+{
+  bob::core::array::assertZeroBase(ivectors);
+  bob::core::array::assertSameDimensionLength(ivectors.extent(0), (int)gs.size());
+  bob::core::array::assertSameDimensionLength(ivectors.extent(1), (int)m_rt);
+  forward_(gs, ivectors, n_threads);
+}
+
+void bob::machine::IVectorMachine::computeIdTtSigmaInvT(
+  const std::vector<bob::machine::GMMStats>& gs, const size_t begin,
+  blitz::Array<double,2>& output) const
+{
+  const int N = output.extent(0);
+  const int C = (int)getDimC();
+  const int R = (int)m_rt;
+
+  // Zeroth order statistics, one utterance per row
+  blitz::Array<double,2> n(N, C);
+  for (int i=0; i<N; ++i)
+    n(i, blitz::Range::all()) = gs[begin+i].n;
+
+  // The T_{c}^{T}.sigma_{c}^{-1}.T_{c} matrices, one per row
+  const blitz::Array<double,2> Tct_sigmacInv_Tc(
+    const_cast<double*>(m_cache_Tct_sigmacInv_Tc.data()),
+    blitz::shape(C, R*R), blitz::neverDeleteData);
+  bob::math::prod(n, Tct_sigmacInv_Tc, output);
+  for (int i=0; i<N; ++i)
+    for (int k=0; k<R; ++k)
+      output(i, k*R+k) += 1.;
+}
+
+void bob::machine::IVectorMachine::computeTtSigmaInvFnorm(
+  const std::vector<bob::machine::GMMStats>& gs, const size_t begin,
+  blitz::Array<double,2>& output) const
+{
+  const int N = output.extent(0);
+  const int C = (int)getDimC();
+  const int D = (int)getDimD();
+
+  // First order statistics centered on the UBM means and scaled by
+  // sigma^{-1}, one utterance per row
+  blitz::Array<double,2> fnorm(N, C*D);
+  const blitz::Array<double,1>& mean = m_ubm->getMeanSupervector();
+  for (int i=0; i<N; ++i)
+  {
+    const bob::machine::GMMStats& gs_i = gs[begin+i];
+    for (int c=0; c<C; ++c)
+    {
+      const double n_c = gs_i.n(c);
+      for (int d=0; d<D; ++d)
+      {
+        const int s = c*D+d;
+        fnorm(i,s) = (gs_i.sumPx(c,d) - n_c * mean(s)) / m_sigma(s);
+      }
+    }
+  }
+  bob::math::prod(fnorm, m_T, output);
+}
+
+void bob::machine::IVectorMachine::forward_(
+  const std::vector<bob::machine::GMMStats>& gs,
+  blitz::Array<double,2>& ivectors, const size_t n_threads) const
+{
+  const int N = (int)gs.size();
+  const int R = (int)m_rt;
+  if (N == 0) return;
+
+  // The utterances are processed by blocks, which bounds the memory used
+  // by their precision matrices
+  const int block = std::max(1, std::min(N, s_max_block_elements / (R*R)));
+  blitz::Array<double,2> precisions(block, R*R);
+  blitz::Array<double,2> projections(block, R);
+
+  for (int b0=0; b0<N; b0+=block)
+  {
+    const int nb = std::min(block, N-b0);
+    const blitz::Range rb(0, nb-1);
+    const blitz::Range rall = blitz::Range::all();
+    blitz::Array<double,2> precisions_b = precisions(rb, rall);
+    blitz::Array<double,2> projections_b = projections(rb, rall);
+    computeIdTtSigmaInvT(gs, b0, precisions_b);
+    computeTtSigmaInvFnorm(gs, b0, projections_b);
+
+    IVectorSolver solver;
+    solver.precisions = precisions.data();
+    solver.projections = projections.data();
+    solver.ivectors = &ivectors(b0,0);
+    solver.rt = R;
+    solver.stride0 = ivectors.stride(0);
+    solver.stride1 = ivectors.stride(1);
+    bob::core::thread_loop(solver, nb, n_threads);
+  }
+}
@@ -24,8 +24,179 @@
 #include <bob/math/linear.h>
 #include <bob/math/inv.h>
 #include <bob/machine/LinearScoring.h>
+#include <bob/core/assert.h>
+#include <bob/core/threads.h>
+#include <algorithm>
 #include <limits>
 
+/**
+ * Number of probes processed at once by FABase::estimateUx() and
+ * FABase::computeScores()
+ */
+static const int s_probe_block = 256;
+
+/**
+ * Returns a view of an array built from its data pointer, which does not
+ * share (nor modify) the reference count of its memory block
+ */
+template <int N>
+static blitz::Array<double,N> view(const blitz::Array<double,N>& a)
+{
+  return blitz::Array<double,N>(const_cast<double*>(a.data()), a.shape(),
+    a.stride(), blitz::neverDeleteData);
+}
+
+/**
+ * Estimates the session offsets U.x of blocks of s_probe_block probes
+ * (considering the LPT assumption), unless they are given, and scores the
+ * blocks against the models if any, like the matrix form of
+ * linearScoring() (with the frame length normalisation). The shared arrays
+ * are only read through pointers (blitz reference counting is not
+ * thread-safe), and each block of probes is written to its own rows of Ux
+ * and columns of the scores.
+ */
+struct FAProbeScorer {
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >* probes;
+  const blitz::Array<double,2>* U;
+  const blitz::Array<double,2>* UtSigmaInv;
+  const blitz::Array<double,3>* UProd; ///< U_{c}^T.Sigma_{c}^-1.U_{c}
+  const blitz::Array<double,1>* mean;
+  const blitz::Array<double,2>* models; ///< (model-mean)/sigma, one per row
+  const blitz::Array<double,2>* cached_Ux; ///< given offsets (one per row)
+  blitz::Array<double,2>* Ux; ///< estimated offsets (one per row)
+  blitz::Array<double,2>* scores;
+
+  void operator()(const size_t, const size_t begin, const size_t end) const
+  {
+    const int n_probes = probes->size();
+    const int C = UProd->extent(0);
+    const int ru = UProd->extent(1);
+    const int CD = mean->extent(0);
+    const int D = CD / C;
+    blitz::Array<double,2> Fn(CD, s_probe_block);
+    blitz::Array<double,2> T(ru, s_probe_block);
+    blitz::Array<double,2> X(ru, s_probe_block);
+    blitz::Array<double,2> IdPlusUSProd(ru, ru);
+    blitz::Array<double,2> IdPlusUSProdInv(ru, ru);
+    blitz::Array<double,2> UxT(CD, s_probe_block);
+    blitz::Array<double,2> B(CD, s_probe_block);
+    blitz::Array<double,2> cross;
+    if (models) cross.resize(models->extent(0), s_probe_block);
+    for (size_t k=begin; k<end; ++k)
+    {
+      const int p0 = k*s_probe_block;
+      const int np = std::min(s_probe_block, n_probes-p0);
+      const blitz::Range rp(0, np-1);
+      blitz::Array<double,2> UxT_b = UxT(blitz::Range::all(), rp);
+
+      if (cached_Ux)
+      {
+        for (int j=0; j<np; ++j)
+          for (int s=0; s<CD; ++s)
+            UxT_b(s,j) = (*cached_Ux)(p0+j,s);
+      }
+      else
+      {
+        // Fn_x = N*(o - m) (Normalised first order statistics), one per
+        // column
+        blitz::Array<double,2> Fn_b = Fn(blitz::Range::all(), rp);
+        for (int j=0; j<np; ++j)
+        {
+          const bob::machine::GMMStats& stats = *(*probes)[p0+j];
+          for (int c=0; c<C; ++c)
+            for (int d=0; d<D; ++d)
+              Fn_b(c*D+d,j) = stats.sumPx(c,d) - (*mean)(c*D+d)*stats.n(c);
+        }
+        // Ut*diag(sigma)^-1 * Fn_x of all the probes of the block
+        blitz::Array<double,2> T_b = T(blitz::Range::all(), rp);
+        bob::math::prod_(*UtSigmaInv, Fn_b, T_b);
+        // x = (Id + sum_{c=1..C} N_{c}.U_{c}^T.Sigma_{c}^-1.U_{c})^-1 * T
+        for (int j=0; j<np; ++j)
+        {
+          const bob::machine::GMMStats& stats = *(*probes)[p0+j];
+          bob::math::eye(IdPlusUSProd);
+          for (int c=0; c<C; ++c)
+          {
+            const double n_c = stats.n(c);
+            for (int a=0; a<ru; ++a)
+              for (int b=0; b<ru; ++b)
+                IdPlusUSProd(a,b) += (*UProd)(c,a,b) * n_c;
+          }
+          bob::math::inv(IdPlusUSProd, IdPlusUSProdInv);
+          for (int a=0; a<ru; ++a)
+          {
+            double sum = 0.;
+            for (int b=0; b<ru; ++b) sum += IdPlusUSProdInv(a,b) * T(b,j);
+            X(a,j) = sum;
+          }
+        }
+        blitz::Array<double,2> X_b = X(blitz::Range::all(), rp);
+        bob::math::prod_(*U, X_b, UxT_b);
+        if (Ux)
+          for (int j=0; j<np; ++j)
+            for (int s=0; s<CD; ++s)
+              (*Ux)(p0+j,s) = UxT_b(s,j);
+      }
+
+      if (!models) continue;
+      // Normalised statistics of the probes, one per column (as in
+      // linearScoring())
+      blitz::Array<double,2> B_b = B(blitz::Range::all(), rp);
+      for (int j=0; j<np; ++j)
+      {
+        const bob::machine::GMMStats& stats = *(*probes)[p0+j];
+        const double sum_N = stats.T;
+        const bool no_frames = (sum_N <= std::numeric_limits<double>::epsilon() &&
+          sum_N >= -std::numeric_limits<double>::epsilon());
+        for (int c=0; c<C; ++c)
+        {
+          const double n_c = stats.n(c);
+          for (int d=0; d<D; ++d)
+          {
+            const int s = c*D + d;
+            B_b(s,j) = (no_frames ? 0. : (stats.sumPx(c,d) -
+              n_c * ((*mean)(s) + UxT_b(s,j))) / sum_N);
+          }
+        }
+      }
+      blitz::Array<double,2> cross_b = cross(blitz::Range::all(), rp);
+      bob::math::prod_(*models, B_b, cross_b);
+      for (int m=0; m<cross.extent(0); ++m)
+        for (int j=0; j<np; ++j)
+          (*scores)(m,p0+j) = cross_b(m,j);
+    }
+  }
+};
+
+/**
+ * Computes the mean supervectors m + V.y + D.z of several models (one per
+ * row), as JFAMachine::updateCache() and ISVMachine::updateCache() do
+ */
+static void modelSupervectors(const bob::machine::FABase& base,
+  const blitz::Array<double,2>* y, const blitz::Array<double,2>& z,
+  blitz::Array<double,2>& models)
+{
+  if (!base.getUbm()) throw std::runtime_error("No UBM was set in the JFA machine.");
+  const int n_models = z.extent(0);
+  bob::core::array::assertSameDimensionLength(z.extent(1), base.getDimCD());
+  models.resize(n_models, base.getDimCD());
+  if (y) {
+    bob::core::array::assertSameDimensionLength(y->extent(0), n_models);
+    bob::core::array::assertSameDimensionLength(y->extent(1), base.getDimRv());
+    const blitz::Array<double,2> Vt = const_cast<blitz::Array<double,2>&>(base.getV()).transpose(1,0);
+    bob::math::prod(*y, Vt, models); // V.y of each model
+  }
+  else
+    models = 0.;
+  const blitz::Array<double,1>& mean = base.getUbm()->getMeanSupervector();
+  const blitz::Array<double,1>& d = base.getD();
+  blitz::Range rall = blitz::Range::all();
+  for (int m=0; m<n_models; ++m) {
+    blitz::Array<double,1> model = models(m, rall);
+    model += d * z(m, rall) + mean;
+  }
+}
+
 
 //////////////////// FABase ////////////////////
 bob::machine::FABase::FABase():
@@ -319,6 +490,100 @@ void bob::machine::FABase::estimateX(const bob::machine::GMMStats& gmm_stats, bl
   estimateX(m_tmp_IdPlusUSProdInv, m_tmp_Fn_x, x); // Estimates the value of x
 }
 
+void bob::machine::FABase::processProbes(const blitz::Array<double,2>* models,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  const blitz::Array<double,2>* cached_Ux, blitz::Array<double,2>* Ux,
+  blitz::Array<double,2>* scores, const size_t n_threads) const
+{
+  if (!m_ubm) throw std::runtime_error("No UBM was set in the JFA machine.");
+  const int n_probes = probes.size();
+  const size_t dim_c = getDimC();
+  const size_t dim_d = getDimD();
+  for (int p=0; p<n_probes; ++p) {
+    bob::core::array::assertSameDimensionLength(probes[p]->sumPx.extent(0), dim_c);
+    bob::core::array::assertSameDimensionLength(probes[p]->sumPx.extent(1), dim_d);
+  }
+  if (cached_Ux) {
+    bob::core::array::assertSameDimensionLength(cached_Ux->extent(0), n_probes);
+    bob::core::array::assertSameDimensionLength(cached_Ux->extent(1), getDimCD());
+  }
+  if (Ux) {
+    bob::core::array::assertSameDimensionLength(Ux->extent(0), n_probes);
+    bob::core::array::assertSameDimensionLength(Ux->extent(1), getDimCD());
+  }
+  // the members are only read through views, as blitz reference counting
+  // is not thread-safe
+  blitz::Array<double,2> U = view(m_U);
+  const blitz::Array<double,1> mean = view(m_cache_mean);
+  const blitz::Array<double,1> sigma = view(m_cache_sigma);
+
+  // (model - mean) / sigma, one per row (as in linearScoring())
+  blitz::Array<double,2> A;
+  if (models) {
+    bob::core::array::assertSameDimensionLength(models->extent(1), getDimCD());
+    bob::core::array::assertSameDimensionLength(scores->extent(0), models->extent(0));
+    bob::core::array::assertSameDimensionLength(scores->extent(1), n_probes);
+    blitz::firstIndex i;
+    blitz::secondIndex j;
+    A.resize(models->shape());
+    A = ((*models)(i,j) - mean(j)) / sigma(j);
+  }
+  if (n_probes == 0) return;
+
+  // U_{c}^T.Sigma_{c}^-1.U_{c} of each Gaussian (which does not depend on
+  // the probes)
+  blitz::Array<double,3> UProd(dim_c, getDimRu(), getDimRu());
+  blitz::Array<double,2> Ut = U.transpose(1,0);
+  blitz::Array<double,2> UtSigma_c(getDimRu(), dim_d);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::Range rall = blitz::Range::all();
+  for (size_t c=0; c<dim_c; ++c) {
+    blitz::Range rc(c*dim_d,(c+1)*dim_d-1);
+    blitz::Array<double,2> Ut_c = Ut(rall,rc);
+    blitz::Array<double,1> sigma_c = sigma(rc);
+    UtSigma_c = Ut_c(i,j) / sigma_c(j); // U_{c}^T.Sigma_{c}^-1
+    blitz::Array<double,2> U_c = U(rc,rall);
+    blitz::Array<double,2> UProd_c = UProd(c,rall,rall);
+    bob::math::prod(UtSigma_c, U_c, UProd_c); // U_{c}^T.Sigma_{c}^-1.U_{c}
+  }
+
+  FAProbeScorer scorer;
+  scorer.probes = &probes;
+  scorer.U = &m_U;
+  scorer.UtSigmaInv = &m_cache_UtSigmaInv;
+  scorer.UProd = &UProd;
+  scorer.mean = &m_cache_mean;
+  scorer.models = (models ? &A : 0);
+  scorer.cached_Ux = cached_Ux;
+  scorer.Ux = Ux;
+  scorer.scores = scores;
+  bob::core::thread_loop(scorer,
+    (n_probes + s_probe_block - 1) / s_probe_block, n_threads);
+}
+
+void bob::machine::FABase::estimateUx(
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  blitz::Array<double,2>& Ux, const size_t n_threads) const
+{
+  processProbes(0, probes, 0, &Ux, 0, n_threads);
+}
+
+void bob::machine::FABase::computeScores(const blitz::Array<double,2>& models,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  blitz::Array<double,2>& scores, const size_t n_threads) const
+{
+  processProbes(&models, probes, 0, 0, &scores, n_threads);
+}
+
+void bob::machine::FABase::computeScores(const blitz::Array<double,2>& models,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  const blitz::Array<double,2>& Ux, blitz::Array<double,2>& scores,
+  const size_t n_threads) const
+{
+  processProbes(&models, probes, &Ux, 0, &scores, n_threads);
+}
+
 
 
 //////////////////// JFABase ////////////////////
@@ -380,6 +645,27 @@ bob::machine::JFABase::operator=(const bob::machine::JFABase& other)
   return *this;
 }
 
+void bob::machine::JFABase::computeScores(const blitz::Array<double,2>& y,
+  const blitz::Array<double,2>& z,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  blitz::Array<double,2>& scores, const size_t n_threads) const
+{
+  blitz::Array<double,2> models;
+  modelSupervectors(m_base, &y, z, models);
+  m_base.computeScores(models, probes, scores, n_threads);
+}
+
+void bob::machine::JFABase::computeScores(const blitz::Array<double,2>& y,
+  const blitz::Array<double,2>& z,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  const blitz::Array<double,2>& Ux, blitz::Array<double,2>& scores,
+  const size_t n_threads) const
+{
+  blitz::Array<double,2> models;
+  modelSupervectors(m_base, &y, z, models);
+  m_base.computeScores(models, probes, Ux, scores, n_threads);
+}
+
 
 //////////////////// ISVBase ////////////////////
 bob::machine::ISVBase::ISVBase()
@@ -440,6 +726,25 @@ bob::machine::ISVBase::operator=(const bob::machine::ISVBase& other)
   return *this;
 }
 
+void bob::machine::ISVBase::computeScores(const blitz::Array<double,2>& z,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  blitz::Array<double,2>& scores, const size_t n_threads) const
+{
+  blitz::Array<double,2> models;
+  modelSupervectors(m_base, 0, z, models);
+  m_base.computeScores(models, probes, scores, n_threads);
+}
+
+void bob::machine::ISVBase::computeScores(const blitz::Array<double,2>& z,
+  const std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes,
+  const blitz::Array<double,2>& Ux, blitz::Array<double,2>& scores,
+  const size_t n_threads) const
+{
+  blitz::Array<double,2> models;
+  modelSupervectors(m_base, 0, z, models);
+  m_base.computeScores(models, probes, Ux, scores, n_threads);
+}
+
 
 
 //////////////////// JFAMachine ////////////////////
@@ -42,8 +42,11 @@ namespace detail {
     bob::core::array::assertSameDimensionLength(scores.extent(0), models.size());
     bob::core::array::assertSameDimensionLength(scores.extent(1), test_stats.size());
 
+    // The statistics of each test sample are stored along a row of B, such
+    // that B is filled contiguously, and the scores A*B' are computed by a
+    // single BLAS call on the transposed view of B
     blitz::Array<double,2> A(Tm, CD);
-    blitz::Array<double,2> B(CD, Tt);
+    blitz::Array<double,2> B(Tt, CD);
 
     // 1) Compute A
     for(int t=0; t<Tm; ++t) {
@@ -52,18 +55,21 @@ namespace detail {
     }
 
     // 2) Compute B
-    if(test_channelOffset == 0) {
-      for(int t=0; t<Tt; ++t) 
-        for(int s=0; s<CD; ++s)
-          B(s, t) = test_stats[t]->sumPx(s/D, s%D) - (ubm_mean(s) * test_stats[t]->n(s/D));
-    }
-    else {
+    if(test_channelOffset != 0)
       bob::core::array::assertSameDimensionLength((*test_channelOffset).size(), Tt);
-      
-      for(int t=0; t<Tt; ++t) {
+    for(int t=0; t<Tt; ++t) {
+      const bob::machine::GMMStats& stats = *test_stats[t];
+      if(test_channelOffset != 0)
         bob::core::array::assertSameDimensionLength((*test_channelOffset)[t].extent(0), CD);
-        for(int s=0; s<CD; ++s) 
-          B(s, t) = test_stats[t]->sumPx(s/D, s%D) - (test_stats[t]->n(s/D) * (ubm_mean(s) + (*test_channelOffset)[t](s)));
+      for(int c=0; c<C; ++c) {
+        const double n_c = stats.n(c);
+        for(int d=0; d<D; ++d) {
+          const int s = c*D + d;
+          if(test_channelOffset == 0)
+            B(t, s) = stats.sumPx(c, d) - (ubm_mean(s) * n_c);
+          else
+            B(t, s) = stats.sumPx(c, d) - (n_c * (ubm_mean(s) + (*test_channelOffset)[t](s)));
+        }
       }
     }
 
@@ -71,7 +77,7 @@ namespace detail {
     if(frame_length_normalisation) {
       for(int t=0; t<Tt; ++t) {
         double sum_N = test_stats[t]->T;
-        blitz::Array<double, 1> v_t = B(blitz::Range::all(),t);
+        blitz::Array<double, 1> v_t = B(t, blitz::Range::all());
 
         if (sum_N <= std::numeric_limits<double>::epsilon() && sum_N >= -std::numeric_limits<double>::epsilon())
           v_t = 0;
@@ -81,7 +87,8 @@ namespace detail {
     }
 
     // 3) Compute LLR
-    bob::math::prod(A, B, scores);
+    blitz::Array<double,2> Bt = B.transpose(1,0);
+    bob::math::prod(A, Bt, scores);
   } 
 }
 
@@ -22,23 +22,41 @@
 
 #include <sys/time.h>
 #include <cmath>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/make_shared.hpp>
 
 #include <bob/core/check.h>
 #include <bob/core/array_copy.h>
 #include <bob/core/assert.h>
+#include <bob/core/threads.h>
 #include <bob/machine/MLP.h>
 #include <bob/math/linear.h>
 
+/**
+ * Buffers for the inputs of each layer, which belong to the calling thread
+ */
+static boost::thread_specific_ptr<std::vector<blitz::Array<double,1> > > s_buffer;
+
+/**
+ * Buffers for the inputs of each layer of a batch of samples, which belong
+ * to the calling thread
+ */
+static boost::thread_specific_ptr<std::vector<blitz::Array<double,2> > > s_batch_buffer;
+
+/**
+ * Number of samples forwarded at once with the buffers of the calling
+ * thread, which therefore do not grow with the size of the batches
+ */
+static const int s_block_size = 256;
+
 bob::machine::MLP::MLP (size_t input, size_t output):
   m_input_sub(input),
   m_input_div(input),
   m_weight(1),
   m_bias(1),
   m_hidden_activation(boost::make_shared<bob::machine::HyperbolicTangentActivation>()),
-  m_output_activation(m_hidden_activation),
-  m_buffer(1)
+  m_output_activation(m_hidden_activation)
 {
   resize(input, output);
   m_input_sub = 0;
@@ -53,8 +71,7 @@ bob::machine::MLP::MLP (size_t input, size_t hidden, size_t output):
   m_weight(2),
   m_bias(2),
   m_hidden_activation(boost::make_shared<bob::machine::HyperbolicTangentActivation>()),
-  m_output_activation(m_hidden_activation),
-  m_buffer(2)
+  m_output_activation(m_hidden_activation)
 {
   resize(input, hidden, output);
   m_input_sub = 0;
@@ -69,8 +86,7 @@ bob::machine::MLP::MLP (size_t input, const std::vector<size_t>& hidden, size_t
   m_weight(hidden.size()+1),
   m_bias(hidden.size()+1),
   m_hidden_activation(boost::make_shared<bob::machine::HyperbolicTangentActivation>()),
-  m_output_activation(m_hidden_activation),
-  m_buffer(hidden.size()+1)
+  m_output_activation(m_hidden_activation)
 {
   resize(input, hidden, output);
   m_input_sub = 0;
@@ -96,13 +112,11 @@ bob::machine::MLP::MLP (const bob::machine::MLP& other):
   m_weight(other.m_weight.size()),
   m_bias(other.m_bias.size()),
   m_hidden_activation(other.m_hidden_activation),
-  m_output_activation(other.m_output_activation),
-  m_buffer(other.m_buffer.size())
+  m_output_activation(other.m_output_activation)
 {
   for (size_t i=0; i<other.m_weight.size(); ++i) {
     m_weight[i].reference(bob::core::array::ccopy(other.m_weight[i]));
     m_bias[i].reference(bob::core::array::ccopy(other.m_bias[i]));
-    m_buffer[i].reference(bob::core::array::ccopy(other.m_buffer[i]));
   }
 }
 
@@ -121,11 +135,9 @@ bob::machine::MLP& bob::machine::MLP::operator= (const MLP& other) {
     m_bias.resize(other.m_bias.size());
     m_hidden_activation = other.m_hidden_activation;
     m_output_activation = other.m_output_activation;
-    m_buffer.resize(other.m_buffer.size());
     for (size_t i=0; i<other.m_weight.size(); ++i) {
       m_weight[i].reference(bob::core::array::ccopy(other.m_weight[i]));
       m_bias[i].reference(bob::core::array::ccopy(other.m_bias[i]));
-      m_buffer[i].reference(bob::core::array::ccopy(other.m_buffer[i]));
     }
   }
   return *this;
@@ -160,7 +172,6 @@ void bob::machine::MLP::load (bob::io::HDF5File& config) {
   uint8_t nhidden = config.read<uint8_t>("nhidden");
   m_weight.resize(nhidden+1);
   m_bias.resize(nhidden+1);
-  m_buffer.resize(nhidden+1);
 
   //configures the input
   m_input_sub.reference(config.readArray<double,1>("input_sub"));
@@ -189,13 +200,6 @@ void bob::machine::MLP::load (bob::io::HDF5File& config) {
     m_hidden_activation = bob::machine::make_deprecated_activation(act);
     m_output_activation = m_hidden_activation;
   }
-
-  //setup buffers: first, input
-  m_buffer[0].reference(blitz::Array<double,1>(m_input_sub.shape()));
-  for (size_t i=1; i<m_weight.size(); ++i) {
-    //buffers have to be sized the same as the input for the next layer
-    m_buffer[i].reference(blitz::Array<double,1>(m_weight[i].extent(0)));
-  }
 }
 
 void bob::machine::MLP::save (bob::io::HDF5File& config) const {
@@ -222,30 +226,44 @@ void bob::machine::MLP::save (bob::io::HDF5File& config) const {
 }
 
 void bob::machine::MLP::forward_ (const blitz::Array<double,1>& input,
-    blitz::Array<double,1>& output) {
+    blitz::Array<double,1>& output,
+    std::vector<blitz::Array<double,1> >& buffer) const {
+
+  //buffers have to be sized the same as the input of each layer
+  buffer.resize(m_weight.size());
+  for (size_t j=0; j<m_weight.size(); ++j) {
+    if (buffer[j].extent(0) != m_weight[j].extent(0))
+      buffer[j].resize(m_weight[j].extent(0));
+  }
 
   //doesn't check input, just computes
-  m_buffer[0] = (input - m_input_sub) / m_input_div;
+  buffer[0] = (input - m_input_sub) / m_input_div;
 
   //input -> hidden[0]; hidden[0] -> hidden[1], ..., hidden[N-2] -> hidden[N-1]
   for (size_t j=1; j<m_weight.size(); ++j) {
-    bob::math::prod_(m_buffer[j-1], m_weight[j-1], m_buffer[j]);
-    m_buffer[j] += m_bias[j-1];
-    for (int i=0; i<m_buffer[j].extent(0); ++i) {
-      m_buffer[j](i) = m_hidden_activation->f(m_buffer[j](i));
+    bob::math::prod_(buffer[j-1], m_weight[j-1], buffer[j]);
+    buffer[j] += m_bias[j-1];
+    for (int i=0; i<buffer[j].extent(0); ++i) {
+      buffer[j](i) = m_hidden_activation->f(buffer[j](i));
     }
   }
 
   //hidden[N-1] -> output
-  bob::math::prod_(m_buffer.back(), m_weight.back(), output);
+  bob::math::prod_(buffer.back(), m_weight.back(), output);
   output += m_bias.back();
   for (int i=0; i<output.extent(0); ++i) {
     output(i) = m_output_activation->f(output(i));
   }
 }
 
+void bob::machine::MLP::forward_ (const blitz::Array<double,1>& input,
+    blitz::Array<double,1>& output) const {
+  forward_(input, output, bob::core::thread_workspace(s_buffer));
+}
+
 void bob::machine::MLP::forward (const blitz::Array<double,1>& input,
-    blitz::Array<double,1>& output) {
+    blitz::Array<double,1>& output,
+    std::vector<blitz::Array<double,1> >& buffer) const {
 
   //checks input
   if (m_weight.front().extent(0) != input.extent(0)) {//checks input
@@ -258,22 +276,80 @@ void bob::machine::MLP::forward (const blitz::Array<double,1>& input,
     m % m_weight.back().extent(1) % output.extent(0);
     throw std::runtime_error(m.str());
   }
-  forward_(input, output); 
+  forward_(input, output, buffer); 
+}
+
+void bob::machine::MLP::forward (const blitz::Array<double,1>& input,
+    blitz::Array<double,1>& output) const {
+  forward(input, output, bob::core::thread_workspace(s_buffer));
+}
+
+void bob::machine::MLP::forwardLayer_ (const size_t k,
+    const blitz::Array<double,2>& input, blitz::Array<double,2>& output) const {
+
+  //one matrix product for the whole batch
+  bob::math::prod_(input, m_weight[k], output);
+  const blitz::Array<double,1>& bias = m_bias[k];
+  for (int i=0; i<output.extent(0); ++i) {
+    for (int j=0; j<output.extent(1); ++j) {
+      output(i,j) += bias(j);
+    }
+  }
+
+  //a single (virtual) call to the activation for the whole batch
+  if (k+1 == m_weight.size()) m_output_activation->f_batch(output);
+  else m_hidden_activation->f_batch(output);
 }
 
 void bob::machine::MLP::forward_ (const blitz::Array<double,2>& input,
-    blitz::Array<double,2>& output) {
+    blitz::Array<double,2>& output,
+    std::vector<blitz::Array<double,2> >& buffer) const {
 
-  blitz::Range all = blitz::Range::all();
-  for (int i=0; i<input.extent(0); ++i) {
-    blitz::Array<double,1> inref(input(i,all));
-    blitz::Array<double,1> outref(output(i,all));
-    forward_(inref, outref);
+  //buffers have to be sized the same as the input of each layer
+  const int n_samples = input.extent(0);
+  buffer.resize(m_weight.size());
+  for (size_t k=0; k<m_weight.size(); ++k) {
+    if (buffer[k].extent(0) != n_samples ||
+        buffer[k].extent(1) != m_weight[k].extent(0))
+      buffer[k].resize(n_samples, m_weight[k].extent(0));
+  }
+
+  //doesn't check input, just computes
+  blitz::Array<double,2>& normalized = buffer[0];
+  for (int i=0; i<n_samples; ++i) {
+    for (int j=0; j<normalized.extent(1); ++j) {
+      normalized(i,j) = (input(i,j) - m_input_sub(j)) / m_input_div(j);
+    }
+  }
+
+  //input -> hidden[0]; hidden[0] -> hidden[1], ..., hidden[N-1] -> output
+  const size_t last = m_weight.size() - 1;
+  for (size_t k=0; k<last; ++k) forwardLayer_(k, buffer[k], buffer[k+1]);
+  forwardLayer_(last, buffer[last], output);
+}
+
+void bob::machine::MLP::forward_ (const blitz::Array<double,2>& input,
+    blitz::Array<double,2>& output) const {
+  std::vector<blitz::Array<double,2> >& buffer =
+    bob::core::thread_workspace(s_batch_buffer);
+
+  //blocks of rows of the input and output, without slicing them
+  const int n_samples = input.extent(0);
+  for (int b=0; b<n_samples; b+=s_block_size) {
+    const int n = std::min(s_block_size, n_samples-b);
+    const blitz::Array<double,2> input_block(
+        const_cast<double*>(input.data()) + b*input.stride(0),
+        blitz::shape(n, input.extent(1)),
+        blitz::shape(input.stride(0), input.stride(1)), blitz::neverDeleteData);
+    blitz::Array<double,2> output_block(output.data() + b*output.stride(0),
+        blitz::shape(n, output.extent(1)),
+        blitz::shape(output.stride(0), output.stride(1)), blitz::neverDeleteData);
+    forward_(input_block, output_block, buffer);
   }
 }
 
 void bob::machine::MLP::forward (const blitz::Array<double,2>& input,
-    blitz::Array<double,2>& output) {
+    blitz::Array<double,2>& output) const {
 
   //checks input
   if (m_weight.front().extent(0) != input.extent(1)) {//checks input
@@ -300,8 +376,6 @@ void bob::machine::MLP::resize (size_t input, size_t output) {
   m_weight[0].reference(blitz::Array<double,2>(input, output));
   m_bias.resize(1);
   m_bias[0].reference(blitz::Array<double,1>(output));
-  m_buffer.resize(1);
-  m_buffer[0].reference(blitz::Array<double,1>(input));
   setWeights(0);
   setBiases(0);
 }
@@ -325,25 +399,21 @@ void bob::machine::MLP::resize (size_t input, const std::vector<size_t>& hidden,
   m_input_div = 1;
   m_weight.resize(hidden.size()+1);
   m_bias.resize(hidden.size()+1);
-  m_buffer.resize(hidden.size()+1);
   
   //initializes first layer
   m_weight[0].reference(blitz::Array<double,2>(input, hidden[0]));
   m_bias[0].reference(blitz::Array<double,1>(hidden[0]));
-  m_buffer[0].reference(blitz::Array<double,1>(input));
 
   //initializes hidden layers
   const size_t NH1 = hidden.size()-1;
   for (size_t i=0; i<NH1; ++i) {
     m_weight[i+1].reference(blitz::Array<double,2>(hidden[i], hidden[i+1]));
     m_bias[i+1].reference(blitz::Array<double,1>(hidden[i+1]));
-    m_buffer[i+1].reference(blitz::Array<double,1>(hidden[i]));
   }
 
   //initializes the last layer
   m_weight.back().reference(blitz::Array<double,2>(hidden.back(), output));
   m_bias.back().reference(blitz::Array<double,1>(output));
-  m_buffer.back().reference(blitz::Array<double,1>(hidden.back()));
   
   setWeights(0);
   setBiases(0);
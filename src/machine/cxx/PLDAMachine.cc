@@ -23,14 +23,102 @@
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
 #include <bob/core/array_copy.h>
+#include <bob/core/threads.h>
 #include <bob/machine/PLDAMachine.h>
 #include <bob/math/linear.h>
 #include <bob/math/det.h>
 #include <bob/math/inv.h>
 
+#include <algorithm>
 #include <cmath>
 #include <boost/lexical_cast.hpp>
 #include <string>
+#include <vector>
+
+/**
+ * Number of probes scored at once by PLDABase::computeLogLikelihoodRatios()
+ */
+static const int s_probe_block = 256;
+
+/**
+ * Computes \f$\gamma_a = (Id + a F^T \beta F)^{-1}\f$ from the
+ * \f$F^T \beta F\f$ matrix, without using any working array of the machine
+ */
+static void gammaFromFtBetaF(const blitz::Array<double,2>& Ft_beta_F,
+  const size_t a, blitz::Array<double,2>& gamma_a)
+{
+  blitz::Array<double,2> tmp(Ft_beta_F.shape());
+  tmp = static_cast<double>(a) * Ft_beta_F;
+  for (int i=0; i<tmp.extent(0); ++i) tmp(i,i) += 1.;
+  bob::math::inv(tmp, gamma_a);
+}
+
+/**
+ * Models with the same number of enrolment samples n. With a=n+1, s the
+ * weighted sum of a model and u = F^T.beta.(x-mu) for a probe x, the log
+ * likelihood ratio is offset + s^T.gamma_a.u + 1/2 u^T.(gamma_a-gamma_1).u
+ */
+struct PLDAScoreGroup {
+  std::vector<int> models; ///< Indices of the models
+  blitz::Array<double,1> offsets; ///< Terms which do not depend on the probe
+  blitz::Array<double,2> s_gamma; ///< s^T.gamma_a of the models (one per row)
+  blitz::Array<double,2> d_gamma; ///< gamma_a - gamma_1
+};
+
+/**
+ * Scores blocks of s_probe_block probes against all the groups of models.
+ * The shared arrays are only read through pointers (blitz reference
+ * counting is not thread-safe), and each block of probes is written to its
+ * own columns of the scores.
+ */
+struct PLDAScorer {
+  const blitz::Array<double,2>* Ft_beta;
+  const blitz::Array<double,1>* mu;
+  const blitz::Array<double,2>* probes;
+  const std::vector<PLDAScoreGroup>* groups;
+  blitz::Array<double,2>* scores;
+
+  void operator()(const size_t, const size_t begin, const size_t end) const
+  {
+    const int n_probes = probes->extent(0);
+    const int dim_d = probes->extent(1);
+    const int dim_f = Ft_beta->extent(0);
+    for (size_t k=begin; k<end; ++k)
+    {
+      const int p0 = k*s_probe_block;
+      const int np = std::min(s_probe_block, n_probes-p0);
+
+      // Projections u of the centered probes (one per column)
+      blitz::Array<double,2> xc(dim_d, np);
+      for (int j=0; j<np; ++j)
+        for (int d=0; d<dim_d; ++d)
+          xc(d,j) = (*probes)(p0+j,d) - (*mu)(d);
+      blitz::Array<double,2> u(dim_f, np);
+      bob::math::prod_(*Ft_beta, xc, u);
+
+      blitz::Array<double,2> w(dim_f, np);
+      blitz::Array<double,1> q(np);
+      for (size_t g=0; g<groups->size(); ++g)
+      {
+        const PLDAScoreGroup& group = (*groups)[g];
+        // q = 1/2 u^T.(gamma_a-gamma_1).u
+        bob::math::prod_(group.d_gamma, u, w);
+        for (int j=0; j<np; ++j)
+        {
+          double sum = 0.;
+          for (int f=0; f<dim_f; ++f) sum += u(f,j) * w(f,j);
+          q(j) = sum / 2.;
+        }
+        // s^T.gamma_a.u for all the models of the group
+        blitz::Array<double,2> cross(group.models.size(), np);
+        bob::math::prod_(group.s_gamma, u, cross);
+        for (size_t i=0; i<group.models.size(); ++i)
+          for (int j=0; j<np; ++j)
+            (*scores)(group.models[i], p0+j) = group.offsets(i) + cross(i,j) + q(j);
+      }
+    }
+  }
+};
 
 bob::machine::PLDABase::PLDABase():
   m_variance_threshold(0.)
@@ -583,6 +671,89 @@ double bob::machine::PLDABase::computeLogLikelihoodPointEstimate(
   return res;
 }
 
+void bob::machine::PLDABase::computeLogLikelihoodRatios(
+  const blitz::Array<double,2>& weighted_sums,
+  const blitz::Array<uint64_t,1>& n_samples,
+  const blitz::Array<double,2>& probes, blitz::Array<double,2>& scores,
+  const size_t n_threads) const
+{
+  const int n_models = weighted_sums.extent(0);
+  const int n_probes = probes.extent(0);
+  // Check inputs
+  bob::core::array::assertSameDimensionLength(weighted_sums.extent(1), getDimF());
+  bob::core::array::assertSameDimensionLength(n_samples.extent(0), n_models);
+  bob::core::array::assertSameDimensionLength(probes.extent(1), getDimD());
+  bob::core::array::assertSameDimensionLength(scores.extent(0), n_models);
+  bob::core::array::assertSameDimensionLength(scores.extent(1), n_probes);
+  if (n_models == 0 || n_probes == 0) return;
+
+  // Computes the log likelihood ratio of a probe x against a model enrolled
+  // with n samples, with a=n+1, u=F^T.beta.(x-mu) and s the weighted sum:
+  //   l_a + terma + 1/2 (s+u)^T.gamma_a.(s+u)            (match)
+  //   - (l_1 + terma_x + 1/2 u^T.gamma_1.u)              (no match, probe)
+  //   - (l_n + terma_enrol + 1/2 s^T.gamma_n.s)          (no match, model)
+  // where the terma terms cancel out. The gamma matrices are not taken from
+  // (nor added to) the maps, which are not thread-safe.
+  blitz::Array<double,2> Ft_beta_F(m_dim_f, m_dim_f);
+  bob::math::prod(m_cache_Ft_beta, m_F, Ft_beta_F);
+  blitz::Array<double,2> gamma_1(m_dim_f, m_dim_f);
+  gammaFromFtBetaF(Ft_beta_F, 1, gamma_1);
+  const double constterm_1 = computeLogLikeConstTerm(1, gamma_1);
+
+  // Groups the models by number of enrolment samples
+  std::map<uint64_t, std::vector<int> > models;
+  for (int m=0; m<n_models; ++m) models[n_samples(m)].push_back(m);
+
+  std::vector<PLDAScoreGroup> groups(models.size());
+  blitz::Array<double,2> gamma_n(m_dim_f, m_dim_f);
+  blitz::Array<double,2> gamma_a(m_dim_f, m_dim_f);
+  blitz::Range all = blitz::Range::all();
+  size_t g = 0;
+  for (std::map<uint64_t, std::vector<int> >::const_iterator it=models.begin();
+      it!=models.end(); ++it, ++g)
+  {
+    const uint64_t n = it->first;
+    PLDAScoreGroup& group = groups[g];
+    group.models = it->second;
+    const int size = group.models.size();
+    gammaFromFtBetaF(Ft_beta_F, n, gamma_n);
+    gammaFromFtBetaF(Ft_beta_F, n+1, gamma_a);
+    const double constterm = computeLogLikeConstTerm(n+1, gamma_a) -
+      computeLogLikeConstTerm(n, gamma_n) - constterm_1;
+
+    // Weighted sums of the models of the group (which are ignored by the
+    // PLDAMachine when there is no enrolment sample)
+    blitz::Array<double,2> s(size, m_dim_f);
+    if (n > 0)
+      for (int i=0; i<size; ++i) s(i,all) = weighted_sums(group.models[i],all);
+    else
+      s = 0.;
+
+    group.s_gamma.resize(size, m_dim_f);
+    bob::math::prod(s, gamma_a, group.s_gamma);
+    group.d_gamma.resize(m_dim_f, m_dim_f);
+    group.d_gamma = gamma_a - gamma_1;
+
+    // offsets = l_a - l_n - l_1 + 1/2 s^T.(gamma_a-gamma_n).s
+    blitz::Array<double,2> s_gamma_n(size, m_dim_f);
+    bob::math::prod(s, gamma_n, s_gamma_n);
+    s_gamma_n = group.s_gamma - s_gamma_n;
+    group.offsets.resize(size);
+    for (int i=0; i<size; ++i)
+      group.offsets(i) = constterm +
+        blitz::sum(s(i,all) * s_gamma_n(i,all)) / 2.;
+  }
+
+  PLDAScorer scorer;
+  scorer.Ft_beta = &m_cache_Ft_beta;
+  scorer.mu = &m_mu;
+  scorer.probes = &probes;
+  scorer.groups = &groups;
+  scorer.scores = &scores;
+  bob::core::thread_loop(scorer,
+    (n_probes + s_probe_block - 1) / s_probe_block, n_threads);
+}
+
 namespace bob{
   namespace machine{
     /**
@@ -0,0 +1,126 @@
+/**
+ * @file machine/cxx/test/gmm.cc
+ * @date Sat Oct 17 10:12:31 2026 +0200
+ *
+ * @brief Tests the concurrent use of a single GMMMachine
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE GMM Machine Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <blitz/array.h>
+#include <cmath>
+#include <vector>
+
+#include "bob/machine/GMMMachine.h"
+#include "bob/machine/GMMStats.h"
+
+static const size_t n_gaussians = 16;
+static const size_t n_inputs = 10;
+static const size_t n_threads = 8;
+static const size_t n_repeats = 5;
+
+/**
+ * Builds a GMMMachine with deterministic (pseudo-random) parameters
+ */
+static void init_machine(bob::machine::GMMMachine& gmm) {
+  gmm.resize(n_gaussians, n_inputs);
+  blitz::Array<double,1> weights(n_gaussians);
+  blitz::Array<double,2> means(n_gaussians, n_inputs);
+  blitz::Array<double,2> variances(n_gaussians, n_inputs);
+  for (size_t i=0; i<n_gaussians; ++i) {
+    weights(i) = 1. + i % 3;
+    for (size_t j=0; j<n_inputs; ++j) {
+      means(i,j) = 3. * sin(1.3*i + 0.7*j);
+      variances(i,j) = 1. + 0.5 * cos(0.9*i + 1.1*j);
+    }
+  }
+  weights /= blitz::sum(weights);
+  gmm.setWeights(weights);
+  gmm.setMeans(means);
+  gmm.setVariances(variances);
+}
+
+/**
+ * Builds a set of deterministic (pseudo-random) samples
+ */
+static void init_data(blitz::Array<double,2>& data) {
+  data.resize(2000, n_inputs);
+  for (int t=0; t<data.extent(0); ++t)
+    for (int j=0; j<data.extent(1); ++j)
+      data(t,j) = 4. * sin(0.37*t + 2.1*j) + cos(0.011*t*j);
+}
+
+/**
+ * Accumulates statistics and log likelihoods several times, using a
+ * workspace owned by the calling thread
+ */
+static void worker(const bob::machine::GMMMachine* gmm,
+  const blitz::Array<double,2>* data, bob::machine::GMMStats* stats,
+  blitz::Array<double,1>* ll)
+{
+  bob::machine::GMMWorkspace workspace(n_gaussians, n_inputs);
+  for (size_t r=0; r<n_repeats; ++r) {
+    stats->init();
+    gmm->accStatistics(*data, *stats, workspace);
+    gmm->logLikelihood(*data, *ll, workspace);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_acc_statistics )
+{
+  bob::machine::GMMMachine gmm;
+  init_machine(gmm);
+  blitz::Array<double,2> data;
+  init_data(data);
+
+  // Single-threaded reference
+  bob::machine::GMMStats ref(n_gaussians, n_inputs);
+  gmm.accStatistics(data, ref);
+  blitz::Array<double,1> ref_ll(data.extent(0));
+  gmm.logLikelihood(data, ref_ll);
+
+  // The same machine used by several threads at once
+  std::vector<bob::machine::GMMStats> stats(n_threads,
+    bob::machine::GMMStats(n_gaussians, n_inputs));
+  std::vector<blitz::Array<double,1> > ll(n_threads);
+  boost::thread_group threads;
+  for (size_t k=0; k<n_threads; ++k) {
+    ll[k].resize(data.extent(0));
+    threads.create_thread(boost::bind(&worker, &gmm, &data, &stats[k], &ll[k]));
+  }
+  threads.join_all();
+
+  for (size_t k=0; k<n_threads; ++k) {
+    BOOST_CHECK( stats[k] == ref );
+    BOOST_CHECK( blitz::all(ll[k] == ref_ll) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_workspace_copy )
+{
+  bob::machine::GMMWorkspace a(n_gaussians, n_inputs);
+  bob::machine::GMMWorkspace b(a);
+  BOOST_CHECK_EQUAL( b.Px.extent(0), (int)n_gaussians );
+  BOOST_CHECK_EQUAL( b.Px.extent(1), (int)n_inputs );
+  // The scratch arrays must not be shared
+  BOOST_CHECK( a.Px.data() != b.Px.data() );
+  BOOST_CHECK( a.packed_means.data() != b.packed_means.data() );
+}
@@ -0,0 +1,209 @@
+/**
+ * @file machine/cxx/test/threads.cc
+ * @date Sun Oct 18 09:41:26 2026 +0200
+ *
+ * @brief Tests the concurrent use of a single LinearMachine, MLP or
+ * BICMachine
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Concurrent Machine Tests
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+#include <blitz/array.h>
+#include <cmath>
+#include <vector>
+
+#include "bob/machine/LinearMachine.h"
+#include "bob/machine/MLP.h"
+#include "bob/machine/BICMachine.h"
+
+static const int n_inputs = 20;
+static const int n_samples = 500;
+static const size_t n_threads = 8;
+static const size_t n_repeats = 20;
+
+/**
+ * Fills an array with deterministic (pseudo-random) values
+ */
+template <int N>
+static void init_array(blitz::Array<double,N>& a, const double seed) {
+  double* p = a.data();
+  for (int i=0; i<a.numElements(); ++i)
+    p[i] = sin(seed + 0.37*i) + 0.5 * cos(1.3*seed + 0.011*i*i);
+}
+
+static void forward(const bob::machine::LinearMachine& m,
+  const blitz::Array<double,1>& input, blitz::Array<double,1>& output) {
+  m.forward(input, output);
+}
+
+static void forward(const bob::machine::MLP& m,
+  const blitz::Array<double,1>& input, blitz::Array<double,1>& output) {
+  m.forward(input, output);
+}
+
+static void forward(const bob::machine::BICMachine& m,
+  const blitz::Array<double,1>& input, blitz::Array<double,1>& output) {
+  m.forward(input, output(0));
+}
+
+/**
+ * Computes the outputs of all the samples, several times, and counts the
+ * ones which differ from the expected outputs. Only the elements of the
+ * shared arrays are accessed (their reference counting is not thread-safe).
+ */
+template <typename T>
+static void worker(const T* machine, const blitz::Array<double,2>* data,
+  const blitz::Array<double,2>* expected, int* n_errors)
+{
+  blitz::Array<double,1> input(data->extent(1));
+  blitz::Array<double,1> output(expected->extent(1));
+  *n_errors = 0;
+  for (size_t r=0; r<n_repeats; ++r) {
+    for (int i=0; i<data->extent(0); ++i) {
+      for (int j=0; j<input.extent(0); ++j) input(j) = (*data)(i,j);
+      forward(*machine, input, output);
+      for (int k=0; k<output.extent(0); ++k)
+        if (output(k) != (*expected)(i,k)) ++(*n_errors);
+    }
+  }
+}
+
+/**
+ * Compares the outputs of a machine used by several threads at once with
+ * the sequential ones
+ */
+template <typename T>
+static void check_concurrent_forward(const T& machine, const int n_outputs) {
+  blitz::Array<double,2> data(n_samples, n_inputs);
+  init_array(data, 0.5);
+
+  // Single-threaded reference
+  blitz::Array<double,2> expected(n_samples, n_outputs);
+  blitz::Array<double,1> output(n_outputs);
+  blitz::Range a = blitz::Range::all();
+  for (int i=0; i<n_samples; ++i) {
+    blitz::Array<double,1> input = data(i,a);
+    forward(machine, input, output);
+    expected(i,a) = output;
+  }
+
+  // The same machine used by several threads at once
+  std::vector<int> n_errors(n_threads, -1);
+  boost::thread_group threads;
+  for (size_t k=0; k<n_threads; ++k)
+    threads.create_thread(boost::bind(&worker<T>, &machine, &data, &expected,
+      &n_errors[k]));
+  threads.join_all();
+
+  for (size_t k=0; k<n_threads; ++k)
+    BOOST_CHECK_EQUAL( n_errors[k], 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_linear )
+{
+  const int n_outputs = 7;
+  blitz::Array<double,2> weights(n_inputs, n_outputs);
+  init_array(weights, 1.);
+  bob::machine::LinearMachine machine(weights);
+  blitz::Array<double,1> biases(n_outputs);
+  init_array(biases, 2.);
+  machine.setBiases(biases);
+  blitz::Array<double,1> isub(n_inputs);
+  init_array(isub, 3.);
+  machine.setInputSubtraction(isub);
+  blitz::Array<double,1> idiv(n_inputs);
+  idiv = 2.;
+  machine.setInputDivision(idiv);
+  machine.setActivation(boost::make_shared<bob::machine::HyperbolicTangentActivation>());
+
+  check_concurrent_forward(machine, n_outputs);
+
+  // A caller-provided working array gives the same outputs
+  blitz::Array<double,1> input(n_inputs);
+  init_array(input, 4.);
+  blitz::Array<double,1> output(n_outputs);
+  blitz::Array<double,1> output_buffer(n_outputs);
+  blitz::Array<double,1> buffer;
+  machine.forward(input, output);
+  machine.forward(input, output_buffer, buffer);
+  BOOST_CHECK( blitz::all(output == output_buffer) );
+  BOOST_CHECK_EQUAL( buffer.extent(0), n_inputs );
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_mlp )
+{
+  const int n_outputs = 4;
+  std::vector<size_t> hidden;
+  hidden.push_back(15);
+  hidden.push_back(9);
+  bob::machine::MLP machine(n_inputs, hidden, n_outputs);
+  boost::mt19937 rng(0);
+  machine.randomize(rng, -0.5, 0.5);
+  blitz::Array<double,1> isub(n_inputs);
+  init_array(isub, 3.);
+  machine.setInputSubtraction(isub);
+
+  check_concurrent_forward(machine, n_outputs);
+
+  // A caller-provided working array gives the same outputs
+  blitz::Array<double,1> input(n_inputs);
+  init_array(input, 4.);
+  blitz::Array<double,1> output(n_outputs);
+  blitz::Array<double,1> output_buffer(n_outputs);
+  std::vector<blitz::Array<double,1> > buffer;
+  machine.forward(input, output);
+  machine.forward(input, output_buffer, buffer);
+  BOOST_CHECK( blitz::all(output == output_buffer) );
+  BOOST_CHECK_EQUAL( buffer.size(), hidden.size()+1 );
+
+  // The batch (one matrix product per layer) gives the outputs of the
+  // samples, up to round-off
+  blitz::Array<double,2> data(n_samples, n_inputs);
+  init_array(data, 0.5);
+  blitz::Array<double,2> batch_output(n_samples, n_outputs);
+  machine.forward(data, batch_output);
+  blitz::Range a = blitz::Range::all();
+  for (int i=0; i<n_samples; ++i) {
+    blitz::Array<double,1> sample = data(i,a);
+    machine.forward(sample, output);
+    for (int k=0; k<n_outputs; ++k)
+      BOOST_CHECK_SMALL( batch_output(i,k) - output(k), 1e-10 );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_concurrent_bic )
+{
+  const int n_kept = 6;
+  bob::machine::BICMachine machine(true);
+  for (int c=0; c<2; ++c) {
+    blitz::Array<double,1> mean(n_inputs);
+    init_array(mean, 5.+c);
+    blitz::Array<double,1> variances(n_kept);
+    init_array(variances, 7.+c);
+    variances = 1. + blitz::abs(variances);
+    blitz::Array<double,2> projection(n_inputs, n_kept);
+    init_array(projection, 9.+c);
+    machine.setBIC(c == 1, mean, variances, projection, 0.5+c, true);
+  }
+
+  check_concurrent_forward(machine, 1);
+}
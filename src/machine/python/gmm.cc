@@ -22,6 +22,7 @@
 #include <boost/concept_check.hpp>
 #include <bob/machine/GMMStats.h>
 #include <bob/machine/GMMMachine.h>
+#include <bob/machine/GMMSelector.h>
 #include <blitz/array.h>
 
 
@@ -181,16 +182,42 @@ static double py_gmmmachine_loglikelihoodA_(const bob::machine::GMMMachine& mach
   return machine.logLikelihood_(x.bz<double,1>(), ll_);
 }
 
-static double py_gmmmachine_loglikelihoodB(const bob::machine::GMMMachine& machine,
+static object py_gmmmachine_loglikelihoodB(const bob::machine::GMMMachine& machine,
   bob::python::const_ndarray x)
 {
-  return machine.logLikelihood(x.bz<double,1>());
+  const bob::core::array::typeinfo& info = x.type();
+  switch(info.nd) {
+    case 1:
+      return object(machine.logLikelihood(x.bz<double,1>()));
+    case 2:
+      {
+        bob::python::ndarray ll(bob::core::array::t_float64, info.shape[0]);
+        blitz::Array<double,1> ll_ = ll.bz<double,1>();
+        machine.logLikelihood(x.bz<double,2>(), ll_);
+        return ll.self();
+      }
+    default:
+      PYTHON_ERROR(TypeError, "cannot compute the log likelihood of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
+  }
 }
 
-static double py_gmmmachine_loglikelihoodB_(const bob::machine::GMMMachine& machine,
+static object py_gmmmachine_loglikelihoodB_(const bob::machine::GMMMachine& machine,
   bob::python::const_ndarray x)
 {
-  return machine.logLikelihood_(x.bz<double,1>());
+  const bob::core::array::typeinfo& info = x.type();
+  switch(info.nd) {
+    case 1:
+      return object(machine.logLikelihood_(x.bz<double,1>()));
+    case 2:
+      {
+        bob::python::ndarray ll(bob::core::array::t_float64, info.shape[0]);
+        blitz::Array<double,1> ll_ = ll.bz<double,1>();
+        machine.logLikelihood_(x.bz<double,2>(), ll_);
+        return ll.self();
+      }
+    default:
+      PYTHON_ERROR(TypeError, "cannot compute the log likelihood of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
+  }
 }
 
 static void py_gmmmachine_accStatistics(const bob::machine::GMMMachine& machine,
@@ -225,6 +252,42 @@ static void py_gmmmachine_accStatistics_(const bob::machine::GMMMachine& machine
   }
 }
 
+static void py_gmmmachine_accStatisticsSelector(const bob::machine::GMMMachine& machine,
+  bob::python::const_ndarray x, bob::machine::GMMStats& gs,
+  const bob::machine::GMMSelector& selector)
+{
+  bob::machine::GMMWorkspace workspace(machine.getNGaussians(), machine.getNInputs());
+  const bob::core::array::typeinfo& info = x.type();
+  switch(info.nd) {
+    case 1:
+      machine.accStatistics(x.bz<double,1>(), gs, selector, workspace);
+      break;
+    case 2:
+      machine.accStatistics(x.bz<double,2>(), gs, selector, workspace);
+      break;
+    default:
+      PYTHON_ERROR(TypeError, "cannot accStatistics of arrays with "  SIZE_T_FMT " dimensions (only with 1 or 2 dimensions).", info.nd);
+  }
+}
+
+static object py_gmmselector_select(const bob::machine::GMMSelector& selector,
+  const bob::machine::GMMMachine& machine, bob::python::const_ndarray x)
+{
+  const blitz::Array<double,1> x_ = x.bz<double,1>();
+  bob::core::array::assertSameDimensionLength(x_.extent(0), machine.getNInputs());
+  // same checks as bob::machine::GMMMachine::accStatistics()
+  if (selector.getNClusters() > 0) {
+    bob::core::array::assertSameDimensionLength(selector.getClusterIndices().extent(0), machine.getNGaussians());
+    bob::core::array::assertSameDimensionLength(selector.getClusterMachine().getNInputs(), machine.getNInputs());
+  }
+  bob::machine::GMMWorkspace workspace(machine.getNGaussians(), machine.getNInputs());
+  const size_t n = selector.select_(machine, x_, workspace);
+  bob::python::ndarray selection(bob::core::array::t_int32, n);
+  blitz::Array<int32_t,1> selection_ = selection.bz<int32_t,1>();
+  for (size_t k=0; k<n; ++k) selection_(k) = workspace.selection(k);
+  return selection.self();
+}
+
 void bind_machine_gmm()
 {
   class_<bob::machine::GMMStats, boost::shared_ptr<bob::machine::GMMStats> >("GMMStats",
@@ -292,16 +355,35 @@ void bind_machine_gmm()
     .def("log_likelihood_", &py_gmmmachine_loglikelihoodA_, args("self", "x", "log_weighted_gaussian_likelihoods"),
          "Output the log likelihood of the sample, x, i.e. log(p(x|bob::machine::GMMMachine)). Inputs are NOT checked.")
     .def("log_likelihood", &py_gmmmachine_loglikelihoodB, args("self", "x"),
-         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). Inputs are checked.")
+         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). If x is a 2D array, the log likelihood of each sample (row) is returned as a 1D array. Inputs are checked.")
     .def("log_likelihood_", &py_gmmmachine_loglikelihoodB_, args("self", "x"),
-         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). Inputs are checked.")
+         " Output the log likelihood of the sample, x, i.e. log(p(x|GMM)). If x is a 2D array, the log likelihood of each sample (row) is returned as a 1D array. Inputs are NOT checked.")
     .def("acc_statistics", &py_gmmmachine_accStatistics, args("self", "x", "stats"),
          "Accumulate the GMM statistics for this sample(s). Inputs are checked.")
     .def("acc_statistics_", &py_gmmmachine_accStatistics_, args("self", "x", "stats"),
          "Accumulate the GMM statistics for this sample(s). Inputs are NOT checked.")
+    .def("acc_statistics", &py_gmmmachine_accStatisticsSelector, args("self", "x", "stats", "selector"),
+         "Accumulate approximate GMM statistics for this sample(s), using only the Gaussian components chosen by the given GMMSelector for each sample. Inputs are checked.")
     .def("load", &bob::machine::GMMMachine::load, (arg("self"), arg("config")), "Load from a Configuration")
     .def("save", &bob::machine::GMMMachine::save, (arg("self"), arg("config")), "Save to a Configuration")
     .def(self_ns::str(self_ns::self))
   ;
 
+
+  class_<bob::machine::GMMSelector, boost::shared_ptr<bob::machine::GMMSelector> >("GMMSelector",
+      "This class selects, for a given sample, the n_top Gaussian components of a GMMMachine with the highest weighted likelihoods. "
+      "By default, all the components are evaluated. Alternatively, the components can be grouped into clusters (k-means over the means), "
+      "and only the members of the n_best_clusters most likely clusters are then evaluated.",
+      init<optional<const size_t> >((arg("self"), arg("n_top")=5), "Creates a GMMSelector which evaluates all the components."))
+    .def(init<const bob::machine::GMMMachine&, const size_t, const size_t, const size_t>((arg("self"), arg("machine"), arg("n_top"), arg("n_clusters"), arg("n_best_clusters")), "Creates a GMMSelector which groups the components of the machine into n_clusters clusters."))
+    .def(init<const bob::machine::GMMSelector&>((arg("self"), arg("other")), "Creates a GMMSelector from another one, using the copy constructor."))
+    .add_property("n_top", &bob::machine::GMMSelector::getNTop, &bob::machine::GMMSelector::setNTop, "The number of components to select")
+    .add_property("n_clusters", &bob::machine::GMMSelector::getNClusters, "The number of clusters (0 if all the components are evaluated)")
+    .add_property("n_best_clusters", &bob::machine::GMMSelector::getNBestClusters, "The number of clusters whose members are evaluated")
+    .add_property("cluster_indices", make_function(&bob::machine::GMMSelector::getClusterIndices, return_value_policy<copy_const_reference>()), "The cluster of each component")
+    .add_property("cluster_machine", make_function(&bob::machine::GMMSelector::getClusterMachine, return_value_policy<copy_const_reference>()), "The GMMMachine whose Gaussians represent the clusters")
+    .def("cluster", &bob::machine::GMMSelector::cluster, (arg("self"), arg("machine"), arg("n_clusters"), arg("n_best_clusters")), "Groups the components of the machine into n_clusters clusters.")
+    .def("unset_clusters", &bob::machine::GMMSelector::unsetClusters, (arg("self")), "Removes the clusters, all the components being evaluated.")
+    .def("select", &py_gmmselector_select, (arg("self"), arg("machine"), arg("x")), "Returns the indices of the components selected for the sample x, in decreasing order of likelihood.")
+  ;
 }
@@ -23,6 +23,7 @@
 #include <boost/shared_ptr.hpp>
 #include <bob/python/exception.h>
 #include <bob/machine/IVectorMachine.h>
+#include <boost/python/stl_iterator.hpp>
 
 using namespace boost::python;
 
@@ -93,6 +94,16 @@ static object py_iv_forward2(const bob::machine::IVectorMachine& machine,
   return ivector.self();
 }
 
+static object py_iv_forward3(const bob::machine::IVectorMachine& machine,
+  object gmmstats, const size_t n_threads)
+{
+  stl_input_iterator<bob::machine::GMMStats> dbegin(gmmstats), dend;
+  std::vector<bob::machine::GMMStats> gs(dbegin, dend);
+  bob::python::ndarray ivectors(bob::core::array::t_float64, gs.size(), machine.getDimRt());
+  blitz::Array<double,2> ivectors_ = ivectors.bz<double,2>();
+  machine.forward(gs, ivectors_, n_threads);
+  return ivectors.self();
+}
 
 void bind_machine_ivector()
 {
@@ -119,6 +130,7 @@ void bind_machine_ivector()
     .def("__compute_Id_TtSigmaInvT__", &py_computeIdTtSigmaInvT2, (arg("self"), arg("gmmstats")), "Computes (Id + sum_{c=1}^{C} N_{i,j,c} T^{T} Sigma_{c}^{-1} T)")
     .def("__compute_TtSigmaInvFnorm__", &py_computeTtSigmaInvFnorm1, (arg("self"), arg("gmmstats"), arg("output")), "Computes T^{T} Sigma^{-1} sum_{c=1}^{C} (F_c - N_c mean(c))")
     .def("__compute_TtSigmaInvFnorm__", &py_computeTtSigmaInvFnorm2, (arg("self"), arg("gmmstats")), "Computes T^{T} Sigma^{-1} sum_{c=1}^{C} (F_c - N_c mean(c))")
+    .def("forward", &py_iv_forward3, (arg("self"), arg("gmmstats"), arg("n_threads")=1), "Executes the machine on an iterable of GMMStats, solving the linear systems with the given number of threads (0 for the number of hardware threads). The ivectors are allocated and returned as the rows of a 2D array.")
     .def("__call__", &py_iv_forward1_, (arg("self"), arg("gmmstats"), arg("ivector")), "Executes the machine on the GMMStats, and updates the ivector array. NO CHECK is performed.")
     .def("__call__", &py_iv_forward2, (arg("self"), arg("gmmstats")), "Executes the machine on the GMMStats. The ivector is allocated an returned.")
     .def("forward", &py_iv_forward1, (arg("self"), arg("gmmstats"), arg("ivector")), "Executes the machine on the GMMStats, and updates the ivector array.")
@@ -28,6 +28,65 @@
 
 using namespace boost::python;
 
+static void convertGMMStatsList(object probes,
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> >& probes_c)
+{
+  stl_input_iterator<boost::shared_ptr<bob::machine::GMMStats> > dbegin(probes), dend;
+  probes_c.assign(dbegin, dend);
+}
+
+template <typename TBase>
+static object py_estimateUx(const TBase& machine, object probes,
+  const size_t n_threads)
+{
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> > probes_c;
+  convertGMMStatsList(probes, probes_c);
+  bob::python::ndarray ux(bob::core::array::t_float64, probes_c.size(),
+    machine.getDimCD());
+  blitz::Array<double,2> ux_ = ux.bz<double,2>();
+  machine.estimateUx(probes_c, ux_, n_threads);
+  return ux.self();
+}
+
+static object py_jfa_computeScores(const bob::machine::JFABase& machine,
+  bob::python::const_ndarray y, bob::python::const_ndarray z, object probes,
+  object ux, const size_t n_threads)
+{
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> > probes_c;
+  convertGMMStatsList(probes, probes_c);
+  const blitz::Array<double,2> y_ = y.bz<double,2>();
+  const blitz::Array<double,2> z_ = z.bz<double,2>();
+  bob::python::ndarray scores(bob::core::array::t_float64, z_.extent(0),
+    probes_c.size());
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  if (ux.ptr() == Py_None)
+    machine.computeScores(y_, z_, probes_c, scores_, n_threads);
+  else
+    machine.computeScores(y_, z_, probes_c,
+      extract<bob::python::const_ndarray>(ux)().bz<double,2>(), scores_,
+      n_threads);
+  return scores.self();
+}
+
+static object py_isv_computeScores(const bob::machine::ISVBase& machine,
+  bob::python::const_ndarray z, object probes, object ux,
+  const size_t n_threads)
+{
+  std::vector<boost::shared_ptr<const bob::machine::GMMStats> > probes_c;
+  convertGMMStatsList(probes, probes_c);
+  const blitz::Array<double,2> z_ = z.bz<double,2>();
+  bob::python::ndarray scores(bob::core::array::t_float64, z_.extent(0),
+    probes_c.size());
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  if (ux.ptr() == Py_None)
+    machine.computeScores(z_, probes_c, scores_, n_threads);
+  else
+    machine.computeScores(z_, probes_c,
+      extract<bob::python::const_ndarray>(ux)().bz<double,2>(), scores_,
+      n_threads);
+  return scores.self();
+}
+
 static void py_jfa_setU(bob::machine::JFABase& machine, 
   bob::python::const_ndarray U) 
 {
@@ -185,6 +244,8 @@ void bind_machine_jfa()
     .add_property("dim_cd", &bob::machine::JFABase::getDimCD, "The dimensionality of the supervector space")
     .add_property("dim_ru", &bob::machine::JFABase::getDimRu, "The dimensionality of the within-class variations subspace (rank of U)")
     .add_property("dim_rv", &bob::machine::JFABase::getDimRv, "The dimensionality of the between-class variations subspace (rank of V)")
+    .def("estimate_ux", &py_estimateUx<bob::machine::JFABase>, (arg("self"), arg("probes"), arg("n_threads")=1), "Estimates the session offsets Ux (LPT assumption) of a list of GMMStats at once, and returns them as the rows of a 2D array, which can be given to compute_scores(). The probes are split across n_threads threads (0 for the number of hardware threads).")
+    .def("compute_scores", &py_jfa_computeScores, (arg("self"), arg("y"), arg("z"), arg("probes"), arg("ux")=object(), arg("n_threads")=1), "Computes the scores of several JFAMachines, given by the rows of y and z, against a list of GMMStats, and returns them as a 2D array (number of models x number of probes). The session offset Ux of each probe is estimated once, unless the offsets given by estimate_ux() are provided, and the scores are computed by matrix products. The probes are split across n_threads threads (0 for the number of hardware threads).")
   ;
 
   class_<bob::machine::JFAMachine, boost::shared_ptr<bob::machine::JFAMachine>, bases<bob::machine::Machine<bob::machine::GMMStats, double> > >("JFAMachine", "A JFAMachine. An attached JFABase should be provided for Joint Factor Analysis. The JFAMachine carries information about the speaker factors y and z, whereas a JFABase carries information about the matrices U, V and D.\n\nReferences:\n[1] 'Explicit Modelling of Session Variability for Speaker Verification', R. Vogt, S. Sridharan, Computer Speech & Language, 2008, vol. 22, no. 1, pp. 17-38\n[2] 'Session Variability Modelling for Face Authentication', C. McCool, R. Wallace, M. McLaren, L. El Shafey, S. Marcel, IET Biometrics, 2013", init<const boost::shared_ptr<bob::machine::JFABase> >((arg("self"), arg("jfa_base")), "Builds a new JFAMachine."))
@@ -227,6 +288,8 @@ void bind_machine_jfa()
     .add_property("dim_d", &bob::machine::ISVBase::getDimD, "The dimensionality of the feature space")
     .add_property("dim_cd", &bob::machine::ISVBase::getDimCD, "The dimensionality of the supervector space")
     .add_property("dim_ru", &bob::machine::ISVBase::getDimRu, "The dimensionality of the within-class variations subspace (rank of U)")
+    .def("estimate_ux", &py_estimateUx<bob::machine::ISVBase>, (arg("self"), arg("probes"), arg("n_threads")=1), "Estimates the session offsets Ux (LPT assumption) of a list of GMMStats at once, and returns them as the rows of a 2D array, which can be given to compute_scores(). The probes are split across n_threads threads (0 for the number of hardware threads).")
+    .def("compute_scores", &py_isv_computeScores, (arg("self"), arg("z"), arg("probes"), arg("ux")=object(), arg("n_threads")=1), "Computes the scores of several ISVMachines, given by the rows of z, against a list of GMMStats, and returns them as a 2D array (number of models x number of probes). The session offset Ux of each probe is estimated once, unless the offsets given by estimate_ux() are provided, and the scores are computed by matrix products. The probes are split across n_threads threads (0 for the number of hardware threads).")
   ;
 
   class_<bob::machine::ISVMachine, boost::shared_ptr<bob::machine::ISVMachine>, bases<bob::machine::Machine<bob::machine::GMMStats, double> > >("ISVMachine", "An ISVMachine. An attached ISVBase should be provided for Inter-session Variability Modelling. The ISVMachine carries information about the speaker factors z, whereas a ISVBase carries information about the matrices U and D. \n\nReferences:\n[1] 'Explicit Modelling of Session Variability for Speaker Verification', R. Vogt, S. Sridharan, Computer Speech & Language, 2008, vol. 22, no. 1, pp. 17-38\n[2] 'Session Variability Modelling for Face Authentication', C. McCool, R. Wallace, M. McLaren, L. El Shafey, S. Marcel, IET Biometrics, 2013", init<const boost::shared_ptr<bob::machine::ISVBase> >((arg("self"), arg("isv_base")), "Builds a new ISVMachine."))
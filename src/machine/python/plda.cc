@@ -114,6 +114,20 @@ static double py_log_likelihood_point_estimate(bob::machine::PLDABase& plda,
 
 BOOST_PYTHON_FUNCTION_OVERLOADS(computeLogLikelihood_overloads, computeLogLikelihood, 2, 3)
 
+static object py_log_likelihood_ratios(const bob::machine::PLDABase& plda,
+  bob::python::const_ndarray weighted_sums, bob::python::const_ndarray n_samples,
+  bob::python::const_ndarray probes, const size_t n_threads)
+{
+  const blitz::Array<double,2> probes_ = probes.bz<double,2>();
+  const blitz::Array<double,2> weighted_sums_ = weighted_sums.bz<double,2>();
+  bob::python::ndarray scores(bob::core::array::t_float64,
+    weighted_sums_.extent(0), probes_.extent(0));
+  blitz::Array<double,2> scores_ = scores.bz<double,2>();
+  plda.computeLogLikelihoodRatios(weighted_sums_, n_samples.bz<uint64_t,1>(),
+    probes_, scores_, n_threads);
+  return scores.self();
+}
+
 void bind_machine_plda()
 {
   class_<bob::machine::PLDABase, boost::shared_ptr<bob::machine::PLDABase> >("PLDABase", "A PLDABase can be seen as a container for the subspaces F, G, the diagonal covariance matrix sigma (stored as a 1D array) and the mean vector mu when performing Probabilistic Linear Discriminant Analysis (PLDA). PLDA is a probabilistic model that incorporates components describing both between-class and within-class variations. A PLDABase can be shared between several PLDAMachine that contains class-specific information (information about the enrolment samples).\n\nReferences:\n1. 'A Scalable Formulation of Probabilistic Linear Discriminant Analysis: Applied to Face Recognition', Laurent El Shafey, Chris McCool, Roy Wallace, Sebastien Marcel, TPAMI'2013\n2. 'Probabilistic Linear Discriminant Analysis for Inference About Identity', Prince and Elder, ICCV'2007.\n3. 'Probabilistic Models for Inference about Identity', Li, Fu, Mohammed, Elder and Prince, TPAMI'2012.", init<const size_t, const size_t, const size_t, optional<const double> >((arg("self"), arg("dim_d"), arg("dim_f"), arg("dim_g"), arg("variance_flooring")=0.), "Builds a new PLDABase. dim_d is the dimensionality of the input features, dim_f is the dimensionality of the F subspace and dim_g the dimensionality of the G subspace. The variance flooring threshold is the minimum value that the variance sigma can reach, as this diagonal matrix is inverted."))
@@ -146,6 +160,7 @@ void bind_machine_plda()
     .def("get_log_like_const_term", &bob::machine::PLDABase::getLogLikeConstTerm, (arg("self"), arg("a")), "Returns the log likelihood constant term for the given number of samples if it has already been put in cache. Throws an exception otherwise.")
     .def("clear_maps", &bob::machine::PLDABase::clearMaps, (arg("self")), "Clear the maps containing the gamma's as well as the log likelihood constant term for few number of samples. These maps are used to make likelihood computations faster.")
     .def("compute_log_likelihood_point_estimate", &py_log_likelihood_point_estimate, (arg("self"), arg("xij"), arg("hi"), arg("wij")), "Computes the log-likelihood of a sample given the latent variables hi and wij (point estimate rather than Bayesian-like full integration).")
+    .def("compute_log_likelihood_ratios", &py_log_likelihood_ratios, (arg("self"), arg("weighted_sums"), arg("n_samples"), arg("probes"), arg("n_threads")=1), "Computes the log-likelihood ratio scores of the probes (one per row) against several models enrolled by the PLDATrainer, given by their weighted sums (one per row) and their numbers of enrolment samples (1D uint64 array). The scores are returned as a 2D array (models x probes), using the given number of threads (0 for the number of hardware threads). The maps of the machine are neither used nor updated.")
     .def(self_ns::str(self_ns::self))
     .add_property("__isigma__", make_function(&bob::machine::PLDABase::getISigma, return_value_policy<copy_const_reference>()), "sigma^{-1} matrix stored in cache")
     .add_property("__alpha__", make_function(&bob::machine::PLDABase::getAlpha, return_value_policy<copy_const_reference>()), "alpha matrix stored in cache")
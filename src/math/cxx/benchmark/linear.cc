@@ -0,0 +1,123 @@
+/**
+ * @file math/cxx/benchmark/linear.cc
+ * @date Sat Oct 17 21:05:12 2026 +0200
+ *
+ * @brief Benchmark of the matrix products, for the shapes used by the
+ * trainers and the scoring functions
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/core/array_random.h>
+#include <bob/math/linear.h>
+
+#include <boost/random.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <iostream>
+
+void benchmark_prod(const char* name, const int M, const int K, const int N,
+  boost::mt19937& rng)
+{
+  blitz::Array<double,2> A(M, K);
+  blitz::Array<double,2> B(K, N);
+  blitz::Array<double,2> C(M, N);
+  bob::core::array::randn(rng, A);
+  bob::core::array::randn(rng, B);
+  // Strided views of the same shapes
+  blitz::Array<double,2> A2(M, 2*K);
+  blitz::Array<double,2> B2(K, 2*N);
+  blitz::Array<double,2> A_s = A2(blitz::Range::all(), blitz::Range(0,2*K-1,2));
+  blitz::Array<double,2> B_s = B2(blitz::Range::all(), blitz::Range(0,2*N-1,2));
+  A_s = A;
+  B_s = B;
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << name << ": product of matrices of dimensions " << M << "x" << K
+    << " and " << K << "x" << N << "..." << std::endl;
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  bob::math::prod_<double,double,double>(A, B, C);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  blitz duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  bob::math::prod_(A, B, C);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  BLAS duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  bob::math::prod_(A_s, B_s, C);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  blocked (strided views) duration in (microseconds) " << diff.total_microseconds() << std::endl;
+}
+
+void benchmark_prod_vector(const char* name, const int M, const int N,
+  boost::mt19937& rng)
+{
+  blitz::Array<double,2> A(M, N);
+  blitz::Array<double,1> b(N);
+  blitz::Array<double,1> c(M);
+  bob::core::array::randn(rng, A);
+  bob::core::array::randn(rng, b);
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << name << ": product of a matrix of dimension " << M << "x" << N
+    << " with a vector..." << std::endl;
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  bob::math::prod_<double,double,double>(A, b, c);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  blitz duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  t1 = boost::posix_time::microsec_clock::local_time();
+  bob::math::prod_(A, b, c);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  BLAS duration in (microseconds) " << diff.total_microseconds() << std::endl;
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char** argv)
+{
+  boost::mt19937 rng(0);
+
+  // Linear scoring of 200 models against 200 probes, with a UBM of 512
+  // Gaussians of dimension 40
+  benchmark_prod("linearScoring", 200, 512*40, 200, rng);
+  // I-Vector/JFA: T'*Sigma^-1*T-like products, with a rank of 100
+  benchmark_prod("IVector/JFA", 100, 256*40, 100, rng);
+  // MLP: mini-batch of 256 samples through a 400x100 layer
+  benchmark_prod("MLP", 256, 400, 100, rng);
+  // k-means: distances of 10000 samples of dimension 40 to 512 means
+  benchmark_prod("KMeans", 10000, 40, 512, rng);
+  // PLDA: products of square matrices
+  benchmark_prod("PLDA", 300, 300, 300, rng);
+
+  // Projections of a supervector (I-Vector extraction, JFA/ISV)
+  benchmark_prod_vector("IVector", 100, 256*40, rng);
+  benchmark_prod_vector("LinearMachine", 500, 500, rng);
+
+  return 0;
+}
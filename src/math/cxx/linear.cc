@@ -0,0 +1,314 @@
+/**
+ * @file math/cxx/linear.cc
+ * @date Sat Oct 17 21:05:12 2026 +0200
+ *
+ * @brief Matrix and vector products of double arrays, computed by the BLAS
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/math/linear.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+// Declaration of the external BLAS functions
+// Matrix-matrix product (dgemm)
+extern "C" void dgemm_( const char *transa, const char *transb, const int *M,
+  const int *N, const int *K, const double *alpha, const double *A,
+  const int *lda, const double *B, const int *ldb, const double *beta,
+  double *C, const int *ldc);
+// Matrix-vector product (dgemv)
+extern "C" void dgemv_( const char *trans, const int *M, const int *N,
+  const double *alpha, const double *A, const int *lda, const double *x,
+  const int *incx, const double *beta, double *y, const int *incy);
+// Rank-1 update of a matrix (dger)
+extern "C" void dger_( const int *M, const int *N, const double *alpha,
+  const double *x, const int *incx, const double *y, const int *incy,
+  double *A, const int *lda);
+
+/**
+ * Sizes of the blocks of the cache-blocked matrix product: a block of
+ * s_block_k x s_block_n elements of B (128KB) stays in the L2 cache while
+ * it is multiplied by all the rows of A.
+ */
+static const int s_block_k = 64;
+static const int s_block_n = 256;
+
+/**
+ * Storage of a matrix, as seen by the BLAS: the matrix is X (if trans is
+ * false) or X' (if trans is true, i.e. if the matrix is stored in C order),
+ * X being the column-major matrix of leading dimension ld at data().
+ */
+struct BlasMatrix {
+  bool valid;
+  bool trans;
+  int ld;
+};
+
+/**
+ * Returns the storage of a matrix, which is valid if the matrix is
+ * contiguous along one of its dimensions (the other stride being large
+ * enough for the rows or columns not to overlap)
+ */
+static BlasMatrix blasMatrix(const blitz::Array<double,2>& A)
+{
+  const int M = A.extent(0);
+  const int N = A.extent(1);
+  const int s0 = A.stride(0);
+  const int s1 = A.stride(1);
+  BlasMatrix m;
+  m.valid = true;
+  m.trans = false;
+  m.ld = 1;
+  if ((M <= 1 || s0 == 1) && (N <= 1 || s1 >= std::max(1,M))) {
+    // Fortran order
+    m.ld = (N <= 1 ? std::max(1,M) : s1);
+  }
+  else if ((N <= 1 || s1 == 1) && (M <= 1 || s0 >= std::max(1,N))) {
+    // C order
+    m.trans = true;
+    m.ld = (M <= 1 ? std::max(1,N) : s0);
+  }
+  else
+    m.valid = false;
+  return m;
+}
+
+/**
+ * Returns the BLAS increment of a vector, which is valid if positive
+ */
+static int blasIncrement(const blitz::Array<double,1>& a)
+{
+  return (a.extent(0) <= 1 ? 1 : a.stride(0));
+}
+
+/**
+ * Cache-blocked product C=A*B of strided matrices: each block of B is
+ * packed into a contiguous buffer, and the rows of C are accumulated in a
+ * contiguous buffer, such that the inner loop is a unit-stride multiply-add
+ * which the compiler vectorizes.
+ */
+static void gemmBlocked(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C)
+{
+  const int M = A.extent(0);
+  const int K = A.extent(1);
+  const int N = B.extent(1);
+  const double* a = A.data();
+  const double* b = B.data();
+  double* c = C.data();
+  const int as0 = A.stride(0), as1 = A.stride(1);
+  const int bs0 = B.stride(0), bs1 = B.stride(1);
+  const int cs0 = C.stride(0), cs1 = C.stride(1);
+
+  std::vector<double> b_pack(s_block_k * s_block_n);
+  std::vector<double> c_row(s_block_n);
+  for (int j0=0; j0<N; j0+=s_block_n)
+  {
+    const int nj = std::min(s_block_n, N-j0);
+    for (int k0=0; k0<K; k0+=s_block_k)
+    {
+      const int nk = std::min(s_block_k, K-k0);
+      for (int k=0; k<nk; ++k)
+      {
+        const double* b_k = b + (k0+k)*bs0 + j0*bs1;
+        double* p = &b_pack[k*nj];
+        for (int j=0; j<nj; ++j) p[j] = b_k[j*bs1];
+      }
+
+      for (int i=0; i<M; ++i)
+      {
+        double* c_i = c + i*cs0 + j0*cs1;
+        double* r = &c_row[0];
+        if (k0 == 0) std::fill(r, r+nj, 0.);
+        else for (int j=0; j<nj; ++j) r[j] = c_i[j*cs1];
+        const double* a_i = a + i*as0 + k0*as1;
+        for (int k=0; k<nk; ++k)
+        {
+          const double a_ik = a_i[k*as1];
+          const double* p = &b_pack[k*nj];
+          for (int j=0; j<nj; ++j) r[j] += a_ik * p[j];
+        }
+        for (int j=0; j<nj; ++j) c_i[j*cs1] = r[j];
+      }
+    }
+  }
+}
+
+/**
+ * Product y=X*x of strided arrays, where X(i,j) is X[i*s_row+j*s_col]
+ */
+static void gemvLoop(const int M, const int N, const double* X,
+  const int s_row, const int s_col, const double* x, const int incx,
+  double* y, const int incy)
+{
+  if (std::abs(s_col) <= std::abs(s_row))
+  {
+    // Dot products along the rows of X
+    for (int i=0; i<M; ++i)
+    {
+      const double* X_i = X + i*s_row;
+      double sum = 0.;
+      for (int j=0; j<N; ++j) sum += X_i[j*s_col] * x[j*incx];
+      y[i*incy] = sum;
+    }
+  }
+  else
+  {
+    // Multiply-adds of the columns of X
+    for (int i=0; i<M; ++i) y[i*incy] = 0.;
+    for (int j=0; j<N; ++j)
+    {
+      const double* X_j = X + j*s_col;
+      const double x_j = x[j*incx];
+      for (int i=0; i<M; ++i) y[i*incy] += X_j[i*s_row] * x_j;
+    }
+  }
+}
+
+void bob::math::prod_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C)
+{
+  const int M = A.extent(0);
+  const int K = A.extent(1);
+  const int N = B.extent(1);
+  if (M == 0 || N == 0) return;
+  if (K == 0) {
+    C = 0.;
+    return;
+  }
+
+  const BlasMatrix a = blasMatrix(A);
+  const BlasMatrix b = blasMatrix(B);
+  const BlasMatrix c = blasMatrix(C);
+  if (!a.valid || !b.valid || !c.valid) {
+    gemmBlocked(A, B, C);
+    return;
+  }
+
+  const double one = 1.;
+  const double zero = 0.;
+  if (!c.trans) {
+    const char ta = (a.trans ? 'T' : 'N');
+    const char tb = (b.trans ? 'T' : 'N');
+    dgemm_( &ta, &tb, &M, &N, &K, &one, A.data(), &a.ld, B.data(), &b.ld,
+      &zero, C.data(), &c.ld);
+  }
+  else {
+    // C is stored in C order: C'=B'*A' is computed instead
+    const char ta = (a.trans ? 'N' : 'T');
+    const char tb = (b.trans ? 'N' : 'T');
+    dgemm_( &tb, &ta, &N, &M, &K, &one, B.data(), &b.ld, A.data(), &a.ld,
+      &zero, C.data(), &c.ld);
+  }
+}
+
+void bob::math::prod_(const blitz::Array<double,2>& A,
+  const blitz::Array<double,1>& b, blitz::Array<double,1>& c)
+{
+  const int M = A.extent(0);
+  const int N = A.extent(1);
+  if (M == 0) return;
+  if (N == 0) {
+    c = 0.;
+    return;
+  }
+
+  const BlasMatrix a = blasMatrix(A);
+  const int incb = blasIncrement(b);
+  const int incc = blasIncrement(c);
+  if (!a.valid || incb <= 0 || incc <= 0) {
+    gemvLoop(M, N, A.data(), A.stride(0), A.stride(1), b.data(), b.stride(0),
+      c.data(), c.stride(0));
+    return;
+  }
+
+  const double one = 1.;
+  const double zero = 0.;
+  if (!a.trans) {
+    const char t = 'N';
+    dgemv_( &t, &M, &N, &one, A.data(), &a.ld, b.data(), &incb, &zero,
+      c.data(), &incc);
+  }
+  else {
+    const char t = 'T';
+    dgemv_( &t, &N, &M, &one, A.data(), &a.ld, b.data(), &incb, &zero,
+      c.data(), &incc);
+  }
+}
+
+void bob::math::prod_(const blitz::Array<double,1>& a,
+  const blitz::Array<double,2>& B, blitz::Array<double,1>& c)
+{
+  const int M = B.extent(0);
+  const int N = B.extent(1);
+  if (N == 0) return;
+  if (M == 0) {
+    c = 0.;
+    return;
+  }
+
+  const BlasMatrix b = blasMatrix(B);
+  const int inca = blasIncrement(a);
+  const int incc = blasIncrement(c);
+  if (!b.valid || inca <= 0 || incc <= 0) {
+    gemvLoop(N, M, B.data(), B.stride(1), B.stride(0), a.data(), a.stride(0),
+      c.data(), c.stride(0));
+    return;
+  }
+
+  // c=B'*a
+  const double one = 1.;
+  const double zero = 0.;
+  if (!b.trans) {
+    const char t = 'T';
+    dgemv_( &t, &M, &N, &one, B.data(), &b.ld, a.data(), &inca, &zero,
+      c.data(), &incc);
+  }
+  else {
+    const char t = 'N';
+    dgemv_( &t, &N, &M, &one, B.data(), &b.ld, a.data(), &inca, &zero,
+      c.data(), &incc);
+  }
+}
+
+void bob::math::prod_(const blitz::Array<double,1>& a,
+  const blitz::Array<double,1>& b, blitz::Array<double,2>& C)
+{
+  const int M = a.extent(0);
+  const int N = b.extent(0);
+  if (M == 0 || N == 0) return;
+
+  const BlasMatrix c = blasMatrix(C);
+  const int inca = blasIncrement(a);
+  const int incb = blasIncrement(b);
+  if (!c.valid || inca <= 0 || incb <= 0) {
+    const double* a_ = a.data();
+    const double* b_ = b.data();
+    double* C_ = C.data();
+    for (int i=0; i<M; ++i)
+      for (int j=0; j<N; ++j)
+        C_[i*C.stride(0) + j*C.stride(1)] = a_[i*a.stride(0)] * b_[j*b.stride(0)];
+    return;
+  }
+
+  C = 0.;
+  const double one = 1.;
+  if (!c.trans)
+    dger_( &M, &N, &one, a.data(), &inca, b.data(), &incb, C.data(), &c.ld);
+  else
+    dger_( &N, &M, &one, b.data(), &incb, a.data(), &inca, C.data(), &c.ld);
+}
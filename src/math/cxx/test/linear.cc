@@ -25,6 +25,7 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include <bob/math/linear.h>
+#include <vector>
 
 
 struct T {
@@ -189,4 +190,104 @@ BOOST_AUTO_TEST_CASE( test_diag_bis )
   checkBlitzClose(dsol_diag_44, sol4, eps);
 }
 
+/**
+ * Returns views of the given matrix with different storage orders: the
+ * matrix itself (C order), in Fortran order, and a strided view
+ */
+static std::vector<blitz::Array<double,2> > storages(const blitz::Array<double,2>& A)
+{
+  std::vector<blitz::Array<double,2> > res;
+  res.push_back(A);
+  blitz::Array<double,2> F(A.extent(1), A.extent(0));
+  F = A.transpose(1,0);
+  res.push_back(F.transpose(1,0));
+  blitz::Array<double,2> S(2*A.extent(0), 3*A.extent(1));
+  S = 0.;
+  blitz::Array<double,2> V = S(blitz::Range(0,2*A.extent(0)-1,2),
+    blitz::Range(0,3*A.extent(1)-1,3));
+  V = A;
+  res.push_back(V);
+  return res;
+}
+
+static blitz::Array<double,2> testMatrix(const int M, const int N)
+{
+  blitz::Array<double,2> A(M, N);
+  for (int i=0; i<M; ++i)
+    for (int j=0; j<N; ++j)
+      A(i,j) = sin(0.1*i + 0.37*j);
+  return A;
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_matrix_prod_storage )
+{
+  const int M = 37, K = 300, N = 270;
+  blitz::Array<double,2> A = testMatrix(M, K);
+  blitz::Array<double,2> B = testMatrix(K, N);
+  blitz::Array<double,2> ref(M, N);
+  bob::math::prod_<double,double,double>(A, B, ref);
+
+  std::vector<blitz::Array<double,2> > As = storages(A);
+  std::vector<blitz::Array<double,2> > Bs = storages(B);
+  for (size_t a=0; a<As.size(); ++a)
+    for (size_t b=0; b<Bs.size(); ++b)
+    {
+      std::vector<blitz::Array<double,2> > Cs = storages(testMatrix(M, N));
+      for (size_t c=0; c<Cs.size(); ++c)
+      {
+        bob::math::prod(As[a], Bs[b], Cs[c]);
+        checkBlitzClose(ref, Cs[c], 1e-10);
+      }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( test_matrix_vector_prod_storage )
+{
+  const int M = 37, N = 300;
+  blitz::Array<double,2> A = testMatrix(M, N);
+  blitz::Array<double,2> X = testMatrix(2, 2*N);
+  blitz::Array<double,1> x = X(0, blitz::Range(0,N-1));
+  blitz::Array<double,1> x_s = X(1, blitz::Range(0,2*N-1,2));
+  x_s = x;
+  blitz::Array<double,2> Y = testMatrix(2, 2*M);
+  blitz::Array<double,1> y = Y(0, blitz::Range(0,M-1));
+  blitz::Array<double,1> y_s = Y(1, blitz::Range(0,2*M-1,2));
+  y_s = y;
+
+  blitz::Array<double,1> ref_Ax(M), ref_yA(N);
+  bob::math::prod_<double,double,double>(A, x, ref_Ax);
+  bob::math::prod_<double,double,double>(y, A, ref_yA);
+
+  std::vector<blitz::Array<double,2> > As = storages(A);
+  for (size_t a=0; a<As.size(); ++a)
+  {
+    blitz::Array<double,1> Ax(M), yA(N);
+    bob::math::prod(As[a], x, Ax);
+    checkBlitzClose(ref_Ax, Ax, 1e-10);
+    bob::math::prod(As[a], x_s, Ax);
+    checkBlitzClose(ref_Ax, Ax, 1e-10);
+    bob::math::prod(y, As[a], yA);
+    checkBlitzClose(ref_yA, yA, 1e-10);
+    bob::math::prod(y_s, As[a], yA);
+    checkBlitzClose(ref_yA, yA, 1e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_vector_vector_prod_storage )
+{
+  blitz::Array<double,2> X = testMatrix(2, 70);
+  blitz::Array<double,1> a = X(0, blitz::Range(0,36));
+  blitz::Array<double,1> b = X(1, blitz::Range(0,69,3));
+  blitz::Array<double,2> ref(a.extent(0), b.extent(0));
+  bob::math::prod_<double,double,double>(a, b, ref);
+
+  std::vector<blitz::Array<double,2> > Cs = storages(ref);
+  for (size_t c=0; c<Cs.size(); ++c)
+  {
+    Cs[c] = 0.;
+    bob::math::prod(a, b, Cs[c]);
+    checkBlitzClose(ref, Cs[c], 1e-12);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
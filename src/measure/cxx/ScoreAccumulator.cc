@@ -0,0 +1,837 @@
+/**
+ * @file measure/cxx/ScoreAccumulator.cc
+ * @date Mon Oct 19 10:12:44 2026 +0200
+ *
+ * @brief Implements the accumulators of scores
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <boost/format.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/filesystem.hpp>
+#include <bob/measure/ScoreAccumulator.h>
+#include <bob/measure/error.h>
+#include <bob/core/logging.h>
+
+/**
+ * Number of scores read at once from each run
+ */
+static const size_t s_read_block = 1 << 14;
+
+/**
+ * Number of scores of the arrays saved into HDF5 files
+ */
+static const size_t s_save_block = 1 << 16;
+
+/**
+ * Largest number of runs of negative (or positive) scores, hence of files
+ * read at once by a sweep
+ */
+static const size_t s_max_runs = 64;
+
+bob::measure::ScoreAccumulator::ScoreAccumulator():
+  m_n_negatives(0),
+  m_n_positives(0),
+  m_min(std::numeric_limits<double>::max()),
+  m_max(-std::numeric_limits<double>::max())
+{
+}
+
+void bob::measure::ScoreAccumulator::count(
+    const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives) {
+  m_n_negatives += negatives.extent(0);
+  m_n_positives += positives.extent(0);
+  if (negatives.extent(0)) {
+    m_min = std::min(m_min, (double)blitz::min(negatives));
+    m_max = std::max(m_max, (double)blitz::max(negatives));
+  }
+  if (positives.extent(0)) {
+    m_min = std::min(m_min, (double)blitz::min(positives));
+    m_max = std::max(m_max, (double)blitz::max(positives));
+  }
+}
+
+void bob::measure::ScoreAccumulator::count(
+    const bob::measure::ScoreAccumulator& other) {
+  m_n_negatives += other.m_n_negatives;
+  m_n_positives += other.m_n_positives;
+  m_min = std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+}
+
+/**
+ * Counts the false accepts and false rejects at a threshold
+ */
+struct FarFrrCounter: public bob::measure::ScoreVisitor {
+  double threshold;
+  size_t false_accepts;
+  size_t false_rejects;
+
+  FarFrrCounter(double threshold_):
+    threshold(threshold_), false_accepts(0), false_rejects(0) {}
+
+  virtual void operator()(double score, double, size_t negatives,
+      size_t positives) {
+    if (score >= threshold) false_accepts += negatives;
+    else false_rejects += positives;
+  }
+};
+
+std::pair<double, double> bob::measure::ScoreAccumulator::farfrr(
+    double threshold) const {
+  FarFrrCounter counter(threshold);
+  sweep(counter);
+  const double total_negatives = std::max(m_n_negatives, (size_t)1);
+  const double total_positives = std::max(m_n_positives, (size_t)1);
+  return std::make_pair(counter.false_accepts / total_negatives,
+      counter.false_rejects / total_positives);
+}
+
+/**
+ * Keeps the thresholds of the minimum of a predicate of the FA and FR
+ * ratios, as bob::measure::sortedExactMinimizingThreshold()
+ */
+template <typename T> struct MinimizingVisitor: public bob::measure::ScoreVisitor {
+  T& predicate;
+  size_t n_neg;
+  size_t n_pos;
+  double total_negatives;
+  double total_positives;
+  size_t i_neg;
+  size_t i_pos;
+  double min_value;
+  std::vector<double> accumulator;
+
+  MinimizingVisitor(T& predicate_, size_t n_neg_, size_t n_pos_, double min):
+    predicate(predicate_), n_neg(n_neg_), n_pos(n_pos_),
+    total_negatives(std::max(n_neg_, (size_t)1)),
+    total_positives(std::max(n_pos_, (size_t)1)),
+    i_neg(0), i_pos(0)
+  {
+    //below the smallest score, all the scores are accepted
+    min_value = predicate(n_neg / total_negatives, 0.0);
+    accumulator.push_back(min);
+  }
+
+  virtual void operator()(double, double threshold, size_t negatives,
+      size_t positives) {
+    i_neg += negatives;
+    i_pos += positives;
+    double current_cost = predicate((n_neg - i_neg) / total_negatives,
+        i_pos / total_positives);
+    if (current_cost < min_value) {
+      min_value = current_cost;
+      accumulator.clear();
+      accumulator.push_back(threshold);
+    }
+    else if (std::abs(current_cost - min_value) < 1e-16) {
+      accumulator.push_back(threshold);
+    }
+  }
+};
+
+template <typename T> static double sweepMinimizingThreshold(
+    const bob::measure::ScoreAccumulator& accumulator, T& predicate) {
+  if (accumulator.getNNegatives() + accumulator.getNPositives() == 0)
+    return 0.;
+  MinimizingVisitor<T> visitor(predicate, accumulator.getNNegatives(),
+      accumulator.getNPositives(), accumulator.getMin());
+  accumulator.sweep(visitor);
+  return visitor.accumulator[visitor.accumulator.size()/2];
+}
+
+/**
+ * |FAR - FRR|
+ */
+struct AbsoluteDifference {
+  double operator()(double far, double frr) const {
+    return std::abs(far - frr);
+  }
+};
+
+/**
+ * [cost * FAR] + [(1-cost) * FRR], with the cost clipped to [0, 1]
+ */
+struct WeightedErrorRate {
+  double cost;
+
+  WeightedErrorRate(double cost_):
+    cost(std::min(std::max(cost_, 0.), 1.)) {}
+
+  double operator()(double far, double frr) const {
+    return (cost*far) + ((1.0-cost)*frr);
+  }
+};
+
+double bob::measure::ScoreAccumulator::eerThreshold() const {
+  AbsoluteDifference predicate;
+  return sweepMinimizingThreshold(*this, predicate);
+}
+
+double bob::measure::ScoreAccumulator::minWeightedErrorRateThreshold(
+    double cost) const {
+  WeightedErrorRate predicate(cost);
+  return sweepMinimizingThreshold(*this, predicate);
+}
+
+/**
+ * Counts the negative and positive scores which are smaller than each of
+ * the increasing thresholds min + i*step
+ */
+struct RocCounter: public bob::measure::ScoreVisitor {
+  double min;
+  double step;
+  size_t points;
+  size_t index;
+  size_t negatives_below;
+  size_t positives_below;
+  std::vector<size_t> neg_below;
+  std::vector<size_t> pos_below;
+
+  RocCounter(double min_, double step_, size_t points_):
+    min(min_), step(step_), points(points_), index(0),
+    negatives_below(0), positives_below(0),
+    neg_below(points_), pos_below(points_) {}
+
+  virtual void operator()(double score, double, size_t negatives,
+      size_t positives) {
+    while (index < points && min + (int)index*step <= score) {
+      neg_below[index] = negatives_below;
+      pos_below[index] = positives_below;
+      ++index;
+    }
+    negatives_below += negatives;
+    positives_below += positives;
+  }
+
+  void finish() {
+    for (; index < points; ++index) {
+      neg_below[index] = negatives_below;
+      pos_below[index] = positives_below;
+    }
+  }
+};
+
+blitz::Array<double,2> bob::measure::ScoreAccumulator::roc(
+    size_t points) const {
+  double step = (m_max-m_min)/((double)points-1.0);
+  RocCounter counter(m_min, step, points);
+  sweep(counter);
+  counter.finish();
+  const double total_negatives = std::max(m_n_negatives, (size_t)1);
+  const double total_positives = std::max(m_n_positives, (size_t)1);
+  blitz::Array<double,2> retval(2, points);
+  for (int i=0; i<(int)points; ++i) {
+    //note: inversion to preserve X x Y ordering (FRR x FAR)
+    retval(0,i) = counter.pos_below[i] / total_positives;
+    retval(1,i) = (m_n_negatives - counter.neg_below[i]) / total_negatives;
+  }
+  return retval;
+}
+
+blitz::Array<double,2> bob::measure::ScoreAccumulator::det(
+    size_t points) const {
+  blitz::Array<double,2> retval = roc(points);
+  for (int i=0; i<retval.extent(0); ++i)
+    for (int j=0; j<retval.extent(1); ++j)
+      retval(i,j) = bob::measure::ppndf(retval(i,j));
+  return retval;
+}
+
+/**
+ * Counts the positive scores which are not larger than the negative score
+ * of each of the given ranks (sorted increasingly, and starting at 1)
+ */
+struct RankCounter: public bob::measure::ScoreVisitor {
+  const std::vector<std::pair<size_t, size_t> >& ranks;
+  size_t index;
+  size_t negatives_below;
+  size_t positives_below;
+  std::vector<size_t> pos_counts;
+
+  RankCounter(const std::vector<std::pair<size_t, size_t> >& ranks_,
+      size_t points):
+    ranks(ranks_), index(0), negatives_below(0), positives_below(0),
+    pos_counts(points) {}
+
+  virtual void operator()(double, double, size_t negatives,
+      size_t positives) {
+    negatives_below += negatives;
+    positives_below += positives;
+    while (index < ranks.size() && ranks[index].first <= negatives_below) {
+      pos_counts[ranks[index].second] = positives_below;
+      ++index;
+    }
+  }
+};
+
+blitz::Array<double,2> bob::measure::ScoreAccumulator::roc_for_far(
+    const blitz::Array<double,1>& far_list) const {
+  const int n_points = far_list.extent(0);
+  const double n_neg = m_n_negatives;
+  const double total_positives = std::max(m_n_positives, (size_t)1);
+
+  //the rank of the negative at which the ratio of the negatives first
+  //exceeds the CRR (Correct Rejection Rate; = 1 - FAR) of each point
+  std::vector<std::pair<size_t, size_t> > ranks;
+  std::vector<bool> reached(n_points, false);
+  for (int i=0; i<n_points; ++i) {
+    const double crr = 1. - far_list(i);
+    size_t rank = (size_t)std::max(std::floor(crr * n_neg), 1.);
+    rank = std::min(rank, m_n_negatives + 1);
+    while (rank > 1 && (rank-1) / n_neg > crr) --rank;
+    while (rank <= m_n_negatives && !(rank / n_neg > crr)) ++rank;
+    if (rank <= m_n_negatives) {
+      ranks.push_back(std::make_pair(rank, (size_t)i));
+      reached[i] = true;
+    }
+  }
+  std::sort(ranks.begin(), ranks.end());
+
+  RankCounter counter(ranks, n_points);
+  sweep(counter);
+
+  blitz::Array<double,2> retval(2, n_points);
+  for (int i=0; i<n_points; ++i) {
+    retval(0,i) = far_list(i);
+    //the CAR (i.e., 1.-FRR) for the current FAR, zero if the CRR is never
+    //exceeded
+    retval(1,i) = reached[i] ?
+      1. - counter.pos_counts[i] / total_positives : 0.;
+  }
+  return retval;
+}
+
+/**
+ * Reads a sorted run of scores from a file by blocks, or from memory
+ */
+class RunReader {
+
+  public:
+
+    RunReader(const std::string& path, size_t size):
+      m_path(path),
+      m_file(new std::ifstream(path.c_str(), std::ios::binary)),
+      m_buffer(std::min(size, s_read_block)),
+      m_data(0), m_index(0), m_end(0), m_remaining(size)
+    {
+      if (!*m_file) {
+        boost::format m("cannot open the run of scores '%s'");
+        m % m_path;
+        throw std::runtime_error(m.str());
+      }
+      fill();
+    }
+
+    RunReader(const std::vector<double>& data):
+      m_data(data.size() ? &data[0] : 0),
+      m_index(0), m_end(data.size()), m_remaining(0) {}
+
+    bool done() const { return m_index == m_end; }
+
+    double value() const { return m_data[m_index]; }
+
+    void next() { if (++m_index == m_end && m_remaining) fill(); }
+
+  private:
+
+    void fill() {
+      const size_t n = std::min(m_remaining, m_buffer.size());
+      m_file->read(reinterpret_cast<char*>(&m_buffer[0]), n*sizeof(double));
+      if (!*m_file) {
+        boost::format m("cannot read the run of scores '%s'");
+        m % m_path;
+        throw std::runtime_error(m.str());
+      }
+      m_data = &m_buffer[0];
+      m_index = 0;
+      m_end = n;
+      m_remaining -= n;
+    }
+
+    std::string m_path;
+    boost::shared_ptr<std::ifstream> m_file;
+    std::vector<double> m_buffer;
+    const double* m_data;
+    size_t m_index;
+    size_t m_end;
+    size_t m_remaining;
+
+};
+
+/**
+ * Orders the readers such that the smallest score is at the top of the heap
+ */
+struct GreaterValue {
+  bool operator()(const RunReader* a, const RunReader* b) const {
+    return a->value() > b->value();
+  }
+};
+
+/**
+ * Merges sorted runs of scores on the fly
+ */
+class MergedStream {
+
+  public:
+
+    MergedStream(const std::vector<bob::measure::ExactScoreAccumulator::Run>& runs,
+        const std::vector<double>& sorted) {
+      for (size_t i=0; i<runs.size(); ++i)
+        m_readers.push_back(boost::shared_ptr<RunReader>(
+              new RunReader(runs[i].path, runs[i].size)));
+      m_readers.push_back(boost::shared_ptr<RunReader>(new RunReader(sorted)));
+      for (size_t i=0; i<m_readers.size(); ++i)
+        if (!m_readers[i]->done()) m_heap.push_back(m_readers[i].get());
+      std::make_heap(m_heap.begin(), m_heap.end(), GreaterValue());
+    }
+
+    bool done() const { return m_heap.empty(); }
+
+    double value() const { return m_heap.front()->value(); }
+
+    void next() {
+      std::pop_heap(m_heap.begin(), m_heap.end(), GreaterValue());
+      RunReader* reader = m_heap.back();
+      reader->next();
+      if (reader->done()) m_heap.pop_back();
+      else std::push_heap(m_heap.begin(), m_heap.end(), GreaterValue());
+    }
+
+    /**
+     * Skips the scores equal to the given one, and returns their number
+     */
+    size_t skip(double score) {
+      size_t n = 0;
+      for (; !done() && value() == score; ++n) next();
+      return n;
+    }
+
+  private:
+
+    std::vector<boost::shared_ptr<RunReader> > m_readers;
+    std::vector<RunReader*> m_heap;
+
+};
+
+/**
+ * Returns the smallest of the next scores of two streams, which are not both
+ * done
+ */
+static double smallest(const MergedStream& a, const MergedStream& b) {
+  if (a.done()) return b.value();
+  if (b.done()) return a.value();
+  return std::min(a.value(), b.value());
+}
+
+/**
+ * Orders the runs by increasing size
+ */
+struct SmallerRun {
+  bool operator()(const bob::measure::ExactScoreAccumulator::Run& a,
+      const bob::measure::ExactScoreAccumulator::Run& b) const {
+    return a.size < b.size;
+  }
+};
+
+/**
+ * Merges sorted runs (and sorted scores in memory) into a new run, by blocks
+ * of s_read_block scores
+ */
+static bob::measure::ExactScoreAccumulator::Run mergeRuns(
+    const std::vector<bob::measure::ExactScoreAccumulator::Run>& runs,
+    const std::vector<double>& sorted) {
+  bob::measure::ExactScoreAccumulator::Run run;
+  run.path = bob::core::tmpfile(".run");
+  run.size = 0;
+  std::ofstream file(run.path.c_str(), std::ios::binary);
+  MergedStream stream(runs, sorted);
+  std::vector<double> block;
+  block.reserve(s_read_block);
+  while (!stream.done()) {
+    block.push_back(stream.value());
+    stream.next();
+    if (block.size() == s_read_block || stream.done()) {
+      file.write(reinterpret_cast<const char*>(&block[0]),
+          block.size()*sizeof(double));
+      run.size += block.size();
+      block.clear();
+    }
+  }
+  file.close();
+  if (!file) {
+    boost::format m("cannot write the run of scores '%s'");
+    m % run.path;
+    throw std::runtime_error(m.str());
+  }
+  return run;
+}
+
+/**
+ * Removes the temporary files of runs
+ */
+static void removeRuns(
+    const std::vector<bob::measure::ExactScoreAccumulator::Run>& runs) {
+  boost::system::error_code ec;
+  for (size_t i=0; i<runs.size(); ++i)
+    boost::filesystem::remove(runs[i].path, ec);
+}
+
+/**
+ * Merges the s_max_runs smallest runs into a single one, as long as there are
+ * more than s_max_runs runs. As the runs of similar sizes are merged
+ * together, each score is rewritten a logarithmic number of times.
+ */
+static void compactRuns(
+    std::vector<bob::measure::ExactScoreAccumulator::Run>& runs) {
+  const std::vector<double> empty;
+  while (runs.size() > s_max_runs) {
+    std::sort(runs.begin(), runs.end(), SmallerRun());
+    const std::vector<bob::measure::ExactScoreAccumulator::Run> smallest(
+        runs.begin(), runs.begin() + s_max_runs);
+    const bob::measure::ExactScoreAccumulator::Run run =
+      mergeRuns(smallest, empty);
+    runs.erase(runs.begin(), runs.begin() + s_max_runs);
+    runs.push_back(run);
+    removeRuns(smallest);
+  }
+}
+
+/**
+ * Sorts the scores and writes them to a new run
+ */
+static void writeRun(std::vector<double>& scores,
+    std::vector<bob::measure::ExactScoreAccumulator::Run>& runs) {
+  if (scores.empty()) return;
+  std::sort(scores.begin(), scores.end());
+  bob::measure::ExactScoreAccumulator::Run run;
+  run.path = bob::core::tmpfile(".run");
+  run.size = scores.size();
+  std::ofstream file(run.path.c_str(), std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&scores[0]),
+      scores.size()*sizeof(double));
+  file.close();
+  if (!file) {
+    boost::format m("cannot write the run of scores '%s'");
+    m % run.path;
+    throw std::runtime_error(m.str());
+  }
+  runs.push_back(run);
+  scores.clear();
+  compactRuns(runs);
+}
+
+bob::measure::ExactScoreAccumulator::ExactScoreAccumulator(size_t run_size):
+  m_run_size(run_size)
+{
+  if (m_run_size == 0)
+    throw std::runtime_error("the number of scores kept in memory must be at least 1");
+}
+
+bob::measure::ExactScoreAccumulator::ExactScoreAccumulator(
+    bob::io::HDF5File& config, size_t run_size):
+  m_run_size(run_size)
+{
+  if (m_run_size == 0)
+    throw std::runtime_error("the number of scores kept in memory must be at least 1");
+  load(config);
+}
+
+bob::measure::ExactScoreAccumulator::~ExactScoreAccumulator() {
+  removeRuns(m_negative_runs);
+  removeRuns(m_positive_runs);
+}
+
+void bob::measure::ExactScoreAccumulator::spill() {
+  if (m_negatives.size() + m_positives.size() < m_run_size) return;
+  writeRun(m_negatives, m_negative_runs);
+  writeRun(m_positives, m_positive_runs);
+}
+
+void bob::measure::ExactScoreAccumulator::add(
+    const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives) {
+  count(negatives, positives);
+  for (int i=0; i<negatives.extent(0); ++i) {
+    m_negatives.push_back(negatives(i));
+    spill();
+  }
+  for (int i=0; i<positives.extent(0); ++i) {
+    m_positives.push_back(positives(i));
+    spill();
+  }
+}
+
+/**
+ * Returns a sorted copy of scores, such that the accumulator is not modified
+ * by concurrent sweeps
+ */
+static std::vector<double> sortedCopy(const std::vector<double>& scores) {
+  std::vector<double> sorted(scores);
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+void bob::measure::ExactScoreAccumulator::sweep(
+    bob::measure::ScoreVisitor& visitor) const {
+  const std::vector<double> sorted_negatives = sortedCopy(m_negatives);
+  const std::vector<double> sorted_positives = sortedCopy(m_positives);
+  MergedStream negatives(m_negative_runs, sorted_negatives);
+  MergedStream positives(m_positive_runs, sorted_positives);
+  const size_t n_scores = m_n_negatives + m_n_positives;
+
+  while (!negatives.done() || !positives.done()) {
+    const double score = smallest(negatives, positives);
+    const size_t n_neg = negatives.skip(score);
+    const size_t n_pos = positives.skip(score);
+
+    //same thresholds as bob::measure::sortedExactMinimizingThreshold()
+    double threshold;
+    if (!negatives.done() || !positives.done()) {
+      const double next = smallest(negatives, positives);
+      threshold = 0.5 * (score + next);
+      if (threshold <= score) threshold = next; //consecutive doubles
+    }
+    else {
+      threshold = score + 0.5 * (m_max - m_min) / n_scores;
+      if (threshold <= score)
+        threshold = score + std::max(std::abs(score), 1.) *
+          std::numeric_limits<double>::epsilon();
+    }
+
+    visitor(score, threshold, n_neg, n_pos);
+  }
+}
+
+/**
+ * Saves sorted scores into blocks of s_save_block scores, the last one being
+ * padded with its last score
+ */
+static void saveSorted(bob::io::HDF5File& config, const std::string& path,
+    const std::vector<bob::measure::ExactScoreAccumulator::Run>& runs,
+    const std::vector<double>& buffer) {
+  const std::vector<double> sorted = sortedCopy(buffer);
+  MergedStream stream(runs, sorted);
+  blitz::Array<double,1> block(s_save_block);
+  size_t n = 0;
+  while (!stream.done()) {
+    block(n++) = stream.value();
+    stream.next();
+    if (n == s_save_block || stream.done()) {
+      if (n < s_save_block)
+        block(blitz::Range(n, s_save_block-1)) = block(n-1);
+      config.appendArray(path, block);
+      n = 0;
+    }
+  }
+}
+
+void bob::measure::ExactScoreAccumulator::save(
+    bob::io::HDF5File& config) const {
+  config.set("n_negatives", (uint64_t)m_n_negatives);
+  config.set("n_positives", (uint64_t)m_n_positives);
+  saveSorted(config, "negatives", m_negative_runs, m_negatives);
+  saveSorted(config, "positives", m_positive_runs, m_positives);
+}
+
+void bob::measure::ExactScoreAccumulator::load(bob::io::HDF5File& config) {
+  const size_t sizes[2] = {
+    (size_t)config.read<uint64_t>("n_negatives"),
+    (size_t)config.read<uint64_t>("n_positives")
+  };
+  const char* paths[2] = {"negatives", "positives"};
+  std::vector<Run>* runs[2] = {&m_negative_runs, &m_positive_runs};
+  const blitz::Array<double,1> empty;
+
+  //the saved scores are sorted: each of them is copied into a single run
+  for (int k=0; k<2; ++k) {
+    if (sizes[k] == 0) continue;
+    Run run;
+    run.path = bob::core::tmpfile(".run");
+    run.size = sizes[k];
+    runs[k]->push_back(run);
+    std::ofstream file(run.path.c_str(), std::ios::binary);
+    blitz::Array<double,1> block(s_save_block);
+    for (size_t begin=0, pos=0; begin<sizes[k]; begin+=s_save_block, ++pos) {
+      config.readArray(paths[k], pos, block);
+      const size_t n = std::min(s_save_block, sizes[k] - begin);
+      file.write(reinterpret_cast<const char*>(block.data()),
+          n*sizeof(double));
+      blitz::Array<double,1> scores = block(blitz::Range(0, n-1));
+      if (k == 0) count(scores, empty);
+      else count(empty, scores);
+    }
+    file.close();
+    if (!file) {
+      boost::format m("cannot write the run of scores '%s'");
+      m % run.path;
+      throw std::runtime_error(m.str());
+    }
+    compactRuns(*runs[k]);
+  }
+}
+
+void bob::measure::ExactScoreAccumulator::merge(
+    const bob::measure::ExactScoreAccumulator& other) {
+  //copies first, in case other is this accumulator
+  const std::vector<Run> runs[2] = {other.m_negative_runs,
+    other.m_positive_runs};
+  const std::vector<double> negatives(other.m_negatives);
+  const std::vector<double> positives(other.m_positives);
+  count(other);
+
+  //the runs of the other accumulator are merged into a single new run
+  std::vector<Run>* own_runs[2] = {&m_negative_runs, &m_positive_runs};
+  const std::vector<double> empty;
+  for (int k=0; k<2; ++k) {
+    if (runs[k].empty()) continue;
+    own_runs[k]->push_back(mergeRuns(runs[k], empty));
+    compactRuns(*own_runs[k]);
+  }
+  for (size_t i=0; i<negatives.size(); ++i) {
+    m_negatives.push_back(negatives[i]);
+    spill();
+  }
+  for (size_t i=0; i<positives.size(); ++i) {
+    m_positives.push_back(positives[i]);
+    spill();
+  }
+}
+
+bob::measure::HistogramScoreAccumulator::HistogramScoreAccumulator(
+    double min, double max, size_t n_bins):
+  m_range_min(min),
+  m_range_max(max),
+  m_n_bins(n_bins),
+  m_negative_counts(n_bins+2),
+  m_positive_counts(n_bins+2)
+{
+  if (!(min < max)) {
+    boost::format m("the range of the histogram [%f, %f] is empty");
+    m % min % max;
+    throw std::runtime_error(m.str());
+  }
+  if (n_bins == 0)
+    throw std::runtime_error("the number of bins of the histogram must be at least 1");
+  m_negative_counts = 0;
+  m_positive_counts = 0;
+}
+
+bob::measure::HistogramScoreAccumulator::HistogramScoreAccumulator(
+    bob::io::HDF5File& config)
+{
+  load(config);
+}
+
+double bob::measure::HistogramScoreAccumulator::edge(size_t i) const {
+  if (i == m_n_bins) return m_range_max;
+  return m_range_min + (m_range_max - m_range_min) * ((double)i / m_n_bins);
+}
+
+size_t bob::measure::HistogramScoreAccumulator::bin(double score) const {
+  if (score < m_range_min) return 0;
+  if (score >= m_range_max) return m_n_bins + 1;
+  size_t i = (size_t)((score - m_range_min) / (m_range_max - m_range_min) *
+      m_n_bins);
+  if (i >= m_n_bins) i = m_n_bins - 1;
+  //the scores are quantized to the lower edge of their bin, despite the
+  //rounding errors
+  while (i > 0 && edge(i) > score) --i;
+  while (i + 1 < m_n_bins && edge(i+1) <= score) ++i;
+  return i + 1;
+}
+
+void bob::measure::HistogramScoreAccumulator::add(
+    const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives) {
+  count(negatives, positives);
+  for (int i=0; i<negatives.extent(0); ++i)
+    ++m_negative_counts(bin(negatives(i)));
+  for (int i=0; i<positives.extent(0); ++i)
+    ++m_positive_counts(bin(positives(i)));
+}
+
+void bob::measure::HistogramScoreAccumulator::sweep(
+    bob::measure::ScoreVisitor& visitor) const {
+  for (size_t b=0; b<m_n_bins+2; ++b) {
+    const size_t n_neg = m_negative_counts(b);
+    const size_t n_pos = m_positive_counts(b);
+    if (n_neg == 0 && n_pos == 0) continue;
+    if (b == 0) {
+      //below the range: quantized to the smallest score
+      visitor(m_min, m_range_min, n_neg, n_pos);
+    }
+    else if (b <= m_n_bins) {
+      visitor(edge(b-1), edge(b), n_neg, n_pos);
+    }
+    else {
+      //above the range: the threshold rejects the largest score
+      visitor(m_range_max, m_max + std::max(std::abs(m_max), 1.) *
+          std::numeric_limits<double>::epsilon(), n_neg, n_pos);
+    }
+  }
+}
+
+void bob::measure::HistogramScoreAccumulator::save(
+    bob::io::HDF5File& config) const {
+  config.set("range_min", m_range_min);
+  config.set("range_max", m_range_max);
+  config.set("n_bins", (uint64_t)m_n_bins);
+  config.set("min", m_min);
+  config.set("max", m_max);
+  config.setArray("negative_counts", m_negative_counts);
+  config.setArray("positive_counts", m_positive_counts);
+}
+
+void bob::measure::HistogramScoreAccumulator::load(bob::io::HDF5File& config) {
+  m_range_min = config.read<double>("range_min");
+  m_range_max = config.read<double>("range_max");
+  m_n_bins = config.read<uint64_t>("n_bins");
+  m_min = config.read<double>("min");
+  m_max = config.read<double>("max");
+  m_negative_counts.reference(
+      config.readArray<uint64_t,1>("negative_counts"));
+  m_positive_counts.reference(
+      config.readArray<uint64_t,1>("positive_counts"));
+  if (m_negative_counts.extent(0) != (int)m_n_bins+2 ||
+      m_positive_counts.extent(0) != (int)m_n_bins+2) {
+    boost::format m("the histograms of %u bins do not have %u counts");
+    m % m_n_bins % (m_n_bins+2);
+    throw std::runtime_error(m.str());
+  }
+  m_n_negatives = blitz::sum(m_negative_counts);
+  m_n_positives = blitz::sum(m_positive_counts);
+}
+
+void bob::measure::HistogramScoreAccumulator::merge(
+    const bob::measure::HistogramScoreAccumulator& other) {
+  if (m_range_min != other.m_range_min || m_range_max != other.m_range_max ||
+      m_n_bins != other.m_n_bins) {
+    boost::format m("cannot merge a histogram of %u bins in [%f, %f] into a histogram of %u bins in [%f, %f]");
+    m % other.m_n_bins % other.m_range_min % other.m_range_max;
+    m % m_n_bins % m_range_min % m_range_max;
+    throw std::runtime_error(m.str());
+  }
+  count(other);
+  m_negative_counts += other.m_negative_counts;
+  m_positive_counts += other.m_positive_counts;
+}
@@ -27,9 +27,80 @@
 #include <bob/measure/error.h>
 #include <bob/core/assert.h>
 #include <bob/core/cast.h>
+#include <bob/core/threads.h>
 #include <bob/math/pavx.h>
 #include <bob/math/linsolve.h>
 
+/**
+ * Minimum number of scores for which the sort is split among threads
+ */
+static const size_t s_parallel_sort_min = 1 << 20;
+
+/**
+ * Sorts the chunks of an array, the chunk c being the elements
+ * [c*size/n_chunks, (c+1)*size/n_chunks)
+ */
+struct SortChunks {
+  double* data;
+  size_t size;
+  size_t n_chunks;
+
+  void operator()(const size_t, const size_t begin, const size_t end) const {
+    for (size_t c=begin; c<end; ++c)
+      std::sort(data + c*size/n_chunks, data + (c+1)*size/n_chunks);
+  }
+};
+
+/**
+ * Merges the pairs of consecutive groups of 'width' sorted chunks
+ */
+struct MergeChunks {
+  double* data;
+  size_t size;
+  size_t n_chunks;
+  size_t width;
+
+  void operator()(const size_t, const size_t begin, const size_t end) const {
+    for (size_t p=begin; p<end; ++p) {
+      const size_t lo = 2*p*width;
+      const size_t mid = lo + width;
+      const size_t hi = std::min(mid + width, n_chunks);
+      if (mid >= n_chunks) continue;
+      std::inplace_merge(data + lo*size/n_chunks, data + mid*size/n_chunks,
+          data + hi*size/n_chunks);
+    }
+  }
+};
+
+void bob::measure::sort(const blitz::Array<double,1>& scores,
+    std::vector<double>& sorted, size_t n_threads) {
+  const size_t size = scores.extent(0);
+  sorted.resize(size);
+  std::copy(scores.begin(), scores.end(), sorted.begin());
+
+  if (n_threads == 0) n_threads = bob::core::hardware_threads();
+  if (n_threads == 1 || size < s_parallel_sort_min) {
+    std::sort(sorted.begin(), sorted.end());
+    return;
+  }
+
+  // sorts one chunk per thread, then merges them pairwise
+  SortChunks sort_chunks;
+  sort_chunks.data = &sorted[0];
+  sort_chunks.size = size;
+  sort_chunks.n_chunks = n_threads;
+  bob::core::thread_loop(sort_chunks, n_threads, n_threads);
+  for (size_t width=1; width<n_threads; width*=2) {
+    MergeChunks merge_chunks;
+    merge_chunks.data = &sorted[0];
+    merge_chunks.size = size;
+    merge_chunks.n_chunks = n_threads;
+    merge_chunks.width = width;
+    bob::core::thread_loop(merge_chunks, (n_threads + 2*width - 1)/(2*width),
+        n_threads);
+  }
+}
+
 std::pair<double, double> bob::measure::farfrr(const blitz::Array<double,1>& negatives,
     const blitz::Array<double,1>& positives, double threshold) {
   blitz::sizeType total_negatives = negatives.extent(blitz::firstDim);
@@ -76,6 +147,11 @@ double bob::measure::eerThreshold(const blitz::Array<double,1>& negatives,
   return bob::measure::minimizingThreshold(negatives, positives, eer_predicate);
 }
 
+double bob::measure::exactEerThreshold(const blitz::Array<double,1>& negatives,
+    const blitz::Array<double,1>& positives) {
+  return bob::measure::exactMinimizingThreshold(negatives, positives, eer_predicate);
+}
+
 double bob::measure::eerRocch(const blitz::Array<double,1>& negatives,
     const blitz::Array<double,1>& positives) {
   return bob::measure::rocch2eer(bob::measure::rocch(negatives, positives));
@@ -94,9 +170,8 @@ double bob::measure::farThreshold(const blitz::Array<double,1>& negatives,
   }
 
   // sort negative scores ascendingly
-  std::vector<double> negatives_(negatives.shape()[0]);
-  std::copy(negatives.begin(), negatives.end(), negatives_.begin());
-  std::sort(negatives_.begin(), negatives_.end(), std::less<double>());
+  std::vector<double> negatives_;
+  bob::measure::sort(negatives, negatives_);
 
   // compute position of the threshold
   double crr = 1.-far_value; // (Correct Rejection Rate; = 1 - FAR)
@@ -134,9 +209,9 @@ double bob::measure::frrThreshold(const blitz::Array<double,1>&,
   }
 
   // sort positive scores descendingly
-  std::vector<double> positives_(positives.shape()[0]);
-  std::copy(positives.begin(), positives.end(), positives_.begin());
-  std::sort(positives_.begin(), positives_.end(), std::greater<double>());
+  std::vector<double> positives_;
+  bob::measure::sort(positives, positives_);
+  std::reverse(positives_.begin(), positives_.end());
 
   // compute position of the threshold
   double car = 1.-frr_value; // (Correct Acceptance Rate; = 1 - FRR)
@@ -188,33 +263,75 @@ double bob::measure::minWeightedErrorRateThreshold
   return bob::measure::minimizingThreshold(negatives, positives, predicate);
 }
 
+double bob::measure::exactMinWeightedErrorRateThreshold
+(const blitz::Array<double,1>& negatives,
+ const blitz::Array<double,1>& positives, double cost) {
+  weighted_error predicate(cost);
+  return bob::measure::exactMinimizingThreshold(negatives, positives, predicate);
+}
+
+/**
+ * Counts the sorted scores which are smaller than each of the increasing
+ * thresholds min + i*step, with a single sweep. counts[i] is the number of
+ * scores below the i-th threshold.
+ */
+static void countBelow(const std::vector<double>& sorted, double min,
+    double step, size_t points, std::vector<size_t>& counts) {
+  counts.resize(points);
+  size_t index = 0;
+  for (size_t i=0; i<points; ++i) {
+    const double threshold = min + (int)i*step;
+    while (index < sorted.size() && sorted[index] < threshold) ++index;
+    counts[i] = index;
+  }
+}
+
 blitz::Array<double,2> bob::measure::roc(const blitz::Array<double,1>& negatives,
  const blitz::Array<double,1>& positives, size_t points) {
-  double min = std::min(blitz::min(negatives), blitz::min(positives));
-  double max = std::max(blitz::max(negatives), blitz::max(positives));
+  std::vector<double> negatives_, positives_;
+  bob::measure::sort(negatives, negatives_);
+  bob::measure::sort(positives, positives_);
+  std::pair<double, double> range =
+    bob::measure::sortedRange(negatives_, positives_);
+  double min = range.first;
+  double max = range.second;
   double step = (max-min)/((double)points-1.0);
+  std::vector<size_t> neg_below, pos_below;
+  countBelow(negatives_, min, step, points, neg_below);
+  countBelow(positives_, min, step, points, pos_below);
+  const double total_negatives = std::max(negatives_.size(), (size_t)1);
+  const double total_positives = std::max(positives_.size(), (size_t)1);
   blitz::Array<double,2> retval(2, points);
   for (int i=0; i<(int)points; ++i) {
-    std::pair<double, double> ratios =
-      bob::measure::farfrr(negatives, positives, min + i*step);
     //note: inversion to preserve X x Y ordering (FRR x FAR)
-    retval(0,i) = ratios.second;
-    retval(1,i) = ratios.first;
+    retval(0,i) = pos_below[i] / total_positives;
+    retval(1,i) = (negatives_.size() - neg_below[i]) / total_negatives;
   }
   return retval;
 }
 
 blitz::Array<double,2> bob::measure::precision_recall_curve(const blitz::Array<double,1>& negatives,
  const blitz::Array<double,1>& positives, size_t points) {
-  double min = std::min(blitz::min(negatives), blitz::min(positives));
-  double max = std::max(blitz::max(negatives), blitz::max(positives));
+  std::vector<double> negatives_, positives_;
+  bob::measure::sort(negatives, negatives_);
+  bob::measure::sort(positives, positives_);
+  std::pair<double, double> range =
+    bob::measure::sortedRange(negatives_, positives_);
+  double min = range.first;
+  double max = range.second;
   double step = (max-min)/((double)points-1.0);
+  std::vector<size_t> neg_below, pos_below;
+  countBelow(negatives_, min, step, points, neg_below);
+  countBelow(positives_, min, step, points, pos_below);
+  const double total_positives = std::max(positives_.size(), (size_t)1);
   blitz::Array<double,2> retval(2, points);
   for (int i=0; i<(int)points; ++i) {
-    std::pair<double, double> ratios =
-      bob::measure::precision_recall(negatives, positives, min + i*step);
-    retval(0,i) = ratios.first;
-    retval(1,i) = ratios.second;
+    size_t false_positives = negatives_.size() - neg_below[i];
+    size_t true_positives = positives_.size() - pos_below[i];
+    size_t total_classified_positives =
+      std::max(true_positives + false_positives, (size_t)1);
+    retval(0,i) = true_positives/(double)total_classified_positives;
+    retval(1,i) = true_positives/total_positives;
   }
   return retval;
 }
@@ -372,13 +489,11 @@ blitz::Array<double,2> bob::measure::roc_for_far(const blitz::Array<double,1>& n
   int n_points = far_list.extent(0);
 
   // sort negative scores ascendingly
-  std::vector<double> negatives_(negatives.extent(0));;
-  std::copy(negatives.begin(), negatives.end(), negatives_.begin());
-  std::sort(negatives_.begin(), negatives_.end());
+  std::vector<double> negatives_;
+  bob::measure::sort(negatives, negatives_);
   // sort positive scores ascendingly
-  std::vector<double> positives_(positives.extent(0));;
-  std::copy(positives.begin(), positives.end(), positives_.begin());
-  std::sort(positives_.begin(), positives_.end());
+  std::vector<double> positives_;
+  bob::measure::sort(positives, positives_);
 
   // do some magic to compute the FRR list
   blitz::Array<double,2> retval(2, n_points);
@@ -519,15 +634,23 @@ blitz::Array<double,2> bob::measure::epc
  const blitz::Array<double,1>& dev_positives,
  const blitz::Array<double,1>& test_negatives,
  const blitz::Array<double,1>& test_positives, size_t points) {
+  // all the scores are sorted once
+  std::vector<double> dev_negatives_, dev_positives_;
+  std::vector<double> test_negatives_, test_positives_;
+  bob::measure::sort(dev_negatives, dev_negatives_);
+  bob::measure::sort(dev_positives, dev_positives_);
+  bob::measure::sort(test_negatives, test_negatives_);
+  bob::measure::sort(test_positives, test_positives_);
   double step = 1.0/((double)points-1.0);
   blitz::Array<double,2> retval(2, points);
   for (int i=0; i<(int)points; ++i) {
     double alpha = (double)i*step;
     retval(0,i) = alpha;
-    double threshold = bob::measure::minWeightedErrorRateThreshold(dev_negatives,
-        dev_positives, alpha);
+    weighted_error predicate(alpha);
+    double threshold = bob::measure::sortedMinimizingThreshold(dev_negatives_,
+        dev_positives_, predicate);
     std::pair<double, double> ratios =
-      bob::measure::farfrr(test_negatives, test_positives, threshold);
+      bob::measure::sortedFarfrr(test_negatives_, test_positives_, threshold);
     retval(1,i) = (ratios.first + ratios.second) / 2;
   }
   return retval;
@@ -64,6 +64,10 @@ static double bob_eer_threshold(bob::python::const_ndarray negatives, bob::pytho
   return bob::measure::eerThreshold(negatives.cast<double,1>(), positives.cast<double,1>());
 }
 
+static double bob_exact_eer_threshold(bob::python::const_ndarray negatives, bob::python::const_ndarray positives){
+  return bob::measure::exactEerThreshold(negatives.cast<double,1>(), positives.cast<double,1>());
+}
+
 static double bob_eer_rocch(bob::python::const_ndarray negatives, bob::python::const_ndarray positives){
   return bob::measure::eerRocch(negatives.cast<double,1>(), positives.cast<double,1>());
 }
@@ -72,6 +76,9 @@ static double bob_min_weighted_error_rate_threshold(bob::python::const_ndarray n
   return bob::measure::minWeightedErrorRateThreshold(negatives.cast<double,1>(), positives.cast<double,1>(), costs);
 }
 
+static double bob_exact_min_weighted_error_rate_threshold(bob::python::const_ndarray negatives, bob::python::const_ndarray positives, const double costs){
+  return bob::measure::exactMinWeightedErrorRateThreshold(negatives.cast<double,1>(), positives.cast<double,1>(), costs);
+}
 
 static double bob_min_hter_threshold(bob::python::const_ndarray negatives, bob::python::const_ndarray positives){
   return bob::measure::minHterThreshold(negatives.cast<double,1>(), positives.cast<double,1>());
@@ -162,6 +169,13 @@ void bind_measure_error() {
     "Calculates the threshold that is as close as possible to the equal-error-rate (EER) given the input data. The EER should be the point where the FAR equals the FRR. Graphically, this would be equivalent to the intersection between the ROC (or DET) curves and the identity."
   );
 
+  def(
+    "exact_eer_threshold",
+    &bob_exact_eer_threshold,
+    (arg("negatives"), arg("positives")),
+    "Calculates the threshold which minimizes exactly |FAR - FRR| given the input data. The scores are sorted once, and the FAR and FRR between each pair of consecutive scores are obtained with a single sweep. The threshold is in the middle of the interval of the minimum."
+  );
+
  def(
     "eer_rocch",
     &bob_eer_rocch,
@@ -176,6 +190,13 @@ void bind_measure_error() {
     "Calculates the threshold that minimizes the error rate, given the input data. An optional parameter 'cost' determines the relative importance between false-accepts and false-rejections. This number should be between 0 and 1 and will be clipped to those extremes. The value to minimize becomes: ER_cost = [cost * FAR] + [(1-cost) * FRR]. The higher the cost, the higher the importance given to *not* making mistakes classifying negatives/noise/impostors."
   );
 
+  def(
+    "exact_min_weighted_error_rate_threshold",
+    &bob_exact_min_weighted_error_rate_threshold,
+    (arg("negatives"), arg("positives"), arg("cost")),
+    "Calculates the threshold which minimizes exactly the weighted error rate ER_cost = [cost * FAR] + [(1-cost) * FRR] given the input data (see min_weighted_error_rate_threshold()). The scores are sorted once, and the FAR and FRR between each pair of consecutive scores are obtained with a single sweep. The threshold is in the middle of the interval of the minimum."
+  );
+
   def(
     "min_hter_threshold",
     &bob_min_hter_threshold,
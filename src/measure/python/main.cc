@@ -23,10 +23,12 @@
 #include "bob/python/ndarray.h"
 
 void bind_measure_error();
+void bind_measure_score_accumulator();
 
 BOOST_PYTHON_MODULE(_measure) {
   boost::python::docstring_options docopt(true, true, false);
   bob::python::setup_python("bob error measure classes and sub-classes");
 
   bind_measure_error();
+  bind_measure_score_accumulator();
 }
@@ -0,0 +1,89 @@
+/**
+ * @file measure/python/score_accumulator.cc
+ * @date Mon Oct 19 10:12:44 2026 +0200
+ *
+ * @brief Python bindings to the accumulators of scores
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bob/measure/ScoreAccumulator.h"
+#include "bob/python/ndarray.h"
+
+using namespace boost::python;
+
+static void add(bob::measure::ScoreAccumulator& accumulator,
+    bob::python::const_ndarray negatives,
+    bob::python::const_ndarray positives) {
+  accumulator.add(negatives.cast<double,1>(), positives.cast<double,1>());
+}
+
+static tuple farfrr(const bob::measure::ScoreAccumulator& accumulator,
+    double threshold) {
+  std::pair<double, double> retval = accumulator.farfrr(threshold);
+  return make_tuple(retval.first, retval.second);
+}
+
+static blitz::Array<double,2> roc_for_far(
+    const bob::measure::ScoreAccumulator& accumulator,
+    bob::python::const_ndarray far_list) {
+  return accumulator.roc_for_far(far_list.cast<double,1>());
+}
+
+static blitz::Array<uint64_t,1> negative_counts(
+    const bob::measure::HistogramScoreAccumulator& accumulator) {
+  return accumulator.getNegativeCounts().copy();
+}
+
+static blitz::Array<uint64_t,1> positive_counts(
+    const bob::measure::HistogramScoreAccumulator& accumulator) {
+  return accumulator.getPositiveCounts().copy();
+}
+
+void bind_measure_score_accumulator() {
+  class_<bob::measure::ScoreAccumulator, boost::noncopyable>("ScoreAccumulator", "Accumulates negative and positive scores given by chunks, and evaluates the error rates like the functions of this module, with one or a few sweeps over the accumulated scores in increasing order. The scores are never all in memory.", no_init)
+    .def("add", &add, (arg("self"), arg("negatives"), arg("positives")), "Adds a chunk of negative and positive scores")
+    .add_property("n_negatives", &bob::measure::ScoreAccumulator::getNNegatives, "The number of negative scores")
+    .add_property("n_positives", &bob::measure::ScoreAccumulator::getNPositives, "The number of positive scores")
+    .add_property("min", &bob::measure::ScoreAccumulator::getMin, "The smallest score")
+    .add_property("max", &bob::measure::ScoreAccumulator::getMax, "The largest score")
+    .def("save", &bob::measure::ScoreAccumulator::save, (arg("self"), arg("config")), "Saves the scores into an HDF5 file, such that accumulators of several processes can be merged")
+    .def("farfrr", &farfrr, (arg("self"), arg("threshold")), "Calculates the FA ratio and the FR ratio at the given threshold (see farfrr())")
+    .def("eer_threshold", &bob::measure::ScoreAccumulator::eerThreshold, (arg("self")), "Calculates the threshold which minimizes exactly |FAR - FRR| (see exact_eer_threshold())")
+    .def("min_weighted_error_rate_threshold", &bob::measure::ScoreAccumulator::minWeightedErrorRateThreshold, (arg("self"), arg("cost")), "Calculates the threshold which minimizes exactly the weighted error rate (see exact_min_weighted_error_rate_threshold())")
+    .def("roc", &bob::measure::ScoreAccumulator::roc, (arg("self"), arg("n_points")), "Calculates the ROC curve on n_points thresholds distributed uniformly in [min, max] (see roc())")
+    .def("det", &bob::measure::ScoreAccumulator::det, (arg("self"), arg("n_points")), "Calculates the DET curve (see det())")
+    .def("roc_for_far", &roc_for_far, (arg("self"), arg("far_list")), "Calculates the ROC curve at the given FAR values (see roc_for_far()). The CAR of each FAR is the one after the smallest number of negatives whose ratio is above 1-FAR.")
+    ;
+
+  class_<bob::measure::ExactScoreAccumulator, boost::noncopyable, bases<bob::measure::ScoreAccumulator> >("ExactScoreAccumulator", "Accumulates the scores exactly. The scores are buffered in memory, and once the buffers hold run_size scores, they are sorted and written to temporary files, which are merged on the fly by the sweeps. The results are the same as the ones of the functions of this module on all the scores.", init<optional<size_t> >((arg("self"), arg("run_size")=1<<22), "Creates an empty accumulator, which keeps at most run_size scores in memory"))
+    .def(init<bob::io::HDF5File&, optional<size_t> >((arg("self"), arg("config"), arg("run_size")=1<<22), "Creates an accumulator from the scores saved in an HDF5 file"))
+    .def("load", &bob::measure::ExactScoreAccumulator::load, (arg("self"), arg("config")), "Adds the scores saved in an HDF5 file")
+    .def("merge", &bob::measure::ExactScoreAccumulator::merge, (arg("self"), arg("other")), "Adds the scores of another accumulator")
+    .add_property("run_size", &bob::measure::ExactScoreAccumulator::getRunSize, "The number of scores kept in memory")
+    .add_property("n_runs", &bob::measure::ExactScoreAccumulator::getNRuns, "The number of sorted runs written to temporary files")
+    ;
+
+  class_<bob::measure::HistogramScoreAccumulator, boost::noncopyable, bases<bob::measure::ScoreAccumulator> >("HistogramScoreAccumulator", "Accumulates the number of scores in n_bins bins of equal width in [min, max], with the scores below min and above max in two extra bins, in constant memory. The scores are quantized to the lower edge of their bin, and the results are the exact ones of the quantized scores: the error rates are exact at the edges of the bins, and the thresholds are edges of the bins.", init<double, double, optional<size_t> >((arg("self"), arg("min"), arg("max"), arg("n_bins")=1<<16), "Creates an empty accumulator with n_bins bins in [min, max]"))
+    .def(init<bob::io::HDF5File&>((arg("self"), arg("config")), "Creates an accumulator from the histograms saved in an HDF5 file"))
+    .def("load", &bob::measure::HistogramScoreAccumulator::load, (arg("self"), arg("config")), "Replaces the histograms by the ones saved in an HDF5 file")
+    .def("merge", &bob::measure::HistogramScoreAccumulator::merge, (arg("self"), arg("other")), "Adds the scores of another accumulator, which has the same bins")
+    .add_property("range_min", &bob::measure::HistogramScoreAccumulator::getRangeMin, "The lower edge of the first bin")
+    .add_property("range_max", &bob::measure::HistogramScoreAccumulator::getRangeMax, "The upper edge of the last bin")
+    .add_property("n_bins", &bob::measure::HistogramScoreAccumulator::getNBins, "The number of bins in [min, max]")
+    .add_property("negative_counts", &negative_counts, "The number of negative scores of the bins, the first one being below min and the last one above max")
+    .add_property("positive_counts", &positive_counts, "The number of positive scores of the bins, the first one being below min and the last one above max")
+    ;
+}
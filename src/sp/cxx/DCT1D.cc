@@ -23,7 +23,7 @@
 
 #include <bob/sp/DCT1D.h>
 #include <bob/core/assert.h>
-#include <fftw3.h>
+#include <bob/sp/FFTWPlanCache.h>
 
 bob::sp::DCT1DAbstract::DCT1DAbstract(const size_t length):
   m_length(length)
@@ -121,16 +121,9 @@ void bob::sp::DCT1D::operator()(const blitz::Array<double,1>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  double* src_ = const_cast<double*>(src.data());
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_1d(src.extent(0), src_, dst_, FFTW_REDFT10, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached plan for this length
+  bob::sp::FFTWPlanCache::instance()->executeR2R(bob::sp::FFTWPlanCache::DCT, 1,
+    src.extent(0), 0, src.data(), dst.data());
 
   // Normalize
   dst(0) *= m_sqrt_1byl/2.;
@@ -180,14 +173,8 @@ void bob::sp::IDCT1D::operator()(const blitz::Array<double,1>& src,
     dst(r_dst) /= m_sqrt_2l;
   }
 
-  // Reinterpret cast to fftw format
-  double* dst_ = dst.data();
- 
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_1d(src.extent(0), dst_, dst_, FFTW_REDFT01, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached (in-place) plan for this length
+  bob::sp::FFTWPlanCache::instance()->executeR2R(bob::sp::FFTWPlanCache::IDCT, 1,
+    dst.extent(0), 0, dst.data(), dst.data());
 }
 
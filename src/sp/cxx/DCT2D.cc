@@ -23,7 +23,7 @@
 
 #include <bob/sp/DCT2D.h>
 #include <bob/core/assert.h>
-#include <fftw3.h>
+#include <bob/sp/FFTWPlanCache.h>
 
 
 bob::sp::DCT2DAbstract::DCT2DAbstract(const size_t height, const size_t width):
@@ -130,16 +130,9 @@ void bob::sp::DCT2D::operator()(const blitz::Array<double,2>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  double* src_ = const_cast<double*>(src.data());
-  double* dst_ = dst.data();
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_REDFT10, FFTW_REDFT10, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeR2R(bob::sp::FFTWPlanCache::DCT, 2,
+    src.extent(0), src.extent(1), src.data(), dst.data());
 
   // Rescale the result
   for (int i=0; i<(int)m_height; ++i)
@@ -147,6 +140,29 @@ void bob::sp::DCT2D::operator()(const blitz::Array<double,2>& src,
       dst(i,j) = dst(i,j)/4.*(i==0?m_sqrt_1h:m_sqrt_2h)*(j==0?m_sqrt_1w:m_sqrt_2w);
 }
 
+void bob::sp::DCT2D::operator()(const blitz::Array<double,3>& src, 
+  blitz::Array<double,3>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertSameDimensionLength(src.extent(1), m_height);
+  bob::core::array::assertSameDimensionLength(src.extent(2), m_width);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape( dst, src);
+
+  // Use the cached batched plan for this shape and number of arrays
+  bob::sp::FFTWPlanCache::instance()->executeR2R(bob::sp::FFTWPlanCache::DCT, 2,
+    m_height, m_width, src.data(), dst.data(), src.extent(0));
+
+  // Rescale the result
+  for (int k=0; k<dst.extent(0); ++k)
+    for (int i=0; i<(int)m_height; ++i)
+      for (int j=0; j<(int)m_width; ++j)
+        dst(k,i,j) = dst(k,i,j)/4.*(i==0?m_sqrt_1h:m_sqrt_2h)*(j==0?m_sqrt_1w:m_sqrt_2w);
+}
+
 
 bob::sp::IDCT2D::IDCT2D():
   bob::sp::DCT2DAbstract::DCT2DAbstract(0,0)
@@ -185,15 +201,38 @@ void bob::sp::IDCT2D::operator()(const blitz::Array<double,2>& src,
       dst(i,j) = src(i,j)*4/(i==0?m_sqrt_1h:m_sqrt_2h)/(j==0?m_sqrt_1w:m_sqrt_2w);
   }
 
-  // Reinterpret cast to fftw format
-  double* dst_ = dst.data();
+  // Use the cached (in-place) plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeR2R(bob::sp::FFTWPlanCache::IDCT, 2,
+    dst.extent(0), dst.extent(1), dst.data(), dst.data());
   
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_r2r_2d(src.extent(0), src.extent(1), dst_, dst_, FFTW_REDFT01, FFTW_REDFT01, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Rescale the result by the size of the input 
+  // (as this is not performed by FFW)
+  double norm_factor = 4.*(int)m_width*(int)m_height;
+  dst /= norm_factor;
+}
+
+void bob::sp::IDCT2D::operator()(const blitz::Array<double,3>& src, 
+  blitz::Array<double,3>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertSameDimensionLength(src.extent(1), m_height);
+  bob::core::array::assertSameDimensionLength(src.extent(2), m_width);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape( dst, src);
+
+  // Normalize
+  for (int k=0; k<src.extent(0); ++k)
+    for (int i=0; i<(int)m_height; ++i)
+      for (int j=0; j<(int)m_width; ++j)
+        dst(k,i,j) = src(k,i,j)*4/(i==0?m_sqrt_1h:m_sqrt_2h)/(j==0?m_sqrt_1w:m_sqrt_2w);
+
+  // Use the cached (in-place) batched plan for this shape and number of
+  // arrays
+  bob::sp::FFTWPlanCache::instance()->executeR2R(bob::sp::FFTWPlanCache::IDCT, 2,
+    m_height, m_width, dst.data(), dst.data(), dst.extent(0));
   
   // Rescale the result by the size of the input 
   // (as this is not performed by FFW)
@@ -23,7 +23,7 @@
 
 #include <bob/sp/FFT1D.h>
 #include <bob/core/assert.h>
-#include <fftw3.h>
+#include <bob/sp/FFTWPlanCache.h>
 
 
 bob::sp::FFT1DAbstract::FFT1DAbstract(const size_t length):
@@ -100,16 +100,24 @@ void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,1>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape(dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached plan for this length
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_FORWARD, 1,
+    src.extent(0), 0, src.data(), dst.data());
+}
+
+void bob::sp::FFT1D::operator()(const blitz::Array<std::complex<double>,2>& src, 
+  blitz::Array<std::complex<double>,2>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  // Use the cached batched plan for this length and number of signals
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_FORWARD, 1,
+    src.extent(1), 0, src.data(), dst.data(), src.extent(0));
 }
 
 
@@ -142,18 +150,29 @@ void bob::sp::IFFT1D::operator()(const blitz::Array<std::complex<double>,1>& src
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape(dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_1d(src.extent(0), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p); /* repeat as needed */
-  fftw_destroy_plan(p);
+  // Use the cached plan for this length
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_BACKWARD, 1,
+    src.extent(0), 0, src.data(), dst.data());
 
   // Rescale as FFTW is not doing it
   dst /= static_cast<double>(m_length);
 }
 
+void bob::sp::IFFT1D::operator()(const blitz::Array<std::complex<double>,2>& src, 
+  blitz::Array<std::complex<double>,2>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, src);
+
+  // Use the cached batched plan for this length and number of signals
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_BACKWARD, 1,
+    src.extent(1), 0, src.data(), dst.data(), src.extent(0));
+
+  // Rescale as FFTW is not doing it
+  dst /= static_cast<double>(src.extent(1));
+}
+
@@ -23,7 +23,7 @@
 
 #include <bob/sp/FFT2D.h>
 #include <bob/core/assert.h>
-#include <fftw3.h>
+#include <bob/sp/FFTWPlanCache.h>
 
 bob::sp::FFT2DAbstract::FFT2DAbstract(const size_t height, const size_t width):
   m_height(height), m_width(width)
@@ -94,16 +94,9 @@ void bob::sp::FFT2D::operator()(const blitz::Array<std::complex<double>,2>& src,
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_FORWARD, 2,
+    src.extent(0), src.extent(1), src.data(), dst.data());
 }
 
 
@@ -112,15 +105,9 @@ void bob::sp::FFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst) c
   // check data
   bob::core::array::assertCZeroBaseContiguous(src_dst);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
-
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_FORWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached (in-place) plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_FORWARD, 2,
+    src_dst.extent(0), src_dst.extent(1), src_dst.data(), src_dst.data());
 }
 
 
@@ -153,16 +140,9 @@ void bob::sp::IFFT2D::operator()(const blitz::Array<std::complex<double>,2>& src
   bob::core::array::assertCZeroBaseContiguous(dst);
   bob::core::array::assertSameShape( dst, src);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(src.data()));
-  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst.data());
-  
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized 
-  // for large arrays
-  p = fftw_plan_dft_2d(src.extent(0), src.extent(1), src_, dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_BACKWARD, 2,
+    src.extent(0), src.extent(1), src.data(), dst.data());
 
   // Rescale the result by the size of the input 
   // (as this is not performed by FFTW)
@@ -174,15 +154,9 @@ void bob::sp::IFFT2D::operator()(blitz::Array<std::complex<double>,2>& src_dst)
   // check data
   bob::core::array::assertCZeroBaseContiguous(src_dst);
 
-  // Reinterpret cast to fftw format
-  fftw_complex* src_dst_ = reinterpret_cast<fftw_complex*>(src_dst.data());
-
-  fftw_plan p;
-  // FFTW_ESTIMATE -> The planner is computed quickly but may not be optimized
-  // for large arrays
-  p = fftw_plan_dft_2d(src_dst.extent(0), src_dst.extent(1), src_dst_, src_dst_, FFTW_BACKWARD, FFTW_ESTIMATE);
-  fftw_execute(p);
-  fftw_destroy_plan(p);
+  // Use the cached (in-place) plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeDFT(bob::sp::FFTWPlanCache::DFT_BACKWARD, 2,
+    src_dst.extent(0), src_dst.extent(1), src_dst.data(), src_dst.data());
 
   // Rescale the result by the size of the input
   // (as this is not performed by FFTW)
@@ -0,0 +1,328 @@
+/**
+ * @file sp/cxx/FFTWPlanCache.cc
+ * @date Sat Oct 17 15:21:40 2026 +0200
+ *
+ * @brief Thread-safe cache of the FFTW plans used by the FFT and DCT
+ * classes, and persistence of the FFTW wisdom
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/sp/FFTWPlanCache.h>
+#include <boost/format.hpp>
+#include <new>
+#include <stdexcept>
+#include <fftw3.h>
+
+/**
+ * Returns the FFTW planner flags of the given rigor
+ */
+static unsigned plannerFlags(const bob::sp::FFTWPlanCache::rigor_t rigor)
+{
+  switch (rigor) {
+    case bob::sp::FFTWPlanCache::MEASURE:
+      return FFTW_MEASURE;
+    case bob::sp::FFTWPlanCache::PATIENT:
+      return FFTW_PATIENT;
+    default:
+      return FFTW_ESTIMATE;
+  }
+}
+
+/**
+ * Number of transforms of the batched plans. Calls with more transforms are
+ * processed by batches of this size, and the remaining transforms one at a
+ * time, so that at most two plans exist for each transform size (whatever
+ * the number of transforms the callers ask for).
+ */
+static const int s_batch_size = 64;
+
+/**
+ * Returns the number of transforms of the next batch, when done out of
+ * howmany transforms were computed
+ */
+static inline int batchSize(const int done, const int howmany)
+{
+  return (howmany - done >= s_batch_size ? s_batch_size : 1);
+}
+
+/**
+ * Checks that an array has the alignment assumed by the plans created on
+ * the (fftw_malloc'ed) scratch buffers
+ */
+static bool isAligned(const double* data)
+{
+  return fftw_alignment_of(const_cast<double*>(data)) == 0;
+}
+
+bob::sp::FFTWPlanCache::PlanKey::PlanKey(const kind_t kind_, const int rank_,
+    const int n0_, const int n1_, const int howmany_, const bool in_place_,
+    const bool aligned_, const rigor_t rigor_):
+  kind(kind_), rank(rank_), n0(n0_), n1(rank_ == 2 ? n1_ : 1),
+  howmany(howmany_), in_place(in_place_), aligned(aligned_), rigor(rigor_)
+{
+}
+
+bool bob::sp::FFTWPlanCache::PlanKey::operator<(const PlanKey& o) const
+{
+  if (kind != o.kind) return kind < o.kind;
+  if (rank != o.rank) return rank < o.rank;
+  if (n0 != o.n0) return n0 < o.n0;
+  if (n1 != o.n1) return n1 < o.n1;
+  if (howmany != o.howmany) return howmany < o.howmany;
+  if (in_place != o.in_place) return in_place < o.in_place;
+  if (aligned != o.aligned) return aligned < o.aligned;
+  return rigor < o.rigor;
+}
+
+boost::shared_ptr<bob::sp::FFTWPlanCache> bob::sp::FFTWPlanCache::instance()
+{
+  static boost::shared_ptr<bob::sp::FFTWPlanCache> s_instance(new FFTWPlanCache());
+  return s_instance;
+}
+
+bob::sp::FFTWPlanCache::FFTWPlanCache():
+  m_rigor(ESTIMATE)
+{
+}
+
+bob::sp::FFTWPlanCache::~FFTWPlanCache()
+{
+  destroyPlans();
+}
+
+bob::sp::FFTWPlanCache::rigor_t bob::sp::FFTWPlanCache::getRigor() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_rigor;
+}
+
+void bob::sp::FFTWPlanCache::setRigor(const rigor_t rigor)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  m_rigor = rigor;
+}
+
+bool bob::sp::FFTWPlanCache::importWisdom(const std::string& filename)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return fftw_import_wisdom_from_filename(filename.c_str()) != 0;
+}
+
+void bob::sp::FFTWPlanCache::exportWisdom(const std::string& filename)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  if (!fftw_export_wisdom_to_filename(filename.c_str())) {
+    boost::format m("cannot export the FFTW wisdom to file '%s'");
+    m % filename;
+    throw std::runtime_error(m.str());
+  }
+}
+
+void bob::sp::FFTWPlanCache::forgetWisdom()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  destroyPlans();
+  fftw_forget_wisdom();
+}
+
+void bob::sp::FFTWPlanCache::clear()
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  destroyPlans();
+}
+
+size_t bob::sp::FFTWPlanCache::size() const
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  return m_plans.size();
+}
+
+void bob::sp::FFTWPlanCache::destroyPlans()
+{
+  for (std::map<PlanKey, fftw_plan_s*>::iterator it=m_plans.begin();
+      it!=m_plans.end(); ++it)
+    fftw_destroy_plan(it->second);
+  m_plans.clear();
+}
+
+fftw_plan_s* bob::sp::FFTWPlanCache::getPlan(const kind_t kind,
+  const int rank, const int n0, const int n1, const int howmany,
+  const bool in_place, const bool aligned)
+{
+  boost::mutex::scoped_lock lock(m_mutex);
+  const PlanKey key(kind, rank, n0, n1, howmany, in_place, aligned, m_rigor);
+  std::map<PlanKey, fftw_plan_s*>::const_iterator it = m_plans.find(key);
+  if (it != m_plans.end()) return it->second;
+
+  // The plan is created on scratch buffers, as FFTW_MEASURE and
+  // FFTW_PATIENT overwrite the arrays while planning. The input and output
+  // buffers are allocated separately, to get the alignment of fftw_malloc.
+  // All the plans use the advanced interface, the howmany transforms
+  // operating on consecutive arrays of n_real (or n_half) elements.
+  const int n_real = key.n0 * key.n1;
+  const int n_half = (rank == 1 ? key.n0/2+1 : key.n0 * (key.n1/2+1));
+  const int n[2] = { key.n0, key.n1 };
+  size_t n_in_bytes = 0, n_out_bytes = 0;
+  switch (kind) {
+    case DFT_FORWARD:
+    case DFT_BACKWARD:
+      n_in_bytes = n_out_bytes = n_real * sizeof(fftw_complex);
+      break;
+    case DCT:
+    case IDCT:
+      n_in_bytes = n_out_bytes = n_real * sizeof(double);
+      break;
+    case RFFT:
+      n_in_bytes = n_real * sizeof(double);
+      n_out_bytes = n_half * sizeof(fftw_complex);
+      break;
+    case IRFFT:
+      n_in_bytes = n_half * sizeof(fftw_complex);
+      n_out_bytes = n_real * sizeof(double);
+      break;
+  }
+  n_in_bytes *= howmany;
+  n_out_bytes *= howmany;
+  void* in = fftw_malloc(n_in_bytes);
+  void* out = (in_place ? in : fftw_malloc(n_out_bytes));
+  if (!in || !out) {
+    fftw_free(in);
+    if (!in_place) fftw_free(out);
+    throw std::bad_alloc();
+  }
+  const unsigned flags = plannerFlags(m_rigor) | (aligned ? 0 : FFTW_UNALIGNED);
+
+  fftw_plan p = 0;
+  switch (kind) {
+    case DFT_FORWARD:
+    case DFT_BACKWARD:
+      {
+        fftw_complex* in_ = static_cast<fftw_complex*>(in);
+        fftw_complex* out_ = static_cast<fftw_complex*>(out);
+        const int sign = (kind == DFT_FORWARD ? FFTW_FORWARD : FFTW_BACKWARD);
+        p = fftw_plan_many_dft(rank, n, howmany, in_, 0, 1, n_real,
+          out_, 0, 1, n_real, sign, flags);
+      }
+      break;
+    case DCT:
+    case IDCT:
+      {
+        double* in_ = static_cast<double*>(in);
+        double* out_ = static_cast<double*>(out);
+        const fftw_r2r_kind r2r = (kind == DCT ? FFTW_REDFT10 : FFTW_REDFT01);
+        const fftw_r2r_kind r2r_kinds[2] = { r2r, r2r };
+        p = fftw_plan_many_r2r(rank, n, howmany, in_, 0, 1, n_real,
+          out_, 0, 1, n_real, r2r_kinds, flags);
+      }
+      break;
+    case RFFT:
+      {
+        double* in_ = static_cast<double*>(in);
+        fftw_complex* out_ = static_cast<fftw_complex*>(out);
+        p = fftw_plan_many_dft_r2c(rank, n, howmany, in_, 0, 1, n_real,
+          out_, 0, 1, n_half, flags);
+      }
+      break;
+    case IRFFT:
+      {
+        fftw_complex* in_ = static_cast<fftw_complex*>(in);
+        double* out_ = static_cast<double*>(out);
+        // Only 1D complex-to-real transforms can preserve their input
+        const unsigned c2r_flags = (rank == 1 ? flags | FFTW_PRESERVE_INPUT : flags);
+        p = fftw_plan_many_dft_c2r(rank, n, howmany, in_, 0, 1, n_half,
+          out_, 0, 1, n_real, c2r_flags);
+      }
+      break;
+  }
+  fftw_free(in);
+  if (!in_place) fftw_free(out);
+
+  if (!p) {
+    boost::format m("cannot create a FFTW plan of rank %d for %d array(s) of size %dx%d");
+    m % rank % howmany % key.n0 % key.n1;
+    throw std::runtime_error(m.str());
+  }
+  m_plans[key] = p;
+  return p;
+}
+
+void bob::sp::FFTWPlanCache::executeDFT(const kind_t kind, const int rank,
+  const int n0, const int n1, const std::complex<double>* src,
+  std::complex<double>* dst, const int howmany)
+{
+  if (n0 == 0 || (rank == 2 && n1 == 0) || howmany == 0) return;
+  const int n_real = n0 * (rank == 2 ? n1 : 1);
+  for (int done=0; done<howmany; ) {
+    const int count = batchSize(done, howmany);
+    fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>*>(src + done*n_real));
+    fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst + done*n_real);
+    const bool aligned = isAligned(reinterpret_cast<const double*>(src_)) &&
+      isAligned(reinterpret_cast<const double*>(dst_));
+    fftw_execute_dft(getPlan(kind, rank, n0, n1, count, src_ == dst_, aligned), src_, dst_);
+    done += count;
+  }
+}
+
+void bob::sp::FFTWPlanCache::executeR2R(const kind_t kind, const int rank,
+  const int n0, const int n1, const double* src, double* dst,
+  const int howmany)
+{
+  if (n0 == 0 || (rank == 2 && n1 == 0) || howmany == 0) return;
+  const int n_real = n0 * (rank == 2 ? n1 : 1);
+  for (int done=0; done<howmany; ) {
+    const int count = batchSize(done, howmany);
+    double* src_ = const_cast<double*>(src + done*n_real);
+    double* dst_ = dst + done*n_real;
+    const bool aligned = isAligned(src_) && isAligned(dst_);
+    fftw_execute_r2r(getPlan(kind, rank, n0, n1, count, src_ == dst_, aligned), src_, dst_);
+    done += count;
+  }
+}
+
+void bob::sp::FFTWPlanCache::executeR2C(const int rank, const int n0,
+  const int n1, const double* src, std::complex<double>* dst,
+  const int howmany)
+{
+  if (n0 == 0 || (rank == 2 && n1 == 0) || howmany == 0) return;
+  const int n_real = n0 * (rank == 2 ? n1 : 1);
+  const int n_half = (rank == 1 ? n0/2+1 : n0 * (n1/2+1));
+  for (int done=0; done<howmany; ) {
+    const int count = batchSize(done, howmany);
+    double* src_ = const_cast<double*>(src + done*n_real);
+    fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(dst + done*n_half);
+    const bool aligned = isAligned(src_) &&
+      isAligned(reinterpret_cast<const double*>(dst_));
+    fftw_execute_dft_r2c(getPlan(RFFT, rank, n0, n1, count, false, aligned), src_, dst_);
+    done += count;
+  }
+}
+
+void bob::sp::FFTWPlanCache::executeC2R(const int rank, const int n0,
+  const int n1, std::complex<double>* src, double* dst, const int howmany)
+{
+  if (n0 == 0 || (rank == 2 && n1 == 0) || howmany == 0) return;
+  const int n_real = n0 * (rank == 2 ? n1 : 1);
+  const int n_half = (rank == 1 ? n0/2+1 : n0 * (n1/2+1));
+  for (int done=0; done<howmany; ) {
+    const int count = batchSize(done, howmany);
+    fftw_complex* src_ = reinterpret_cast<fftw_complex*>(src + done*n_half);
+    double* dst_ = dst + done*n_real;
+    const bool aligned = isAligned(reinterpret_cast<const double*>(src_)) &&
+      isAligned(dst_);
+    fftw_execute_dft_c2r(getPlan(IRFFT, rank, n0, n1, count, false, aligned), src_, dst_);
+    done += count;
+  }
+}
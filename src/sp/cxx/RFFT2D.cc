@@ -0,0 +1,154 @@
+/**
+ * @file sp/cxx/RFFT2D.cc
+ * @date Sat Oct 17 16:02:18 2026 +0200
+ *
+ * @brief Implement a blitz-based 2D Fast Fourier Transform of real signals
+ * using FFTW functions
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/sp/RFFT2D.h>
+#include <bob/sp/FFTWPlanCache.h>
+#include <bob/core/assert.h>
+#include <bob/core/array_copy.h>
+
+
+bob::sp::RFFT2DAbstract::RFFT2DAbstract(const size_t height, const size_t width):
+  m_height(height), m_width(width)
+{
+}
+
+bob::sp::RFFT2DAbstract::RFFT2DAbstract(const bob::sp::RFFT2DAbstract& other):
+  m_height(other.m_height), m_width(other.m_width)
+{
+}
+
+bob::sp::RFFT2DAbstract::~RFFT2DAbstract()
+{
+}
+
+bob::sp::RFFT2DAbstract&
+bob::sp::RFFT2DAbstract::operator=(const RFFT2DAbstract& other)
+{
+  if (this != &other) {
+    reset(other.m_height, other.m_width);
+  }
+  return *this;
+}
+
+bool bob::sp::RFFT2DAbstract::operator==(const bob::sp::RFFT2DAbstract& b) const
+{
+  return (this->m_height == b.m_height && this->m_width == b.m_width);
+}
+
+bool bob::sp::RFFT2DAbstract::operator!=(const bob::sp::RFFT2DAbstract& b) const
+{
+  return !(this->operator==(b));
+}
+
+void bob::sp::RFFT2DAbstract::reset(const size_t height, const size_t width)
+{
+  // Update the height and width
+  m_height = height;
+  m_width = width;
+}
+
+void bob::sp::RFFT2DAbstract::setHeight(const size_t height)
+{
+  m_height = height;
+}
+
+void bob::sp::RFFT2DAbstract::setWidth(const size_t width)
+{
+  m_width = width;
+}
+
+
+bob::sp::RFFT2D::RFFT2D():
+  bob::sp::RFFT2DAbstract(0,0)
+{
+}
+
+bob::sp::RFFT2D::RFFT2D(const size_t height, const size_t width):
+  bob::sp::RFFT2DAbstract(height, width)
+{
+}
+
+bob::sp::RFFT2D::RFFT2D(const bob::sp::RFFT2D& other):
+  bob::sp::RFFT2DAbstract(other)
+{
+}
+
+bob::sp::RFFT2D::~RFFT2D()
+{
+}
+
+void bob::sp::RFFT2D::operator()(const blitz::Array<double,2>& src, 
+  blitz::Array<std::complex<double>,2>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertSameShape(src, blitz::shape(m_height, m_width));
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, blitz::shape(m_height, getHalfWidth()));
+
+  // Use the cached plan for this shape
+  bob::sp::FFTWPlanCache::instance()->executeR2C(2, m_height, m_width,
+    src.data(), dst.data());
+}
+
+
+bob::sp::IRFFT2D::IRFFT2D():
+  bob::sp::RFFT2DAbstract(0,0)
+{
+}
+
+bob::sp::IRFFT2D::IRFFT2D(const size_t height, const size_t width):
+  bob::sp::RFFT2DAbstract(height, width)
+{
+}
+
+bob::sp::IRFFT2D::IRFFT2D(const bob::sp::IRFFT2D& other):
+  bob::sp::RFFT2DAbstract(other)
+{
+}
+
+bob::sp::IRFFT2D::~IRFFT2D()
+{
+}
+
+void bob::sp::IRFFT2D::operator()(const blitz::Array<std::complex<double>,2>& src, 
+  blitz::Array<double,2>& dst) const
+{
+  // check input
+  bob::core::array::assertCZeroBaseContiguous(src);
+  bob::core::array::assertSameShape(src, blitz::shape(m_height, getHalfWidth()));
+
+  // Check output
+  bob::core::array::assertCZeroBaseContiguous(dst);
+  bob::core::array::assertSameShape(dst, blitz::shape(m_height, m_width));
+
+  // The 2D complex-to-real transform of FFTW overwrites its input
+  blitz::Array<std::complex<double>,2> src_copy = bob::core::array::ccopy(src);
+  bob::sp::FFTWPlanCache::instance()->executeC2R(2, m_height, m_width,
+    src_copy.data(), dst.data());
+
+  // Rescale the result by the size of the input 
+  // (as this is not performed by FFTW)
+  dst /= static_cast<double>(m_width*m_height);
+}
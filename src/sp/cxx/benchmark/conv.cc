@@ -0,0 +1,126 @@
+/**
+ * @file sp/cxx/benchmark/conv.cc
+ * @date Sat Oct 17 19:20:37 2026 +0200
+ *
+ * @brief Benchmark of the direct and FFT-based convolution products, to
+ * locate the crossover between the two algorithms
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/core/array_random.h>
+#include <bob/sp/conv.h>
+
+#include <boost/random.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <iostream>
+
+static const char* algorithm_names[3] = {"auto", "direct", "FFT"};
+
+void benchmark_conv1D(const blitz::Array<double,1> a, const blitz::Array<double,1> b)
+{
+  blitz::Array<double,1> c(bob::sp::getConvOutputSize(a, b, bob::sp::Conv::Same));
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << "1D convolution of an array of dimension " << a.extent(0)
+    << " with a kernel of dimension " << b.extent(0) << "..." << std::endl;
+  for (int k=0; k<3; ++k)
+  {
+    t1 = boost::posix_time::microsec_clock::local_time();
+    bob::sp::conv(a, b, c, bob::sp::Conv::Same, (bob::sp::Conv::Algorithm)k);
+    t2 = boost::posix_time::microsec_clock::local_time();
+    diff = t2 - t1;
+    std::cout << "  " << algorithm_names[k] << " duration in (microseconds) " << diff.total_microseconds() << std::endl;
+  }
+}
+
+void benchmark_conv2D(const blitz::Array<double,2> A, const blitz::Array<double,2> B)
+{
+  blitz::Array<double,2> C(bob::sp::getConvOutputSize(A, B, bob::sp::Conv::Same));
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << "2D convolution of an array of dimension " << A.extent(0) << "x" << A.extent(1)
+    << " with a kernel of dimension " << B.extent(0) << "x" << B.extent(1) << "..." << std::endl;
+  for (int k=0; k<3; ++k)
+  {
+    t1 = boost::posix_time::microsec_clock::local_time();
+    bob::sp::conv(A, B, C, bob::sp::Conv::Same, (bob::sp::Conv::Algorithm)k);
+    t2 = boost::posix_time::microsec_clock::local_time();
+    diff = t2 - t1;
+    std::cout << "  " << algorithm_names[k] << " duration in (microseconds) " << diff.total_microseconds() << std::endl;
+  }
+}
+
+void benchmark_convSep(const blitz::Array<double,2> A, const blitz::Array<double,1> b)
+{
+  blitz::Array<double,2> C(A.shape());
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << "Separable convolution of an array of dimension " << A.extent(0) << "x" << A.extent(1)
+    << " with a kernel of dimension " << b.extent(0) << " (along both dimensions)..." << std::endl;
+  for (int k=0; k<3; ++k)
+  {
+    t1 = boost::posix_time::microsec_clock::local_time();
+    for (int dim=0; dim<2; ++dim)
+      bob::sp::convSep(A, b, C, dim, bob::sp::Conv::Same, (bob::sp::Conv::Algorithm)k);
+    t2 = boost::posix_time::microsec_clock::local_time();
+    diff = t2 - t1;
+    std::cout << "  " << algorithm_names[k] << " duration in (microseconds) " << diff.total_microseconds() << std::endl;
+  }
+}
+
+/**
+ * Main function
+ */
+int main(int argc, char** argv)
+{
+  boost::mt19937 rng(0);
+
+  blitz::Array<double,1> a(1000000);
+  bob::core::array::randn(rng, a);
+  int dims_1d[8] = {4, 8, 16, 32, 64, 128, 256, 1024};
+  for (int i=0; i<8; ++i)
+  {
+    blitz::Array<double,1> b(dims_1d[i]);
+    bob::core::array::randn(rng, b);
+    benchmark_conv1D(a, b);
+  }
+
+  blitz::Array<double,2> A(512, 512);
+  bob::core::array::randn(rng, A);
+  int dims_2d[7] = {3, 5, 7, 11, 15, 31, 63};
+  for (int i=0; i<7; ++i)
+  {
+    blitz::Array<double,2> B(dims_2d[i], dims_2d[i]);
+    bob::core::array::randn(rng, B);
+    benchmark_conv2D(A, B);
+  }
+
+  // the separable kernels cannot be larger than A
+  for (int i=0; i<8 && dims_1d[i]+1<=A.extent(0); ++i)
+  {
+    blitz::Array<double,1> b(dims_1d[i]+1);
+    bob::core::array::randn(rng, b);
+    benchmark_convSep(A, b);
+  }
+
+  return 0;
+}
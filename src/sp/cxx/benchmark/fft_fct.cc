@@ -30,6 +30,8 @@
 #include <bob/sp/DCT1DNaive.h>
 #include <bob/sp/DCT2D.h>
 #include <bob/sp/DCT2DNaive.h>
+#include <bob/sp/FFTWPlanCache.h>
+#include <fftw3.h>
 
 #include <boost/random.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -146,11 +148,156 @@ void benchmark_fft2D(const blitz::Array<std::complex<double>,2> t)
   std::cout << "  DFT duration in (microseconds) " << diff.total_microseconds() << std::endl;
 }
 
+/**
+ * Repeated 1D FFTs of the same length (e.g. one per frame of a
+ * spectrogram): a plan created and destroyed at each call vs. the plans
+ * cached by bob::sp::FFTWPlanCache, with several planning rigors
+ */
+void benchmark_plan_cache(const blitz::Array<std::complex<double>,1> t,
+  const int n_frames)
+{
+  const int M = t.extent(0);
+  blitz::Array<std::complex<double>,1> t_fft(M);
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+  boost::shared_ptr<bob::sp::FFTWPlanCache> cache = bob::sp::FFTWPlanCache::instance();
+
+  std::cout << n_frames << " 1D FFTs on arrays of dimension " << M << "..." << std::endl;
+
+  // a plan per call (FFTW_ESTIMATE)
+  fftw_complex* src_ = reinterpret_cast<fftw_complex*>(const_cast<std::complex<double>* >(t.data()));
+  fftw_complex* dst_ = reinterpret_cast<fftw_complex*>(t_fft.data());
+  t1 = boost::posix_time::microsec_clock::local_time();
+  for (int k=0; k<n_frames; ++k) {
+    fftw_plan p = fftw_plan_dft_1d(M, src_, dst_, FFTW_FORWARD, FFTW_ESTIMATE);
+    fftw_execute(p);
+    fftw_destroy_plan(p);
+  }
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  plan per call duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  const bob::sp::FFTWPlanCache::rigor_t rigors[3] = {bob::sp::FFTWPlanCache::ESTIMATE,
+    bob::sp::FFTWPlanCache::MEASURE, bob::sp::FFTWPlanCache::PATIENT};
+  const char* names[3] = {"ESTIMATE", "MEASURE", "PATIENT"};
+  bob::sp::FFT1D fft(M);
+  for (int r=0; r<3; ++r) {
+    cache->setRigor(rigors[r]);
+
+    // first call: creates the plan
+    t1 = boost::posix_time::microsec_clock::local_time();
+    fft(t, t_fft);
+    t2 = boost::posix_time::microsec_clock::local_time();
+    diff = t2 - t1;
+    std::cout << "  cached plan (" << names[r] << "): planning duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+    // next calls: reuse the plan
+    t1 = boost::posix_time::microsec_clock::local_time();
+    for (int k=0; k<n_frames; ++k) fft(t, t_fft);
+    t2 = boost::posix_time::microsec_clock::local_time();
+    diff = t2 - t1;
+    std::cout << "  cached plan (" << names[r] << "): duration in (microseconds) " << diff.total_microseconds() << std::endl;
+  }
+  cache->setRigor(bob::sp::FFTWPlanCache::ESTIMATE);
+}
+
+/**
+ * 1D FFTs of many frames of the same length (one per row): one FFT per
+ * frame in a loop vs. a single batched FFT of all the frames
+ */
+void benchmark_batch_fft1D(const blitz::Array<std::complex<double>,2> t)
+{
+  const int n_frames = t.extent(0);
+  const int M = t.extent(1);
+  blitz::Array<std::complex<double>,2> t_loop(n_frames, M), t_batch(n_frames, M);
+  blitz::Array<std::complex<double>,1> frame(M), frame_fft(M);
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << n_frames << " 1D FFTs of frames of dimension " << M << "..." << std::endl;
+
+  bob::sp::FFT1D fft(M);
+  // create the plans beforehand
+  frame = t(0, blitz::Range::all());
+  fft(frame, frame_fft);
+  fft(t, t_batch);
+
+  // loop over the frames
+  t1 = boost::posix_time::microsec_clock::local_time();
+  for (int k=0; k<n_frames; ++k) {
+    frame = t(k, blitz::Range::all());
+    fft(frame, frame_fft);
+    t_loop(k, blitz::Range::all()) = frame_fft;
+  }
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  loop duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  // batched FFT
+  t1 = boost::posix_time::microsec_clock::local_time();
+  fft(t, t_batch);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  batch duration in (microseconds) " << diff.total_microseconds() << std::endl;
+}
+
+/**
+ * 2D DCTs of many blocks of the same shape (e.g. DCT features): one DCT per
+ * block in a loop vs. a single batched DCT of the stack of blocks
+ */
+void benchmark_batch_dct2D(const blitz::Array<double,3> t)
+{
+  const int n_blocks = t.extent(0);
+  const int M = t.extent(1);
+  const int N = t.extent(2);
+  blitz::Array<double,3> t_loop(n_blocks, M, N), t_batch(n_blocks, M, N);
+  blitz::Array<double,2> block(M, N), block_dct(M, N);
+  boost::posix_time::ptime t1;
+  boost::posix_time::ptime t2;
+  boost::posix_time::time_duration diff;
+
+  std::cout << n_blocks << " 2D DCTs of blocks of dimension " << M << "x" << N << "..." << std::endl;
+
+  bob::sp::DCT2D dct(M, N);
+  // create the plans beforehand
+  block = t(0, blitz::Range::all(), blitz::Range::all());
+  dct(block, block_dct);
+  dct(t, t_batch);
+
+  // loop over the blocks
+  t1 = boost::posix_time::microsec_clock::local_time();
+  for (int k=0; k<n_blocks; ++k) {
+    block = t(k, blitz::Range::all(), blitz::Range::all());
+    dct(block, block_dct);
+    t_loop(k, blitz::Range::all(), blitz::Range::all()) = block_dct;
+  }
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  loop duration in (microseconds) " << diff.total_microseconds() << std::endl;
+
+  // batched DCT
+  t1 = boost::posix_time::microsec_clock::local_time();
+  dct(t, t_batch);
+  t2 = boost::posix_time::microsec_clock::local_time();
+  diff = t2 - t1;
+  std::cout << "  batch duration in (microseconds) " << diff.total_microseconds() << std::endl;
+}
+
 /*************** FCT Tests *****************/
-int main()
+/**
+ * An optional argument is the name of a FFTW wisdom file, which is imported
+ * (if it exists) before and exported after the benchmark
+ */
+int main(int argc, char** argv)
 {
   boost::mt19937 rng(0);
 
+  boost::shared_ptr<bob::sp::FFTWPlanCache> cache = bob::sp::FFTWPlanCache::instance();
+  if (argc > 1 && cache->importWisdom(argv[1]))
+    std::cout << "Imported FFTW wisdom from " << argv[1] << std::endl;
+
   int dims[5] = {16, 64, 128, 256, 512};
   for(int i=0; i<5; ++i)
   {
@@ -194,5 +341,41 @@ int main()
     benchmark_fft2D(t_2d);
   }
 
+  int frame_dims[3] = {256, 400, 512};
+  for(int i=0; i<3; ++i)
+  {
+    const int M = frame_dims[i];
+    // 1D array
+    blitz::Array<double,1> t_d_1d(M);
+    bob::core::array::randn(rng, t_d_1d);
+    blitz::Array<std::complex<double>,1> t_1d = bob::core::array::cast<std::complex<double> >(t_d_1d);
+    // Benchmark
+    benchmark_plan_cache(t_1d, 10000);
+  }
+
+  for(int i=0; i<3; ++i)
+  {
+    const int M = frame_dims[i];
+    // 2D array (one frame per row)
+    blitz::Array<double,2> t_d_2d(10000, M);
+    bob::core::array::randn(rng, t_d_2d);
+    blitz::Array<std::complex<double>,2> t_2d = bob::core::array::cast<std::complex<double> >(t_d_2d);
+    // Benchmark
+    benchmark_batch_fft1D(t_2d);
+  }
+
+  int block_dims[3] = {8, 12, 16};
+  for(int i=0; i<3; ++i)
+  {
+    const int M = block_dims[i];
+    // 3D array (stack of blocks)
+    blitz::Array<double,3> t_d_3d(20000, M, M);
+    bob::core::array::randn(rng, t_d_3d);
+    // Benchmark
+    benchmark_batch_dct2D(t_d_3d);
+  }
+
+  if (argc > 1) cache->exportWisdom(argv[1]);
+
   return 0;
 }
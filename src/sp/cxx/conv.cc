@@ -0,0 +1,218 @@
+/**
+ * @file sp/cxx/conv.cc
+ * @date Sat Oct 17 19:20:37 2026 +0200
+ *
+ * @brief FFT-based convolution products of double arrays
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/sp/conv.h>
+#include <bob/sp/RFFT1D.h>
+#include <bob/sp/RFFT2D.h>
+#include <cmath>
+
+/**
+ * Cost of a FFT of size L, in units of L*log2(L), relative to the one of
+ * the multiply-add of the direct convolution. This is the crossover
+ * measured by the sp_conv benchmark.
+ */
+static const double s_fft_cost = 3.;
+
+/**
+ * Returns the smallest size larger than or equal to n, whose only prime
+ * factors are 2, 3 and 5 (for which FFTW is the fastest)
+ */
+static int fftSize(const int n)
+{
+  for (int m=std::max(n,1); ; ++m)
+  {
+    int r = m;
+    while (r % 2 == 0) r /= 2;
+    while (r % 3 == 0) r /= 3;
+    while (r % 5 == 0) r /= 5;
+    if (r == 1) return m;
+  }
+}
+
+/**
+ * Returns the number of operations of a FFT of size L
+ */
+static double fftOps(const double L)
+{
+  return s_fft_cost * L * std::max(1., std::log(L) / std::log(2.));
+}
+
+/**
+ * Tells if the FFT-based algorithm should be used
+ */
+static bool useFFT(const bob::sp::Conv::Algorithm algorithm,
+  const double direct_ops, const double fft_ops)
+{
+  if (algorithm == bob::sp::Conv::Direct) return false;
+  if (algorithm == bob::sp::Conv::FFT) return true;
+  return direct_ops > fft_ops;
+}
+
+/**
+ * Pointwise product of the rows of spectra with the spectrum of the kernel
+ */
+static void multiplySpectra(blitz::Array<std::complex<double>,2>& spectra,
+  const blitz::Array<std::complex<double>,1>& kernel)
+{
+  for (int i=0; i<spectra.extent(0); ++i)
+  {
+    std::complex<double>* s = &spectra(i,0);
+    const std::complex<double>* k = kernel.data();
+    for (int j=0; j<spectra.extent(1); ++j) s[j] *= k[j];
+  }
+}
+
+bool bob::sp::detail::ConvFFT<double>::conv(const blitz::Array<double,1>& a,
+  const blitz::Array<double,1>& b, blitz::Array<double,1>& c,
+  const int shift, const bob::sp::Conv::Algorithm algorithm)
+{
+  const int M = a.extent(0);
+  const int N = b.extent(0);
+  const int P = c.extent(0);
+  const int n_full = M+N-1;
+
+  // Overlap-add: the input is split into blocks of L-N+1 samples, whose
+  // convolutions (of L samples) are computed with FFTs of size L. The size
+  // is a few times the one of the kernel, unless a single block is enough.
+  int L = 64;
+  while (L < 4*N) L *= 2;
+  if (L >= n_full) L = fftSize(n_full);
+  const int block = L-N+1;
+  const int n_blocks = (M + block - 1) / block;
+  const double direct_ops = (double)P * N;
+  if (!useFFT(algorithm, direct_ops, (2.*n_blocks + 1.) * fftOps(L)))
+    return false;
+
+  bob::sp::RFFT1D fft(L);
+  bob::sp::IRFFT1D ifft(L);
+  const int H = fft.getHalfLength();
+
+  // Spectrum of the zero-padded kernel
+  blitz::Array<double,1> b_pad(L);
+  blitz::Array<std::complex<double>,1> b_fft(H);
+  b_pad = 0.;
+  b_pad(blitz::Range(0,N-1)) = b;
+  fft(b_pad, b_fft);
+
+  // Zero-padded blocks of the input, transformed with a single batched FFT
+  blitz::Array<double,2> blocks(n_blocks, L);
+  blitz::Array<std::complex<double>,2> blocks_fft(n_blocks, H);
+  blocks = 0.;
+  for (int k=0; k<n_blocks; ++k)
+  {
+    const int n = std::min(block, M - k*block);
+    blocks(k, blitz::Range(0,n-1)) = a(blitz::Range(k*block, k*block+n-1));
+  }
+  fft(blocks, blocks_fft);
+  multiplySpectra(blocks_fft, b_fft);
+  ifft(blocks_fft, blocks);
+
+  // Overlap-add of the convolutions of the blocks
+  blitz::Array<double,1> full(n_full);
+  full = 0.;
+  for (int k=0; k<n_blocks; ++k)
+  {
+    const int n = std::min(L, n_full - k*block);
+    full(blitz::Range(k*block, k*block+n-1)) += blocks(k, blitz::Range(0,n-1));
+  }
+  c = full(blitz::Range(shift, shift+P-1));
+  return true;
+}
+
+bool bob::sp::detail::ConvFFT<double>::conv(const blitz::Array<double,2>& A,
+  const blitz::Array<double,2>& B, blitz::Array<double,2>& C,
+  const int shift0, const int shift1, const bob::sp::Conv::Algorithm algorithm)
+{
+  const int M0 = A.extent(0);
+  const int M1 = A.extent(1);
+  const int N0 = B.extent(0);
+  const int N1 = B.extent(1);
+  const int P0 = C.extent(0);
+  const int P1 = C.extent(1);
+
+  // Product of the transforms of the arrays, zero-padded to the size of
+  // the full convolution
+  const int L0 = fftSize(M0+N0-1);
+  const int L1 = fftSize(M1+N1-1);
+  const double direct_ops = (double)P0 * P1 * N0 * N1;
+  if (!useFFT(algorithm, direct_ops, 3. * fftOps((double)L0 * L1)))
+    return false;
+
+  bob::sp::RFFT2D fft(L0, L1);
+  bob::sp::IRFFT2D ifft(L0, L1);
+  const int H1 = fft.getHalfWidth();
+
+  blitz::Array<double,2> pad(L0, L1);
+  blitz::Array<std::complex<double>,2> A_fft(L0, H1), B_fft(L0, H1);
+  pad = 0.;
+  pad(blitz::Range(0,N0-1), blitz::Range(0,N1-1)) = B;
+  fft(pad, B_fft);
+  pad = 0.;
+  pad(blitz::Range(0,M0-1), blitz::Range(0,M1-1)) = A;
+  fft(pad, A_fft);
+  A_fft *= B_fft;
+  ifft(A_fft, pad);
+
+  C = pad(blitz::Range(shift0, shift0+P0-1), blitz::Range(shift1, shift1+P1-1));
+  return true;
+}
+
+bool bob::sp::detail::ConvFFT<double>::convSep(const blitz::Array<double,2>& A,
+  const blitz::Array<double,1>& b, blitz::Array<double,2>& C,
+  const int shift, const bob::sp::Conv::Algorithm algorithm)
+{
+  const int M = A.extent(0);
+  const int N = b.extent(0);
+  const int P = C.extent(0);
+  const int n_lines = A.extent(1);
+
+  // Batched transforms of all the columns of A, zero-padded to the size of
+  // the full convolution
+  const int L = fftSize(M+N-1);
+  const double direct_ops = (double)P * N * n_lines;
+  if (!useFFT(algorithm, direct_ops, (2.*n_lines + 1.) * fftOps(L)))
+    return false;
+
+  bob::sp::RFFT1D fft(L);
+  bob::sp::IRFFT1D ifft(L);
+  const int H = fft.getHalfLength();
+
+  blitz::Array<double,1> b_pad(L);
+  blitz::Array<std::complex<double>,1> b_fft(H);
+  b_pad = 0.;
+  b_pad(blitz::Range(0,N-1)) = b;
+  fft(b_pad, b_fft);
+
+  blitz::Array<double,2> lines(n_lines, L);
+  blitz::Array<std::complex<double>,2> lines_fft(n_lines, H);
+  lines = 0.;
+  // Ugly fix to support old blitz versions without const transpose()
+  // method
+  lines(blitz::Range::all(), blitz::Range(0,M-1)) =
+    (const_cast<blitz::Array<double,2>*>(&A))->transpose(1,0);
+  fft(lines, lines_fft);
+  multiplySpectra(lines_fft, b_fft);
+  ifft(lines_fft, lines);
+
+  blitz::Array<double,2> Ct = C.transpose(1,0);
+  Ct = lines(blitz::Range::all(), blitz::Range(shift, shift+P-1));
+  return true;
+}
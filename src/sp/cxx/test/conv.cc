@@ -27,6 +27,7 @@
 #include <boost/test/floating_point_comparison.hpp>
 
 #include <bob/sp/conv.h>
+#include <cmath>
 
 struct T {
   blitz::Array<double,1> A1_10;
@@ -423,4 +424,101 @@ BOOST_AUTO_TEST_CASE( test_convolve_2D_3x4_2x2 )
     bob::sp::Conv::Valid);
 }
 
+// The FFT-based and direct convolutions give the same results, for all the
+// size options and sizes of kernels on both sides of the crossover
+static const bob::sp::Conv::SizeOption size_opts[3] =
+  { bob::sp::Conv::Full, bob::sp::Conv::Same, bob::sp::Conv::Valid };
+
+BOOST_AUTO_TEST_CASE( test_convolve_1D_fft )
+{
+  blitz::Array<double,1> a(1000);
+  for (int i=0; i<a.extent(0); ++i) a(i) = sin(0.37*i) + cos(0.011*i*i);
+  const int kernel_sizes[4] = {1, 6, 31, 256};
+  for (int k=0; k<4; ++k)
+  {
+    blitz::Array<double,1> b(kernel_sizes[k]);
+    for (int i=0; i<b.extent(0); ++i) b(i) = cos(1.3*i) / b.extent(0);
+    for (int o=0; o<3; ++o)
+    {
+      blitz::Array<double,1> res_direct(bob::sp::getConvOutputSize(a, b, size_opts[o]));
+      blitz::Array<double,1> res_fft(res_direct.shape()), res_auto(res_direct.shape());
+      bob::sp::conv(a, b, res_direct, size_opts[o], bob::sp::Conv::Direct);
+      bob::sp::conv(a, b, res_fft, size_opts[o], bob::sp::Conv::FFT);
+      bob::sp::conv(a, b, res_auto, size_opts[o], bob::sp::Conv::Auto);
+      for (int i=0; i<res_direct.extent(0); ++i)
+      {
+        BOOST_CHECK_SMALL(res_fft(i) - res_direct(i), 1e-10);
+        BOOST_CHECK_SMALL(res_auto(i) - res_direct(i), 1e-10);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_convolve_2D_fft )
+{
+  blitz::Array<double,2> A(47, 60);
+  for (int i=0; i<A.extent(0); ++i)
+    for (int j=0; j<A.extent(1); ++j)
+      A(i,j) = sin(0.37*i + 2.1*j) + cos(0.011*i*j);
+  const int kernel_sizes[3][2] = {{1, 1}, {3, 4}, {21, 17}};
+  for (int k=0; k<3; ++k)
+  {
+    blitz::Array<double,2> B(kernel_sizes[k][0], kernel_sizes[k][1]);
+    for (int i=0; i<B.extent(0); ++i)
+      for (int j=0; j<B.extent(1); ++j)
+        B(i,j) = cos(1.3*i - 0.4*j) / B.size();
+    for (int o=0; o<3; ++o)
+    {
+      blitz::Array<double,2> res_direct(bob::sp::getConvOutputSize(A, B, size_opts[o]));
+      blitz::Array<double,2> res_fft(res_direct.shape()), res_auto(res_direct.shape());
+      bob::sp::conv(A, B, res_direct, size_opts[o], bob::sp::Conv::Direct);
+      bob::sp::conv(A, B, res_fft, size_opts[o], bob::sp::Conv::FFT);
+      bob::sp::conv(A, B, res_auto, size_opts[o], bob::sp::Conv::Auto);
+      for (int i=0; i<res_direct.extent(0); ++i)
+        for (int j=0; j<res_direct.extent(1); ++j)
+        {
+          BOOST_CHECK_SMALL(res_fft(i,j) - res_direct(i,j), 1e-10);
+          BOOST_CHECK_SMALL(res_auto(i,j) - res_direct(i,j), 1e-10);
+        }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( test_convolve_sep_fft )
+{
+  blitz::Array<double,3> A(37, 45, 17);
+  for (int i=0; i<A.extent(0); ++i)
+    for (int j=0; j<A.extent(1); ++j)
+      for (int l=0; l<A.extent(2); ++l)
+        A(i,j,l) = sin(0.37*i + 2.1*j - l) + cos(0.011*i*j);
+  blitz::Array<double,1> b(13);
+  for (int i=0; i<b.extent(0); ++i) b(i) = cos(1.3*i) / b.extent(0);
+  for (int dim=0; dim<3; ++dim)
+    for (int o=0; o<3; ++o)
+    {
+      blitz::Array<double,3> res_direct(bob::sp::getConvSepOutputSize(A, b, dim, size_opts[o]));
+      blitz::Array<double,3> res_fft(res_direct.shape()), res_auto(res_direct.shape()), res_lines(res_direct.shape());
+      bob::sp::convSep(A, b, res_direct, dim, size_opts[o], bob::sp::Conv::Direct);
+      bob::sp::convSep(A, b, res_fft, dim, size_opts[o], bob::sp::Conv::FFT);
+      bob::sp::convSep(A, b, res_auto, dim, size_opts[o], bob::sp::Conv::Auto);
+      // Reference: 1D convolution of each line
+      blitz::TinyVector<int,3> index;
+      for (index(0)=0; index(0)<res_lines.extent(0); ++index(0))
+        for (index(1)=0; index(1)<res_lines.extent(1); ++index(1))
+          for (index(2)=0; index(2)<res_lines.extent(2); ++index(2))
+            if (index(dim) == 0)
+            {
+              blitz::Array<double,1> line(A.extent(dim));
+              blitz::TinyVector<int,3> k = index;
+              for (k(dim)=0; k(dim)<A.extent(dim); ++k(dim)) line(k(dim)) = A(k);
+              blitz::Array<double,1> line_res(res_lines.extent(dim));
+              bob::sp::conv(line, b, line_res, size_opts[o], bob::sp::Conv::Direct);
+              for (k(dim)=0; k(dim)<res_lines.extent(dim); ++k(dim)) res_lines(k) = line_res(k(dim));
+            }
+      BOOST_CHECK_SMALL(blitz::max(blitz::abs(res_direct - res_lines)), 1e-10);
+      BOOST_CHECK_SMALL(blitz::max(blitz::abs(res_fft - res_lines)), 1e-10);
+      BOOST_CHECK_SMALL(blitz::max(blitz::abs(res_auto - res_lines)), 1e-10);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
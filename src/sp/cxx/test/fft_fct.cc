@@ -36,6 +36,9 @@
 #include <bob/sp/DCT1DNaive.h>
 #include <bob/sp/DCT2D.h>
 #include <bob/sp/DCT2DNaive.h>
+#include <bob/sp/FFTWPlanCache.h>
+#include <bob/sp/RFFT1D.h>
+#include <vector>
 // Random number
 #include <cstdlib>
 
@@ -489,4 +492,137 @@ BOOST_AUTO_TEST_CASE( test_fftshift2D_random )
   }
 }
 
+BOOST_AUTO_TEST_CASE( test_fftw_plan_cache )
+{
+  boost::shared_ptr<bob::sp::FFTWPlanCache> cache = bob::sp::FFTWPlanCache::instance();
+  cache->setRigor(bob::sp::FFTWPlanCache::MEASURE);
+  const int N = 60;
+
+  // Reference on aligned (blitz-allocated) arrays
+  blitz::Array<std::complex<double>,1> t(N), t_ref(N);
+  for (int i=0; i<N; ++i)
+    t(i) = std::complex<double>((rand()/(double)RAND_MAX)*10.,0);
+  bob::sp::FFT1D fft(N);
+  fft(t, t_ref);
+  const size_t n_plans = cache->size();
+  fft(t, t_ref);
+  BOOST_CHECK_EQUAL( cache->size(), n_plans );
+
+  // The same transform on arrays which are not aligned as the plan buffers
+  std::vector<double> buffer(4*N+2);
+  blitz::Array<std::complex<double>,1> u(
+    reinterpret_cast<std::complex<double>*>(&buffer[1]), blitz::shape(N),
+    blitz::neverDeleteData);
+  blitz::Array<std::complex<double>,1> u_fft(
+    reinterpret_cast<std::complex<double>*>(&buffer[2*N+1]), blitz::shape(N),
+    blitz::neverDeleteData);
+  u = t;
+  fft(u, u_fft);
+  for (int i=0; i<N; ++i)
+    BOOST_CHECK_SMALL( abs(u_fft(i)-t_ref(i)), eps);
+
+  // Planning does not overwrite the input
+  for (int i=0; i<N; ++i)
+    BOOST_CHECK_EQUAL( u(i), t(i) );
+
+  cache->setRigor(bob::sp::FFTWPlanCache::ESTIMATE);
+}
+
+BOOST_AUTO_TEST_CASE( test_fftw_plan_cache_batches )
+{
+  boost::shared_ptr<bob::sp::FFTWPlanCache> cache = bob::sp::FFTWPlanCache::instance();
+  const int N = 23;
+  const int max_howmany = 150;
+  blitz::Array<std::complex<double>,2> t(max_howmany, N), t_fft(max_howmany, N);
+  for (int k=0; k<max_howmany; ++k)
+    for (int i=0; i<N; ++i)
+      t(k,i) = std::complex<double>((rand()/(double)RAND_MAX)*10.,0);
+
+  // Reference, one transform at a time
+  blitz::Array<std::complex<double>,2> t_ref(max_howmany, N);
+  cache->executeDFT(bob::sp::FFTWPlanCache::DFT_FORWARD, 1, N, 0,
+    t.data(), t_ref.data(), max_howmany);
+  const size_t n_plans = cache->size();
+
+  // Whatever the number of transforms, no new plan is created
+  for (int howmany=1; howmany<=max_howmany; ++howmany) {
+    cache->executeDFT(bob::sp::FFTWPlanCache::DFT_FORWARD, 1, N, 0,
+      t.data(), t_fft.data(), howmany);
+    for (int k=0; k<howmany; ++k)
+      for (int i=0; i<N; ++i)
+        BOOST_CHECK_SMALL( abs(t_fft(k,i)-t_ref(k,i)), eps);
+  }
+  BOOST_CHECK_EQUAL( cache->size(), n_plans );
+}
+
+BOOST_AUTO_TEST_CASE( test_batch_fft1D )
+{
+  const int n_frames = 37;
+  const int N = 50;
+  blitz::Array<std::complex<double>,2> t(n_frames, N), t_fft(n_frames, N), t_ifft(n_frames, N);
+  blitz::Array<double,2> t_real(n_frames, N), t_real_ifft(n_frames, N);
+  blitz::Array<std::complex<double>,2> t_rfft(n_frames, N/2+1);
+  for (int k=0; k<n_frames; ++k)
+    for (int i=0; i<N; ++i) {
+      t_real(k,i) = (rand()/(double)RAND_MAX)*10.;
+      t(k,i) = std::complex<double>(t_real(k,i), (rand()/(double)RAND_MAX)*10.);
+    }
+
+  // The batched transforms give the same results as one transform per row
+  bob::sp::FFT1D fft(N);
+  bob::sp::IFFT1D ifft(N);
+  bob::sp::RFFT1D rfft(N);
+  fft(t, t_fft);
+  ifft(t_fft, t_ifft);
+  rfft(t_real, t_rfft);
+  blitz::Array<std::complex<double>,1> frame(N), frame_fft(N), frame_rfft(N/2+1);
+  blitz::Array<double,1> frame_real(N);
+  for (int k=0; k<n_frames; ++k) {
+    frame = t(k, blitz::Range::all());
+    fft(frame, frame_fft);
+    frame_real = t_real(k, blitz::Range::all());
+    rfft(frame_real, frame_rfft);
+    for (int i=0; i<N; ++i) {
+      BOOST_CHECK_SMALL( abs(t_fft(k,i)-frame_fft(i)), eps);
+      BOOST_CHECK_SMALL( abs(t_ifft(k,i)-t(k,i)), eps);
+    }
+    for (int i=0; i<N/2+1; ++i)
+      BOOST_CHECK_SMALL( abs(t_rfft(k,i)-frame_rfft(i)), eps);
+  }
+
+  bob::sp::IRFFT1D irfft(N);
+  irfft(t_rfft, t_real_ifft);
+  for (int k=0; k<n_frames; ++k)
+    for (int i=0; i<N; ++i)
+      BOOST_CHECK_SMALL( fabs(t_real_ifft(k,i)-t_real(k,i)), eps);
+}
+
+BOOST_AUTO_TEST_CASE( test_batch_dct2D )
+{
+  const int n_blocks = 23;
+  const int M = 8;
+  const int N = 6;
+  blitz::Array<double,3> t(n_blocks, M, N), t_dct(n_blocks, M, N), t_idct(n_blocks, M, N);
+  for (int k=0; k<n_blocks; ++k)
+    for (int i=0; i<M; ++i)
+      for (int j=0; j<N; ++j)
+        t(k,i,j) = (rand()/(double)RAND_MAX)*10.;
+
+  // The batched transforms give the same results as one transform per block
+  bob::sp::DCT2D dct(M, N);
+  bob::sp::IDCT2D idct(M, N);
+  dct(t, t_dct);
+  idct(t_dct, t_idct);
+  blitz::Array<double,2> block(M, N), block_dct(M, N);
+  for (int k=0; k<n_blocks; ++k) {
+    block = t(k, blitz::Range::all(), blitz::Range::all());
+    dct(block, block_dct);
+    for (int i=0; i<M; ++i)
+      for (int j=0; j<N; ++j) {
+        BOOST_CHECK_SMALL( fabs(t_dct(k,i,j)-block_dct(i,j)), eps);
+        BOOST_CHECK_SMALL( fabs(t_idct(k,i,j)-t(k,i,j)), eps);
+      }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -75,12 +75,24 @@ static object py_idct1d_p(bob::sp::IDCT1D& op, bob::python::const_ndarray src)
 static void py_dct2d_c(bob::sp::DCT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
+  if (src.type().nd == 3) { // stack of 2D arrays
+    blitz::Array<double,3> dst_ = dst.bz<double,3>();
+    op(src.bz<double,3>(), dst_);
+    return;
+  }
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
   op(src.bz<double,2>(), dst_);
 }
 
 static object py_dct2d_p(bob::sp::DCT2D& op, bob::python::const_ndarray src)
 {
+  if (src.type().nd == 3) { // stack of 2D arrays
+    bob::python::ndarray dst(bob::core::array::t_float64, src.type().shape[0],
+      op.getHeight(), op.getWidth());
+    blitz::Array<double,3> dst_ = dst.bz<double,3>();
+    op(src.bz<double,3>(), dst_);
+    return dst.self();
+  }
   bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
     op.getWidth());
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
@@ -91,12 +103,24 @@ static object py_dct2d_p(bob::sp::DCT2D& op, bob::python::const_ndarray src)
 static void py_idct2d_c(bob::sp::IDCT2D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
+  if (src.type().nd == 3) { // stack of 2D arrays
+    blitz::Array<double,3> dst_ = dst.bz<double,3>();
+    op(src.bz<double,3>(), dst_);
+    return;
+  }
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
   op(src.bz<double,2>(), dst_);
 }
 
 static object py_idct2d_p(bob::sp::IDCT2D& op, bob::python::const_ndarray src)
 {
+  if (src.type().nd == 3) { // stack of 2D arrays
+    bob::python::ndarray dst(bob::core::array::t_float64, src.type().shape[0],
+      op.getHeight(), op.getWidth());
+    blitz::Array<double,3> dst_ = dst.bz<double,3>();
+    op(src.bz<double,3>(), dst_);
+    return dst.self();
+  }
   bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
     op.getWidth());
   blitz::Array<double,2> dst_ = dst.bz<double,2>();
@@ -189,16 +213,16 @@ void bind_sp_dct()
       .def(init<bob::sp::DCT2D&>((arg("self"), arg("other"))))
       .def(self == self)
       .def(self != self)
-      .def("__call__", &py_dct2d_c, (arg("self"), arg("input"), arg("output")), "Compute the DCT of the input 2D array/signal. The output should have the expected size and type (numpy.float64).")
-      .def("__call__", &py_dct2d_p, (arg("self"), arg("input")), "Compute the DCT of the input 2D array/signal. The output is allocated and returned.")
+      .def("__call__", &py_dct2d_c, (arg("self"), arg("input"), arg("output")), "Compute the DCT of the input 2D array/signal, or of each 2D array of the input 3D stack (all the arrays being transformed with a single call to FFTW). The output should have the expected size and type (numpy.float64).")
+      .def("__call__", &py_dct2d_p, (arg("self"), arg("input")), "Compute the DCT of the input 2D array/signal, or of each 2D array of the input 3D stack. The output is allocated and returned.")
     ;
 
   class_<bob::sp::IDCT2D, boost::shared_ptr<bob::sp::IDCT2D>, bases<bob::sp::DCT2DAbstract> >("IDCT2D", IDCT2D_DOC, init<const size_t, const size_t>((arg("self"), arg("height"), arg("width"))))
       .def(init<bob::sp::IDCT2D&>((arg("self"), arg("other"))))
       .def(self == self)
       .def(self != self)
-      .def("__call__", &py_idct2d_c, (arg("self"), arg("input"), arg("output")), "Compute the inverse DCT of the input 2D array/signal. The output should have the expected size and type (numpy.float64).")
-      .def("__call__", &py_idct2d_p, (arg("self"), arg("input")), "Compute the inverse DCT of the input 2D array/signal. The output is allocated and returned.")
+      .def("__call__", &py_idct2d_c, (arg("self"), arg("input"), arg("output")), "Compute the inverse DCT of the input 2D array/signal, or of each 2D array of the input 3D stack (all the arrays being transformed with a single call to FFTW). The output should have the expected size and type (numpy.float64).")
+      .def("__call__", &py_idct2d_p, (arg("self"), arg("input")), "Compute the inverse DCT of the input 2D array/signal, or of each 2D array of the input 3D stack. The output is allocated and returned.")
     ;
 
   // dct function-like
@@ -25,9 +25,12 @@
 
 #include <bob/sp/FFT1D.h>
 #include <bob/sp/FFT2D.h>
+#include <bob/sp/RFFT1D.h>
+#include <bob/sp/RFFT2D.h>
 #include <bob/sp/FFT1DNaive.h>
 #include <bob/sp/FFT2DNaive.h>
 #include <bob/sp/fftshift.h>
+#include <bob/sp/FFTWPlanCache.h>
 
 
 using namespace boost::python;
@@ -37,6 +40,10 @@ static const char* FFT1D_DOC = "Objects of this class, after configuration, can
 static const char* IFFT1D_DOC = "Objects of this class, after configuration, can compute the inverse FFT of a 1D array/signal.";
 static const char* FFT2D_DOC = "Objects of this class, after configuration, can compute the direct FFT of a 2D array/signal.";
 static const char* IFFT2D_DOC = "Objects of this class, after configuration, can compute the inverse FFT of a 2D array/signal.";
+static const char* RFFT1D_DOC = "Objects of this class, after configuration, can compute the direct FFT of a real 1D array/signal of length N. Only the N/2+1 first (non-redundant) coefficients of the Hermitian spectrum are computed.";
+static const char* IRFFT1D_DOC = "Objects of this class, after configuration, can compute the inverse FFT of the N/2+1 first coefficients of a Hermitian spectrum, returning a real 1D array/signal of length N.";
+static const char* RFFT2D_DOC = "Objects of this class, after configuration, can compute the direct FFT of a real HxW 2D array/signal. Only the Hx(W/2+1) first (non-redundant) coefficients of the Hermitian spectrum are computed.";
+static const char* IRFFT2D_DOC = "Objects of this class, after configuration, can compute the inverse FFT of the Hx(W/2+1) first coefficients of a Hermitian spectrum, returning a real HxW 2D array/signal.";
  
 // free methods documentation
 static const char* FFT_DOC = "Compute the direct FFT of a 1 or 2D array/signal of type complex128.";
@@ -49,12 +56,24 @@ static const char* IFFTSHIFT_DOC = "This method undo what fftshift() does. Accep
 static void py_fft1d_c(bob::sp::FFT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
+  if (src.type().nd == 2) { // one signal per row
+    blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
+    op(src.bz<std::complex<double>,2>(), dst_);
+    return;
+  }
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
   op(src.bz<std::complex<double>,1>(), dst_);
 }
 
 static object py_fft1d_p(bob::sp::FFT1D& op, bob::python::const_ndarray src)
 {
+  if (src.type().nd == 2) { // one signal per row
+    bob::python::ndarray dst(bob::core::array::t_complex128, 
+      src.type().shape[0], op.getLength());
+    blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
+    op(src.bz<std::complex<double>,2>(), dst_);
+    return dst.self();
+  }
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getLength());
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
   op(src.bz<std::complex<double>,1>(), dst_);
@@ -64,12 +83,24 @@ static object py_fft1d_p(bob::sp::FFT1D& op, bob::python::const_ndarray src)
 static void py_ifft1d_c(bob::sp::IFFT1D& op, bob::python::const_ndarray src,
   bob::python::ndarray dst) 
 {
+  if (src.type().nd == 2) { // one signal per row
+    blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
+    op(src.bz<std::complex<double>,2>(), dst_);
+    return;
+  }
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
   op(src.bz<std::complex<double>,1>(), dst_);
 }
 
 static object py_ifft1d_p(bob::sp::IFFT1D& op, bob::python::const_ndarray src)
 {
+  if (src.type().nd == 2) { // one signal per row
+    bob::python::ndarray dst(bob::core::array::t_complex128, 
+      src.type().shape[0], op.getLength());
+    blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
+    op(src.bz<std::complex<double>,2>(), dst_);
+    return dst.self();
+  }
   bob::python::ndarray dst(bob::core::array::t_complex128, op.getLength());
   blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
   op(src.bz<std::complex<double>,1>(), dst_);
@@ -109,6 +140,68 @@ static object py_ifft2d_p(bob::sp::IFFT2D& op, bob::python::const_ndarray src)
   return dst.self();
 }
 
+static void py_rfft1d_c(bob::sp::RFFT1D& op, bob::python::const_ndarray src,
+  bob::python::ndarray dst) 
+{
+  blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
+  op(src.bz<double,1>(), dst_);
+}
+
+static object py_rfft1d_p(bob::sp::RFFT1D& op, bob::python::const_ndarray src)
+{
+  bob::python::ndarray dst(bob::core::array::t_complex128, op.getHalfLength());
+  blitz::Array<std::complex<double>,1> dst_ = dst.bz<std::complex<double>,1>();
+  op(src.bz<double,1>(), dst_);
+  return dst.self();
+}
+
+static void py_irfft1d_c(bob::sp::IRFFT1D& op, bob::python::const_ndarray src,
+  bob::python::ndarray dst) 
+{
+  blitz::Array<double,1> dst_ = dst.bz<double,1>();
+  op(src.bz<std::complex<double>,1>(), dst_);
+}
+
+static object py_irfft1d_p(bob::sp::IRFFT1D& op, bob::python::const_ndarray src)
+{
+  bob::python::ndarray dst(bob::core::array::t_float64, op.getLength());
+  blitz::Array<double,1> dst_ = dst.bz<double,1>();
+  op(src.bz<std::complex<double>,1>(), dst_);
+  return dst.self();
+}
+
+static void py_rfft2d_c(bob::sp::RFFT2D& op, bob::python::const_ndarray src,
+  bob::python::ndarray dst) 
+{
+  blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
+  op(src.bz<double,2>(), dst_);
+}
+
+static object py_rfft2d_p(bob::sp::RFFT2D& op, bob::python::const_ndarray src)
+{
+  bob::python::ndarray dst(bob::core::array::t_complex128, op.getHeight(), 
+    op.getHalfWidth());
+  blitz::Array<std::complex<double>,2> dst_ = dst.bz<std::complex<double>,2>();
+  op(src.bz<double,2>(), dst_);
+  return dst.self();
+}
+
+static void py_irfft2d_c(bob::sp::IRFFT2D& op, bob::python::const_ndarray src,
+  bob::python::ndarray dst) 
+{
+  blitz::Array<double,2> dst_ = dst.bz<double,2>();
+  op(src.bz<std::complex<double>,2>(), dst_);
+}
+
+static object py_irfft2d_p(bob::sp::IRFFT2D& op, bob::python::const_ndarray src)
+{
+  bob::python::ndarray dst(bob::core::array::t_float64, op.getHeight(), 
+    op.getWidth());
+  blitz::Array<double,2> dst_ = dst.bz<double,2>();
+  op(src.bz<std::complex<double>,2>(), dst_);
+  return dst.self();
+}
+
 
 static object script_fft(bob::python::const_ndarray ar) 
 {
@@ -256,8 +349,58 @@ static void py_ifftshift(bob::python::const_ndarray ar, bob::python::ndarray t)
   }
 }
 
+static bob::sp::FFTWPlanCache::rigor_t py_fftw_get_plan_rigor()
+{
+  return bob::sp::FFTWPlanCache::instance()->getRigor();
+}
+
+static void py_fftw_set_plan_rigor(bob::sp::FFTWPlanCache::rigor_t rigor)
+{
+  bob::sp::FFTWPlanCache::instance()->setRigor(rigor);
+}
+
+static bool py_fftw_import_wisdom(const std::string& filename)
+{
+  return bob::sp::FFTWPlanCache::instance()->importWisdom(filename);
+}
+
+static void py_fftw_export_wisdom(const std::string& filename)
+{
+  bob::sp::FFTWPlanCache::instance()->exportWisdom(filename);
+}
+
+static void py_fftw_forget_wisdom()
+{
+  bob::sp::FFTWPlanCache::instance()->forgetWisdom();
+}
+
+static void py_fftw_clear_plan_cache()
+{
+  bob::sp::FFTWPlanCache::instance()->clear();
+}
+
+static size_t py_fftw_plan_cache_size()
+{
+  return bob::sp::FFTWPlanCache::instance()->size();
+}
+
 void bind_sp_fft()
 {
+  // FFTW plan cache and wisdom
+  enum_<bob::sp::FFTWPlanCache::rigor_t>("FFTWPlanRigor", "Rigor of the FFTW planner used when a transform of a new size is computed for the first time. The more rigorous, the slower the planning and the faster the transforms.")
+    .value("ESTIMATE", bob::sp::FFTWPlanCache::ESTIMATE)
+    .value("MEASURE", bob::sp::FFTWPlanCache::MEASURE)
+    .value("PATIENT", bob::sp::FFTWPlanCache::PATIENT)
+    ;
+
+  def("fftw_get_plan_rigor", &py_fftw_get_plan_rigor, "Returns the rigor of the FFTW planner.");
+  def("fftw_set_plan_rigor", &py_fftw_set_plan_rigor, (arg("rigor")), "Sets the rigor of the FFTW planner used for the plans created afterwards.");
+  def("fftw_import_wisdom", &py_fftw_import_wisdom, (arg("filename")), "Imports FFTW wisdom from the given file, and returns False if the file could not be read.");
+  def("fftw_export_wisdom", &py_fftw_export_wisdom, (arg("filename")), "Exports the FFTW wisdom accumulated so far (e.g. with the MEASURE or PATIENT rigor) to the given file.");
+  def("fftw_forget_wisdom", &py_fftw_forget_wisdom, "Forgets the FFTW wisdom and destroys all the cached plans.");
+  def("fftw_clear_plan_cache", &py_fftw_clear_plan_cache, "Destroys all the cached FFTW plans.");
+  def("fftw_plan_cache_size", &py_fftw_plan_cache_size, "Returns the number of cached FFTW plans.");
+
   // Fast Fourier Transform
   class_<bob::sp::FFT1DAbstract, boost::noncopyable>("FFT1DAbstract", "Abstract class for FFT1D", no_init)
     .def("reset", (void (bob::sp::FFT1D::*)(const size_t))&bob::sp::FFT1D::reset, (arg("self"),arg("length")), "Reset the length of the expected input signals.")
@@ -268,16 +411,16 @@ void bind_sp_fft()
       .def(init<bob::sp::FFT1D&>((arg("self"), arg("other"))))
       .def(self == self)
       .def(self != self)
-      .def("__call__", &py_fft1d_c, (arg("self"), arg("input"), arg("output")), "Compute the FFT of the input 1D array/signal. The output should have the expected size and type (numpy.float64).")
-      .def("__call__", &py_fft1d_p, (arg("self"), arg("input")), "Compute the FFT of the input 1D array/signal. The output is allocated and returned.")
+      .def("__call__", &py_fft1d_c, (arg("self"), arg("input"), arg("output")), "Compute the FFT of the input 1D array/signal, or of each row of the input 2D array (all the rows being transformed with a single call to FFTW). The output should have the expected size and type (numpy.complex128).")
+      .def("__call__", &py_fft1d_p, (arg("self"), arg("input")), "Compute the FFT of the input 1D array/signal, or of each row of the input 2D array. The output is allocated and returned.")
     ;
 
   class_<bob::sp::IFFT1D, boost::shared_ptr<bob::sp::IFFT1D>, bases<bob::sp::FFT1DAbstract> >("IFFT1D", IFFT1D_DOC, init<const size_t>((arg("self"), arg("length"))))
       .def(init<bob::sp::IFFT1D&>((arg("self"), arg("other"))))
       .def(self == self)
       .def(self != self)
-      .def("__call__", &py_ifft1d_c, (arg("self"), arg("input"), arg("output")), "Compute the inverse FFT of the input 1D array/signal. The output should have the expected size and type (numpy.float64).")
-      .def("__call__", &py_ifft1d_p, (arg("self"), arg("input")), "Compute the inverse FFT of the input 1D array/signal. The output is allocated and returned.")
+      .def("__call__", &py_ifft1d_c, (arg("self"), arg("input"), arg("output")), "Compute the inverse FFT of the input 1D array/signal, or of each row of the input 2D array (all the rows being transformed with a single call to FFTW). The output should have the expected size and type (numpy.complex128).")
+      .def("__call__", &py_ifft1d_p, (arg("self"), arg("input")), "Compute the inverse FFT of the input 1D array/signal, or of each row of the input 2D array. The output is allocated and returned.")
     ;
 
   class_<bob::sp::FFT2DAbstract, boost::noncopyable>("FFT2DAbstract", "Abstract class for FFT2D", no_init)
@@ -302,6 +445,52 @@ void bind_sp_fft()
       .def("__call__", &py_ifft2d_p, (arg("self"), arg("input")), "Compute the inverse FFT of the input 2D array/signal. The output is allocated and returned.")
     ;
 
+  // Fast Fourier Transform of real signals
+  class_<bob::sp::RFFT1DAbstract, boost::noncopyable>("RFFT1DAbstract", "Abstract class for RFFT1D", no_init)
+    .def("reset", &bob::sp::RFFT1DAbstract::reset, (arg("self"),arg("length")), "Reset the length of the real signals.")
+    .add_property("length", &bob::sp::RFFT1DAbstract::getLength, "The length N of the real signals")
+    .add_property("half_length", &bob::sp::RFFT1DAbstract::getHalfLength, "The length N/2+1 of the non-redundant half of the spectra")
+    ;
+
+  class_<bob::sp::RFFT1D, boost::shared_ptr<bob::sp::RFFT1D>, bases<bob::sp::RFFT1DAbstract> >("RFFT1D", RFFT1D_DOC, init<const size_t>((arg("self"), arg("length"))))
+      .def(init<bob::sp::RFFT1D&>((arg("self"), arg("other"))))
+      .def(self == self)
+      .def(self != self)
+      .def("__call__", &py_rfft1d_c, (arg("self"), arg("input"), arg("output")), "Compute the FFT of the input real 1D array/signal. The output should have the expected size (N/2+1) and type (numpy.complex128).")
+      .def("__call__", &py_rfft1d_p, (arg("self"), arg("input")), "Compute the FFT of the input real 1D array/signal. The output is allocated and returned.")
+    ;
+
+  class_<bob::sp::IRFFT1D, boost::shared_ptr<bob::sp::IRFFT1D>, bases<bob::sp::RFFT1DAbstract> >("IRFFT1D", IRFFT1D_DOC, init<const size_t>((arg("self"), arg("length"))))
+      .def(init<bob::sp::IRFFT1D&>((arg("self"), arg("other"))))
+      .def(self == self)
+      .def(self != self)
+      .def("__call__", &py_irfft1d_c, (arg("self"), arg("input"), arg("output")), "Compute the inverse FFT of the input half spectrum. The output should have the expected size (N) and type (numpy.float64).")
+      .def("__call__", &py_irfft1d_p, (arg("self"), arg("input")), "Compute the inverse FFT of the input half spectrum. The output is allocated and returned.")
+    ;
+
+  class_<bob::sp::RFFT2DAbstract, boost::noncopyable>("RFFT2DAbstract", "Abstract class for RFFT2D", no_init)
+    .def("reset", &bob::sp::RFFT2DAbstract::reset, (arg("self"), arg("height"), arg("width")), "Reset the dimension of the real signals.")
+    .add_property("height", &bob::sp::RFFT2DAbstract::getHeight, "The height H of the real signals")
+    .add_property("width", &bob::sp::RFFT2DAbstract::getWidth, "The width W of the real signals")
+    .add_property("half_width", &bob::sp::RFFT2DAbstract::getHalfWidth, "The width W/2+1 of the non-redundant half of the spectra")
+    ;
+
+  class_<bob::sp::RFFT2D, boost::shared_ptr<bob::sp::RFFT2D>, bases<bob::sp::RFFT2DAbstract> >("RFFT2D", RFFT2D_DOC, init<const size_t,const size_t>((arg("self"), arg("height"), arg("width"))))
+      .def(init<bob::sp::RFFT2D&>((arg("self"), arg("other"))))
+      .def(self == self)
+      .def(self != self)
+      .def("__call__", &py_rfft2d_c, (arg("self"), arg("input"), arg("output")), "Compute the FFT of the input real 2D array/signal. The output should have the expected size (Hx(W/2+1)) and type (numpy.complex128).")
+      .def("__call__", &py_rfft2d_p, (arg("self"), arg("input")), "Compute the FFT of the input real 2D array/signal. The output is allocated and returned.")
+    ;
+
+  class_<bob::sp::IRFFT2D, boost::shared_ptr<bob::sp::IRFFT2D>, bases<bob::sp::RFFT2DAbstract> >("IRFFT2D", IRFFT2D_DOC, init<const size_t,const size_t>((arg("self"), arg("height"), arg("width"))))
+      .def(init<bob::sp::IRFFT2D&>((arg("self"), arg("other"))))
+      .def(self == self)
+      .def(self != self)
+      .def("__call__", &py_irfft2d_c, (arg("self"), arg("input"), arg("output")), "Compute the inverse FFT of the input half spectrum. The output should have the expected size (HxW) and type (numpy.float64).")
+      .def("__call__", &py_irfft2d_p, (arg("self"), arg("input")), "Compute the inverse FFT of the input half spectrum. The output is allocated and returned.")
+    ;
+
   // fft function-like 
   def("fft", &script_fft, (arg("array")), FFT_DOC);
   def("ifft", &script_ifft, (arg("array")), IFFT_DOC);
@@ -21,6 +21,41 @@
 #include <bob/trainer/GMMTrainer.h>
 #include <bob/core/assert.h>
 #include <bob/core/check.h>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <vector>
+
+/**
+ * Number of samples of a shard of the E-step. The shards do not depend on
+ * the number of threads, which keeps the E-step reproducible.
+ */
+static const int s_shard_size = 4096;
+
+/**
+ * Returns a wrapper of the samples [begin, end) of the data, with its own
+ * reference count. The reference counting of blitz arrays is not
+ * thread-safe: the wrappers are built by the calling thread, and each thread
+ * only uses its own.
+ */
+static blitz::Array<double,2> wrapShard(const blitz::Array<double,2>& data,
+  const int begin, const int end)
+{
+  return blitz::Array<double,2>(const_cast<double*>(data.data()) +
+    begin*data.stride(0), blitz::shape(end-begin, data.extent(1)),
+    blitz::shape(data.stride(0), data.stride(1)), blitz::neverDeleteData);
+}
+
+/**
+ * Accumulates the statistics of a shard of the data
+ */
+static void accStatisticsShard(const bob::machine::GMMMachine* gmm,
+  const blitz::Array<double,2>* shard, bob::machine::GMMStats* stats,
+  bob::machine::GMMWorkspace* workspace)
+{
+  stats->init();
+  gmm->accStatistics_(*shard, *stats, *workspace);
+}
 
 bob::trainer::GMMTrainer::GMMTrainer(const bool update_means, 
     const bool update_variances, const bool update_weights,
@@ -28,14 +63,16 @@ bob::trainer::GMMTrainer::GMMTrainer(const bool update_means,
   bob::trainer::EMTrainer<bob::machine::GMMMachine, blitz::Array<double,2> >(), 
   m_update_means(update_means), m_update_variances(update_variances),
   m_update_weights(update_weights), 
-  m_mean_var_update_responsibilities_threshold(mean_var_update_responsibilities_threshold) 
+  m_mean_var_update_responsibilities_threshold(mean_var_update_responsibilities_threshold),
+  m_n_threads(1)
 {
 }
 
 bob::trainer::GMMTrainer::GMMTrainer(const bob::trainer::GMMTrainer& b):
   bob::trainer::EMTrainer<bob::machine::GMMMachine, blitz::Array<double,2> >(b),
   m_update_means(b.m_update_means), m_update_variances(b.m_update_variances),
-  m_mean_var_update_responsibilities_threshold(b.m_mean_var_update_responsibilities_threshold)
+  m_mean_var_update_responsibilities_threshold(b.m_mean_var_update_responsibilities_threshold),
+  m_n_threads(b.m_n_threads)
 {
 }
 
@@ -53,9 +90,54 @@ void bob::trainer::GMMTrainer::initialize(bob::machine::GMMMachine& gmm,
 void bob::trainer::GMMTrainer::eStep(bob::machine::GMMMachine& gmm,
   const blitz::Array<double,2>& data) 
 {
+  const size_t n_gaussians = gmm.getNGaussians();
+  const size_t n_inputs = gmm.getNInputs();
+  bob::core::array::assertSameDimensionLength(data.extent(1), n_inputs);
+  bob::core::array::assertSameDimensionLength(m_ss.sumPx.extent(0), n_gaussians);
+  bob::core::array::assertSameDimensionLength(m_ss.sumPx.extent(1), n_inputs);
+
+  // Allocate the statistics and the workspace of each thread
+  if (m_cache_shard_stats.size() != m_n_threads ||
+      m_cache_shard_stats[0].sumPx.extent(0) != (int)n_gaussians ||
+      m_cache_shard_stats[0].sumPx.extent(1) != (int)n_inputs)
+  {
+    m_cache_shard_stats.assign(m_n_threads, bob::machine::GMMStats(n_gaussians, n_inputs));
+    m_cache_workspaces.assign(m_n_threads, bob::machine::GMMWorkspace(n_gaussians, n_inputs));
+  }
+
   m_ss.init();
   // Calculate the sufficient statistics and save in m_ss
-  gmm.accStatistics(data, m_ss);
+  const int n_samples = data.extent(0);
+  const int n_shards = (n_samples + s_shard_size - 1) / s_shard_size;
+  for (int s0=0; s0<n_shards; s0+=m_n_threads) {
+    // Process (at most) one shard per thread
+    const int n_current = std::min(static_cast<int>(m_n_threads), n_shards-s0);
+    std::vector<blitz::Array<double,2> > shards;
+    for (int k=0; k<n_current; ++k)
+      shards.push_back(wrapShard(data, (s0+k)*s_shard_size,
+        std::min((s0+k+1)*s_shard_size, n_samples)));
+    if (n_current == 1)
+      accStatisticsShard(&gmm, &shards[0], &m_cache_shard_stats[0],
+        &m_cache_workspaces[0]);
+    else {
+      boost::thread_group threads;
+      for (int k=0; k<n_current; ++k)
+        threads.create_thread(boost::bind(&accStatisticsShard, &gmm,
+          &shards[k], &m_cache_shard_stats[k], &m_cache_workspaces[k]));
+      threads.join_all();
+    }
+
+    // Sum the statistics in the order of the shards
+    for (int k=0; k<n_current; ++k)
+      m_ss += m_cache_shard_stats[k];
+  }
+}
+
+void bob::trainer::GMMTrainer::setNThreads(const size_t n_threads)
+{
+  if (n_threads == 0)
+    throw std::runtime_error("GMMTrainer: the number of threads should be strictly positive");
+  m_n_threads = n_threads;
 }
 
 double bob::trainer::GMMTrainer::computeLikelihood(bob::machine::GMMMachine& gmm)
@@ -80,6 +162,7 @@ bob::trainer::GMMTrainer& bob::trainer::GMMTrainer::operator=
     m_update_variances = other.m_update_variances;
     m_update_weights = other.m_update_weights;
     m_mean_var_update_responsibilities_threshold = other.m_mean_var_update_responsibilities_threshold;
+    m_n_threads = other.m_n_threads;
   }
   return *this;
 }
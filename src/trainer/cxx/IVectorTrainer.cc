@@ -27,8 +27,135 @@
 #include <bob/math/inv.h>
 #include <bob/math/linear.h>
 #include <bob/math/linsolve.h>
+#include <bob/core/threads.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/random.hpp>
+#include <algorithm>
+#include <vector>
+
+/**
+ * Maximum number of elements of the flattened precision matrices of a
+ * block of utterances processed at once by the E-step (128MB)
+ */
+static const int s_max_block_elements = 1 << 24;
+
+/**
+ * Computes E{wij} and E{wij.wij^{T}} for a block of utterances, given
+ * their flattened precision matrices \f$Id + T^{T} \Sigma^{-1} T\f$ and
+ * \f$T^{T} \Sigma^{-1} F_{norm}\f$. Only raw pointers are shared with the
+ * other threads, as the reference counting of blitz arrays is not
+ * thread-safe.
+ */
+struct IVectorPosteriors {
+  const double* precisions;
+  const double* projections;
+  double* wij;
+  double* wij2;
+  int rt;
+  bool use_cholesky;
+
+  void operator()(const size_t, const size_t begin, const size_t end) const
+  {
+    const blitz::Range rall = blitz::Range::all();
+    const blitz::Range rt_range(0, rt-1);
+    blitz::Array<double,2> inv(rt, rt);
+    blitz::Array<double,1> w(rt);
+    blitz::Array<double,2> X, B;
+    if (use_cholesky)
+    {
+      X.resize(rt, rt+1);
+      B.resize(rt, rt+1);
+    }
+    for (size_t i=begin; i<end; ++i)
+    {
+      const blitz::Array<double,2> A(const_cast<double*>(precisions + i*rt*rt),
+        blitz::shape(rt,rt), blitz::neverDeleteData);
+      const blitz::Array<double,1> b(const_cast<double*>(projections + i*rt),
+        blitz::shape(rt), blitz::neverDeleteData);
+      if (use_cholesky)
+      {
+        // Solves A.[A^{-1} E{wij}] = [Id T^{T} \Sigma^{-1} F_{norm}]
+        blitz::Array<double,2> B_id = B(rall, rt_range);
+        bob::math::eye(B_id);
+        B(rall, rt) = b;
+        bob::math::linsolveSympos_(A, X, B);
+        inv = X(rall, rt_range);
+        w = X(rall, rt);
+      }
+      else
+      {
+        bob::math::inv(A, inv);
+        bob::math::prod(inv, b, w);
+      }
+      blitz::Array<double,1> wij_i(wij + i*rt, blitz::shape(rt),
+        blitz::neverDeleteData);
+      wij_i = w;
+      blitz::Array<double,2> wij2_i(wij2 + i*rt*rt, blitz::shape(rt,rt),
+        blitz::neverDeleteData);
+      bob::math::prod(w, w, wij2_i);
+      wij2_i += inv;
+    }
+  }
+};
+
+/**
+ * Adds the statistics of a block of utterances to the accumulators of the
+ * Gaussian components of a range. The utterances are summed in the order
+ * of the data, such that the accumulators do not depend on the split of
+ * the components among the threads.
+ */
+struct IVectorAccumulator {
+  const std::vector<bob::machine::GMMStats>* data;
+  size_t begin;
+  int n_utterances;
+  const double* wij;
+  const double* wij2;
+  const double* mean;
+  double* acc_Nij_wij2;
+  double* acc_Fnormij_wij;
+  double* acc_Nij;
+  double* acc_Snormij;
+  int dim_d;
+  int rt;
+  bool update_sigma;
+
+  void operator()(const size_t, const size_t c_begin, const size_t c_end) const
+  {
+    const int D = dim_d;
+    const int R = rt;
+    std::vector<double> fnorm(D);
+    for (size_t c=c_begin; c<c_end; ++c)
+    {
+      double* acc_Nij_wij2_c = acc_Nij_wij2 + c*R*R;
+      double* acc_Fnormij_wij_c = acc_Fnormij_wij + c*D*R;
+      const double* mc = mean + c*D;
+      for (int i=0; i<n_utterances; ++i)
+      {
+        const bob::machine::GMMStats& gs = (*data)[begin+i];
+        const double n_c = gs.n(c);
+        // acc_Nij_wij2_c += Nijc . E{wij.wij^{T}}
+        const double* wij2_i = wij2 + i*R*R;
+        for (int k=0; k<R*R; ++k)
+          acc_Nij_wij2_c[k] += n_c * wij2_i[k];
+        // acc_Fnormij_wij += (Fijc - Nijc * ubmmean_{c}).E{wij}^{T}
+        const double* wij_i = wij + i*R;
+        for (int d=0; d<D; ++d)
+        {
+          fnorm[d] = gs.sumPx(c,d) - n_c * mc[d];
+          double* acc_d = acc_Fnormij_wij_c + d*R;
+          for (int r=0; r<R; ++r)
+            acc_d[r] += fnorm[d] * wij_i[r];
+        }
+        if (update_sigma)
+        {
+          acc_Nij[c] += n_c;
+          for (int d=0; d<D; ++d)
+            acc_Snormij[c*D+d] += gs.sumPxx(c,d) - mc[d] * (gs.sumPx(c,d) + fnorm[d]);
+        }
+      }
+    }
+  }
+};
 
 bob::trainer::IVectorTrainer::IVectorTrainer(const bool update_sigma,
     const double convergence_threshold,
@@ -36,28 +163,23 @@ bob::trainer::IVectorTrainer::IVectorTrainer(const bool update_sigma,
   bob::trainer::EMTrainer<bob::machine::IVectorMachine, 
     std::vector<bob::machine::GMMStats> >(convergence_threshold,
       max_iterations, compute_likelihood), 
-  m_update_sigma(update_sigma)
+  m_update_sigma(update_sigma), m_n_threads(1), m_use_cholesky(false)
 {
 }
 
 bob::trainer::IVectorTrainer::IVectorTrainer(const bob::trainer::IVectorTrainer& other):
   bob::trainer::EMTrainer<bob::machine::IVectorMachine, 
     std::vector<bob::machine::GMMStats> >(other),
-  m_update_sigma(other.m_update_sigma)
+  m_update_sigma(other.m_update_sigma), m_n_threads(other.m_n_threads),
+  m_use_cholesky(other.m_use_cholesky)
 {
   m_acc_Nij_wij2.reference(bob::core::array::ccopy(other.m_acc_Nij_wij2));
   m_acc_Fnormij_wij.reference(bob::core::array::ccopy(other.m_acc_Fnormij_wij));
   m_acc_Nij.reference(bob::core::array::ccopy(other.m_acc_Nij));
   m_acc_Snormij.reference(bob::core::array::ccopy(other.m_acc_Snormij));
 
-  m_tmp_wij.reference(bob::core::array::ccopy(other.m_tmp_wij));
-  m_tmp_wij2.reference(bob::core::array::ccopy(other.m_tmp_wij2));
   m_tmp_d1.reference(bob::core::array::ccopy(other.m_tmp_d1));
-  m_tmp_t1.reference(bob::core::array::ccopy(other.m_tmp_t1));
   m_tmp_dd1.reference(bob::core::array::ccopy(other.m_tmp_dd1));
-  m_tmp_dt1.reference(bob::core::array::ccopy(other.m_tmp_dt1));
-  m_tmp_tt1.reference(bob::core::array::ccopy(other.m_tmp_tt1));
-  m_tmp_tt2.reference(bob::core::array::ccopy(other.m_tmp_tt2));
 }
 
 bob::trainer::IVectorTrainer::~IVectorTrainer() 
@@ -82,13 +204,7 @@ void bob::trainer::IVectorTrainer::initialize(
   }
 
   // Tmp
-  m_tmp_wij.resize(Rt);
-  m_tmp_wij2.resize(Rt,Rt);
   m_tmp_d1.resize(D);
-  m_tmp_t1.resize(Rt);
-  m_tmp_dt1.resize(D,Rt);
-  m_tmp_tt1.resize(Rt,Rt);
-  m_tmp_tt2.resize(Rt,Rt);
   if (m_update_sigma)
     m_tmp_dd1.resize(D,D);
 
@@ -115,45 +231,59 @@ void bob::trainer::IVectorTrainer::eStep(
     m_acc_Nij = 0.;
     m_acc_Snormij = 0.;
   }
-  for (std::vector<bob::machine::GMMStats>::const_iterator it = data.begin();
-       it != data.end(); ++it)
+
+  const int N = (int)data.size();
+  const int D = machine.getDimD();
+  const int Rt = machine.getDimRt();
+  if (N == 0) return;
+
+  // The utterances are processed by blocks, which bounds the memory used
+  // by their precision matrices and posteriors. The blocks do not depend on
+  // the number of threads.
+  const int block = std::max(1, std::min(N, s_max_block_elements / (Rt*Rt)));
+  blitz::Array<double,2> precisions(block, Rt*Rt);
+  blitz::Array<double,2> projections(block, Rt);
+  blitz::Array<double,2> wij(block, Rt);
+  blitz::Array<double,2> wij2(block, Rt*Rt);
+
+  for (int b0=0; b0<N; b0+=block)
   {
-    // Computes E{wij} and E{wij.wij^{T}}
+    const int nb = std::min(block, N-b0);
+    const blitz::Range rb(0, nb-1);
     // a. Computes \f$T^{T} \Sigma^{-1} F_{norm}\f$
-    machine.computeTtSigmaInvFnorm(*it, m_tmp_t1);
+    blitz::Array<double,2> projections_b = projections(rb, rall);
+    machine.computeTtSigmaInvFnorm(data, b0, projections_b);
     // b. Computes \f$Id + T^{T} \Sigma^{-1} T\f$
-    machine.computeIdTtSigmaInvT(*it, m_tmp_tt1);
-    // c. Computes \f$(Id + T^{T} \Sigma^{-1} T)^{-1}\f$
-    bob::math::inv(m_tmp_tt1, m_tmp_tt2);
-    // d. Computes \f$E{wij} = (Id + T^{T} \Sigma^{-1} T)^{-1} T^{T} \Sigma^{-1} F_{norm}\f$
-    bob::math::prod(m_tmp_tt2, m_tmp_t1, m_tmp_wij); // E{wij}
-    // e.  Computes \f$E{wij}.E{wij^{T}}\f$
-    bob::math::prod(m_tmp_wij, m_tmp_wij, m_tmp_wij2);
-    // f. Computes \f$E{wij.wij^{T}} = (Id + T^{T} \Sigma^{-1} T)^{-1} + E{wij}.E{wij^{T}}\f$
-    m_tmp_wij2 += m_tmp_tt2; // E{wij.wij^{T}}
+    blitz::Array<double,2> precisions_b = precisions(rb, rall);
+    machine.computeIdTtSigmaInvT(data, b0, precisions_b);
 
-    if (m_update_sigma)
-      m_acc_Nij += (*it).n;
+    // c. Computes E{wij} and E{wij.wij^{T}}, in parallel over the
+    // utterances
+    IVectorPosteriors posteriors;
+    posteriors.precisions = precisions.data();
+    posteriors.projections = projections.data();
+    posteriors.wij = wij.data();
+    posteriors.wij2 = wij2.data();
+    posteriors.rt = Rt;
+    posteriors.use_cholesky = m_use_cholesky;
+    bob::core::thread_loop(posteriors, nb, m_n_threads);
 
-    for (int c=0; c<C; ++c)
-    {
-      blitz::Array<double,2> acc_Nij_wij2_c = m_acc_Nij_wij2(c,rall,rall);
-      blitz::Array<double,2> acc_Fnormij_wij = m_acc_Fnormij_wij(c,rall,rall);
-      // acc_Nij_wij2_c += Nijc . E{wij.wij^{T}}
-      acc_Nij_wij2_c += (*it).n(c) * m_tmp_wij2;
-      blitz::Array<double,1> mc = machine.getUbm()->getGaussian(c)->getMean();
-      // m_tmp_d1 = Fijc - Nijc * ubmmean_{c}
-      m_tmp_d1 = (*it).sumPx(c,rall) - (*it).n(c)*mc; // Fnorm_c
-      // m_tmp_dt1 = (Fijc - Nijc * ubmmean_{c}).E{wij}^{T}
-      bob::math::prod(m_tmp_d1, m_tmp_wij, m_tmp_dt1); 
-      // acc_Fnormij_wij += (Fijc - Nijc * ubmmean_{c}).E{wij}^{T}
-      acc_Fnormij_wij += m_tmp_dt1;
-      if (m_update_sigma)
-      {
-        blitz::Array<double,1> acc_Snormij_c = m_acc_Snormij(c,rall);
-        acc_Snormij_c += (*it).sumPxx(c,rall) - mc*((*it).sumPx(c,rall) + m_tmp_d1);
-      }
-    }
+    // d. Updates the accumulators, in parallel over the Gaussian components
+    IVectorAccumulator accumulator;
+    accumulator.data = &data;
+    accumulator.begin = b0;
+    accumulator.n_utterances = nb;
+    accumulator.wij = wij.data();
+    accumulator.wij2 = wij2.data();
+    accumulator.mean = machine.getUbm()->getMeanSupervector().data();
+    accumulator.acc_Nij_wij2 = m_acc_Nij_wij2.data();
+    accumulator.acc_Fnormij_wij = m_acc_Fnormij_wij.data();
+    accumulator.acc_Nij = (m_update_sigma ? m_acc_Nij.data() : 0);
+    accumulator.acc_Snormij = (m_update_sigma ? m_acc_Snormij.data() : 0);
+    accumulator.dim_d = D;
+    accumulator.rt = Rt;
+    accumulator.update_sigma = m_update_sigma;
+    bob::core::thread_loop(accumulator, C, m_n_threads);
   }
 }
 
@@ -213,20 +343,16 @@ bob::trainer::IVectorTrainer& bob::trainer::IVectorTrainer::operator=
     bob::trainer::EMTrainer<bob::machine::IVectorMachine,
       std::vector<bob::machine::GMMStats> >::operator=(other);
     m_update_sigma = other.m_update_sigma;
+    m_n_threads = other.m_n_threads;
+    m_use_cholesky = other.m_use_cholesky;
 
     m_acc_Nij_wij2.reference(bob::core::array::ccopy(other.m_acc_Nij_wij2));
     m_acc_Fnormij_wij.reference(bob::core::array::ccopy(other.m_acc_Fnormij_wij));
     m_acc_Nij.reference(bob::core::array::ccopy(other.m_acc_Nij));
     m_acc_Snormij.reference(bob::core::array::ccopy(other.m_acc_Snormij));
 
-    m_tmp_wij.reference(bob::core::array::ccopy(other.m_tmp_wij));
-    m_tmp_wij2.reference(bob::core::array::ccopy(other.m_tmp_wij2));
     m_tmp_d1.reference(bob::core::array::ccopy(other.m_tmp_d1));
-    m_tmp_t1.reference(bob::core::array::ccopy(other.m_tmp_t1));
     m_tmp_dd1.reference(bob::core::array::ccopy(other.m_tmp_dd1));
-    m_tmp_dt1.reference(bob::core::array::ccopy(other.m_tmp_dt1));
-    m_tmp_tt1.reference(bob::core::array::ccopy(other.m_tmp_tt1));
-    m_tmp_tt2.reference(bob::core::array::ccopy(other.m_tmp_tt2)); 
   }
   return *this;
 }
@@ -237,6 +363,7 @@ bool bob::trainer::IVectorTrainer::operator==
   return bob::trainer::EMTrainer<bob::machine::IVectorMachine,
            std::vector<bob::machine::GMMStats> >::operator==(other) &&
         m_update_sigma == other.m_update_sigma &&
+        m_use_cholesky == other.m_use_cholesky &&
         bob::core::array::isEqual(m_acc_Nij_wij2, other.m_acc_Nij_wij2) &&
         bob::core::array::isEqual(m_acc_Fnormij_wij, other.m_acc_Fnormij_wij) &&
         bob::core::array::isEqual(m_acc_Nij, other.m_acc_Nij) &&
@@ -256,6 +383,7 @@ bool bob::trainer::IVectorTrainer::is_similar_to
   return bob::trainer::EMTrainer<bob::machine::IVectorMachine,
            std::vector<bob::machine::GMMStats> >::is_similar_to(other, r_epsilon, a_epsilon) &&
         m_update_sigma == other.m_update_sigma &&
+        m_use_cholesky == other.m_use_cholesky &&
         bob::core::array::isClose(m_acc_Nij_wij2, other.m_acc_Nij_wij2, r_epsilon, a_epsilon) &&
         bob::core::array::isClose(m_acc_Fnormij_wij, other.m_acc_Fnormij_wij, r_epsilon, a_epsilon) &&
         bob::core::array::isClose(m_acc_Nij, other.m_acc_Nij, r_epsilon, a_epsilon) &&
@@ -28,16 +28,238 @@
 #include <bob/math/linear.h>
 #include <bob/core/check.h>
 #include <bob/core/array_repmat.h>
+#include <bob/core/threads.h>
+#include <boost/bind.hpp>
 #include <algorithm>
 
+/**
+ * Maximum number of elements of the statistics of a block of identities (or
+ * sessions) processed at once by the accumulators (128MB)
+ */
+static const size_t s_max_block_elements = 1 << 24;
+
+/**
+ * Returns the number of identities (or sessions) of the blocks processed by
+ * the accumulators, given the number of elements of their statistics. The
+ * blocks do not depend on the number of threads.
+ */
+static size_t blockSize(const size_t n_items, const size_t item_elements)
+{
+  return std::max((size_t)1, std::min(n_items,
+    s_max_block_elements / std::max((size_t)1, item_elements)));
+}
+
+/**
+ * Returns an array which points to the data of a C-contiguous array, with
+ * its own reference count. The reference counting of blitz arrays is not
+ * thread-safe: the threads only use such local wrappers of the shared
+ * arrays (and views of them).
+ */
+template <typename T, int N>
+static blitz::Array<T,N> wrap(const blitz::Array<T,N>& a)
+{
+  if (a.size()) bob::core::array::assertCZeroBaseContiguous(a);
+  return blitz::Array<T,N>(const_cast<T*>(a.data()), a.shape(),
+    blitz::neverDeleteData);
+}
+
+/**
+ * Lists the (identity, session) pairs of the statistics
+ */
+static std::vector<std::pair<size_t,size_t> > listSessions(
+  const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats)
+{
+  std::vector<std::pair<size_t,size_t> > sessions;
+  for (size_t id=0; id<stats.size(); ++id)
+    for (size_t h=0; h<stats[id].size(); ++h)
+      sessions.push_back(std::make_pair(id, h));
+  return sessions;
+}
+
+/**
+ * Computes (I + sum_c N(c)*Prod_c)^-1, Prod_c being Ut_c*diag(sigma)^-1*U_c
+ * (or the V equivalent) for each Gaussian c
+ */
+static void computeIdPlusProd(const blitz::Array<double,3>& prod,
+  const blitz::Array<double,1>& N, blitz::Array<double,2>& tmp,
+  blitz::Array<double,2>& out)
+{
+  bob::math::eye(tmp); // tmp = I
+  blitz::Range rall = blitz::Range::all();
+  for (int c=0; c<prod.extent(0); ++c) {
+    blitz::Array<double,2> prod_c = prod(c, rall, rall);
+    tmp += prod_c * N(c);
+  }
+  bob::math::inv(tmp, out); // out = (I+Ut*diag(sigma)^-1*N*U)^-1
+}
+
+/**
+ * Computes (I+diag(d)t*diag(sigma)^-1*Ni*diag(d))^-1
+ */
+static void computeIdPlusDProd(const blitz::Array<double,1>& DProd,
+  const blitz::Array<double,1>& Ni, blitz::Array<double,1>& tmp_CD,
+  blitz::Array<double,1>& out)
+{
+  bob::core::array::repelem(Ni, tmp_CD); // tmp_CD = Ni 'repmat'
+  out = 1.; // out = Id
+  out += DProd * tmp_CD; // out = I+Dt*diag(sigma)^-1*Ni*D
+  out = 1 / out; // out = (I+Dt*diag(sigma)^-1*Ni*D)^-1
+}
+
+/**
+ * Computes sum_{sessions h}(N_{i,h}*(o_{i,h} - m - o_{i} - U*x_{i,h}), the
+ * offset o_{i} (D*z_{i} for y, V*y_{i} for z) being given in tmp_CD_b
+ */
+static void computeFn_yz(const blitz::Array<double,1>& Fi,
+  const blitz::Array<double,1>& Ni, const blitz::Array<double,1>& m,
+  const blitz::Array<double,2>& U, const blitz::Array<double,2>& X,
+  const std::vector<boost::shared_ptr<bob::machine::GMMStats> >& stats,
+  blitz::Array<double,1>& tmp_CD, blitz::Array<double,1>& tmp_CD_b,
+  blitz::Array<double,1>& Fn)
+{
+  bob::core::array::repelem(Ni, tmp_CD);
+  Fn = Fi - tmp_CD * (m + tmp_CD_b); // Fn = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - o_{i})
+  blitz::Range rall = blitz::Range::all();
+  for (int h=0; h<X.extent(1); ++h) // Loops over the sessions
+  {
+    blitz::Array<double,1> Xh = X(rall, h); // Xh = x_{i,h} (length: ru)
+    bob::math::prod(U, Xh, tmp_CD_b); // tmp_CD_b = U*x_{i,h}
+    const blitz::Array<double,1> Nih = wrap(stats[h]->n);
+    bob::core::array::repelem(Nih, tmp_CD);
+    Fn -= tmp_CD * tmp_CD_b; // N_{i,h} * U * x_{i,h}
+  }
+}
+
+/**
+ * Computes N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i})
+ */
+static void computeFn_x(const blitz::Array<double,2>& Fih,
+  const blitz::Array<double,1>& Nih, const blitz::Array<double,1>& m,
+  const blitz::Array<double,1>& d, const blitz::Array<double,1>& z,
+  const blitz::Array<double,2>& V, const blitz::Array<double,1>& y,
+  blitz::Array<double,1>& tmp_CD, blitz::Array<double,1>& tmp_CD_b,
+  blitz::Array<double,1>& Fn)
+{
+  const int C = Fih.extent(0);
+  const int D = Fih.extent(1);
+  bob::core::array::repelem(Nih, tmp_CD);
+  for (int c=0; c<C; ++c) {
+    blitz::Array<double,1> Fn_c = Fn(blitz::Range(c*D,(c+1)*D-1));
+    Fn_c = Fih(c,blitz::Range::all());
+  }
+  Fn -= tmp_CD * (m + d * z); // Fn = N_{i,h}*(o_{i,h} - m - D*z_{i})
+  bob::math::prod(V, y, tmp_CD_b);
+  Fn -= tmp_CD * tmp_CD_b; // Fn = N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i})
+}
+
+/**
+ * Computes the latent variable w = IdPlusProd * WtSigmaInv * Fn, W being U
+ * or V
+ */
+static void updateLatent(const blitz::Array<double,2>& WtSigmaInv,
+  const blitz::Array<double,2>& IdPlusProd, const blitz::Array<double,1>& Fn,
+  blitz::Array<double,1>& tmp_r, blitz::Array<double,1>& w)
+{
+  bob::math::prod(WtSigmaInv, Fn, tmp_r);
+  bob::math::prod(IdPlusProd, tmp_r, w);
+}
+
+/**
+ * Adds the statistics of a block of identities (or sessions) to the
+ * accumulators of U (or V) of the Gaussian components of a range. The
+ * items are summed in their order, such that the accumulators do not
+ * depend on the split of the components among the threads. Only raw
+ * pointers are shared with the other threads.
+ */
+struct FAAccumulator {
+  const double* A1; // (I+Ut*diag(sigma)^-1*N*U)^-1 + x*xt, r*r per item
+  const double* Fn; // C*D per item
+  const double* w; // r per item
+  const double* N; // C per item
+  int n_items;
+  int dim_c;
+  int dim_d;
+  int r;
+  double* acc_A1;
+  double* acc_A2;
+
+  void operator()(const size_t, const size_t c_begin, const size_t c_end) const
+  {
+    const int C = dim_c;
+    const int D = dim_d;
+    const int R = r;
+    for (size_t c=c_begin; c<c_end; ++c)
+    {
+      double* acc_A1_c = acc_A1 + c*R*R;
+      double* acc_A2_c = acc_A2 + c*D*R;
+      for (int i=0; i<n_items; ++i)
+      {
+        const double n_c = N[i*C+c];
+        // A1_c += (I+Ut*diag(sigma)^-1*N*U)^-1 + x*xt) * N_c
+        const double* A1_i = A1 + i*R*R;
+        for (int k=0; k<R*R; ++k)
+          acc_A1_c[k] += A1_i[k] * n_c;
+        // A2_c += Fn_c * xt
+        const double* Fn_ic = Fn + i*C*D + c*D;
+        const double* w_i = w + i*R;
+        for (int d=0; d<D; ++d)
+        {
+          double* acc_d = acc_A2_c + d*R;
+          for (int k=0; k<R; ++k)
+            acc_d[k] += Fn_ic[d] * w_i[k];
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Adds the statistics of a block of identities to the accumulators of d of
+ * the Gaussian components of a range (see FAAccumulator)
+ */
+struct FADAccumulator {
+  const double* A1; // (I+Dt*diag(sigma)^-1*Ni*D)^-1, C*D per item
+  const double* Fn; // C*D per item
+  const double* z; // C*D per item
+  const double* N; // C per item
+  int n_items;
+  int dim_c;
+  int dim_d;
+  double* acc_A1;
+  double* acc_A2;
+
+  void operator()(const size_t, const size_t c_begin, const size_t c_end) const
+  {
+    const int C = dim_c;
+    const int D = dim_d;
+    for (size_t c=c_begin; c<c_end; ++c)
+    {
+      for (int i=0; i<n_items; ++i)
+      {
+        const double n_c = N[i*C+c];
+        const double* A1_i = A1 + i*C*D;
+        const double* Fn_i = Fn + i*C*D;
+        const double* z_i = z + i*C*D;
+        for (size_t k=c*D; k<(c+1)*D; ++k)
+        {
+          acc_A1[k] += (A1_i[k] + z_i[k] * z_i[k]) * n_c;
+          acc_A2[k] += Fn_i[k] * z_i[k];
+        }
+      }
+    }
+  }
+};
+
 
 bob::trainer::FABaseTrainer::FABaseTrainer():
-  m_Nid(0), m_dim_C(0), m_dim_D(0), m_dim_ru(0), m_dim_rv(0),
+  m_n_threads(1), m_Nid(0), m_dim_C(0), m_dim_D(0), m_dim_ru(0), m_dim_rv(0),
   m_x(0), m_y(0), m_z(0), m_Nacc(0), m_Facc(0)
 {
 }
 
-bob::trainer::FABaseTrainer::FABaseTrainer(const bob::trainer::FABaseTrainer& other)
+bob::trainer::FABaseTrainer::FABaseTrainer(const bob::trainer::FABaseTrainer& other):
+  m_n_threads(other.m_n_threads), m_Nid(0), m_dim_C(0), m_dim_D(0),
+  m_dim_ru(0), m_dim_rv(0)
 {
 }
 
@@ -222,47 +444,68 @@ void bob::trainer::FABaseTrainer::computeVProd(const bob::machine::FABase& m)
 
 void bob::trainer::FABaseTrainer::computeIdPlusVProd_i(const size_t id)
 {
-  const blitz::Array<double,1>& Ni = m_Nacc[id];
-  bob::math::eye(m_tmp_rvrv); // m_tmp_rvrv = I
-  blitz::Range rall = blitz::Range::all();
-  for (size_t c=0; c<m_dim_C; ++c) {
-    blitz::Array<double,2> VProd_c = m_cache_VProd(c, rall, rall);
-    m_tmp_rvrv += VProd_c * Ni(c);
-  }
-  bob::math::inv(m_tmp_rvrv, m_cache_IdPlusVProd_i); // m_cache_IdPlusVProd_i = ( I+Vt*diag(sigma)^-1*Ni*V)^-1
+  // m_cache_IdPlusVProd_i = ( I+Vt*diag(sigma)^-1*Ni*V)^-1
+  computeIdPlusProd(m_cache_VProd, m_Nacc[id], m_tmp_rvrv, m_cache_IdPlusVProd_i);
 }
 
 void bob::trainer::FABaseTrainer::computeFn_y_i(const bob::machine::FABase& mb,
   const std::vector<boost::shared_ptr<bob::machine::GMMStats> >& stats, const size_t id)
 {
-  const blitz::Array<double,2>& U = mb.getU();
-  const blitz::Array<double,1>& d = mb.getD();
   // Compute Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - U*x_{i,h}) (Normalised first order statistics)
-  const blitz::Array<double,1>& Fi = m_Facc[id];
-  const blitz::Array<double,1>& m = mb.getUbmMean();
-  const blitz::Array<double,1>& z = m_z[id];
-  bob::core::array::repelem(m_Nacc[id], m_tmp_CD);
-  m_cache_Fn_y_i = Fi - m_tmp_CD * (m + d * z); // Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i})
-  const blitz::Array<double,2>& X = m_x[id];
-  blitz::Range rall = blitz::Range::all();
-  for (int h=0; h<X.extent(1); ++h) // Loops over the sessions
-  {
-    blitz::Array<double,1> Xh = X(rall, h); // Xh = x_{i,h} (length: ru)
-    bob::math::prod(U, Xh, m_tmp_CD_b); // m_tmp_CD_b = U*x_{i,h}
-    const blitz::Array<double,1>& Nih = stats[h]->n;
-    bob::core::array::repelem(Nih, m_tmp_CD);
-    m_cache_Fn_y_i -= m_tmp_CD * m_tmp_CD_b; // N_{i,h} * U * x_{i,h}
-  }
-  // Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - U*x_{i,h})
+  m_tmp_CD_b = mb.getD() * m_z[id];
+  computeFn_yz(m_Facc[id], m_Nacc[id], mb.getUbmMean(), mb.getU(), m_x[id],
+    stats, m_tmp_CD, m_tmp_CD_b, m_cache_Fn_y_i);
 }
 
 void bob::trainer::FABaseTrainer::updateY_i(const size_t id)
 {
   // Computes yi = Ayi * Cvs * Fn_yi
-  blitz::Array<double,1>& y = m_y[id];
-  // m_tmp_rv = m_cache_VtSigmaInv * m_cache_Fn_y_i = Vt*diag(sigma)^-1 * sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - U*x_{i,h})
-  bob::math::prod(m_cache_VtSigmaInv, m_cache_Fn_y_i, m_tmp_rv);
-  bob::math::prod(m_cache_IdPlusVProd_i, m_tmp_rv, y);
+  updateLatent(m_cache_VtSigmaInv, m_cache_IdPlusVProd_i, m_cache_Fn_y_i,
+    m_tmp_rv, m_y[id]);
+}
+
+void bob::trainer::FABaseTrainer::processV(const bob::machine::FABase& mb,
+  const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats,
+  const bool accumulate, const size_t b0, const size_t begin, const size_t end)
+{
+  const int CD = m_dim_C*m_dim_D;
+  const int rv = m_dim_rv;
+  const blitz::Array<double,2> U = wrap(mb.getU());
+  const blitz::Array<double,1> d = wrap(mb.getD());
+  const blitz::Array<double,1> m = wrap(mb.getUbmMean());
+  const blitz::Array<double,2> VtSigmaInv = wrap(m_cache_VtSigmaInv);
+  const blitz::Array<double,3> VProd = wrap(m_cache_VProd);
+  blitz::Array<double,2> block_A1 = wrap(m_block_A1);
+  blitz::Array<double,2> block_Fn = wrap(m_block_Fn);
+  blitz::Array<double,2> block_w = wrap(m_block_w);
+  blitz::Array<double,2> block_N = wrap(m_block_N);
+  // Working arrays of the thread
+  blitz::Array<double,2> IdPlusVProd(rv, rv), tmp_rvrv(rv, rv);
+  blitz::Array<double,1> Fn(CD), tmp_CD(CD), tmp_CD_b(CD), tmp_rv(rv);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::Range rall = blitz::Range::all();
+  for (size_t k=begin; k<end; ++k) {
+    const size_t id = b0 + k;
+    const blitz::Array<double,1> Ni = wrap(m_Nacc[id]);
+    blitz::Array<double,1> y = wrap(m_y[id]);
+    computeIdPlusProd(VProd, Ni, tmp_rvrv, IdPlusVProd);
+    tmp_CD_b = d * wrap(m_z[id]);
+    computeFn_yz(wrap(m_Facc[id]), Ni, m, U, wrap(m_x[id]), stats[id],
+      tmp_CD, tmp_CD_b, Fn);
+    if (!accumulate)
+      updateLatent(VtSigmaInv, IdPlusVProd, Fn, tmp_rv, y);
+    else {
+      // Needs to return values to be accumulated for estimating V
+      blitz::Array<double,2> A1_k(block_A1.data() + k*rv*rv,
+        blitz::shape(rv,rv), blitz::neverDeleteData);
+      A1_k = IdPlusVProd;
+      A1_k += y(i) * y(j);
+      block_Fn(k, rall) = Fn;
+      block_w(k, rall) = y;
+      block_N(k, rall) = Ni;
+    }
+  }
 }
 
 void bob::trainer::FABaseTrainer::updateY(const bob::machine::FABase& m,
@@ -272,11 +515,9 @@ void bob::trainer::FABaseTrainer::updateY(const bob::machine::FABase& m,
   computeVtSigmaInv(m);
   computeVProd(m);
   // Loops over all people
-  for (size_t id=0; id<stats.size(); ++id) {
-    computeIdPlusVProd_i(id);
-    computeFn_y_i(m, stats[id], id);
-    updateY_i(id);
-  }
+  bob::core::thread_loop(boost::bind(&bob::trainer::FABaseTrainer::processV,
+    this, boost::cref(m), boost::cref(stats), false, 0, _2, _3),
+    stats.size(), m_n_threads);
 }
 
 void bob::trainer::FABaseTrainer::computeAccumulatorsV(
@@ -286,24 +527,35 @@ void bob::trainer::FABaseTrainer::computeAccumulatorsV(
   // Initializes the cache accumulator
   m_acc_V_A1 = 0.;
   m_acc_V_A2 = 0.;
-  // Loops over all people
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-  blitz::Range rall = blitz::Range::all();
-  for (size_t id=0; id<stats.size(); ++id) {
-    computeIdPlusVProd_i(id);
-    computeFn_y_i(m, stats[id], id);
-
-    // Needs to return values to be accumulated for estimating V
-    const blitz::Array<double,1>& y = m_y[id];
-    m_tmp_rvrv = m_cache_IdPlusVProd_i;
-    m_tmp_rvrv += y(i) * y(j);
-    for (size_t c=0; c<m_dim_C; ++c)
-    {
-      blitz::Array<double,2> A1_y_c = m_acc_V_A1(c, rall, rall);
-      A1_y_c += m_tmp_rvrv * m_Nacc[id](c);
-    }
-    m_acc_V_A2 += m_cache_Fn_y_i(i) * y(j);
+  const size_t n_ids = stats.size();
+  if (n_ids == 0) return;
+  const size_t CD = m_dim_C*m_dim_D;
+  // The identities are processed by blocks, which bounds the memory used by
+  // their statistics
+  const size_t block = blockSize(n_ids, m_dim_rv*m_dim_rv + CD + m_dim_rv + m_dim_C);
+  m_block_A1.resize(block, m_dim_rv*m_dim_rv);
+  m_block_Fn.resize(block, CD);
+  m_block_w.resize(block, m_dim_rv);
+  m_block_N.resize(block, m_dim_C);
+  for (size_t b0=0; b0<n_ids; b0+=block) {
+    const size_t nb = std::min(block, n_ids-b0);
+    // Computes the statistics, in parallel over the identities
+    bob::core::thread_loop(boost::bind(&bob::trainer::FABaseTrainer::processV,
+      this, boost::cref(m), boost::cref(stats), true, b0, _2, _3),
+      nb, m_n_threads);
+    // Updates the accumulators, in parallel over the Gaussian components
+    FAAccumulator accumulator;
+    accumulator.A1 = m_block_A1.data();
+    accumulator.Fn = m_block_Fn.data();
+    accumulator.w = m_block_w.data();
+    accumulator.N = m_block_N.data();
+    accumulator.n_items = nb;
+    accumulator.dim_c = m_dim_C;
+    accumulator.dim_d = m_dim_D;
+    accumulator.r = m_dim_rv;
+    accumulator.acc_A1 = m_acc_V_A1.data();
+    accumulator.acc_A2 = m_acc_V_A2.data();
+    bob::core::thread_loop(accumulator, m_dim_C, m_n_threads);
   }
 }
 
@@ -354,45 +606,70 @@ void bob::trainer::FABaseTrainer::computeUProd(const bob::machine::FABase& m)
 void bob::trainer::FABaseTrainer::computeIdPlusUProd_ih(
   const boost::shared_ptr<bob::machine::GMMStats>& stats)
 {
-  const blitz::Array<double,1>& Nih = stats->n;
-  bob::math::eye(m_tmp_ruru); // m_tmp_ruru = I
-  for (size_t c=0; c<m_dim_C; ++c) {
-    blitz::Array<double,2> UProd_c = m_cache_UProd(c,blitz::Range::all(),blitz::Range::all());
-    m_tmp_ruru += UProd_c * Nih(c);
-  }
-  bob::math::inv(m_tmp_ruru, m_cache_IdPlusUProd_ih); // m_cache_IdPlusUProd_ih = ( I+Ut*diag(sigma)^-1*Ni*U)^-1
+  // m_cache_IdPlusUProd_ih = ( I+Ut*diag(sigma)^-1*Ni*U)^-1
+  computeIdPlusProd(m_cache_UProd, stats->n, m_tmp_ruru, m_cache_IdPlusUProd_ih);
 }
 
 void bob::trainer::FABaseTrainer::computeFn_x_ih(const bob::machine::FABase& mb,
   const boost::shared_ptr<bob::machine::GMMStats>& stats, const size_t id)
 {
-  const blitz::Array<double,2>& V = mb.getV();
-  const blitz::Array<double,1>& d =  mb.getD();
   // Compute Fn_x_ih = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i}) (Normalised first order statistics)
-  const blitz::Array<double,2>& Fih = stats->sumPx;
-  const blitz::Array<double,1>& m = mb.getUbmMean();
-  const blitz::Array<double,1>& z = m_z[id];
-  const blitz::Array<double,1>& Nih = stats->n;
-  bob::core::array::repelem(Nih, m_tmp_CD);
-  for (size_t c=0; c<m_dim_C; ++c) {
-    blitz::Array<double,1> Fn_x_ih_c = m_cache_Fn_x_ih(blitz::Range(c*m_dim_D,(c+1)*m_dim_D-1));
-    Fn_x_ih_c = Fih(c,blitz::Range::all());
-  }
-  m_cache_Fn_x_ih -= m_tmp_CD * (m + d * z); // Fn_x_ih = N_{i,h}*(o_{i,h} - m - D*z_{i})
-
-  const blitz::Array<double,1>& y = m_y[id];
-  bob::math::prod(V, y, m_tmp_CD_b);
-  m_cache_Fn_x_ih -= m_tmp_CD * m_tmp_CD_b;
-  // Fn_x_ih = N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i})
+  computeFn_x(stats->sumPx, stats->n, mb.getUbmMean(), mb.getD(), m_z[id],
+    mb.getV(), m_y[id], m_tmp_CD, m_tmp_CD_b, m_cache_Fn_x_ih);
 }
 
 void bob::trainer::FABaseTrainer::updateX_ih(const size_t id, const size_t h)
 {
   // Computes xih = Axih * Cus * Fn_x_ih
   blitz::Array<double,1> x = m_x[id](blitz::Range::all(), h);
-  // m_tmp_ru = m_cache_UtSigmaInv * m_cache_Fn_x_ih = Ut*diag(sigma)^-1 * N_{i,h}*(o_{i,h} - m - D*z_{i} - V*y_{i})
-  bob::math::prod(m_cache_UtSigmaInv, m_cache_Fn_x_ih, m_tmp_ru);
-  bob::math::prod(m_cache_IdPlusUProd_ih, m_tmp_ru, x);
+  updateLatent(m_cache_UtSigmaInv, m_cache_IdPlusUProd_ih, m_cache_Fn_x_ih,
+    m_tmp_ru, x);
+}
+
+void bob::trainer::FABaseTrainer::processU(const bob::machine::FABase& mb,
+  const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats,
+  const std::vector<std::pair<size_t,size_t> >& sessions,
+  const bool accumulate, const size_t b0, const size_t begin, const size_t end)
+{
+  const int CD = m_dim_C*m_dim_D;
+  const int ru = m_dim_ru;
+  const blitz::Array<double,2> V = wrap(mb.getV());
+  const blitz::Array<double,1> d = wrap(mb.getD());
+  const blitz::Array<double,1> m = wrap(mb.getUbmMean());
+  const blitz::Array<double,2> UtSigmaInv = wrap(m_cache_UtSigmaInv);
+  const blitz::Array<double,3> UProd = wrap(m_cache_UProd);
+  blitz::Array<double,2> block_A1 = wrap(m_block_A1);
+  blitz::Array<double,2> block_Fn = wrap(m_block_Fn);
+  blitz::Array<double,2> block_w = wrap(m_block_w);
+  blitz::Array<double,2> block_N = wrap(m_block_N);
+  // Working arrays of the thread
+  blitz::Array<double,2> IdPlusUProd(ru, ru), tmp_ruru(ru, ru);
+  blitz::Array<double,1> Fn(CD), tmp_CD(CD), tmp_CD_b(CD), tmp_ru(ru);
+  blitz::firstIndex i;
+  blitz::secondIndex j;
+  blitz::Range rall = blitz::Range::all();
+  for (size_t k=begin; k<end; ++k) {
+    const size_t id = sessions[b0+k].first;
+    const size_t h = sessions[b0+k].second;
+    const blitz::Array<double,1> Nih = wrap(stats[id][h]->n);
+    blitz::Array<double,2> X = wrap(m_x[id]);
+    blitz::Array<double,1> x = X(rall, h);
+    computeIdPlusProd(UProd, Nih, tmp_ruru, IdPlusUProd);
+    computeFn_x(wrap(stats[id][h]->sumPx), Nih, m, d, wrap(m_z[id]), V,
+      wrap(m_y[id]), tmp_CD, tmp_CD_b, Fn);
+    if (!accumulate)
+      updateLatent(UtSigmaInv, IdPlusUProd, Fn, tmp_ru, x);
+    else {
+      // Needs to return values to be accumulated for estimating U
+      blitz::Array<double,2> A1_k(block_A1.data() + k*ru*ru,
+        blitz::shape(ru,ru), blitz::neverDeleteData);
+      A1_k = IdPlusUProd;
+      A1_k += x(i) * x(j);
+      block_Fn(k, rall) = Fn;
+      block_w(k, rall) = x;
+      block_N(k, rall) = Nih;
+    }
+  }
 }
 
 void bob::trainer::FABaseTrainer::updateX(const bob::machine::FABase& m,
@@ -401,15 +678,11 @@ void bob::trainer::FABaseTrainer::updateX(const bob::machine::FABase& m,
   // Precomputation
   computeUtSigmaInv(m);
   computeUProd(m);
-  // Loops over all people
-  for (size_t id=0; id<stats.size(); ++id) {
-    int n_session_i = stats[id].size();
-    for (int s=0; s<n_session_i; ++s) {
-      computeIdPlusUProd_ih(stats[id][s]);
-      computeFn_x_ih(m, stats[id][s], id);
-      updateX_ih(id, s);
-    }
-  }
+  // Loops over all sessions of all people
+  const std::vector<std::pair<size_t,size_t> > sessions = listSessions(stats);
+  bob::core::thread_loop(boost::bind(&bob::trainer::FABaseTrainer::processU,
+    this, boost::cref(m), boost::cref(stats), boost::cref(sessions), false, 0,
+    _2, _3), sessions.size(), m_n_threads);
 }
 
 void bob::trainer::FABaseTrainer::computeAccumulatorsU(
@@ -419,27 +692,36 @@ void bob::trainer::FABaseTrainer::computeAccumulatorsU(
   // Initializes the cache accumulator
   m_acc_U_A1 = 0.;
   m_acc_U_A2 = 0.;
-  // Loops over all people
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-  blitz::Range rall = blitz::Range::all();
-  for (size_t id=0; id<stats.size(); ++id) {
-    int n_session_i = stats[id].size();
-    for (int h=0; h<n_session_i; ++h) {
-      computeIdPlusUProd_ih(stats[id][h]);
-      computeFn_x_ih(m, stats[id][h], id);
-
-      // Needs to return values to be accumulated for estimating U
-      blitz::Array<double,1> x = m_x[id](rall, h);
-      m_tmp_ruru = m_cache_IdPlusUProd_ih;
-      m_tmp_ruru += x(i) * x(j);
-      for (int c=0; c<(int)m_dim_C; ++c)
-      {
-        blitz::Array<double,2> A1_x_c = m_acc_U_A1(c,rall,rall);
-        A1_x_c += m_tmp_ruru * stats[id][h]->n(c);
-      }
-      m_acc_U_A2 += m_cache_Fn_x_ih(i) * x(j);
-    }
+  const std::vector<std::pair<size_t,size_t> > sessions = listSessions(stats);
+  const size_t n_sessions = sessions.size();
+  if (n_sessions == 0) return;
+  const size_t CD = m_dim_C*m_dim_D;
+  // The sessions are processed by blocks, which bounds the memory used by
+  // their statistics
+  const size_t block = blockSize(n_sessions, m_dim_ru*m_dim_ru + CD + m_dim_ru + m_dim_C);
+  m_block_A1.resize(block, m_dim_ru*m_dim_ru);
+  m_block_Fn.resize(block, CD);
+  m_block_w.resize(block, m_dim_ru);
+  m_block_N.resize(block, m_dim_C);
+  for (size_t b0=0; b0<n_sessions; b0+=block) {
+    const size_t nb = std::min(block, n_sessions-b0);
+    // Computes the statistics, in parallel over the sessions
+    bob::core::thread_loop(boost::bind(&bob::trainer::FABaseTrainer::processU,
+      this, boost::cref(m), boost::cref(stats), boost::cref(sessions), true,
+      b0, _2, _3), nb, m_n_threads);
+    // Updates the accumulators, in parallel over the Gaussian components
+    FAAccumulator accumulator;
+    accumulator.A1 = m_block_A1.data();
+    accumulator.Fn = m_block_Fn.data();
+    accumulator.w = m_block_w.data();
+    accumulator.N = m_block_N.data();
+    accumulator.n_items = nb;
+    accumulator.dim_c = m_dim_C;
+    accumulator.dim_d = m_dim_D;
+    accumulator.r = m_dim_ru;
+    accumulator.acc_A1 = m_acc_U_A1.data();
+    accumulator.acc_A2 = m_acc_U_A2.data();
+    bob::core::thread_loop(accumulator, m_dim_C, m_n_threads);
   }
 }
 
@@ -473,38 +755,18 @@ void bob::trainer::FABaseTrainer::computeDProd(const bob::machine::FABase& m)
 
 void bob::trainer::FABaseTrainer::computeIdPlusDProd_i(const size_t id)
 {
-  const blitz::Array<double,1>& Ni = m_Nacc[id];
-  bob::core::array::repelem(Ni, m_tmp_CD); // m_tmp_CD = Ni 'repmat'
-  m_cache_IdPlusDProd_i = 1.; // m_cache_IdPlusDProd_i = Id
-  m_cache_IdPlusDProd_i += m_cache_DProd * m_tmp_CD; // m_cache_IdPlusDProd_i = I+Dt*diag(sigma)^-1*Ni*D
-  m_cache_IdPlusDProd_i = 1 / m_cache_IdPlusDProd_i; // m_cache_IdPlusVProd_i = (I+Dt*diag(sigma)^-1*Ni*D)^-1
+  // m_cache_IdPlusDProd_i = (I+Dt*diag(sigma)^-1*Ni*D)^-1
+  computeIdPlusDProd(m_cache_DProd, m_Nacc[id], m_tmp_CD, m_cache_IdPlusDProd_i);
 }
 
 void bob::trainer::FABaseTrainer::computeFn_z_i(
   const bob::machine::FABase& mb,
   const std::vector<boost::shared_ptr<bob::machine::GMMStats> >& stats, const size_t id)
 {
-  const blitz::Array<double,2>& U = mb.getU();
-  const blitz::Array<double,2>& V = mb.getV();
   // Compute Fn_z_i = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i} - U*x_{i,h}) (Normalised first order statistics)
-  const blitz::Array<double,1>& Fi = m_Facc[id];
-  const blitz::Array<double,1>& m = mb.getUbmMean();
-  const blitz::Array<double,1>& y = m_y[id];
-  bob::core::array::repelem(m_Nacc[id], m_tmp_CD);
-  bob::math::prod(V, y, m_tmp_CD_b); // m_tmp_CD_b = V * y
-  m_cache_Fn_z_i = Fi - m_tmp_CD * (m + m_tmp_CD_b); // Fn_yi = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i})
-
-  const blitz::Array<double,2>& X = m_x[id];
-  blitz::Range rall = blitz::Range::all();
-  for (int h=0; h<X.extent(1); ++h) // Loops over the sessions
-  {
-    const blitz::Array<double,1>& Nh = stats[h]->n; // Nh = N_{i,h} (length: C)
-    bob::core::array::repelem(Nh, m_tmp_CD);
-    blitz::Array<double,1> Xh = X(rall, h); // Xh = x_{i,h} (length: ru)
-    bob::math::prod(U, Xh, m_tmp_CD_b);
-    m_cache_Fn_z_i -= m_tmp_CD * m_tmp_CD_b;
-  }
-  // Fn_z_i = sum_{sessions h}(N_{i,h}*(o_{i,h} - m - V*y_{i} - U*x_{i,h})
+  bob::math::prod(mb.getV(), m_y[id], m_tmp_CD_b); // m_tmp_CD_b = V * y
+  computeFn_yz(m_Facc[id], m_Nacc[id], mb.getUbmMean(), mb.getU(), m_x[id],
+    stats, m_tmp_CD, m_tmp_CD_b, m_cache_Fn_z_i);
 }
 
 void bob::trainer::FABaseTrainer::updateZ_i(const size_t id)
@@ -515,6 +777,43 @@ void bob::trainer::FABaseTrainer::updateZ_i(const size_t id)
   z = m_cache_IdPlusDProd_i * m_cache_DtSigmaInv * m_cache_Fn_z_i;
 }
 
+void bob::trainer::FABaseTrainer::processD(const bob::machine::FABase& mb,
+  const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats,
+  const bool accumulate, const size_t b0, const size_t begin, const size_t end)
+{
+  const int CD = m_dim_C*m_dim_D;
+  const blitz::Array<double,2> U = wrap(mb.getU());
+  const blitz::Array<double,2> V = wrap(mb.getV());
+  const blitz::Array<double,1> m = wrap(mb.getUbmMean());
+  const blitz::Array<double,1> DtSigmaInv = wrap(m_cache_DtSigmaInv);
+  const blitz::Array<double,1> DProd = wrap(m_cache_DProd);
+  blitz::Array<double,2> block_A1 = wrap(m_block_A1);
+  blitz::Array<double,2> block_Fn = wrap(m_block_Fn);
+  blitz::Array<double,2> block_w = wrap(m_block_w);
+  blitz::Array<double,2> block_N = wrap(m_block_N);
+  // Working arrays of the thread
+  blitz::Array<double,1> IdPlusDProd(CD), Fn(CD), tmp_CD(CD), tmp_CD_b(CD);
+  blitz::Range rall = blitz::Range::all();
+  for (size_t k=begin; k<end; ++k) {
+    const size_t id = b0 + k;
+    const blitz::Array<double,1> Ni = wrap(m_Nacc[id]);
+    blitz::Array<double,1> z = wrap(m_z[id]);
+    computeIdPlusDProd(DProd, Ni, tmp_CD, IdPlusDProd);
+    bob::math::prod(V, wrap(m_y[id]), tmp_CD_b); // tmp_CD_b = V * y
+    computeFn_yz(wrap(m_Facc[id]), Ni, m, U, wrap(m_x[id]), stats[id],
+      tmp_CD, tmp_CD_b, Fn);
+    if (!accumulate)
+      z = IdPlusDProd * DtSigmaInv * Fn;
+    else {
+      // Needs to return values to be accumulated for estimating D
+      block_A1(k, rall) = IdPlusDProd;
+      block_Fn(k, rall) = Fn;
+      block_w(k, rall) = z;
+      block_N(k, rall) = Ni;
+    }
+  }
+}
+
 void bob::trainer::FABaseTrainer::updateZ(const bob::machine::FABase& m,
   const std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > >& stats)
 {
@@ -522,11 +821,9 @@ void bob::trainer::FABaseTrainer::updateZ(const bob::machine::FABase& m,
   computeDtSigmaInv(m);
   computeDProd(m);
   // Loops over all people
-  for (size_t id=0; id<m_Nid; ++id) {
-    computeIdPlusDProd_i(id);
-    computeFn_z_i(m, stats[id], id);
-    updateZ_i(id);
-  }
+  bob::core::thread_loop(boost::bind(&bob::trainer::FABaseTrainer::processD,
+    this, boost::cref(m), boost::cref(stats), false, 0, _2, _3),
+    m_Nid, m_n_threads);
 }
 
 void bob::trainer::FABaseTrainer::computeAccumulatorsD(
@@ -536,18 +833,34 @@ void bob::trainer::FABaseTrainer::computeAccumulatorsD(
   // Initializes the cache accumulator
   m_acc_D_A1 = 0.;
   m_acc_D_A2 = 0.;
-  // Loops over all people
-  blitz::firstIndex i;
-  blitz::secondIndex j;
-  for (size_t id=0; id<stats.size(); ++id) {
-    computeIdPlusDProd_i(id);
-    computeFn_z_i(m, stats[id], id);
-
-    // Needs to return values to be accumulated for estimating D
-    blitz::Array<double,1> z = m_z[id];
-    bob::core::array::repelem(m_Nacc[id], m_tmp_CD);
-    m_acc_D_A1 += (m_cache_IdPlusDProd_i + z * z) * m_tmp_CD;
-    m_acc_D_A2 += m_cache_Fn_z_i * z;
+  const size_t n_ids = stats.size();
+  if (n_ids == 0) return;
+  const size_t CD = m_dim_C*m_dim_D;
+  // The identities are processed by blocks, which bounds the memory used by
+  // their statistics
+  const size_t block = blockSize(n_ids, 3*CD + m_dim_C);
+  m_block_A1.resize(block, CD);
+  m_block_Fn.resize(block, CD);
+  m_block_w.resize(block, CD);
+  m_block_N.resize(block, m_dim_C);
+  for (size_t b0=0; b0<n_ids; b0+=block) {
+    const size_t nb = std::min(block, n_ids-b0);
+    // Computes the statistics, in parallel over the identities
+    bob::core::thread_loop(boost::bind(&bob::trainer::FABaseTrainer::processD,
+      this, boost::cref(m), boost::cref(stats), true, b0, _2, _3),
+      nb, m_n_threads);
+    // Updates the accumulators, in parallel over the Gaussian components
+    FADAccumulator accumulator;
+    accumulator.A1 = m_block_A1.data();
+    accumulator.Fn = m_block_Fn.data();
+    accumulator.z = m_block_w.data();
+    accumulator.N = m_block_N.data();
+    accumulator.n_items = nb;
+    accumulator.dim_c = m_dim_C;
+    accumulator.dim_d = m_dim_D;
+    accumulator.acc_A1 = m_acc_D_A1.data();
+    accumulator.acc_A2 = m_acc_D_A2.data();
+    bob::core::thread_loop(accumulator, m_dim_C, m_n_threads);
   }
 }
 
@@ -570,6 +883,7 @@ bob::trainer::ISVTrainer::ISVTrainer(const bob::trainer::ISVTrainer& other):
   EMTrainer<bob::machine::ISVBase, std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > > >
     (other.m_convergence_threshold, other.m_max_iterations,
      other.m_compute_likelihood),
+  m_base_trainer(other.m_base_trainer),
   m_relevance_factor(other.m_relevance_factor)
 {
 }
@@ -586,6 +900,7 @@ bob::trainer::ISVTrainer& bob::trainer::ISVTrainer::operator=
     bob::trainer::EMTrainer<bob::machine::ISVBase,
       std::vector<std::vector<boost::shared_ptr<bob::machine::GMMStats> > > >::operator=(other);
     m_relevance_factor = other.m_relevance_factor;
+    m_base_trainer.setNThreads(other.m_base_trainer.getNThreads());
   }
   return *this;
 }
@@ -689,7 +1004,8 @@ bob::trainer::JFATrainer::JFATrainer(const size_t max_iterations):
 }
 
 bob::trainer::JFATrainer::JFATrainer(const bob::trainer::JFATrainer& other):
-  m_max_iterations(other.m_max_iterations), m_rng(other.m_rng)
+  m_max_iterations(other.m_max_iterations), m_rng(other.m_rng),
+  m_base_trainer(other.m_base_trainer)
 {
 }
 
@@ -704,6 +1020,7 @@ bob::trainer::JFATrainer& bob::trainer::JFATrainer::operator=
   {
     m_max_iterations = other.m_max_iterations;
     m_rng = other.m_rng;
+    m_base_trainer.setNThreads(other.m_base_trainer.getNThreads());
   }
   return *this;
 }
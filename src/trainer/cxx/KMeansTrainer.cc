@@ -21,19 +21,158 @@
 
 #include <bob/trainer/KMeansTrainer.h>
 #include <bob/core/array_copy.h>
+#include <bob/core/threads.h>
+#include <bob/math/linear.h>
 #include <boost/random.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #if BOOST_VERSION >= 104700
 #include <boost/random/discrete_distribution.hpp>
 #endif
 
+/**
+ * Number of samples of the blocks of the E-step, whose distances to the
+ * means are computed with one matrix product
+ */
+static const int s_block = 256;
+
+/**
+ * Relative margin of the bounds of the distances used by the pruning, which
+ * accounts for the round-off errors of the (square Euclidean) distances and
+ * of the moves of the means
+ */
+static const double s_bound_margin = 1e-9;
+
+/**
+ * Finds the closest mean of each sample of a range of blocks, as well as the
+ * distance to this mean and a lower bound of the distance to the other
+ * means. Only raw pointers are shared with the other threads, as the
+ * reference counting of blitz arrays is not thread-safe.
+ */
+struct KMeansAssigner {
+  const double* data;
+  int data_s0, data_s1;
+  int n_samples;
+  const double* means;
+  int means_s0, means_s1;
+  const double* means_t;
+  const double* means_norm;
+  double max_means_norm;
+  int dim_d;
+  int n_means;
+  size_t* closest;
+  double* min_distance;
+  double* lower_bound;
+  bool use_bounds;
+  double max_shift;
+
+  /**
+   * Square Euclidean distance between a sample and a mean, summed in the
+   * same order as KMeansMachine::getDistanceFromMean()
+   */
+  double distance(const int i, const int j) const
+  {
+    const double* x = data + i*data_s0;
+    const double* m = means + j*means_s0;
+    double d = 0.;
+    for (int k=0; k<dim_d; ++k) {
+      const double t = m[k*means_s1] - x[k*data_s1];
+      d += t*t;
+    }
+    return d;
+  }
+
+  void operator()(const size_t, const size_t begin, const size_t end) const
+  {
+    const blitz::Range rall = blitz::Range::all();
+    const blitz::Array<double,2> Mt(const_cast<double*>(means_t),
+      blitz::shape(dim_d, n_means), blitz::neverDeleteData);
+    blitz::Array<double,2> X(s_block, dim_d);
+    blitz::Array<double,2> G(s_block, n_means);
+    std::vector<int> todo;
+    todo.reserve(s_block);
+
+    for (size_t b=begin; b<end; ++b)
+    {
+      const int i0 = b*s_block;
+      const int i1 = std::min(n_samples, i0+s_block);
+
+      // 1. Skips the samples whose closest mean is closer than the lower
+      // bound of the distance to the other means, once the latter moved
+      todo.clear();
+      for (int i=i0; i<i1; ++i) {
+        if (use_bounds) {
+          const double d = distance(i, closest[i]);
+          const double l = lower_bound[i] * (1.-s_bound_margin) -
+            max_shift * (1.+s_bound_margin);
+          if (std::sqrt(d) * (1.+s_bound_margin) < l) {
+            min_distance[i] = d;
+            lower_bound[i] = l;
+            continue;
+          }
+        }
+        todo.push_back(i);
+      }
+      const int n = todo.size();
+      if (n == 0) continue;
+
+      // 2. Computes the inner products of the other samples with the means
+      for (int r=0; r<n; ++r) {
+        const double* x = data + todo[r]*data_s0;
+        for (int k=0; k<dim_d; ++k) X(r,k) = x[k*data_s1];
+      }
+      const blitz::Range rn(0, n-1);
+      blitz::Array<double,2> Xn = X(rn, rall);
+      blitz::Array<double,2> Gn = G(rn, rall);
+      bob::math::prod_(Xn, Mt, Gn);
+
+      // 3. Compares the exact distances to the means whose approximate
+      // distances are close to the smallest one, in the order of the means
+      for (int r=0; r<n; ++r) {
+        const int i = todo[r];
+        double x_norm = 0.;
+        for (int k=0; k<dim_d; ++k) x_norm += X(r,k) * X(r,k);
+        double approx_min = std::numeric_limits<double>::max();
+        for (int j=0; j<n_means; ++j) {
+          G(r,j) = x_norm - 2.*G(r,j) + means_norm[j];
+          approx_min = std::min(approx_min, G(r,j));
+        }
+        const double tol = 8. * (dim_d + 4) *
+          std::numeric_limits<double>::epsilon() * (x_norm + max_means_norm);
+
+        size_t c = 0;
+        double d_min = std::numeric_limits<double>::max();
+        for (int j=0; j<n_means; ++j) {
+          if (G(r,j) <= approx_min + 2.*tol) {
+            const double d = distance(i, j);
+            if (d < d_min) {
+              d_min = d;
+              c = j;
+            }
+          }
+        }
+        double l = std::numeric_limits<double>::infinity();
+        for (int j=0; j<n_means; ++j)
+          if (j != (int)c) l = std::min(l, G(r,j) - tol);
+        closest[i] = c;
+        min_distance[i] = d_min;
+        lower_bound[i] = std::sqrt(std::max(0., l));
+      }
+    }
+  }
+};
+
 bob::trainer::KMeansTrainer::KMeansTrainer(double convergence_threshold,
     size_t max_iterations, bool compute_likelihood, InitializationMethod i_m):
   bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >(
     convergence_threshold, max_iterations, compute_likelihood), 
   m_initialization_method(i_m),
-  m_rng(new boost::mt19937()), m_average_min_distance(0),
-  m_zeroethOrderStats(0), m_firstOrderStats(0,0)
+  m_rng(new boost::mt19937()), m_n_threads(1), m_use_pruning(false),
+  m_reuse_bounds(false), m_average_min_distance(0),
+  m_zeroethOrderStats(0), m_firstOrderStats(0,0),
+  m_cache_data(0), m_cache_bounds_valid(false), m_in_train(false)
 {
 }
 
@@ -41,9 +180,12 @@ bob::trainer::KMeansTrainer::KMeansTrainer(const bob::trainer::KMeansTrainer& ot
   bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >(
     other.m_convergence_threshold, other.m_max_iterations, other.m_compute_likelihood), 
   m_initialization_method(other.m_initialization_method),
-  m_rng(other.m_rng), m_average_min_distance(other.m_average_min_distance),
+  m_rng(other.m_rng), m_n_threads(other.m_n_threads),
+  m_use_pruning(other.m_use_pruning), m_reuse_bounds(other.m_reuse_bounds),
+  m_average_min_distance(other.m_average_min_distance),
   m_zeroethOrderStats(bob::core::array::ccopy(other.m_zeroethOrderStats)), 
-  m_firstOrderStats(bob::core::array::ccopy(other.m_firstOrderStats))
+  m_firstOrderStats(bob::core::array::ccopy(other.m_firstOrderStats)),
+  m_cache_data(0), m_cache_bounds_valid(false), m_in_train(false)
 {
 }
  
@@ -55,6 +197,10 @@ bob::trainer::KMeansTrainer& bob::trainer::KMeansTrainer::operator=
     EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >::operator=(other);
     m_initialization_method = other.m_initialization_method;
     m_rng = other.m_rng;
+    m_n_threads = other.m_n_threads;
+    m_use_pruning = other.m_use_pruning;
+    m_reuse_bounds = other.m_reuse_bounds;
+    m_cache_bounds_valid = false;
     m_average_min_distance = other.m_average_min_distance;
     m_zeroethOrderStats.reference(bob::core::array::ccopy(other.m_zeroethOrderStats));
     m_firstOrderStats.reference(bob::core::array::ccopy(other.m_firstOrderStats));
@@ -65,7 +211,10 @@ bob::trainer::KMeansTrainer& bob::trainer::KMeansTrainer::operator=
 bool bob::trainer::KMeansTrainer::operator==(const bob::trainer::KMeansTrainer& b) const {
   return EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >::operator==(b) &&
          m_initialization_method == b.m_initialization_method &&
-         *m_rng == *(b.m_rng) && m_average_min_distance == b.m_average_min_distance &&
+         *m_rng == *(b.m_rng) && m_n_threads == b.m_n_threads &&
+         m_use_pruning == b.m_use_pruning &&
+         m_reuse_bounds == b.m_reuse_bounds &&
+         m_average_min_distance == b.m_average_min_distance &&
          bob::core::array::hasSameShape(m_zeroethOrderStats, b.m_zeroethOrderStats) &&
          bob::core::array::hasSameShape(m_firstOrderStats, b.m_firstOrderStats) &&
          blitz::all(m_zeroethOrderStats == b.m_zeroethOrderStats) &&
@@ -76,6 +225,25 @@ bool bob::trainer::KMeansTrainer::operator!=(const bob::trainer::KMeansTrainer&
   return !(this->operator==(b));
 }
  
+void bob::trainer::KMeansTrainer::train(bob::machine::KMeansMachine& kmeans,
+  const blitz::Array<double,2>& ar)
+{
+  // the data does not change during the training, so the bounds of an
+  // eStep() are valid for the next one, but not for a later call
+  m_cache_bounds_valid = false;
+  m_in_train = true;
+  try {
+    bob::trainer::EMTrainer<bob::machine::KMeansMachine, blitz::Array<double,2> >::train(kmeans, ar);
+  }
+  catch (...) {
+    m_in_train = false;
+    m_cache_bounds_valid = false;
+    throw;
+  }
+  m_in_train = false;
+  m_cache_bounds_valid = false;
+}
+
 void bob::trainer::KMeansTrainer::initialize(bob::machine::KMeansMachine& kmeans,
   const blitz::Array<double,2>& ar) 
 {
@@ -182,6 +350,8 @@ void bob::trainer::KMeansTrainer::initialize(bob::machine::KMeansMachine& kmeans
    // Resize the accumulator
   m_zeroethOrderStats.resize(kmeans.getNMeans());
   m_firstOrderStats.resize(kmeans.getNMeans(), kmeans.getNInputs());
+  // The bounds of the previous training (if any) are not valid anymore
+  m_cache_bounds_valid = false;
 }
 
 void bob::trainer::KMeansTrainer::eStep(bob::machine::KMeansMachine& kmeans, 
@@ -190,23 +360,75 @@ void bob::trainer::KMeansTrainer::eStep(bob::machine::KMeansMachine& kmeans,
   // initialise the accumulators
   resetAccumulators(kmeans);
 
-  // iterate over data samples
+  const int n_samples = ar.extent(0);
+  const int n_means = kmeans.getNMeans();
+  const int dim_d = kmeans.getNInputs();
+  const blitz::Array<double,2>& means = kmeans.getMeans();
   blitz::Range a = blitz::Range::all();
-  for(int i=0; i<ar.extent(0); ++i) {
-    // get example
-    blitz::Array<double, 1> x(ar(i,a));
 
-    // find closest mean, and distance from that mean
-    size_t closest_mean = 0;
-    double min_distance = 0;
-    kmeans.getClosestMean(x,closest_mean,min_distance);
+  // transposed means, and their square norms
+  blitz::Array<double,2> means_t(dim_d, n_means);
+  means_t = means.transpose(1,0);
+  blitz::firstIndex i_;
+  blitz::secondIndex j_;
+  blitz::Array<double,1> means_norm(n_means);
+  means_norm = blitz::sum(blitz::pow2(means(i_,j_)), j_);
 
-    // accumulate the stats
-    m_average_min_distance += min_distance;
+  // the bounds of the previous call are only reused within train(), or if
+  // explicitly requested, for the same data and number of means
+  const bool use_bounds = m_use_pruning && m_cache_bounds_valid &&
+    (m_in_train || m_reuse_bounds) && m_cache_data == ar.data() && (int)m_cache_closest.size() == n_samples &&
+    bob::core::array::hasSameShape(m_cache_means, means);
+  double max_shift = 0.;
+  if (use_bounds) {
+    for (int j=0; j<n_means; ++j)
+      max_shift = std::max(max_shift,
+        std::sqrt(blitz::sum(blitz::pow2(means(j,a) - m_cache_means(j,a)))));
+  }
+  m_cache_closest.resize(n_samples);
+  m_cache_min_distance.resize(n_samples);
+  m_cache_lower_bound.resize(n_samples);
+
+  // find the closest means, in parallel over the blocks of samples
+  if (n_samples > 0) {
+    KMeansAssigner assigner;
+    assigner.data = ar.data();
+    assigner.data_s0 = ar.stride(0);
+    assigner.data_s1 = ar.stride(1);
+    assigner.n_samples = n_samples;
+    assigner.means = means.data();
+    assigner.means_s0 = means.stride(0);
+    assigner.means_s1 = means.stride(1);
+    assigner.means_t = means_t.data();
+    assigner.means_norm = means_norm.data();
+    assigner.max_means_norm = (n_means > 0 ? blitz::max(means_norm) : 0.);
+    assigner.dim_d = dim_d;
+    assigner.n_means = n_means;
+    assigner.closest = &m_cache_closest[0];
+    assigner.min_distance = &m_cache_min_distance[0];
+    assigner.lower_bound = &m_cache_lower_bound[0];
+    assigner.use_bounds = use_bounds;
+    assigner.max_shift = max_shift;
+    bob::core::thread_loop(assigner, (n_samples + s_block - 1) / s_block,
+      m_n_threads);
+  }
+
+  // accumulate the stats, in the order of the samples
+  for(int i=0; i<n_samples; ++i) {
+    const size_t closest_mean = m_cache_closest[i];
+    m_average_min_distance += m_cache_min_distance[i];
     ++m_zeroethOrderStats(closest_mean);
-    m_firstOrderStats(closest_mean,blitz::Range::all()) += x;
+    m_firstOrderStats(closest_mean,blitz::Range::all()) += ar(i,a);
   }
   m_average_min_distance /= static_cast<double>(ar.extent(0));
+
+  // keep the means the bounds refer to
+  if (m_use_pruning) {
+    m_cache_means.resize(means.shape());
+    m_cache_means = means;
+    m_cache_data = ar.data();
+    m_cache_bounds_valid = true;
+  }
 }
 
 void bob::trainer::KMeansTrainer::mStep(bob::machine::KMeansMachine& kmeans, 
@@ -233,6 +455,8 @@ void bob::trainer::KMeansTrainer::finalize(bob::machine::KMeansMachine& kmeans,
 bool bob::trainer::KMeansTrainer::resetAccumulators(bob::machine::KMeansMachine& kmeans)
 {
   m_average_min_distance = 0;
+  m_zeroethOrderStats.resize(kmeans.getNMeans());
+  m_firstOrderStats.resize(kmeans.getNMeans(), kmeans.getNInputs());
   m_zeroethOrderStats = 0;
   m_firstOrderStats = 0;
   return true;
@@ -140,22 +140,11 @@ bool bob::trainer::MLPBaseTrainer::isCompatible(const bob::machine::MLP& machine
 void bob::trainer::MLPBaseTrainer::forward_step(const bob::machine::MLP& machine,
   const blitz::Array<double,2>& input)
 {
-  const std::vector<blitz::Array<double,2> >& machine_weight = machine.getWeights();
-  const std::vector<blitz::Array<double,1> >& machine_bias = machine.getBiases();
-
-  boost::shared_ptr<bob::machine::Activation> hidden_actfun = machine.getHiddenActivation();
-  boost::shared_ptr<bob::machine::Activation> output_actfun = machine.getOutputActivation();
-
-  for (size_t k=0; k<machine_weight.size(); ++k) { //for all layers
-    if (k == 0) bob::math::prod_(input, machine_weight[k], m_output[k]);
-    else bob::math::prod_(m_output[k-1], machine_weight[k], m_output[k]);
-    boost::shared_ptr<bob::machine::Activation> cur_actfun =
-      (k == (machine_weight.size()-1) ? output_actfun : hidden_actfun );
-    for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-      for (int j=0; j<m_output[k].extent(1); ++j) { //for all variables
-        m_output[k](i,j) = cur_actfun->f(m_output[k](i,j) + machine_bias[k](j));
-      }
-    }
+  //one matrix product and one activation call per layer, for the whole batch
+  const size_t n_layers = machine.getWeights().size();
+  for (size_t k=0; k<n_layers; ++k) { //for all layers
+    if (k == 0) machine.forwardLayer_(k, input, m_output[k]);
+    else machine.forwardLayer_(k, m_output[k-1], m_output[k]);
   }
 }
 
@@ -177,11 +166,7 @@ void bob::trainer::MLPBaseTrainer::backward_step
   boost::shared_ptr<bob::machine::Activation> hidden_actfun = machine.getHiddenActivation();
   for (size_t k=m_H; k>0; --k) {
     bob::math::prod_(m_error[k], machine_weight[k].transpose(1,0), m_error[k-1]);
-    for (int i=0; i<(int)m_batch_size; ++i) { //for every example
-      for (int j=0; j<m_error[k-1].extent(1); ++j) { //for all variables
-        m_error[k-1](i,j) *= hidden_actfun->f_prime_from_f(m_output[k-1](i,j));
-      }
-    }
+    hidden_actfun->mult_f_prime_from_f_batch(m_output[k-1], m_error[k-1]);
   }
 
   //calculate the derivatives of the cost w.r.t. the weights and biases
@@ -0,0 +1,359 @@
+/**
+ * @file trainer/cxx/MiniBatchKMeansTrainer.cc
+ * @date Sun Oct 18 14:02:37 2026 +0200
+ *
+ * @brief Mini-batch k-means, for data sets which do not fit in memory
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/trainer/MiniBatchKMeansTrainer.h>
+#include <bob/core/array_copy.h>
+#include <bob/core/assert.h>
+#include <bob/core/logging.h>
+#include <boost/format.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Reads all the samples of a source, batch per batch, finds their closest
+ * means, and calls op(batch, trainer) after each batch
+ */
+template <typename T>
+static void forEachBatch(bob::trainer::KMeansTrainer& trainer,
+  bob::machine::KMeansMachine& kmeans,
+  const bob::trainer::SampleSource& source, blitz::Array<double,2>& batch,
+  T& op)
+{
+  const size_t n_samples = source.size();
+  const size_t batch_size = batch.extent(0);
+  for (size_t b0=0; b0<n_samples; b0+=batch_size) {
+    const int nb = std::min(batch_size, n_samples-b0);
+    blitz::Array<double,2> batch_b = batch(blitz::Range(0,nb-1),
+      blitz::Range::all());
+    source.read(b0, batch_b);
+    trainer.eStep(kmeans, batch_b);
+    op(batch_b, trainer);
+  }
+}
+
+/**
+ * Sums the distances of the samples to their closest means
+ */
+struct KMeansCost {
+  double cost;
+
+  void operator()(const blitz::Array<double,2>&,
+    const bob::trainer::KMeansTrainer& trainer)
+  {
+    const std::vector<double>& d = trainer.getMinDistances();
+    for (size_t i=0; i<d.size(); ++i) cost += d[i];
+  }
+};
+
+/**
+ * Selects each sample as a candidate mean of k-means|| with a probability
+ * proportional to its distance to the closest (previous) candidate, and
+ * sums these distances
+ */
+struct KMeansParallelSampler {
+  boost::mt19937* rng;
+  double oversampling;
+  double previous_cost;
+  double cost;
+  std::vector<blitz::Array<double,1> >* candidates;
+
+  void operator()(const blitz::Array<double,2>& batch,
+    const bob::trainer::KMeansTrainer& trainer)
+  {
+    boost::uniform_01<> range01;
+    boost::variate_generator<boost::mt19937&, boost::uniform_01<> > die(*rng, range01);
+    const std::vector<double>& d = trainer.getMinDistances();
+    for (size_t i=0; i<d.size(); ++i) {
+      cost += d[i];
+      if (die() * previous_cost < oversampling * d[i])
+        candidates->push_back(bob::core::array::ccopy(batch(i, blitz::Range::all())));
+    }
+  }
+};
+
+/**
+ * Counts the samples whose closest mean is each of the candidates
+ */
+struct KMeansCounter {
+  blitz::Array<double,1> counts;
+
+  void operator()(const blitz::Array<double,2>&,
+    const bob::trainer::KMeansTrainer& trainer)
+  {
+    counts += trainer.getZeroethOrderStats();
+  }
+};
+
+/**
+ * Returns an index chosen with a probability proportional to its
+ * (non-negative) weight
+ */
+static size_t sampleIndex(boost::mt19937& rng,
+  const blitz::Array<double,1>& weights)
+{
+  const double total = blitz::sum(weights);
+  boost::uniform_01<> range01;
+  boost::variate_generator<boost::mt19937&, boost::uniform_01<> > die(rng, range01);
+  const double u = die() * total;
+  double acc = 0.;
+  size_t last = 0;
+  for (int i=0; i<weights.extent(0); ++i) {
+    if (weights(i) <= 0.) continue;
+    acc += weights(i);
+    last = i;
+    if (u < acc) break;
+  }
+  return last;
+}
+
+/**
+ * Returns a KMeansMachine whose means are the given candidates
+ */
+static boost::shared_ptr<bob::machine::KMeansMachine> candidateMachine(
+  const std::vector<blitz::Array<double,1> >& candidates, const size_t dim_d)
+{
+  boost::shared_ptr<bob::machine::KMeansMachine> machine(
+    new bob::machine::KMeansMachine(candidates.size(), dim_d));
+  for (size_t c=0; c<candidates.size(); ++c)
+    machine->setMean(c, candidates[c]);
+  return machine;
+}
+
+bob::trainer::MiniBatchKMeansTrainer::MiniBatchKMeansTrainer(
+    const size_t batch_size, const size_t max_iterations,
+    const double convergence_threshold):
+  m_batch_size(batch_size), m_max_iterations(max_iterations),
+  m_convergence_threshold(convergence_threshold),
+  m_n_rounds(5), m_oversampling_factor(2.),
+  m_rng(new boost::mt19937()),
+  m_trainer(), m_counts(0), m_average_min_distance(0)
+{
+  setBatchSize(batch_size);
+}
+
+bob::trainer::MiniBatchKMeansTrainer::MiniBatchKMeansTrainer(
+    const bob::trainer::MiniBatchKMeansTrainer& other):
+  m_batch_size(other.m_batch_size),
+  m_max_iterations(other.m_max_iterations),
+  m_convergence_threshold(other.m_convergence_threshold),
+  m_n_rounds(other.m_n_rounds),
+  m_oversampling_factor(other.m_oversampling_factor),
+  m_rng(other.m_rng),
+  m_trainer(other.m_trainer),
+  m_counts(bob::core::array::ccopy(other.m_counts)),
+  m_average_min_distance(other.m_average_min_distance)
+{
+}
+
+bob::trainer::MiniBatchKMeansTrainer&
+bob::trainer::MiniBatchKMeansTrainer::operator=(
+  const bob::trainer::MiniBatchKMeansTrainer& other)
+{
+  if (this != &other)
+  {
+    m_batch_size = other.m_batch_size;
+    m_max_iterations = other.m_max_iterations;
+    m_convergence_threshold = other.m_convergence_threshold;
+    m_n_rounds = other.m_n_rounds;
+    m_oversampling_factor = other.m_oversampling_factor;
+    m_rng = other.m_rng;
+    m_trainer = other.m_trainer;
+    m_counts.reference(bob::core::array::ccopy(other.m_counts));
+    m_average_min_distance = other.m_average_min_distance;
+  }
+  return *this;
+}
+
+bool bob::trainer::MiniBatchKMeansTrainer::operator==(
+  const bob::trainer::MiniBatchKMeansTrainer& b) const
+{
+  return m_batch_size == b.m_batch_size &&
+         m_max_iterations == b.m_max_iterations &&
+         m_convergence_threshold == b.m_convergence_threshold &&
+         m_n_rounds == b.m_n_rounds &&
+         m_oversampling_factor == b.m_oversampling_factor &&
+         *m_rng == *(b.m_rng) &&
+         getNThreads() == b.getNThreads() &&
+         bob::core::array::hasSameShape(m_counts, b.m_counts) &&
+         blitz::all(m_counts == b.m_counts) &&
+         m_average_min_distance == b.m_average_min_distance;
+}
+
+bool bob::trainer::MiniBatchKMeansTrainer::operator!=(
+  const bob::trainer::MiniBatchKMeansTrainer& b) const
+{
+  return !(this->operator==(b));
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::setBatchSize(const size_t batch_size)
+{
+  if (batch_size == 0)
+    throw std::runtime_error("the batch size of the mini-batch k-means should be strictly positive");
+  m_batch_size = batch_size;
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::setOversamplingFactor(const double factor)
+{
+  if (factor <= 0.)
+    throw std::runtime_error("the oversampling factor of k-means|| should be strictly positive");
+  m_oversampling_factor = factor;
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::initialize(
+  bob::machine::KMeansMachine& kmeans, const bob::trainer::SampleSource& source)
+{
+  const size_t n_samples = source.size();
+  const size_t n_means = kmeans.getNMeans();
+  const size_t dim_d = kmeans.getNInputs();
+  bob::core::array::assertSameDimensionLength(source.getNInputs(), dim_d);
+  if (n_samples < n_means) {
+    boost::format m("cannot initialize %u means with %u samples");
+    m % n_means % n_samples;
+    throw std::runtime_error(m.str());
+  }
+  m_cache_batch.resize(std::min(m_batch_size, n_samples), dim_d);
+
+  // 1. Selects one sample uniformly at random
+  std::vector<blitz::Array<double,1> > candidates;
+  {
+    boost::uniform_int<size_t> range(0, n_samples-1);
+    boost::variate_generator<boost::mt19937&, boost::uniform_int<size_t> > die(*m_rng, range);
+    blitz::Array<double,2> sample(1, dim_d);
+    source.read(die(), sample);
+    candidates.push_back(bob::core::array::ccopy(sample(0, blitz::Range::all())));
+  }
+  boost::shared_ptr<bob::machine::KMeansMachine> machine =
+    candidateMachine(candidates, dim_d);
+
+  // 2. Computes the cost of the data given this candidate
+  KMeansCost cost;
+  cost.cost = 0.;
+  forEachBatch(m_trainer, *machine, source, m_cache_batch, cost);
+
+  // 3. Selects the samples which are far from the candidates, round after
+  // round. Each round reads the data once.
+  double previous_cost = cost.cost;
+  for (size_t r=0; r<m_n_rounds && previous_cost > 0.; ++r) {
+    KMeansParallelSampler sampler;
+    sampler.rng = m_rng.get();
+    sampler.oversampling = m_oversampling_factor * n_means;
+    sampler.previous_cost = previous_cost;
+    sampler.cost = 0.;
+    sampler.candidates = &candidates;
+    forEachBatch(m_trainer, *machine, source, m_cache_batch, sampler);
+    machine = candidateMachine(candidates, dim_d);
+    previous_cost = sampler.cost;
+    bob::core::info << "# k-means|| round " << r+1 << ": "
+      << candidates.size() << " candidates" << std::endl;
+  }
+
+  // 4. Weights each candidate by the number of samples it is the closest
+  // mean of
+  KMeansCounter counter;
+  counter.counts.resize(candidates.size());
+  counter.counts = 0.;
+  forEachBatch(m_trainer, *machine, source, m_cache_batch, counter);
+
+  // 5. Selects the means among the candidates, with a weighted k-means++
+  const int n_candidates = candidates.size();
+  blitz::Array<double,1> distances(n_candidates);
+  distances = std::numeric_limits<double>::max();
+  blitz::Array<double,1> weights(n_candidates);
+  weights = counter.counts;
+  for (size_t k=0; k<n_means; ++k) {
+    if (blitz::sum(weights) <= 0.) {
+      boost::format m("initialization failure: k-means|| found %u distinct candidates for %u means");
+      m % k % n_means;
+      throw std::runtime_error(m.str());
+    }
+    const size_t c = sampleIndex(*m_rng, weights);
+    kmeans.setMean(k, candidates[c]);
+    for (int i=0; i<n_candidates; ++i) {
+      distances(i) = std::min(distances(i), blitz::sum(blitz::pow2(candidates[i] - candidates[c])));
+      weights(i) = counter.counts(i) * distances(i);
+    }
+  }
+
+  m_counts.resize(n_means);
+  m_counts = 0.;
+  m_average_min_distance = 0.;
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::step(
+  bob::machine::KMeansMachine& kmeans, const blitz::Array<double,2>& batch)
+{
+  bob::core::array::assertSameDimensionLength(batch.extent(1),
+    kmeans.getNInputs());
+  if (m_counts.extent(0) != (int)kmeans.getNMeans()) {
+    m_counts.resize(kmeans.getNMeans());
+    m_counts = 0.;
+  }
+
+  // finds the closest means
+  m_trainer.eStep(kmeans, batch);
+  m_average_min_distance = m_trainer.getAverageMinDistance();
+
+  // moves each mean towards the average of its samples, with a learning
+  // rate of 1/count for each of them
+  const blitz::Array<double,1>& n = m_trainer.getZeroethOrderStats();
+  const blitz::Array<double,2>& f = m_trainer.getFirstOrderStats();
+  blitz::Array<double,2>& means = kmeans.updateMeans();
+  blitz::Range a = blitz::Range::all();
+  for (int c=0; c<means.extent(0); ++c) {
+    if (n(c) == 0.) continue;
+    m_counts(c) += n(c);
+    means(c,a) += (f(c,a) - n(c) * means(c,a)) / m_counts(c);
+  }
+}
+
+void bob::trainer::MiniBatchKMeansTrainer::train(
+  bob::machine::KMeansMachine& kmeans, const bob::trainer::SampleSource& source)
+{
+  bob::core::info << "# MiniBatchKMeansTrainer:" << std::endl;
+  initialize(kmeans, source);
+
+  // exponential smoothing of the distances of the batches, with a weight
+  // which depends on the fraction of the data in a batch
+  const size_t n_samples = source.size();
+  const int nb = m_cache_batch.extent(0);
+  const double alpha = std::min(1., 2. * nb / (n_samples + 1.));
+  boost::uniform_int<size_t> range(0, n_samples - nb);
+  boost::variate_generator<boost::mt19937&, boost::uniform_int<size_t> > die(*m_rng, range);
+  double average = 0.;
+  for (size_t iter=0; m_max_iterations == 0 || iter < m_max_iterations; ++iter) {
+    source.read(die(), m_cache_batch);
+    step(kmeans, m_cache_batch);
+
+    const double previous = average;
+    average = (iter == 0 ? m_average_min_distance :
+      (1. - alpha) * average + alpha * m_average_min_distance);
+    bob::core::info << "# Iteration " << iter+1 << ": " << average << std::endl;
+    // relative change, without dividing by a null previous average
+    if (iter > 0 && std::fabs(previous - average) <=
+        m_convergence_threshold * std::fabs(previous)) {
+      bob::core::info << "# Mini-batch k-means terminated: average distance converged" << std::endl;
+      break;
+    }
+  }
+}
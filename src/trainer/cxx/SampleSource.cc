@@ -0,0 +1,89 @@
+/**
+ * @file trainer/cxx/SampleSource.cc
+ * @date Sun Oct 18 14:02:37 2026 +0200
+ *
+ * @brief Sources of samples which are read by blocks
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <bob/trainer/SampleSource.h>
+#include <bob/core/assert.h>
+#include <bob/core/check.h>
+#include <boost/format.hpp>
+#include <stdexcept>
+
+/**
+ * Checks that the samples [begin, begin+samples.extent(0)) of a source can
+ * be read into the given array
+ */
+static void checkRead(const bob::trainer::SampleSource& source,
+  const size_t begin, const blitz::Array<double,2>& samples)
+{
+  bob::core::array::assertSameDimensionLength(samples.extent(1),
+    source.getNInputs());
+  if (begin + samples.extent(0) > source.size()) {
+    boost::format m("cannot read samples [%u, %u) of a source of %u samples");
+    m % begin % (begin + samples.extent(0)) % source.size();
+    throw std::runtime_error(m.str());
+  }
+}
+
+bob::trainer::ArraySampleSource::ArraySampleSource(
+  const blitz::Array<double,2>& data):
+  m_data(data)
+{
+}
+
+void bob::trainer::ArraySampleSource::read(const size_t begin,
+  blitz::Array<double,2>& samples) const
+{
+  checkRead(*this, begin, samples);
+  if (samples.extent(0) == 0) return;
+  samples = m_data(blitz::Range(begin, begin + samples.extent(0) - 1),
+    blitz::Range::all());
+}
+
+bob::trainer::HDF5SampleSource::HDF5SampleSource(
+  boost::shared_ptr<bob::io::HDF5File> file, const std::string& path):
+  m_file(file), m_path(path), m_size(0), m_n_inputs(0)
+{
+  const bob::io::HDF5Descriptor& descr = m_file->describe(m_path)[0];
+  const bob::io::HDF5Shape& shape = descr.type.shape();
+  if (shape.n() != 1) {
+    boost::format m("the dataset '%s' does not contain 1D arrays (one per sample), but arrays of %u dimensions");
+    m % m_path % shape.n();
+    throw std::runtime_error(m.str());
+  }
+  m_size = descr.size;
+  m_n_inputs = shape[0];
+}
+
+void bob::trainer::HDF5SampleSource::read(const size_t begin,
+  blitz::Array<double,2>& samples) const
+{
+  checkRead(*this, begin, samples);
+  if (samples.extent(0) == 0) return;
+  const size_t end = begin + samples.extent(0);
+  // a single hyperslab of the dataset, read directly into the samples if
+  // possible
+  if (bob::core::array::isCZeroBaseContiguous(samples))
+    m_file->readArray(m_path, begin, end, samples);
+  else {
+    blitz::Array<double,2> tmp(samples.shape());
+    m_file->readArray(m_path, begin, end, tmp);
+    samples = tmp;
+  }
+}
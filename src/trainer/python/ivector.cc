@@ -116,6 +116,8 @@ void bind_trainer_ivector()
     .def(self == self)
     .def(self != self)
     .def("is_similar_to", &bob::trainer::IVectorTrainer::is_similar_to, (arg("self"), arg("other"), arg("r_epsilon")=1e-5, arg("a_epsilon")=1e-8), "Compares this IVectorTrainer with the 'other' one to be approximately the same.")
+    .add_property("n_threads", &bob::trainer::IVectorTrainer::getNThreads, &bob::trainer::IVectorTrainer::setNThreads, "Number of threads used by the E-step (0 for the number of hardware threads). The accumulators do not depend on it.")
+    .add_property("use_cholesky", &bob::trainer::IVectorTrainer::getUseCholesky, &bob::trainer::IVectorTrainer::setUseCholesky, "Whether the E-step obtains the posteriors by a Cholesky decomposition, rather than by an explicit inverse")
     .add_property("acc_nij_wij2", make_function(&bob::trainer::IVectorTrainer::getAccNijWij2, return_value_policy<copy_const_reference>()), &py_set_AccNijWij2, "Accumulator updated during the E-step")
     .add_property("acc_fnormij_wij", make_function(&bob::trainer::IVectorTrainer::getAccFnormijWij, return_value_policy<copy_const_reference>()), &py_set_AccFnormijWij, "Accumulator updated during the E-step")
     .add_property("acc_nij", make_function(&bob::trainer::IVectorTrainer::getAccNij, return_value_policy<copy_const_reference>()), &py_set_AccNij, "Accumulator updated during the E-step")
@@ -105,6 +105,10 @@ void bind_trainer_kmeans()
      .def(self != self)
      .add_property("initialization_method", &bob::trainer::KMeansTrainer::getInitializationMethod, &bob::trainer::KMeansTrainer::setInitializationMethod, "The initialization method to generate the initial means.")
      .add_property("rng", &bob::trainer::KMeansTrainer::getRng, &bob::trainer::KMeansTrainer::setRng, "The Mersenne Twister mt19937 random generator used for the initialization of the means.")
+     .add_property("n_threads", &bob::trainer::KMeansTrainer::getNThreads, &bob::trainer::KMeansTrainer::setNThreads, "Number of threads used by the E-step (0 for the number of hardware threads). The statistics do not depend on it.")
+     .add_property("use_pruning", &bob::trainer::KMeansTrainer::getUsePruning, &bob::trainer::KMeansTrainer::setUsePruning, "Whether the E-step keeps a lower bound of the distance of each sample to its second closest mean, to skip the samples which cannot change of closest mean. The closest means do not depend on it.")
+     .add_property("reuse_bounds", &bob::trainer::KMeansTrainer::getReuseBounds, &bob::trainer::KMeansTrainer::setReuseBounds, "Whether the E-step reuses the bounds of the previous E-step outside of train(). This is only correct if the same data array is given to both E-steps and is not modified in between.")
+     .def("reset_cache", &bob::trainer::KMeansTrainer::resetCache, (arg("self")), "Discards the bounds of the previous E-step, for instance after having modified the data when reuse_bounds is set.")
      .add_property("average_min_distance", &bob::trainer::KMeansTrainer::getAverageMinDistance, &bob::trainer::KMeansTrainer::setAverageMinDistance, "Average min (square Euclidean) distance. Useful to parallelize the E-step.")
      .add_property("zeroeth_order_statistics", make_function(&bob::trainer::KMeansTrainer::getZeroethOrderStats, return_value_policy<copy_const_reference>()), &py_setZeroethOrderStats, "The zeroeth order statistics. Useful to parallelize the E-step.")
      .add_property("first_order_statistics", make_function(&bob::trainer::KMeansTrainer::getFirstOrderStats, return_value_policy<copy_const_reference>()), &py_setFirstOrderStats, "The first order statistics. Useful to parallelize the E-step.")
@@ -27,6 +27,7 @@ void bind_trainer_pca();
 void bind_trainer_lda();
 void bind_trainer_gmm();
 void bind_trainer_kmeans();
+void bind_trainer_minibatch_kmeans();
 void bind_trainer_mlpbase();
 void bind_trainer_backprop();
 void bind_trainer_rprop();
@@ -54,6 +55,7 @@ BOOST_PYTHON_MODULE(_trainer) {
   bind_trainer_lda();
   bind_trainer_gmm();
   bind_trainer_kmeans();
+  bind_trainer_minibatch_kmeans();
   bind_trainer_mlpbase();
   bind_trainer_backprop();
   bind_trainer_rprop();
@@ -0,0 +1,92 @@
+/**
+ * @file trainer/python/minibatch_kmeans.cc
+ * @date Sun Oct 18 14:02:37 2026 +0200
+ *
+ * @brief Python bindings to the sample sources and to the mini-batch
+ * k-means trainer
+ *
+ * Copyright (C) 2011-2013 Idiap Research Institute, Martigny, Switzerland
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/python.hpp>
+#include <boost/make_shared.hpp>
+#include <bob/python/ndarray.h>
+#include <bob/core/array_copy.h>
+#include <bob/trainer/MiniBatchKMeansTrainer.h>
+
+using namespace boost::python;
+
+static boost::shared_ptr<bob::trainer::ArraySampleSource> array_source
+(bob::python::const_ndarray data) {
+  // The data is copied, as the source may outlive the numpy array
+  return boost::make_shared<bob::trainer::ArraySampleSource>(
+    bob::core::array::ccopy(data.bz<double,2>()));
+}
+
+static object py_read(const bob::trainer::SampleSource& source,
+  const size_t begin, const size_t n_samples)
+{
+  bob::python::ndarray samples(bob::core::array::t_float64, n_samples,
+    source.getNInputs());
+  blitz::Array<double,2> samples_ = samples.bz<double,2>();
+  source.read(begin, samples_);
+  return samples.self();
+}
+
+static void py_step(bob::trainer::MiniBatchKMeansTrainer& trainer,
+  bob::machine::KMeansMachine& machine, bob::python::const_ndarray batch)
+{
+  trainer.step(machine, batch.bz<double,2>());
+}
+
+void bind_trainer_minibatch_kmeans()
+{
+  class_<bob::trainer::SampleSource, boost::shared_ptr<bob::trainer::SampleSource>, boost::noncopyable>("SampleSource", "A source of samples of the same dimensionality, which are read by ranges of consecutive samples.", no_init)
+    .def("__len__", &bob::trainer::SampleSource::size, (arg("self")), "The number of samples")
+    .add_property("dim_d", &bob::trainer::SampleSource::getNInputs, "The dimensionality of the samples")
+    .def("read", &py_read, (arg("self"), arg("begin"), arg("n_samples")), "Reads the samples [begin, begin+n_samples) into the rows of a new array")
+    ;
+
+  class_<bob::trainer::ArraySampleSource, boost::shared_ptr<bob::trainer::ArraySampleSource>, bases<bob::trainer::SampleSource> >("ArraySampleSource", "A source of samples stored in the rows of an array in memory.", no_init)
+    .def("__init__", make_constructor(&array_source, default_call_policies(), (arg("data"))), "Builds a source from the rows of a 2D array of float64, which is copied.")
+    ;
+
+  class_<bob::trainer::HDF5SampleSource, boost::shared_ptr<bob::trainer::HDF5SampleSource>, bases<bob::trainer::SampleSource> >("HDF5SampleSource", "A source of samples stored in a dataset of an HDF5 file, one 1D array per position (as written by HDF5File.append()). Only the samples which are read are loaded in memory.", no_init)
+    .def(init<boost::shared_ptr<bob::io::HDF5File>, const std::string&>((arg("self"), arg("file"), arg("path")), "Builds a source from a dataset of an HDF5 file"))
+    ;
+
+  class_<bob::trainer::MiniBatchKMeansTrainer, boost::shared_ptr<bob::trainer::MiniBatchKMeansTrainer> >("MiniBatchKMeansTrainer",
+      "Trains a KMeans machine with batches of samples read from a SampleSource, such that the memory only depends on the size of the batches and on the number of means.\n"
+      "See Sculley, \"Web-scale k-means clustering\", 2010.\n"
+      "The means are initialized with k-means|| (Bahmani et al., \"Scalable k-means++\", 2012), which reads the data a few times by batches. "
+      "Each iteration then reads a batch of consecutive samples at a random position, and moves each mean towards the average of its samples, with a learning rate which is the inverse of the number of samples it got so far.",
+      init<optional<const size_t, const size_t, const double> >((arg("self"), arg("batch_size")=1000, arg("max_iterations")=100, arg("convergence_threshold")=1e-4)))
+    .def(init<const bob::trainer::MiniBatchKMeansTrainer&>((arg("self"), arg("other"))))
+    .def(self == self)
+    .def(self != self)
+    .def("initialize", &bob::trainer::MiniBatchKMeansTrainer::initialize, (arg("self"), arg("machine"), arg("source")), "Initializes the means with k-means||, and resets the counts of the samples of the means. The data is read n_rounds+2 times.")
+    .def("step", &py_step, (arg("self"), arg("machine"), arg("batch")), "Updates the means given a batch of samples")
+    .def("train", &bob::trainer::MiniBatchKMeansTrainer::train, (arg("self"), arg("machine"), arg("source")), "Initializes the means and updates them with batches of samples until convergence")
+    .add_property("batch_size", &bob::trainer::MiniBatchKMeansTrainer::getBatchSize, &bob::trainer::MiniBatchKMeansTrainer::setBatchSize, "The number of samples of the batches")
+    .add_property("max_iterations", &bob::trainer::MiniBatchKMeansTrainer::getMaxIterations, &bob::trainer::MiniBatchKMeansTrainer::setMaxIterations, "The maximum number of batches (0 for no limit)")
+    .add_property("convergence_threshold", &bob::trainer::MiniBatchKMeansTrainer::getConvergenceThreshold, &bob::trainer::MiniBatchKMeansTrainer::setConvergenceThreshold, "The training stops once the relative change of the (exponentially smoothed) average distance of the samples of the batches to their closest means is below this threshold")
+    .add_property("n_rounds", &bob::trainer::MiniBatchKMeansTrainer::getNRounds, &bob::trainer::MiniBatchKMeansTrainer::setNRounds, "The number of sampling rounds of k-means||")
+    .add_property("oversampling_factor", &bob::trainer::MiniBatchKMeansTrainer::getOversamplingFactor, &bob::trainer::MiniBatchKMeansTrainer::setOversamplingFactor, "The expected number of candidate means per round of k-means||, divided by the number of means")
+    .add_property("n_threads", &bob::trainer::MiniBatchKMeansTrainer::getNThreads, &bob::trainer::MiniBatchKMeansTrainer::setNThreads, "Number of threads used to find the closest means (0 for the number of hardware threads)")
+    .add_property("counts", make_function(&bob::trainer::MiniBatchKMeansTrainer::getCounts, return_value_policy<copy_const_reference>()), "The number of samples each mean got so far")
+    .add_property("average_min_distance", &bob::trainer::MiniBatchKMeansTrainer::getAverageMinDistance, "The average (square Euclidean) distance of the samples of the last batch to their closest mean (before the update of the means)")
+    .add_property("rng", &bob::trainer::MiniBatchKMeansTrainer::getRng, &bob::trainer::MiniBatchKMeansTrainer::setRng, "The Mersenne Twister mt19937 random generator used by the initialization and the selection of the batches")
+    ;
+}